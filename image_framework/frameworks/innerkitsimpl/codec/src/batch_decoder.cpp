@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "batch_decoder.h"
+
+#include <algorithm>
+#include "image_log.h"
+#include "image_utils.h"
+#include "media_errors.h"
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+namespace {
+constexpr uint32_t DEFAULT_BYTES_PER_PIXEL = 4;
+} // namespace
+
+BatchDecoder::BatchDecoder(const BatchDecodeOptions &opts) : opts_(opts)
+{
+    uint32_t count = opts_.threadCount;
+    if (count == 0) {
+        count = thread::hardware_concurrency();
+    }
+    opts_.threadCount = min(max(count, 1u), MAX_THREAD_COUNT);
+}
+
+unique_ptr<BatchDecoder> BatchDecoder::Create(const BatchDecodeOptions &opts)
+{
+    unique_ptr<BatchDecoder> decoder(new (nothrow) BatchDecoder(opts));
+    if (decoder == nullptr) {
+        IMAGE_LOGE("[BatchDecoder]create batch decoder error.");
+        return nullptr;
+    }
+    decoder->Start();
+    return decoder;
+}
+
+BatchDecoder::~BatchDecoder()
+{
+    Wait();
+    {
+        lock_guard<mutex> guard(stateMutex_);
+        stop_ = true;
+    }
+    taskCond_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void BatchDecoder::Start()
+{
+    // register the plugins on this thread, so the workers never race on the first plugin server access.
+    ImageUtils::GetPluginServer();
+    for (uint32_t i = 0; i < opts_.threadCount; i++) {
+        queues_.push_back(make_unique<WorkQueue>());
+    }
+    for (uint32_t i = 0; i < opts_.threadCount; i++) {
+        workers_.emplace_back(&BatchDecoder::WorkerLoop, this, i);
+    }
+    IMAGE_LOGD("[BatchDecoder]start %{public}u workers.", opts_.threadCount);
+}
+
+uint32_t BatchDecoder::GetThreadCount() const
+{
+    return opts_.threadCount;
+}
+
+uint32_t BatchDecoder::Submit(const vector<BatchDecodeItem> &items, const Callback &callback)
+{
+    if (!callback) {
+        IMAGE_LOGE("[BatchDecoder]callback is empty.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    if (items.empty()) {
+        return SUCCESS;
+    }
+    auto sharedCallback = make_shared<Callback>(callback);
+    uint32_t queueIndex = 0;
+    {
+        // counted first, so Wait never sees zero while the tasks are being queued.
+        lock_guard<mutex> guard(stateMutex_);
+        pendingCount_ += items.size();
+        queueIndex = nextQueue_;
+        nextQueue_ = (nextQueue_ + items.size()) % queues_.size();
+    }
+    for (uint32_t i = 0; i < items.size(); i++) {
+        WorkQueue &queue = *queues_[(queueIndex + i) % queues_.size()];
+        lock_guard<mutex> guard(queue.mutex);
+        queue.tasks.push_back(Task { items[i], i, sharedCallback });
+    }
+    {
+        // a task is always in a queue before it is counted here, see WorkerLoop.
+        lock_guard<mutex> guard(stateMutex_);
+        queuedCount_ += items.size();
+    }
+    taskCond_.notify_all();
+    return SUCCESS;
+}
+
+future<vector<BatchDecodeResult>> BatchDecoder::Submit(const vector<BatchDecodeItem> &items)
+{
+    struct BatchState {
+        mutex resultMutex;
+        vector<BatchDecodeResult> results;
+        size_t remaining = 0;
+        promise<vector<BatchDecodeResult>> done;
+    };
+    auto state = make_shared<BatchState>();
+    state->results.resize(items.size());
+    state->remaining = items.size();
+    auto result = state->done.get_future();
+    if (items.empty()) {
+        state->done.set_value(move(state->results));
+        return result;
+    }
+    Submit(items, [state](BatchDecodeResult &itemResult) {
+        lock_guard<mutex> guard(state->resultMutex);
+        uint32_t index = itemResult.itemIndex;
+        state->results[index] = move(itemResult);
+        if (--state->remaining == 0) {
+            state->done.set_value(move(state->results));
+        }
+    });
+    return result;
+}
+
+void BatchDecoder::Wait()
+{
+    unique_lock<mutex> guard(stateMutex_);
+    doneCond_.wait(guard, [this] { return pendingCount_ == 0; });
+}
+
+void BatchDecoder::WorkerLoop(uint32_t workerId)
+{
+    while (true) {
+        {
+            unique_lock<mutex> guard(stateMutex_);
+            taskCond_.wait(guard, [this] { return stop_ || queuedCount_ > 0; });
+            if (queuedCount_ == 0) {
+                return;
+            }
+            // reserves one queued task for this worker.
+            queuedCount_--;
+        }
+        Task task;
+        while (!PopTask(workerId, task)) {
+            this_thread::yield();
+        }
+        RunTask(task);
+        bool allDone = false;
+        {
+            lock_guard<mutex> guard(stateMutex_);
+            allDone = (--pendingCount_ == 0);
+        }
+        if (allDone) {
+            doneCond_.notify_all();
+        }
+    }
+}
+
+bool BatchDecoder::PopTask(uint32_t workerId, Task &task)
+{
+    // own queue in submit order, the others are robbed from the back.
+    uint32_t count = queues_.size();
+    for (uint32_t i = 0; i < count; i++) {
+        WorkQueue &queue = *queues_[(workerId + i) % count];
+        lock_guard<mutex> guard(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        } else {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+void BatchDecoder::RunTask(Task &task)
+{
+    BatchDecodeResult result;
+    result.itemIndex = task.itemIndex;
+    uint32_t errorCode = SUCCESS;
+    uint64_t bytes = 0;
+    unique_ptr<ImageSource> source = CreateSource(task.item, errorCode);
+    if (source != nullptr) {
+        bytes = EstimatePixelBytes(*source, task.item);
+        AcquireBytes(bytes);
+        result.pixelMap = source->CreatePixelMapEx(task.item.index, task.item.decodeOptions, errorCode);
+        if (errorCode == SUCCESS && result.pixelMap == nullptr) {
+            errorCode = ERR_IMAGE_DECODE_FAILED;
+        }
+    }
+    if (errorCode != SUCCESS) {
+        IMAGE_LOGE("[BatchDecoder]item %{public}u decode error, ret:%{public}u.", task.itemIndex, errorCode);
+        result.pixelMap = nullptr;
+    }
+    result.errorCode = errorCode;
+    source = nullptr;
+    (*task.callback)(result);
+    task.callback = nullptr;
+    ReleaseBytes(bytes);
+}
+
+unique_ptr<ImageSource> BatchDecoder::CreateSource(const BatchDecodeItem &item, uint32_t &errorCode)
+{
+    unique_ptr<ImageSource> source;
+    switch (item.sourceType) {
+        case BatchSourceType::PATH:
+            source = ImageSource::CreateImageSource(item.pathName, item.sourceOptions, errorCode);
+            break;
+        case BatchSourceType::FD:
+            source = ImageSource::CreateImageSource(item.fd, item.sourceOptions, errorCode);
+            break;
+        case BatchSourceType::BUFFER:
+            source = ImageSource::CreateImageSource(item.data, item.size, item.sourceOptions, errorCode);
+            break;
+        default:
+            errorCode = ERR_IMAGE_INVALID_PARAMETER;
+            return nullptr;
+    }
+    if (errorCode != SUCCESS) {
+        return nullptr;
+    }
+    if (source == nullptr) {
+        errorCode = ERR_IMAGE_SOURCE_DATA;
+    }
+    return source;
+}
+
+uint64_t BatchDecoder::EstimatePixelBytes(ImageSource &source, const BatchDecodeItem &item)
+{
+    if (opts_.maxInflightBytes == 0) {
+        return 0;
+    }
+    ImageInfo info;
+    if (source.GetImageInfo(item.index, info) != SUCCESS) {
+        // the decode reports the error, it takes no budget.
+        return 0;
+    }
+    const DecodeOptions &opts = item.decodeOptions;
+    int32_t width = (opts.desiredSize.width > 0) ? opts.desiredSize.width : info.size.width;
+    int32_t height = (opts.desiredSize.height > 0) ? opts.desiredSize.height : info.size.height;
+    int32_t bytesPerPixel = (opts.desiredPixelFormat != PixelFormat::UNKNOWN) ?
+        ImageUtils::GetPixelBytes(opts.desiredPixelFormat) : DEFAULT_BYTES_PER_PIXEL;
+    if (width <= 0 || height <= 0 || bytesPerPixel <= 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(bytesPerPixel);
+}
+
+void BatchDecoder::AcquireBytes(uint64_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    unique_lock<mutex> guard(stateMutex_);
+    bytesCond_.wait(guard, [this, bytes] {
+        return inflightBytes_ == 0 || inflightBytes_ + bytes <= opts_.maxInflightBytes;
+    });
+    inflightBytes_ += bytes;
+}
+
+void BatchDecoder::ReleaseBytes(uint64_t bytes)
+{
+    if (bytes == 0) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(stateMutex_);
+        inflightBytes_ -= bytes;
+    }
+    bytesCond_.notify_all();
+}
+} // namespace Media
+} // namespace OHOS
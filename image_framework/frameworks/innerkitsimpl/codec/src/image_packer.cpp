@@ -15,9 +15,11 @@
 
 #include "image_packer.h"
 
+#include <map>
 #include "buffer_packer_stream.h"
 #include "file_packer_stream.h"
 #include "image/abs_image_encoder.h"
+#include "image_metrics.h"
 #include "image_utils.h"
 #include "log_tags.h"
 #include "media_errors.h"
@@ -34,6 +36,44 @@ using namespace ImagePlugin;
 using namespace MultimediaPlugin;
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImagePacker" };
 static constexpr uint8_t QUALITY_MAX = 100;
+static constexpr uint32_t RESTART_INTERVAL_MAX = 65535;
+static constexpr int32_t COMPRESSION_LEVEL_MIN = -1;
+static constexpr int32_t COMPRESSION_LEVEL_MAX = 9;
+
+static const std::map<ChromaSubsampling, PlChromaSubsampling> SUBSAMPLING_MAP = {
+    { ChromaSubsampling::DEFAULT, PlChromaSubsampling::DEFAULT },
+    { ChromaSubsampling::YUV444, PlChromaSubsampling::YUV444 },
+    { ChromaSubsampling::YUV422, PlChromaSubsampling::YUV422 },
+    { ChromaSubsampling::YUV420, PlChromaSubsampling::YUV420 },
+};
+
+static const std::map<DctMethod, PlDctMethod> DCT_METHOD_MAP = {
+    { DctMethod::DEFAULT, PlDctMethod::DEFAULT },
+    { DctMethod::ISLOW, PlDctMethod::ISLOW },
+    { DctMethod::IFAST, PlDctMethod::IFAST },
+    { DctMethod::FLOAT, PlDctMethod::FLOAT },
+};
+
+static const std::map<PngFilter, PlPngFilter> PNG_FILTER_MAP = {
+    { PngFilter::DEFAULT, PlPngFilter::DEFAULT },
+    { PngFilter::NONE, PlPngFilter::NONE },
+    { PngFilter::SUB, PlPngFilter::SUB },
+    { PngFilter::UP, PlPngFilter::UP },
+    { PngFilter::ADAPTIVE, PlPngFilter::ADAPTIVE },
+};
+
+static const std::map<CompressionStrategy, PlCompressionStrategy> STRATEGY_MAP = {
+    { CompressionStrategy::DEFAULT, PlCompressionStrategy::DEFAULT },
+    { CompressionStrategy::FILTERED, PlCompressionStrategy::FILTERED },
+    { CompressionStrategy::HUFFMAN_ONLY, PlCompressionStrategy::HUFFMAN_ONLY },
+    { CompressionStrategy::RLE, PlCompressionStrategy::RLE },
+    { CompressionStrategy::FIXED, PlCompressionStrategy::FIXED },
+};
+
+static const std::map<EncodePreset, PlEncodePreset> PRESET_MAP = {
+    { EncodePreset::DEFAULT, PlEncodePreset::DEFAULT },
+    { EncodePreset::FAST, PlEncodePreset::FAST },
+};
 
 PluginServer &ImagePacker::pluginServer_ = ImageUtils::GetPluginServer();
 
@@ -220,6 +260,7 @@ uint32_t ImagePacker::FinalizePacking()
         HiLog::Error(LABEL, "FinalizePacking get encoder plugin failed.");
         return ERR_IMAGE_MISMATCHED_FORMAT;
     }
+    ImageMetricsSpan span(SPAN_ENCODE);
     return encoder_->FinalizeEncode();
 }
 
@@ -250,6 +291,23 @@ void ImagePacker::CopyOptionsToPlugin(const PackOption &opts, PlEncodeOptions &p
 {
     plOpts.numberHint = opts.numberHint;
     plOpts.quality = opts.quality;
+    plOpts.threadCount = opts.threadCount;
+    auto subsamplingSearch = SUBSAMPLING_MAP.find(opts.subsampling);
+    plOpts.subsampling = (subsamplingSearch != SUBSAMPLING_MAP.end()) ? subsamplingSearch->second :
+        PlChromaSubsampling::DEFAULT;
+    plOpts.optimizeCoding = opts.optimizeCoding;
+    plOpts.progressive = opts.progressive;
+    auto dctSearch = DCT_METHOD_MAP.find(opts.dctMethod);
+    plOpts.dctMethod = (dctSearch != DCT_METHOD_MAP.end()) ? dctSearch->second : PlDctMethod::DEFAULT;
+    plOpts.restartInterval = opts.restartInterval;
+    plOpts.compressionLevel = opts.compressionLevel;
+    auto filterSearch = PNG_FILTER_MAP.find(opts.pngFilter);
+    plOpts.pngFilter = (filterSearch != PNG_FILTER_MAP.end()) ? filterSearch->second : PlPngFilter::DEFAULT;
+    auto strategySearch = STRATEGY_MAP.find(opts.compressionStrategy);
+    plOpts.compressionStrategy = (strategySearch != STRATEGY_MAP.end()) ? strategySearch->second :
+        PlCompressionStrategy::DEFAULT;
+    auto presetSearch = PRESET_MAP.find(opts.preset);
+    plOpts.preset = (presetSearch != PRESET_MAP.end()) ? presetSearch->second : PlEncodePreset::DEFAULT;
 }
 
 void ImagePacker::FreeOldPackerStream()
@@ -261,7 +319,8 @@ void ImagePacker::FreeOldPackerStream()
 
 bool ImagePacker::IsPackOptionValid(const PackOption &option)
 {
-    return !(option.quality > QUALITY_MAX || option.format.empty());
+    return !(option.quality > QUALITY_MAX || option.format.empty() || option.restartInterval > RESTART_INTERVAL_MAX ||
+        option.compressionLevel < COMPRESSION_LEVEL_MIN || option.compressionLevel > COMPRESSION_LEVEL_MAX);
 }
 
 // class reference need explicit constructor and destructor, otherwise unique_ptr<T> use unnormal
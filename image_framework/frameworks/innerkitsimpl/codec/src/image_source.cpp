@@ -26,6 +26,7 @@
 #include "image/abs_image_format_agent.h"
 #include "image/image_plugin_type.h"
 #include "image_log.h"
+#include "image_metrics.h"
 #include "image_utils.h"
 #include "incremental_source_stream.h"
 #include "istream_source_stream.h"
@@ -34,6 +35,7 @@
 #include "plugin_server.h"
 #include "post_proc.h"
 #include "source_stream.h"
+#include "yuv420sp_converter.h"
 #if defined(_ANDROID) || defined(_IOS)
 #include "include/jpeg_decoder.h"
 #endif
@@ -78,6 +80,8 @@ static const map<ColorSpace, PlColorSpace> COLOR_SPACE_MAP = {
 
 namespace InnerFormat {
     const string RAW_FORMAT = "image/x-raw";
+    const string JPEG_FORMAT = "image/jpeg";
+    const string PNG_FORMAT = "image/png";
     const string EXTENDED_FORMAT = "image/x-skia";
     const string RAW_EXTENDED_FORMATS[] = {
         "image/x-sony-arw",
@@ -97,10 +101,24 @@ static const std::string IMAGE_URL_PREFIX = "data:image/";
 static const std::string BASE64_URL_PREFIX = ";base64,";
 static const int INT_2 = 2;
 static const int INT_8 = 8;
-static const uint8_t NUM_0 = 0;
-static const uint8_t NUM_1 = 1;
-static const uint8_t NUM_2 = 2;
-static const uint8_t NUM_3 = 3;
+
+// the plugins sampling down by themselves give ceil(size / sampleSize), but the jpeg plugin only reaches
+// the M/8 IDCT scales and leaves the rest of the way to this size.
+static bool GetSampledSize(const DecodeOptions &opts, const string &encodedFormat, const Size &srcSize,
+                           Size &sampledSize)
+{
+    if (opts.sampleSize <= DecodeOptions::DEFAULT_SAMPLE_SIZE || opts.desiredSize.width > 0 ||
+        opts.desiredSize.height > 0 || opts.CropRect.width != 0 || opts.CropRect.height != 0) {
+        return false;
+    }
+    if (encodedFormat != InnerFormat::JPEG_FORMAT && encodedFormat != InnerFormat::PNG_FORMAT) {
+        return false;
+    }
+    int32_t sampleSize = static_cast<int32_t>(opts.sampleSize);
+    sampledSize.width = (srcSize.width + sampleSize - 1) / sampleSize;
+    sampledSize.height = (srcSize.height + sampleSize - 1) / sampleSize;
+    return sampledSize.width > 0 && sampledSize.height > 0;
+}
 
 PluginServer &ImageSource::pluginServer_ = ImageUtils::GetPluginServer();
 ImageSource::FormatAgentMap ImageSource::formatAgentMap_ = InitClass();
@@ -304,7 +322,7 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMapEx(uint32_t index, const DecodeO
         sourceOptions_.pixelFormat, sourceOptions_.size.width, sourceOptions_.size.height);
 
     if (IsSpecialYUV()) {
-        return CreatePixelMapForYUV(errorCode);
+        return CreatePixelMapForYUV(opts, errorCode);
     }
 
     return CreatePixelMap(index, opts, errorCode);
@@ -340,6 +358,7 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         return nullptr;
     }
 
+    Size srcSize = iter->second.imageInfo.size;
     ImagePlugin::PlImageInfo plInfo;
     errorCode = SetDecodeOptions(mainDecoder_, index, opts_, plInfo);
     if (errorCode != SUCCESS) {
@@ -353,6 +372,9 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         guard.lock();
     }
 
+    if (plInfo.cropApplied) {
+        opts_.CropRect = {};
+    }
     Size size = {
         .width = plInfo.size.width,
         .height = plInfo.size.height
@@ -379,7 +401,10 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         }
     }
 
-    errorCode = mainDecoder_->Decode(index, context);
+    {
+        ImageMetricsSpan span(SPAN_PIXEL_DECODE);
+        errorCode = mainDecoder_->Decode(index, context);
+    }
     if (context.ifPartialOutput) {
         for (auto partialListener : decodeListeners_) {
             guard.unlock();
@@ -405,6 +430,7 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
         }
         return nullptr;
     }
+    ImageMetrics::AddAllocation(context.pixelsBuffer.bufferSize);
 
 #ifdef IMAGE_COLORSPACE_FLAG
     // add graphic colorspace object to pixelMap.
@@ -417,6 +443,16 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMap(uint32_t index, const DecodeOpt
 
     pixelMap->SetPixelsAddr(context.pixelsBuffer.buffer, context.pixelsBuffer.context, context.pixelsBuffer.bufferSize,
                             context.allocatorType, context.freeFunc);
+    Size sampledSize;
+    if (GetSampledSize(opts_, sourceInfo_.encodedFormat, srcSize, sampledSize) &&
+        (pixelMap->GetWidth() != sampledSize.width || pixelMap->GetHeight() != sampledSize.height)) {
+        PostProc sampleProc;
+        if (!sampleProc.ScalePixelMap(sampledSize, *(pixelMap.get()))) {
+            IMAGE_LOGE("[ImageSource]scale to the sampled size fail.");
+            errorCode = ERR_IMAGE_TRANSFORM;
+            return nullptr;
+        }
+    }
     DecodeOptions procOpts;
     CopyOptionsToProcOpts(opts_, procOpts, *(pixelMap.get()));
     PostProc postProc;
@@ -488,6 +524,10 @@ uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts,
                 guard.lock();
             }
         }
+        incrementalRecordIter->second.cropApplied = plInfo.cropApplied;
+        if (plInfo.cropApplied) {
+            opts_.CropRect = {};
+        }
         Size size = {
             .width = plInfo.size.width,
             .height = plInfo.size.height
@@ -501,6 +541,9 @@ uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts,
         incrementalRecordIter->second.IncrementalState = ImageDecodingState::IMAGE_DECODING;
     }
     if (incrementalRecordIter->second.IncrementalState == ImageDecodingState::IMAGE_DECODING) {
+        if (incrementalRecordIter->second.cropApplied) {
+            opts_.CropRect = {};
+        }
         ret = DoIncrementalDecoding(index, opts_, pixelMap, incrementalRecordIter->second);
         decodeProgress = incrementalRecordIter->second.decodingProgress;
         state = incrementalRecordIter->second.IncrementalState;
@@ -533,6 +576,85 @@ uint32_t ImageSource::PromoteDecoding(uint32_t index, const DecodeOptions &opts,
     return SUCCESS;
 }
 
+unique_ptr<AnimationDecoder> ImageSource::CreateAnimationDecoder(const DecodeOptions &opts, uint32_t &errorCode)
+{
+    std::lock_guard<std::mutex> guard(decodingMutex_);
+    opts_ = opts;
+    auto iter = GetValidImageStatus(0, errorCode);
+    if (iter == imageStatusMap_.end()) {
+        IMAGE_LOGE("[ImageSource]get valid image status fail on create animation decoder, ret:%{public}u.", errorCode);
+        return nullptr;
+    }
+    std::unique_ptr<AbsImageDecoder> decoder;
+    if (mainDecoder_ != nullptr) {
+        // borrowed decoder from the mainDecoder_.
+        decoder = std::move(mainDecoder_);
+    } else {
+        decoder = std::unique_ptr<AbsImageDecoder>(CreateDecoder(errorCode));
+    }
+    if (decoder == nullptr) {
+        IMAGE_LOGE("[ImageSource]failed to create decoder on create animation decoder, ret:%{public}u.", errorCode);
+        errorCode = ERR_IMAGE_PLUGIN_CREATE_FAILED;
+        return nullptr;
+    }
+    ImagePlugin::PlImageInfo plInfo;
+    errorCode = SetDecodeOptions(decoder, 0, opts_, plInfo);
+    if (errorCode == SUCCESS && plInfo.pixelFormat != PlPixelFormat::RGBA_8888 &&
+        plInfo.pixelFormat != PlPixelFormat::BGRA_8888) {
+        IMAGE_LOGE("[ImageSource]animation decoder unsupported pixel format %{public}d.", plInfo.pixelFormat);
+        errorCode = ERR_IMAGE_DATA_UNSUPPORT;
+    }
+    if (errorCode != SUCCESS) {
+        if (mainDecoder_ == nullptr) {
+            mainDecoder_ = std::move(decoder);
+        }
+        return nullptr;
+    }
+    ImageInfo info;
+    info.size.width = static_cast<int32_t>(plInfo.size.width);
+    info.size.height = static_cast<int32_t>(plInfo.size.height);
+    info.pixelFormat = (plInfo.pixelFormat == PlPixelFormat::BGRA_8888) ? PixelFormat::BGRA_8888 :
+        PixelFormat::RGBA_8888;
+    info.alphaType = static_cast<AlphaType>(plInfo.alphaType);
+    AnimationDecoder *animationDecoder = new (std::nothrow) AnimationDecoder(this, info);
+    if (animationDecoder == nullptr) {
+        IMAGE_LOGE("[ImageSource]create the animation decoder fail.");
+        if (mainDecoder_ == nullptr) {
+            mainDecoder_ = std::move(decoder);
+        }
+        errorCode = ERR_IMAGE_MALLOC_ABNORMAL;
+        return nullptr;
+    }
+    animDecodingMap_.insert(AnimationRecordMap::value_type(animationDecoder, std::move(decoder)));
+    return unique_ptr<AnimationDecoder>(animationDecoder);
+}
+
+uint32_t ImageSource::DecodeAnimationFrame(AnimationDecoder &animationDecoder, uint32_t index,
+                                           ImagePlugin::AnimationFrameContext &context)
+{
+    std::lock_guard<std::mutex> guard(decodingMutex_);
+    auto iter = animDecodingMap_.find(&animationDecoder);
+    if (iter == animDecodingMap_.end() || iter->second == nullptr) {
+        IMAGE_LOGE("[ImageSource]animation decoder is detached.");
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    return iter->second->DecodeAnimationFrame(index, context);
+}
+
+void ImageSource::DetachAnimationDecoding(AnimationDecoder &animationDecoder)
+{
+    std::lock_guard<std::mutex> guard(decodingMutex_);
+    auto iter = animDecodingMap_.find(&animationDecoder);
+    if (iter == animDecodingMap_.end()) {
+        return;
+    }
+    if (mainDecoder_ == nullptr) {
+        // return back the decoder to mainDecoder_.
+        mainDecoder_ = std::move(iter->second);
+    }
+    animDecodingMap_.erase(iter);
+}
+
 void ImageSource::DetachIncrementalDecoding(PixelMap &pixelMap)
 {
     std::lock_guard<std::mutex> guard(decodingMutex_);
@@ -648,6 +770,60 @@ uint32_t ImageSource::ModifyImageProperty(uint32_t index, const std::string &key
     return SUCCESS;
 }
 
+uint32_t ImageSource::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    const std::string &path)
+{
+    std::unique_lock<std::mutex> guard(decodingMutex_);
+    uint32_t ret;
+    auto iter = GetValidImageStatus(0, ret);
+    if (iter == imageStatusMap_.end()) {
+        IMAGE_LOGE("[ImageSource]get valid image status fail on modify image properties, ret:%{public}u.", ret);
+        return ret;
+    }
+    ret = mainDecoder_->ModifyImageProperties(index, properties, path);
+    if (ret != SUCCESS) {
+        IMAGE_LOGE("[ImageSource] ModifyImageProperties fail, ret:%{public}u", ret);
+        return ret;
+    }
+    return SUCCESS;
+}
+
+uint32_t ImageSource::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    const int fd)
+{
+    std::unique_lock<std::mutex> guard(decodingMutex_);
+    uint32_t ret;
+    auto iter = GetValidImageStatus(0, ret);
+    if (iter == imageStatusMap_.end()) {
+        IMAGE_LOGE("[ImageSource]get valid image status fail on modify image properties, ret:%{public}u.", ret);
+        return ret;
+    }
+    ret = mainDecoder_->ModifyImageProperties(index, properties, fd);
+    if (ret != SUCCESS) {
+        IMAGE_LOGE("[ImageSource] ModifyImageProperties fail, ret:%{public}u", ret);
+        return ret;
+    }
+    return SUCCESS;
+}
+
+uint32_t ImageSource::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    uint8_t *data, uint32_t size)
+{
+    std::unique_lock<std::mutex> guard(decodingMutex_);
+    uint32_t ret;
+    auto iter = GetValidImageStatus(0, ret);
+    if (iter == imageStatusMap_.end()) {
+        IMAGE_LOGE("[ImageSource]get valid image status fail on modify image properties, ret:%{public}u.", ret);
+        return ret;
+    }
+    ret = mainDecoder_->ModifyImageProperties(index, properties, data, size);
+    if (ret != SUCCESS) {
+        IMAGE_LOGE("[ImageSource] ModifyImageProperties fail, ret:%{public}u", ret);
+        return ret;
+    }
+    return SUCCESS;
+}
+
 uint32_t ImageSource::GetImagePropertyInt(uint32_t index, const std::string &key, int32_t &value)
 {
     std::unique_lock<std::mutex> guard(decodingMutex_);
@@ -844,6 +1020,7 @@ uint32_t ImageSource::CheckFormatHint(const string &formatHint, FormatAgentMap::
 
 uint32_t ImageSource::GetEncodedFormat(const string &formatHint, string &format)
 {
+    ImageMetricsSpan span(SPAN_FORMAT_DETECT);
     bool streamIncomplete = false;
     auto hintIter = formatAgentMap_.end();
     if (!formatHint.empty()) {
@@ -1017,6 +1194,7 @@ uint32_t ImageSource::DecodeImageInfo(uint32_t index, ImageStatusMap::iterator &
         IMAGE_LOGE("[ImageSource]get image size, image decode plugin is null.");
         return ERR_IMAGE_PLUGIN_CREATE_FAILED;
     }
+    ImageMetricsSpan span(SPAN_HEADER_DECODE);
     ImagePlugin::PlSize size;
     ret = mainDecoder_->GetImageSize(index, size);
     if (ret == SUCCESS) {
@@ -1055,7 +1233,9 @@ AbsImageDecoder *ImageSource::CreateDecoder(uint32_t &errorCode)
     // in normal mode, we can get actual encoded format to the user
     // but we need transfer to skia codec for adaption, "image/x-skia"
     std::string encodedFormat = sourceInfo_.encodedFormat;
-    if (opts_.sampleSize != 1) {
+    // the jpeg plugin samples down in the DCT domain and the png plugin while the rows are read.
+    if (opts_.sampleSize != 1 && encodedFormat != InnerFormat::JPEG_FORMAT &&
+        encodedFormat != InnerFormat::PNG_FORMAT) {
         encodedFormat = InnerFormat::EXTENDED_FORMAT;
     }
 #if defined(_ANDROID) || defined(_IOS)
@@ -1134,6 +1314,10 @@ void ImageSource::CopyOptionsToPlugin(const DecodeOptions &opts, PixelDecodeOpti
     plOpts.desiredColorSpace = (colorSearch != COLOR_SPACE_MAP.end()) ? colorSearch->second : PlColorSpace::UNKNOWN;
     plOpts.allowPartialImage = opts.allowPartialImage;
     plOpts.editable = opts.editable;
+    plOpts.threadCount = opts.threadCount;
+    plOpts.convertColorSpace = opts.convertColorSpace;
+    plOpts.keyframeInterval = opts.keyframeInterval;
+    plOpts.keyframeCacheSize = opts.keyframeCacheSize;
 }
 
 void ImageSource::CopyOptionsToProcOpts(const DecodeOptions &opts, DecodeOptions &procOpts, PixelMap &pixelMap)
@@ -1164,6 +1348,7 @@ ImageSource::ImageStatusMap::iterator ImageSource::GetValidImageStatus(uint32_t
 {
     auto iter = imageStatusMap_.find(index);
     if (iter == imageStatusMap_.end()) {
+        ImageMetrics::AddCounter(MetricsCounter::CACHE_MISSES, 1);
         errorCode = DecodeImageInfo(index, iter);
         if (errorCode != SUCCESS) {
             IMAGE_LOGE("[ImageSource]image info decode fail, ret:%{public}u.", errorCode);
@@ -1173,6 +1358,8 @@ ImageSource::ImageStatusMap::iterator ImageSource::GetValidImageStatus(uint32_t
         IMAGE_LOGE("[ImageSource]invalid imageState %{public}d on get image status.", iter->second.imageState);
         errorCode = ERR_IMAGE_DECODE_FAILED;
         return imageStatusMap_.end();
+    } else {
+        ImageMetrics::AddCounter(MetricsCounter::CACHE_HITS, 1);
     }
     errorCode = SUCCESS;
     return iter;
@@ -1397,18 +1584,7 @@ bool ImageSource::IsSpecialYUV()
     return (isBufferSource && isSizeValid && isYUV);
 }
 
-static inline uint8_t FloatToUint8(float f)
-{
-    int data = static_cast<int>(f + 0.5f);
-    if (data < 0) {
-        data = 0;
-    } else if (data > UINT8_MAX) {
-        data = UINT8_MAX;
-    }
-    return static_cast<uint8_t>(data);
-}
-
-bool ImageSource::ConvertYUV420ToRGBA(uint8_t *data, uint32_t size,
+bool ImageSource::ConvertYUV420ToRGBA(uint8_t *data, uint32_t size, PixelFormat dstFormat,
     bool isSupportOdd, bool isAddUV, uint32_t &errorCode)
 {
     IMAGE_LOGD("[ImageSource]ConvertYUV420ToRGBA IN srcPixelFormat:%{public}d, srcSize:(%{public}d, %{public}d)",
@@ -1419,46 +1595,25 @@ bool ImageSource::ConvertYUV420ToRGBA(uint8_t *data, uint32_t size,
         return false;
     }
 
-    const size_t width = sourceOptions_.size.width;
-    const size_t height = sourceOptions_.size.height;
-    const size_t uvwidth = (isSupportOdd && isAddUV) ? (width + (width & 1)) : width;
-    const uint8_t *yuvPlane = sourceStreamPtr_->GetDataPtr();
-    const size_t yuvSize = sourceStreamPtr_->GetStreamSize();
-    const size_t ubase = width * height + ((sourceOptions_.pixelFormat == PixelFormat::NV21) ? 0 : 1);
-    const size_t vbase = width * height + ((sourceOptions_.pixelFormat == PixelFormat::NV21) ? 1 : 0);
-    IMAGE_LOGD("[ImageSource]ConvertYUV420ToRGBA uvbase:(%{public}zu, %{public}zu), width:(%{public}zu, %{public}zu)",
-        ubase, vbase, width, uvwidth);
-
-    for (size_t h = 0; h < height; h++) {
-        const size_t yline = h * width;
-        const size_t uvline = (h >> 1) * uvwidth;
-
-        for (size_t w = 0; w < width; w++) {
-            const size_t ypos = yline + w;
-            const size_t upos = ubase + uvline + (w & (~1));
-            const size_t vpos = vbase + uvline + (w & (~1));
-            const uint8_t y = (ypos < yuvSize) ? yuvPlane[ypos] : 0;
-            const uint8_t u = (upos < yuvSize) ? yuvPlane[upos] : 0;
-            const uint8_t v = (vpos < yuvSize) ? yuvPlane[vpos] : 0;
-            // jpeg
-            const uint8_t r = FloatToUint8((1.0f * y) + (1.402f * v) - (0.703749f * UINT8_MAX));
-            const uint8_t g = FloatToUint8((1.0f * y) - (0.344136f * u) - (0.714136f * v) + (0.531211f * UINT8_MAX));
-            const uint8_t b = FloatToUint8((1.0f * y) + (1.772f * u) - (0.889475f * UINT8_MAX));
-
-            const size_t rgbpos = ypos << 2;
-            if ((rgbpos + NUM_3) < size) {
-                data[rgbpos + NUM_0] = r;
-                data[rgbpos + NUM_1] = g;
-                data[rgbpos + NUM_2] = b;
-                data[rgbpos + NUM_3] = UINT8_MAX;
-            }
-        }
+    const uint32_t width = static_cast<uint32_t>(sourceOptions_.size.width);
+    Yuv420spInfo yuvInfo;
+    yuvInfo.data = sourceStreamPtr_->GetDataPtr();
+    yuvInfo.dataSize = sourceStreamPtr_->GetStreamSize();
+    yuvInfo.size = sourceOptions_.size;
+    yuvInfo.format = sourceOptions_.pixelFormat;
+    yuvInfo.matrix = sourceOptions_.yuvColorMatrix;
+    yuvInfo.uvStride = (isSupportOdd && isAddUV) ? (width + (width & 1)) : width;
+    IMAGE_LOGD("[ImageSource]ConvertYUV420ToRGBA uvStride:%{public}u, dstFormat:%{public}d",
+        yuvInfo.uvStride, dstFormat);
+    if (!Yuv420spConverter::Convert(yuvInfo, dstFormat, data, size)) {
+        errorCode = ERR_IMAGE_SOURCE_DATA;
+        return false;
     }
     IMAGE_LOGD("[ImageSource]ConvertYUV420ToRGBA OUT");
     return true;
 }
 
-unique_ptr<PixelMap> ImageSource::CreatePixelMapForYUV(uint32_t &errorCode)
+unique_ptr<PixelMap> ImageSource::CreatePixelMapForYUV(const DecodeOptions &opts, uint32_t &errorCode)
 {
     IMAGE_LOGD("[ImageSource]CreatePixelMapForYUV IN srcPixelFormat:%{public}d, srcSize:(%{public}d, %{public}d)",
         sourceOptions_.pixelFormat, sourceOptions_.size.width, sourceOptions_.size.height);
@@ -1475,6 +1630,12 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMapForYUV(uint32_t &errorCode)
     info.size.width = sourceOptions_.size.width;
     info.size.height = sourceOptions_.size.height;
     info.pixelFormat = PixelFormat::RGBA_8888;
+    if (Yuv420spConverter::IsSupportedDstFormat(opts.desiredPixelFormat)) {
+        info.pixelFormat = opts.desiredPixelFormat;
+    } else if (opts.desiredPixelFormat != PixelFormat::UNKNOWN) {
+        IMAGE_LOGD("[ImageSource]yuv to pixel format %{public}d not supported, use RGBA_8888.",
+            opts.desiredPixelFormat);
+    }
     info.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
     errorCode = pixelMap->SetImageInfo(info);
     if (errorCode != SUCCESS) {
@@ -1489,11 +1650,13 @@ unique_ptr<PixelMap> ImageSource::CreatePixelMapForYUV(uint32_t &errorCode)
         errorCode = ERR_IMAGE_MALLOC_ABNORMAL;
         return nullptr;
     }
+    ImageMetrics::AddAllocation(bufferSize);
 
     pixelMap->SetEditable(false);
     pixelMap->SetPixelsAddr(buffer, nullptr, bufferSize, AllocatorType::HEAP_ALLOC, nullptr);
 
-    if (!ConvertYUV420ToRGBA(static_cast<uint8_t *>(buffer), bufferSize, false, false, errorCode)) {
+    ImageMetricsSpan span(SPAN_CONVERT);
+    if (!ConvertYUV420ToRGBA(static_cast<uint8_t *>(buffer), bufferSize, info.pixelFormat, false, false, errorCode)) {
         HiLog::Error(LABEL, "convert yuv420 to rgba issue");
         errorCode = ERROR;
         return nullptr;
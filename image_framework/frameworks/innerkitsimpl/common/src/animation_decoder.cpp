@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "animation_decoder.h"
+#include <algorithm>
+#include "abs_image_decoder.h"
+#include "hilog/log.h"
+#include "image_source.h"
+#include "log_tags.h"
+#include "media_errors.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace Media {
+using namespace OHOS::HiviewDFX;
+
+static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "AnimationDecoder" };
+static constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+static bool IsEmptyRect(const Rect &rect)
+{
+    return rect.width <= 0 || rect.height <= 0;
+}
+
+static Rect UnionRect(const Rect &a, const Rect &b)
+{
+    if (IsEmptyRect(a)) {
+        return b;
+    }
+    if (IsEmptyRect(b)) {
+        return a;
+    }
+    Rect rect;
+    rect.left = std::min(a.left, b.left);
+    rect.top = std::min(a.top, b.top);
+    rect.width = std::max(a.left + a.width, b.left + b.width) - rect.left;
+    rect.height = std::max(a.top + a.height, b.top + b.height) - rect.top;
+    return rect;
+}
+
+AnimationDecoder::AnimationDecoder(ImageSource *imageSource, const ImageInfo &info)
+    : imageSource_(imageSource), imageInfo_(info)
+{
+    for (uint32_t i = 0; i < BUFFER_COUNT; i++) {
+        staleRects_[i] = { 0, 0, imageInfo_.size.width, imageInfo_.size.height };
+    }
+    if (imageSource_ != nullptr) {
+        imageSource_->RegisterListener(static_cast<PeerListener *>(this));
+    }
+}
+
+AnimationDecoder::~AnimationDecoder()
+{
+    if (imageSource_ == nullptr) {
+        return;
+    }
+    imageSource_->DetachAnimationDecoding(*this);
+    imageSource_->UnRegisterListener(this);
+    imageSource_ = nullptr;
+}
+
+const ImageInfo &AnimationDecoder::GetImageInfo() const
+{
+    return imageInfo_;
+}
+
+uint64_t AnimationDecoder::GetFrameByteCount() const
+{
+    return static_cast<uint64_t>(imageInfo_.size.width) * imageInfo_.size.height * BYTES_PER_PIXEL;
+}
+
+uint32_t AnimationDecoder::SetOutputBuffers(uint8_t *front, uint8_t *back, uint64_t bufferSize)
+{
+    if (front == nullptr || back == nullptr || front == back || bufferSize < GetFrameByteCount()) {
+        HiLog::Error(LABEL, "[SetOutputBuffers]invalid buffers, size %{public}llu, frame needs %{public}llu.",
+                     static_cast<unsigned long long>(bufferSize),
+                     static_cast<unsigned long long>(GetFrameByteCount()));
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    buffers_[0] = front;
+    buffers_[1] = back;
+    for (uint32_t i = 0; i < BUFFER_COUNT; i++) {
+        staleRects_[i] = { 0, 0, imageInfo_.size.width, imageInfo_.size.height };
+    }
+    bufferIndex_ = 0;
+    return SUCCESS;
+}
+
+uint32_t AnimationDecoder::DecodeNextFrame(AnimationFrame &frame)
+{
+    if (imageSource_ == nullptr) {
+        HiLog::Error(LABEL, "[DecodeNextFrame]image source is released.");
+        return ERR_IMAGE_SOURCE_DATA;
+    }
+    if (buffers_[bufferIndex_] == nullptr) {
+        HiLog::Error(LABEL, "[DecodeNextFrame]output buffers are not set.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    ImagePlugin::AnimationFrameContext context;
+    uint32_t ret = imageSource_->DecodeAnimationFrame(*this, nextIndex_, context);
+    if (ret != SUCCESS) {
+        HiLog::Error(LABEL, "[DecodeNextFrame]decode frame %{public}u failed, ret:%{public}u.", nextIndex_, ret);
+        return ret;
+    }
+    if (context.pixels == nullptr || context.frameCount == 0) {
+        HiLog::Error(LABEL, "[DecodeNextFrame]decoder returned no frame for %{public}u.", nextIndex_);
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    // the plugin clips the rect to the canvas, clip again so a bad rect can not write past the buffers.
+    Rect dirtyRect;
+    dirtyRect.left = std::min(static_cast<int32_t>(context.dirtyRect.left), imageInfo_.size.width);
+    dirtyRect.top = std::min(static_cast<int32_t>(context.dirtyRect.top), imageInfo_.size.height);
+    dirtyRect.width = std::min(static_cast<int32_t>(context.dirtyRect.width), imageInfo_.size.width - dirtyRect.left);
+    dirtyRect.height = std::min(static_cast<int32_t>(context.dirtyRect.height),
+                                imageInfo_.size.height - dirtyRect.top);
+    for (uint32_t i = 0; i < BUFFER_COUNT; i++) {
+        staleRects_[i] = UnionRect(staleRects_[i], dirtyRect);
+    }
+    uint8_t *buffer = buffers_[bufferIndex_];
+    CopyToBuffer(context.pixels, buffer, staleRects_[bufferIndex_]);
+    staleRects_[bufferIndex_] = Rect();
+
+    frame.pixels = buffer;
+    frame.index = nextIndex_;
+    frame.frameCount = context.frameCount;
+    frame.delayTime = context.delayTime;
+    frame.disposal = static_cast<DisposalType>(context.disposal);
+    frame.dirtyRect = dirtyRect;
+
+    frameCount_ = context.frameCount;
+    nextIndex_ = (nextIndex_ + 1 < frameCount_) ? nextIndex_ + 1 : 0;
+    bufferIndex_ = (bufferIndex_ + 1) % BUFFER_COUNT;
+    return SUCCESS;
+}
+
+void AnimationDecoder::Rewind()
+{
+    nextIndex_ = 0;
+}
+
+void AnimationDecoder::CopyToBuffer(const uint8_t *canvas, uint8_t *buffer, const Rect &rect)
+{
+    if (IsEmptyRect(rect)) {
+        return;
+    }
+    uint64_t rowBytes = static_cast<uint64_t>(imageInfo_.size.width) * BYTES_PER_PIXEL;
+    uint64_t offset = rect.top * rowBytes + static_cast<uint64_t>(rect.left) * BYTES_PER_PIXEL;
+    if (rect.width == imageInfo_.size.width) {
+        uint64_t copyBytes = rect.height * rowBytes;
+        if (memcpy_s(buffer + offset, copyBytes, canvas + offset, copyBytes) != EOK) {
+            HiLog::Error(LABEL, "[CopyToBuffer]copy frame rows failed.");
+        }
+        return;
+    }
+    uint64_t copyBytes = static_cast<uint64_t>(rect.width) * BYTES_PER_PIXEL;
+    for (int32_t row = 0; row < rect.height; row++) {
+        if (memcpy_s(buffer + offset, copyBytes, canvas + offset, copyBytes) != EOK) {
+            HiLog::Error(LABEL, "[CopyToBuffer]copy frame row %{public}d failed.", rect.top + row);
+            return;
+        }
+        offset += rowBytes;
+    }
+}
+
+void AnimationDecoder::OnPeerDestory()
+{
+    imageSource_ = nullptr;
+}
+} // namespace Media
+} // namespace OHOS
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <unistd.h>
 #include "hilog/log.h"
+#include "image_metrics.h"
 #include "image_utils.h"
 #include "log_tags.h"
 #include "media_errors.h"
@@ -159,7 +160,9 @@ unique_ptr<PixelMap> PixelMap::Create(const uint32_t *colors, uint32_t colorLeng
         HiLog::Error(LABEL, "allocate memory size %{public}u fail", bufferSize);
         return nullptr;
     }
+    ImageMetrics::AddAllocation(bufferSize);
 
+    ImageMetricsSpan span(SPAN_CONVERT);
     Position dstPosition;
     if (!PixelConvertAdapter::WritePixelsConvert(reinterpret_cast<const void *>(colors + offset),
         static_cast<uint32_t>(stride) << FOUR_BYTE_SHIFT, srcImageInfo,
@@ -334,6 +337,8 @@ bool PixelMap::SourceCropAndConvert(PixelMap &source, const ImageInfo &srcImageI
         HiLog::Error(LABEL, "allocate memory size %{public}u fail", bufferSize);
         return false;
     }
+    ImageMetrics::AddAllocation(bufferSize);
+    ImageMetricsSpan span(SPAN_CONVERT);
 
     if (memset_s(dstPixels, bufferSize, 0, bufferSize) != EOK) {
         HiLog::Error(LABEL, "dstPixels memset_s failed.");
@@ -405,6 +410,7 @@ bool PixelMap::CopyPixelMap(PixelMap &source, PixelMap &dstPixelMap)
         HiLog::Error(LABEL, "allocate memory size %{public}u fail", bufferSize);
         return false;
     }
+    ImageMetrics::AddAllocation(bufferSize);
     errno_t errRet = memcpy_s(dstPixels, bufferSize, source.GetPixels(), bufferSize);
     if (errRet != 0) {
         HiLog::Error(LABEL, "copy source memory size %{public}u fail, errorCode = %{public}d", bufferSize, errRet);
@@ -1204,6 +1210,9 @@ uint8_t *PixelMap::ReadImageData(Parcel &parcel, int32_t bufferSize)
         ReleaseMemory(AllocatorType::SHARE_MEM_ALLOC, ptr, &fd, bufferSize);
 #endif
     }
+    if (base != nullptr) {
+        ImageMetrics::AddAllocation(bufferSize);
+    }
     return base;
 }
 
@@ -1638,7 +1647,10 @@ void PixelMap::flip(bool xAxis, bool yAxis)
     if (xAxis == false && yAxis == false) {
         return;
     }
-    scale(xAxis?-1:1, yAxis?-1:1);
+    PostProc postProc;
+    if (!postProc.FlipPixelMap(xAxis, yAxis, *this)) {
+        HiLog::Error(LABEL, "flip fail");
+    }
 }
 uint32_t PixelMap::crop(const Rect &rect)
 {
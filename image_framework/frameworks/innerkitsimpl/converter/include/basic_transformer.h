@@ -176,6 +176,10 @@ private:
 
     bool DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t pixelBytes, const Size &size, uint8_t *data);
 
+    static bool IsSeparableScale(Matrix::OperType operType);
+
+    bool DrawPixelmapByRow(const PixmapInfo &pixmapInfo, const Size &size, const Matrix &invertMatrix, uint8_t *data);
+
     bool CheckAllocateBuffer(PixmapInfo &outPixmap, AllocateMem allocate, int &fd, uint64_t &bufferSize, Size &dstSize);
 
     void BilinearProc(const Point &pt, const PixmapInfo &pixmapInfo, const uint32_t rb, const int32_t shiftBytes,
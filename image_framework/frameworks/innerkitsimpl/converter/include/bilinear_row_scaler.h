@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_BILINEAR_ROW_SCALER_H_
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_BILINEAR_ROW_SCALER_H_
+
+#include <vector>
+#include "basic_transformer.h"
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+/*
+ * Source sample positions along one axis of a separable scale. Only destination
+ * samples that map inside the source are recorded, the others keep the cleared color.
+ */
+struct BilinearAxis {
+    std::vector<uint32_t> dst;   // destination index of the sample
+    std::vector<uint32_t> pos0;  // source index at or before the sample point
+    std::vector<uint32_t> pos1;  // source index after the sample point
+    std::vector<uint32_t> sub;   // 4 bit fraction, the same as GetSubValue
+};
+
+struct BilinearRowArgs {
+    const uint32_t *color00 = nullptr;
+    const uint32_t *color01 = nullptr;
+    const uint32_t *color10 = nullptr;
+    const uint32_t *color11 = nullptr;
+    const uint32_t *subx = nullptr;
+    uint32_t suby = 0;
+    uint32_t *out = nullptr;
+    uint32_t count = 0;
+};
+
+class BilinearRowScaler {
+public:
+    using FilterRowProc = void (*)(const BilinearRowArgs &args);
+
+    static bool IsSupported(PixelFormat format);
+
+    /**
+     * Record the sample of destination index dst, srcPos is the source coordinate
+     * produced by the inverse matrix and must already be inside [0, srcLength).
+     */
+    static void AppendSample(BilinearAxis &axis, uint32_t dst, float srcPos, int32_t srcLength);
+
+    /**
+     * Scale the source pixmap into data row by row, data must be cleared before.
+     * @return false if the pixel format is not supported.
+     */
+    static bool ScaleRows(const PixmapInfo &pixmapInfo, const BilinearAxis &xAxis, const BilinearAxis &yAxis,
+                          const Size &dstSize, uint8_t *data);
+
+    /*
+     * Calculate the target pixel based on the pixels of 4 nearby points with 16.16 fixed point weights.
+     * f(i+u,j+v) = (1-u)(1-v)f(i,j) + (1-u)vf(i,j+1) + u(1-v)f(i+1,j) + uvf(i+1,j+1)
+     */
+    static uint32_t FilterPixel(uint32_t subx, uint32_t suby, uint32_t color00, uint32_t color01,
+                                uint32_t color10, uint32_t color11);
+
+    // The row filter selected for the running cpu, the result is the same as FilterPixel.
+    static FilterRowProc GetFilterRowProc();
+    static FilterRowProc GetScalarFilterRowProc();
+    static const char *GetFilterRowName();
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_BILINEAR_ROW_SCALER_H_
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_ORTHOGONAL_TRANSFORMER_H_
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_ORTHOGONAL_TRANSFORMER_H_
+
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+// Transforms which only move pixels, positive rotate is clockwise as BasicTransformer.
+enum class OrthogonalOp : int32_t {
+    NONE = 0,
+    FLIP_X = 1,      // mirror left and right
+    FLIP_Y = 2,      // mirror top and bottom
+    ROTATE_90 = 3,
+    ROTATE_180 = 4,
+    ROTATE_270 = 5,
+};
+
+class OrthogonalTransformer {
+public:
+    // Return false if degrees is not a multiple of 90.
+    static bool GetRotateOp(float degrees, OrthogonalOp &op);
+    static OrthogonalOp GetFlipOp(bool xAxis, bool yAxis);
+    static bool IsSupported(PixelFormat format);
+    static Size GetDstSize(OrthogonalOp op, const Size &srcSize);
+    static bool CanTransformInPlace(OrthogonalOp op, const Size &srcSize);
+
+    /**
+     * Move the pixels of src into dst, both buffers are tightly packed.
+     * @param src The source pixels.
+     * @param dst The destination pixels, it may be the same as src if CanTransformInPlace returns true,
+     * otherwise it must not overlap src and has the size of GetDstSize.
+     * @return true if success.
+     */
+    static bool Transform(OrthogonalOp op, const uint8_t *src, uint8_t *dst, const Size &srcSize,
+                          int32_t pixelBytes);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_ORTHOGONAL_TRANSFORMER_H_
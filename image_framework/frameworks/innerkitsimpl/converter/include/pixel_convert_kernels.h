@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_KERNELS_H_
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_KERNELS_H_
+
+#include "pixel_convert.h"
+
+namespace OHOS {
+namespace Media {
+/*
+ * Vector bodies of the PixelConvert row procs that only move, pack or premultiply 8 bit channels:
+ * ARGB_8888, RGBA_8888 and BGRA_8888 to each other and to RGB_565, RGB_888 and BGR_888 to the
+ * 32 bit formats. The result is the same as the scalar row procs.
+ */
+class PixelConvertKernels {
+public:
+    /**
+     * Convert the leading pixels of a row.
+     * @return the number of pixels done, a multiple of the vector width. The caller finishes
+     * the rest of the row with the scalar proc.
+     */
+    using RowKernel = uint32_t (*)(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth);
+
+    // nullptr if the running cpu or the combination has no vector kernel.
+    static RowKernel GetRowKernel(uint32_t srcFormat, uint32_t dstFormat, AlphaConvertType alphaType);
+    static const char *GetKernelName();
+
+    // Unpremul255 of 8 bit values by a table of 16 bit fixed point reciprocals, used by the kernels.
+    static uint32_t UnpremulByTable(uint32_t colorComponent, uint32_t alpha);
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_PIXEL_CONVERT_KERNELS_H_
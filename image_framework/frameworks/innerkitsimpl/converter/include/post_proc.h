@@ -19,6 +19,7 @@
 #include <vector>
 #include "basic_transformer.h"
 #include "image_type.h"
+#include "orthogonal_transformer.h"
 #include "pixel_map.h"
 #include "scan_line_filter.h"
 
@@ -34,6 +35,7 @@ public:
     static bool IsHasCrop(const Rect &rect);
     bool HasPixelConvert(const ImageInfo &srcImageInfo, ImageInfo &dstImageInfo);
     bool RotatePixelMap(float rotateDegrees, PixelMap &pixelMap);
+    bool FlipPixelMap(bool xAxis, bool yAxis, PixelMap &pixelMap);
     bool ScalePixelMap(const Size &size, PixelMap &pixelMap);
     bool ScalePixelMap(float scaleX, float scaleY, PixelMap &pixelMap);
     bool TranslatePixelMap(float tX, float tY, PixelMap &pixelMap);
@@ -51,6 +53,7 @@ private:
     bool AllocHeapBuffer(uint64_t bufferSize, uint8_t **buffer);
     void ReleaseBuffer(AllocatorType allocatorType, int fd, uint64_t dataSize, uint8_t **buffer);
     bool Transform(BasicTransformer &trans, const PixmapInfo &input, PixelMap &pixelMap);
+    bool OrthogonalTransform(OrthogonalOp op, PixelMap &pixelMap);
     void ConvertPixelMapToPixmapInfo(PixelMap &pixelMap, PixmapInfo &pixmapInfo);
     void SetScanlineCropAndConvert(const Rect &cropRect, ImageInfo &dstImageInfo, ImageInfo &srcImageInfo,
                                    ScanlineFilter &scanlineFilter, bool hasPixelConvert);
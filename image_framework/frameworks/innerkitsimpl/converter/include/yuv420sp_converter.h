@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_YUV420SP_CONVERTER_H_
+#define FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_YUV420SP_CONVERTER_H_
+
+#include <cstddef>
+#include "image_type.h"
+
+namespace OHOS {
+namespace Media {
+// A NV21 or NV12 image, the luma plane is followed by the interleaved chroma plane.
+struct Yuv420spInfo {
+    const uint8_t *data = nullptr;
+    size_t dataSize = 0;
+    Size size;
+    PixelFormat format = PixelFormat::NV21;
+    YuvColorMatrix matrix = YuvColorMatrix::BT601_FULL;
+    // bytes of a chroma row, 0 means the width rounded up to even.
+    uint32_t uvStride = 0;
+};
+
+/*
+ * 13 bit fixed point coefficients, the chroma coefficients follow the byte order of the
+ * chroma plane, so NV21 and NV12 share the same row procs.
+ * channel = (yScale * (y - yOffset) + coef[0] * (c0 - 128) + coef[1] * (c1 - 128) + 4096) >> 13
+ */
+struct YuvConstants {
+    int16_t yScale = 0;
+    int16_t yOffset = 0;
+    int16_t rCoef[2] = { 0 };
+    int16_t gCoef[2] = { 0 };
+    int16_t bCoef[2] = { 0 };
+};
+
+// Two luma rows share one chroma row, y1 and dst1 are nullptr for the last row of an odd height.
+struct Yuv420spRowArgs {
+    const uint8_t *y0 = nullptr;
+    const uint8_t *y1 = nullptr;
+    const uint8_t *uv = nullptr;
+    uint8_t *dst0 = nullptr;
+    uint8_t *dst1 = nullptr;
+    int32_t width = 0;
+    const YuvConstants *constants = nullptr;
+};
+
+class Yuv420spConverter {
+public:
+    using RowProc = void (*)(const Yuv420spRowArgs &args);
+
+    // RGBA_8888, BGRA_8888 and RGB_565 are written directly.
+    static bool IsSupportedDstFormat(PixelFormat format);
+    static bool GetConstants(PixelFormat srcFormat, YuvColorMatrix matrix, YuvConstants &constants);
+
+    /**
+     * Convert the whole image into dst, which is tightly packed.
+     * @param threadCount The number of threads to use, 0 lets the converter decide by the image size.
+     * @return false if the parameters are invalid or the source data is too short.
+     */
+    static bool Convert(const Yuv420spInfo &src, PixelFormat dstFormat, uint8_t *dst, size_t dstSize,
+                        uint32_t threadCount = 0);
+
+    // The row proc selected for the running cpu, the result is the same as the scalar one.
+    static RowProc GetRowProc(PixelFormat dstFormat);
+    static RowProc GetScalarRowProc(PixelFormat dstFormat);
+    static const char *GetRowProcName();
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // FRAMEWORKS_INNERKITSIMPL_CONVERTER_INCLUDE_YUV420SP_CONVERTER_H_
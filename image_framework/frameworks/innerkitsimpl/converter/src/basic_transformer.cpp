@@ -17,6 +17,7 @@
 #include <iostream>
 #include <new>
 #include <unistd.h>
+#include "bilinear_row_scaler.h"
 #include "image_utils.h"
 #include "pixel_convert.h"
 #include "pixel_map.h"
@@ -223,6 +224,10 @@ bool BasicTransformer::DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t
     Matrix::OperType operType = matrix_.GetOperType();
     Matrix::CalcXYProc fInvProc = Matrix::GetXYProc(operType);
 
+    if (IsSeparableScale(operType) && BilinearRowScaler::IsSupported(pixmapInfo.imageInfo.pixelFormat)) {
+        return DrawPixelmapByRow(pixmapInfo, size, invertMatrix, data);
+    }
+
     for (int32_t y = 0; y < size.height; ++y) {
         for (int32_t x = 0; x < size.width; ++x) {
             Point srcPoint;
@@ -243,6 +248,43 @@ bool BasicTransformer::DrawPixelmap(const PixmapInfo &pixmapInfo, const int32_t
     return true;
 }
 
+bool BasicTransformer::IsSeparableScale(Matrix::OperType operType)
+{
+    // Without rotate or skew, source x only depends on destination x and source y only on destination y.
+    return ((static_cast<uint8_t>(operType) & Matrix::ROTATEORSKEW) == 0) &&
+        ((static_cast<uint8_t>(operType) & Matrix::SCALE) == Matrix::SCALE);
+}
+
+bool BasicTransformer::DrawPixelmapByRow(const PixmapInfo &pixmapInfo, const Size &size, const Matrix &invertMatrix,
+                                         uint8_t *data)
+{
+    Matrix::CalcXYProc fInvProc = Matrix::GetXYProc(matrix_.GetOperType());
+    const Size &srcSize = pixmapInfo.imageInfo.size;
+    BilinearAxis xAxis;
+    BilinearAxis yAxis;
+    xAxis.dst.reserve(size.width);
+    yAxis.dst.reserve(size.height);
+
+    // Same sample points as DrawPixelmap, evaluated once per column and once per row.
+    for (int32_t x = 0; x < size.width; ++x) {
+        Point srcPoint;
+        fInvProc(invertMatrix, static_cast<float>(x) + minX_ + FHALF, minY_ + FHALF, srcPoint);
+        pointLoop(srcPoint, srcSize);
+        if (srcPoint.x >= 0 && srcPoint.x < srcSize.width) {
+            BilinearRowScaler::AppendSample(xAxis, x, srcPoint.x, srcSize.width);
+        }
+    }
+    for (int32_t y = 0; y < size.height; ++y) {
+        Point srcPoint;
+        fInvProc(invertMatrix, minX_ + FHALF, static_cast<float>(y) + minY_ + FHALF, srcPoint);
+        pointLoop(srcPoint, srcSize);
+        if (srcPoint.y >= 0 && srcPoint.y < srcSize.height) {
+            BilinearRowScaler::AppendSample(yAxis, y, srcPoint.y, srcSize.height);
+        }
+    }
+    return BilinearRowScaler::ScaleRows(pixmapInfo, xAxis, yAxis, size, data);
+}
+
 void BasicTransformer::GetRotateDimension(Matrix::CalcXYProc fInvProc, const Size &srcSize, Size &dstSize)
 {
     Point dstP1;
@@ -426,31 +468,8 @@ uint32_t BasicTransformer::RightShift16Bit(uint32_t num, int32_t maxNum)
 
 uint32_t BasicTransformer::FilterProc(const uint32_t subx, const uint32_t suby, const AroundPixels &aroundPixels)
 {
-    int32_t xy = subx * suby;
-    // Mask 0xFF00FF ensures that high and low 16 bits can be calculated simultaneously
-    const uint32_t mask = 0xFF00FF;
-
-    /* All values are first magnified 16 times (left shift 4bit) and then divide 256 (right shift 8bit).
-     * Reference formula f(i+u,j+v) = (1-u)(1-v)f(i,j) + (1-u)vf(i,j+1) + u(1-v)f(i+1,j) + uvf(i+1,j+1),
-     * The subx is u, the suby is y,
-     * color00 is f(i,j), color 01 is f(i,j+1), color 10 is f(i+1,j), color11 is f(i+1,j+1).
-     */
-    int32_t scale = 256 - 16 * suby - 16 * subx + xy;
-    uint32_t lo = (aroundPixels.color00 & mask) * scale;
-    uint32_t hi = ((aroundPixels.color00 >> 8) & mask) * scale;
-
-    scale = 16 * subx - xy;
-    lo += (aroundPixels.color01 & mask) * scale;
-    hi += ((aroundPixels.color01 >> 8) & mask) * scale;
-
-    scale = 16 * suby - xy;
-    lo += (aroundPixels.color10 & mask) * scale;
-    hi += ((aroundPixels.color10 >> 8) & mask) * scale;
-
-    lo += (aroundPixels.color11 & mask) * xy;
-    hi += ((aroundPixels.color11 >> 8) & mask) * xy;
-
-    return ((lo >> 8) & mask) | (hi & ~mask);
+    return BilinearRowScaler::FilterPixel(subx, suby, aroundPixels.color00, aroundPixels.color01,
+                                          aroundPixels.color10, aroundPixels.color11);
 }
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bilinear_row_scaler.h"
+#include "image_utils.h"
+#include "pixel_convert.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define BILINEAR_ROW_SSE2
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define BILINEAR_ROW_AVX2
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#define BILINEAR_ROW_NEON
+#endif
+
+namespace {
+constexpr uint32_t ROW_CHUNK = 256;
+constexpr uint32_t FILTER_MASK = 0xFF00FF;
+constexpr uint32_t FILTER_HIGH_MASK = 0xFF00FF00;
+constexpr uint32_t FILTER_FULL_WEIGHT = 256;
+constexpr uint32_t FILTER_SUB_SCALE = 4;
+constexpr uint32_t FILTER_RESULT_SHIFT = 8;
+constexpr uint32_t LANE_16_SHIFT = 16;
+constexpr uint32_t SSE_LANES = 4;
+constexpr uint32_t AVX_LANES = 8;
+constexpr uint32_t NEON_LANES = 4;
+
+constexpr uint32_t RGB24_R_MASK = 0x00ff0000;
+constexpr uint32_t RGB24_G_MASK = 0x0000ff00;
+constexpr uint32_t RGB24_B_MASK = 0x000000ff;
+constexpr uint16_t RGB16_R_MASK = 0xf800;
+constexpr uint16_t RGB16_G_MASK = 0x07e0;
+constexpr uint16_t RGB16_B_MASK = 0x001f;
+constexpr uint32_t RGB32_RGB16_R_SHIFT = 0x13;
+constexpr uint32_t RGB32_RGB16_G_SHIFT = 0xA;
+constexpr uint32_t RGB32_RGB16_B_SHIFT = 0x3;
+constexpr uint32_t RGB16_RGB32_R_SHIFT = 0x8;
+constexpr uint32_t RGB16_RGB32_G_SHIFT = 0x3;
+constexpr uint32_t RGB16_RGB32_B_SHIFT = 0x3;
+constexpr uint32_t RGB24_R_SHIFT = 0x10;
+constexpr uint32_t RGB24_G_SHIFT = 0x8;
+constexpr uint32_t OFFSET_1 = 1;
+constexpr uint32_t OFFSET_2 = 2;
+}
+
+namespace OHOS {
+namespace Media {
+uint32_t BilinearRowScaler::FilterPixel(uint32_t subx, uint32_t suby, uint32_t color00, uint32_t color01,
+                                        uint32_t color10, uint32_t color11)
+{
+    int32_t xy = subx * suby;
+    // Mask 0xFF00FF ensures that high and low 16 bits can be calculated simultaneously
+    const uint32_t mask = FILTER_MASK;
+
+    /* All values are first magnified 16 times (left shift 4bit) and then divide 256 (right shift 8bit).
+     * The subx is u, the suby is v,
+     * color00 is f(i,j), color 01 is f(i,j+1), color 10 is f(i+1,j), color11 is f(i+1,j+1).
+     */
+    int32_t scale = 256 - 16 * suby - 16 * subx + xy;
+    uint32_t lo = (color00 & mask) * scale;
+    uint32_t hi = ((color00 >> 8) & mask) * scale;
+
+    scale = 16 * subx - xy;
+    lo += (color01 & mask) * scale;
+    hi += ((color01 >> 8) & mask) * scale;
+
+    scale = 16 * suby - xy;
+    lo += (color10 & mask) * scale;
+    hi += ((color10 >> 8) & mask) * scale;
+
+    lo += (color11 & mask) * xy;
+    hi += ((color11 >> 8) & mask) * xy;
+
+    return ((lo >> 8) & mask) | (hi & ~mask);
+}
+
+static void FilterRowScalar(const BilinearRowArgs &args)
+{
+    for (uint32_t i = 0; i < args.count; i++) {
+        args.out[i] = BilinearRowScaler::FilterPixel(args.subx[i], args.suby, args.color00[i], args.color01[i],
+                                                     args.color10[i], args.color11[i]);
+    }
+}
+
+static void FilterRowTail(const BilinearRowArgs &args, uint32_t start)
+{
+    for (uint32_t i = start; i < args.count; i++) {
+        args.out[i] = BilinearRowScaler::FilterPixel(args.subx[i], args.suby, args.color00[i], args.color01[i],
+                                                     args.color10[i], args.color11[i]);
+    }
+}
+
+/*
+ * The SIMD kernels work on 16 bit lanes: each masked channel is at most 255 and the four
+ * weights sum to 256, so every product and partial sum fits in 16 bits and the result is
+ * bit exact with the 32 bit FilterPixel.
+ */
+#ifdef BILINEAR_ROW_SSE2
+static inline __m128i DupWeightSse2(__m128i weight)
+{
+    return _mm_or_si128(weight, _mm_slli_epi32(weight, LANE_16_SHIFT));
+}
+
+static void FilterRowSse2(const BilinearRowArgs &args)
+{
+    const __m128i mask = _mm_set1_epi32(FILTER_MASK);
+    const __m128i highMask = _mm_set1_epi32(FILTER_HIGH_MASK);
+    const __m128i full = _mm_set1_epi32(FILTER_FULL_WEIGHT);
+    const __m128i suby = _mm_set1_epi32(args.suby);
+    const __m128i suby16 = _mm_slli_epi32(suby, FILTER_SUB_SCALE);
+    uint32_t i = 0;
+    for (; i + SSE_LANES <= args.count; i += SSE_LANES) {
+        __m128i subx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.subx + i));
+        __m128i subx16 = _mm_slli_epi32(subx, FILTER_SUB_SCALE);
+        __m128i xy = _mm_mullo_epi16(subx, suby);
+        __m128i w00 = DupWeightSse2(_mm_add_epi32(_mm_sub_epi32(_mm_sub_epi32(full, suby16), subx16), xy));
+        __m128i w01 = DupWeightSse2(_mm_sub_epi32(subx16, xy));
+        __m128i w10 = DupWeightSse2(_mm_sub_epi32(suby16, xy));
+        __m128i w11 = DupWeightSse2(xy);
+
+        __m128i c00 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.color00 + i));
+        __m128i c01 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.color01 + i));
+        __m128i c10 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.color10 + i));
+        __m128i c11 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.color11 + i));
+
+        __m128i lo = _mm_mullo_epi16(_mm_and_si128(c00, mask), w00);
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_and_si128(c01, mask), w01));
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_and_si128(c10, mask), w10));
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_and_si128(c11, mask), w11));
+
+        __m128i hi = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c00, FILTER_RESULT_SHIFT), mask), w00);
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c01, FILTER_RESULT_SHIFT), mask), w01));
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c10, FILTER_RESULT_SHIFT), mask), w10));
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(c11, FILTER_RESULT_SHIFT), mask), w11));
+
+        __m128i result = _mm_or_si128(_mm_srli_epi16(lo, FILTER_RESULT_SHIFT), _mm_and_si128(hi, highMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(args.out + i), result);
+    }
+    FilterRowTail(args, i);
+}
+#endif
+
+#ifdef BILINEAR_ROW_AVX2
+__attribute__((target("avx2"))) static inline __m256i DupWeightAvx2(__m256i weight)
+{
+    return _mm256_or_si256(weight, _mm256_slli_epi32(weight, LANE_16_SHIFT));
+}
+
+__attribute__((target("avx2"))) static void FilterRowAvx2(const BilinearRowArgs &args)
+{
+    const __m256i mask = _mm256_set1_epi32(FILTER_MASK);
+    const __m256i highMask = _mm256_set1_epi32(FILTER_HIGH_MASK);
+    const __m256i full = _mm256_set1_epi32(FILTER_FULL_WEIGHT);
+    const __m256i suby = _mm256_set1_epi32(args.suby);
+    const __m256i suby16 = _mm256_slli_epi32(suby, FILTER_SUB_SCALE);
+    uint32_t i = 0;
+    for (; i + AVX_LANES <= args.count; i += AVX_LANES) {
+        __m256i subx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(args.subx + i));
+        __m256i subx16 = _mm256_slli_epi32(subx, FILTER_SUB_SCALE);
+        __m256i xy = _mm256_mullo_epi16(subx, suby);
+        __m256i w00 = DupWeightAvx2(
+            _mm256_add_epi32(_mm256_sub_epi32(_mm256_sub_epi32(full, suby16), subx16), xy));
+        __m256i w01 = DupWeightAvx2(_mm256_sub_epi32(subx16, xy));
+        __m256i w10 = DupWeightAvx2(_mm256_sub_epi32(suby16, xy));
+        __m256i w11 = DupWeightAvx2(xy);
+
+        __m256i c00 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(args.color00 + i));
+        __m256i c01 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(args.color01 + i));
+        __m256i c10 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(args.color10 + i));
+        __m256i c11 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(args.color11 + i));
+
+        __m256i lo = _mm256_mullo_epi16(_mm256_and_si256(c00, mask), w00);
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_and_si256(c01, mask), w01));
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_and_si256(c10, mask), w10));
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_and_si256(c11, mask), w11));
+
+        __m256i hi = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c00, FILTER_RESULT_SHIFT), mask), w00);
+        hi = _mm256_add_epi16(hi,
+            _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c01, FILTER_RESULT_SHIFT), mask), w01));
+        hi = _mm256_add_epi16(hi,
+            _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c10, FILTER_RESULT_SHIFT), mask), w10));
+        hi = _mm256_add_epi16(hi,
+            _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(c11, FILTER_RESULT_SHIFT), mask), w11));
+
+        __m256i result = _mm256_or_si256(_mm256_srli_epi16(lo, FILTER_RESULT_SHIFT), _mm256_and_si256(hi, highMask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(args.out + i), result);
+    }
+    FilterRowTail(args, i);
+}
+#endif
+
+#ifdef BILINEAR_ROW_NEON
+static inline uint16x8_t DupWeightNeon(uint32x4_t weight)
+{
+    return vreinterpretq_u16_u32(vorrq_u32(weight, vshlq_n_u32(weight, LANE_16_SHIFT)));
+}
+
+static inline uint16x8_t MaskLowNeon(uint32x4_t color, uint32x4_t mask)
+{
+    return vreinterpretq_u16_u32(vandq_u32(color, mask));
+}
+
+static inline uint16x8_t MaskHighNeon(uint32x4_t color, uint32x4_t mask)
+{
+    return vreinterpretq_u16_u32(vandq_u32(vshrq_n_u32(color, FILTER_RESULT_SHIFT), mask));
+}
+
+static void FilterRowNeon(const BilinearRowArgs &args)
+{
+    const uint32x4_t mask = vdupq_n_u32(FILTER_MASK);
+    const uint16x8_t highMask = vreinterpretq_u16_u32(vdupq_n_u32(FILTER_HIGH_MASK));
+    const uint32x4_t full = vdupq_n_u32(FILTER_FULL_WEIGHT);
+    const uint32x4_t suby = vdupq_n_u32(args.suby);
+    const uint32x4_t suby16 = vshlq_n_u32(suby, FILTER_SUB_SCALE);
+    uint32_t i = 0;
+    for (; i + NEON_LANES <= args.count; i += NEON_LANES) {
+        uint32x4_t subx = vld1q_u32(args.subx + i);
+        uint32x4_t subx16 = vshlq_n_u32(subx, FILTER_SUB_SCALE);
+        uint32x4_t xy = vmulq_u32(subx, suby);
+        uint16x8_t w00 = DupWeightNeon(vaddq_u32(vsubq_u32(vsubq_u32(full, suby16), subx16), xy));
+        uint16x8_t w01 = DupWeightNeon(vsubq_u32(subx16, xy));
+        uint16x8_t w10 = DupWeightNeon(vsubq_u32(suby16, xy));
+        uint16x8_t w11 = DupWeightNeon(xy);
+
+        uint32x4_t c00 = vld1q_u32(args.color00 + i);
+        uint32x4_t c01 = vld1q_u32(args.color01 + i);
+        uint32x4_t c10 = vld1q_u32(args.color10 + i);
+        uint32x4_t c11 = vld1q_u32(args.color11 + i);
+
+        uint16x8_t lo = vmulq_u16(MaskLowNeon(c00, mask), w00);
+        lo = vmlaq_u16(lo, MaskLowNeon(c01, mask), w01);
+        lo = vmlaq_u16(lo, MaskLowNeon(c10, mask), w10);
+        lo = vmlaq_u16(lo, MaskLowNeon(c11, mask), w11);
+
+        uint16x8_t hi = vmulq_u16(MaskHighNeon(c00, mask), w00);
+        hi = vmlaq_u16(hi, MaskHighNeon(c01, mask), w01);
+        hi = vmlaq_u16(hi, MaskHighNeon(c10, mask), w10);
+        hi = vmlaq_u16(hi, MaskHighNeon(c11, mask), w11);
+
+        uint16x8_t result = vorrq_u16(vshrq_n_u16(lo, FILTER_RESULT_SHIFT), vandq_u16(hi, highMask));
+        vst1q_u32(args.out + i, vreinterpretq_u32_u16(result));
+    }
+    FilterRowTail(args, i);
+}
+#endif
+
+struct FilterRowEntry {
+    BilinearRowScaler::FilterRowProc proc;
+    const char *name;
+};
+
+static FilterRowEntry SelectFilterRow()
+{
+#ifdef BILINEAR_ROW_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return { FilterRowAvx2, "avx2" };
+    }
+#endif
+#ifdef BILINEAR_ROW_SSE2
+    return { FilterRowSse2, "sse2" };
+#elif defined(BILINEAR_ROW_NEON)
+    return { FilterRowNeon, "neon" };
+#else
+    return { FilterRowScalar, "scalar" };
+#endif
+}
+
+static const FilterRowEntry &GetFilterRowEntry()
+{
+    // cpu features do not change at runtime, detect them once
+    static const FilterRowEntry entry = SelectFilterRow();
+    return entry;
+}
+
+BilinearRowScaler::FilterRowProc BilinearRowScaler::GetFilterRowProc()
+{
+    return GetFilterRowEntry().proc;
+}
+
+BilinearRowScaler::FilterRowProc BilinearRowScaler::GetScalarFilterRowProc()
+{
+    return FilterRowScalar;
+}
+
+const char *BilinearRowScaler::GetFilterRowName()
+{
+    return GetFilterRowEntry().name;
+}
+
+bool BilinearRowScaler::IsSupported(PixelFormat format)
+{
+    switch (format) {
+        case PixelFormat::RGBA_8888:
+        case PixelFormat::ARGB_8888:
+        case PixelFormat::BGRA_8888:
+        case PixelFormat::RGB_565:
+        case PixelFormat::RGB_888:
+        case PixelFormat::ALPHA_8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void BilinearRowScaler::AppendSample(BilinearAxis &axis, uint32_t dst, float srcPos, int32_t srcLength)
+{
+    // keep the same rounding as BasicTransformer::BilinearProc
+    uint32_t src = (srcPos * MULTI_65536) - HALF_BASIC < 0 ? 0 : (srcPos * MULTI_65536) - HALF_BASIC;
+    axis.dst.push_back(dst);
+    axis.pos0.push_back(ClampMax(src >> SHIFT_16_BIT, srcLength - 1));
+    axis.pos1.push_back(ClampMax((src + BASIC) >> SHIFT_16_BIT, srcLength - 1));
+    axis.sub.push_back(GetSubValue(src));
+}
+
+static inline uint32_t RGB565to32(uint16_t c)
+{
+    uint32_t color = c;
+    uint32_t r = (color & RGB16_R_MASK) >> RGB16_RGB32_R_SHIFT;
+    uint32_t g = (color & RGB16_G_MASK) >> RGB16_RGB32_G_SHIFT;
+    uint32_t b = (color & RGB16_B_MASK) << RGB16_RGB32_B_SHIFT;
+    return (r << SHIFT_16_BIT) | (g << SHIFT_8_BIT) | b;
+}
+
+static inline uint16_t Color32toRGB565(uint32_t c)
+{
+    uint16_t r = (c & RGB24_R_MASK) >> RGB32_RGB16_R_SHIFT;
+    uint16_t g = (c & RGB24_G_MASK) >> RGB32_RGB16_G_SHIFT;
+    uint16_t b = (c & RGB24_B_MASK) >> RGB32_RGB16_B_SHIFT;
+    return (r << SHIFT_11_BIT) | (g << SHIFT_5_BIT) | b;
+}
+
+static inline uint32_t LoadRGB888(const uint8_t *row, uint32_t x)
+{
+    const uint8_t *pixel = row + x * RGB888_BYTE;
+    return (pixel[0] << SHIFT_16_BIT) | (pixel[OFFSET_1] << SHIFT_8_BIT) | pixel[OFFSET_2];
+}
+
+struct RowChunk {
+    uint32_t color00[ROW_CHUNK];
+    uint32_t color01[ROW_CHUNK];
+    uint32_t color10[ROW_CHUNK];
+    uint32_t color11[ROW_CHUNK];
+    uint32_t out[ROW_CHUNK];
+};
+
+static void GatherChunk(PixelFormat format, const uint8_t *row0, const uint8_t *row1, const uint32_t *pos0,
+                        const uint32_t *pos1, uint32_t count, RowChunk &chunk)
+{
+    switch (format) {
+        case PixelFormat::RGB_565: {
+            const uint16_t *src0 = reinterpret_cast<const uint16_t *>(row0);
+            const uint16_t *src1 = reinterpret_cast<const uint16_t *>(row1);
+            for (uint32_t i = 0; i < count; i++) {
+                chunk.color00[i] = RGB565to32(src0[pos0[i]]);
+                chunk.color01[i] = RGB565to32(src0[pos1[i]]);
+                chunk.color10[i] = RGB565to32(src1[pos0[i]]);
+                chunk.color11[i] = RGB565to32(src1[pos1[i]]);
+            }
+            break;
+        }
+        case PixelFormat::RGB_888:
+            for (uint32_t i = 0; i < count; i++) {
+                chunk.color00[i] = LoadRGB888(row0, pos0[i]);
+                chunk.color01[i] = LoadRGB888(row0, pos1[i]);
+                chunk.color10[i] = LoadRGB888(row1, pos0[i]);
+                chunk.color11[i] = LoadRGB888(row1, pos1[i]);
+            }
+            break;
+        case PixelFormat::ALPHA_8:
+            for (uint32_t i = 0; i < count; i++) {
+                chunk.color00[i] = row0[pos0[i]];
+                chunk.color01[i] = row0[pos1[i]];
+                chunk.color10[i] = row1[pos0[i]];
+                chunk.color11[i] = row1[pos1[i]];
+            }
+            break;
+        default: {
+            const uint32_t *src0 = reinterpret_cast<const uint32_t *>(row0);
+            const uint32_t *src1 = reinterpret_cast<const uint32_t *>(row1);
+            for (uint32_t i = 0; i < count; i++) {
+                chunk.color00[i] = src0[pos0[i]];
+                chunk.color01[i] = src0[pos1[i]];
+                chunk.color10[i] = src1[pos0[i]];
+                chunk.color11[i] = src1[pos1[i]];
+            }
+            break;
+        }
+    }
+}
+
+static void StoreChunk(PixelFormat format, const uint32_t *result, const uint32_t *dst, uint32_t count,
+                       uint8_t *dstRow)
+{
+    switch (format) {
+        case PixelFormat::RGB_565: {
+            uint16_t *out = reinterpret_cast<uint16_t *>(dstRow);
+            for (uint32_t i = 0; i < count; i++) {
+                out[dst[i]] = Color32toRGB565(result[i]);
+            }
+            break;
+        }
+        case PixelFormat::RGB_888:
+            for (uint32_t i = 0; i < count; i++) {
+                uint8_t *out = dstRow + dst[i] * RGB888_BYTE;
+                out[0] = static_cast<uint8_t>((result[i] & RGB24_R_MASK) >> RGB24_R_SHIFT);
+                out[OFFSET_1] = static_cast<uint8_t>((result[i] & RGB24_G_MASK) >> RGB24_G_SHIFT);
+                out[OFFSET_2] = static_cast<uint8_t>(result[i] & RGB24_B_MASK);
+            }
+            break;
+        case PixelFormat::ALPHA_8:
+            for (uint32_t i = 0; i < count; i++) {
+                dstRow[dst[i]] = static_cast<uint8_t>(result[i] & RGB24_B_MASK);
+            }
+            break;
+        default: {
+            uint32_t *out = reinterpret_cast<uint32_t *>(dstRow);
+            for (uint32_t i = 0; i < count; i++) {
+                out[dst[i]] = result[i];
+            }
+            break;
+        }
+    }
+}
+
+bool BilinearRowScaler::ScaleRows(const PixmapInfo &pixmapInfo, const BilinearAxis &xAxis,
+                                  const BilinearAxis &yAxis, const Size &dstSize, uint8_t *data)
+{
+    PixelFormat format = pixmapInfo.imageInfo.pixelFormat;
+    if (!IsSupported(format) || pixmapInfo.data == nullptr || data == nullptr) {
+        return false;
+    }
+    int32_t pixelBytes = ImageUtils::GetPixelBytes(format);
+    uint32_t srcRowBytes = pixmapInfo.imageInfo.size.width * pixelBytes;
+    uint32_t dstRowBytes = dstSize.width * pixelBytes;
+    uint32_t columns = xAxis.dst.size();
+    FilterRowProc filterRow = GetFilterRowProc();
+    RowChunk chunk;
+    BilinearRowArgs args;
+    args.color00 = chunk.color00;
+    args.color01 = chunk.color01;
+    args.color10 = chunk.color10;
+    args.color11 = chunk.color11;
+    args.out = chunk.out;
+
+    for (size_t row = 0; row < yAxis.dst.size(); row++) {
+        const uint8_t *row0 = pixmapInfo.data + yAxis.pos0[row] * srcRowBytes;
+        const uint8_t *row1 = pixmapInfo.data + yAxis.pos1[row] * srcRowBytes;
+        uint8_t *dstRow = data + static_cast<uint64_t>(yAxis.dst[row]) * dstRowBytes;
+        args.suby = yAxis.sub[row];
+        for (uint32_t start = 0; start < columns; start += ROW_CHUNK) {
+            uint32_t count = std::min(ROW_CHUNK, columns - start);
+            GatherChunk(format, row0, row1, xAxis.pos0.data() + start, xAxis.pos1.data() + start, count, chunk);
+            args.subx = xAxis.sub.data() + start;
+            args.count = count;
+            filterRow(args);
+            StoreChunk(format, chunk.out, xAxis.dst.data() + start, count, dstRow);
+        }
+    }
+    return true;
+}
+} // namespace Media
+} // namespace OHOS
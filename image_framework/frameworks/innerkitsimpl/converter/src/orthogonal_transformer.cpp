@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orthogonal_transformer.h"
+#include <algorithm>
+#include <cmath>
+#include "image_log.h"
+
+namespace {
+constexpr float DEGREES_EPSILON = 1e-4;
+constexpr float DEGREES_ROUND = 360.0f;
+constexpr float DEGREES_QUARTER = 90.0f;
+constexpr int32_t QUARTER_90 = 1;
+constexpr int32_t QUARTER_180 = 2;
+constexpr int32_t QUARTER_270 = 3;
+constexpr int32_t QUARTER_NUM = 4;
+// A source tile and its destination tile together stay well inside a 32KB L1 data cache.
+constexpr uint32_t TILE_BYTES = 8 * 1024;
+constexpr int32_t SMALL_TILE = 32;
+constexpr int32_t LARGE_TILE = 64;
+constexpr int32_t PIXEL_BYTES_1 = 1;
+constexpr int32_t PIXEL_BYTES_2 = 2;
+constexpr int32_t PIXEL_BYTES_3 = 3;
+constexpr int32_t PIXEL_BYTES_4 = 4;
+constexpr int32_t PIXEL_BYTES_8 = 8;
+}
+
+namespace OHOS {
+namespace Media {
+struct Pixel24 {
+    uint8_t value[PIXEL_BYTES_3];
+};
+
+template <typename T>
+constexpr int32_t TileSide()
+{
+    return (sizeof(T) * LARGE_TILE * LARGE_TILE <= TILE_BYTES) ? LARGE_TILE : SMALL_TILE;
+}
+
+template <typename T>
+static void FlipX(const T *src, T *dst, int32_t width, int32_t height)
+{
+    for (int32_t y = 0; y < height; y++) {
+        const T *srcRow = src + static_cast<int64_t>(y) * width;
+        T *dstRow = dst + static_cast<int64_t>(y) * width;
+        if (srcRow == dstRow) {
+            std::reverse(dstRow, dstRow + width);
+        } else {
+            std::reverse_copy(srcRow, srcRow + width, dstRow);
+        }
+    }
+}
+
+template <typename T>
+static void FlipY(const T *src, T *dst, int32_t width, int32_t height)
+{
+    if (src == dst) {
+        for (int32_t top = 0, bottom = height - 1; top < bottom; top++, bottom--) {
+            std::swap_ranges(dst + static_cast<int64_t>(top) * width, dst + static_cast<int64_t>(top + 1) * width,
+                             dst + static_cast<int64_t>(bottom) * width);
+        }
+        return;
+    }
+    for (int32_t y = 0; y < height; y++) {
+        const T *srcRow = src + static_cast<int64_t>(height - 1 - y) * width;
+        std::copy(srcRow, srcRow + width, dst + static_cast<int64_t>(y) * width);
+    }
+}
+
+template <typename T>
+static void Rotate180(const T *src, T *dst, int32_t width, int32_t height)
+{
+    int64_t count = static_cast<int64_t>(width) * height;
+    if (src == dst) {
+        std::reverse(dst, dst + count);
+    } else {
+        std::reverse_copy(src, src + count, dst);
+    }
+}
+
+// In place transpose of a square image, only the tiles on and above the diagonal are visited.
+template <typename T>
+static void TransposeSquare(T *data, int32_t side)
+{
+    constexpr int32_t tile = TileSide<T>();
+    for (int32_t by = 0; by < side; by += tile) {
+        int32_t yEnd = std::min(by + tile, side);
+        for (int32_t bx = by; bx < side; bx += tile) {
+            int32_t xEnd = std::min(bx + tile, side);
+            for (int32_t y = by; y < yEnd; y++) {
+                for (int32_t x = std::max(bx, y + 1); x < xEnd; x++) {
+                    std::swap(data[static_cast<int64_t>(y) * side + x], data[static_cast<int64_t>(x) * side + y]);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Rotate clockwise: dst(r, c) = src(height - 1 - c, r).
+ * Rotate counter clockwise: dst(r, c) = src(c, width - 1 - r).
+ * The destination is height pixels wide, both images are walked tile by tile.
+ */
+template <typename T>
+static void RotateQuarter(const T *src, T *dst, int32_t width, int32_t height, bool clockwise)
+{
+    constexpr int32_t tile = TileSide<T>();
+    for (int32_t by = 0; by < height; by += tile) {
+        int32_t yEnd = std::min(by + tile, height);
+        for (int32_t bx = 0; bx < width; bx += tile) {
+            int32_t xEnd = std::min(bx + tile, width);
+            for (int32_t y = by; y < yEnd; y++) {
+                const T *srcRow = src + static_cast<int64_t>(y) * width;
+                if (clockwise) {
+                    T *dstColumn = dst + (height - 1 - y);
+                    for (int32_t x = bx; x < xEnd; x++) {
+                        dstColumn[static_cast<int64_t>(x) * height] = srcRow[x];
+                    }
+                } else {
+                    T *dstColumn = dst + y;
+                    for (int32_t x = bx; x < xEnd; x++) {
+                        dstColumn[static_cast<int64_t>(width - 1 - x) * height] = srcRow[x];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+static bool TransformPixels(OrthogonalOp op, const uint8_t *srcData, uint8_t *dstData, const Size &srcSize)
+{
+    const T *src = reinterpret_cast<const T *>(srcData);
+    T *dst = reinterpret_cast<T *>(dstData);
+    int32_t width = srcSize.width;
+    int32_t height = srcSize.height;
+    switch (op) {
+        case OrthogonalOp::FLIP_X:
+            FlipX(src, dst, width, height);
+            break;
+        case OrthogonalOp::FLIP_Y:
+            FlipY(src, dst, width, height);
+            break;
+        case OrthogonalOp::ROTATE_180:
+            Rotate180(src, dst, width, height);
+            break;
+        case OrthogonalOp::ROTATE_90:
+        case OrthogonalOp::ROTATE_270:
+            if (src == dst) {
+                // square only: transpose, then mirror to finish the quarter turn
+                TransposeSquare(dst, width);
+                if (op == OrthogonalOp::ROTATE_90) {
+                    FlipX(dst, dst, width, height);
+                } else {
+                    FlipY(dst, dst, width, height);
+                }
+            } else {
+                RotateQuarter(src, dst, width, height, op == OrthogonalOp::ROTATE_90);
+            }
+            break;
+        default:
+            if (src != dst) {
+                std::copy(src, src + static_cast<int64_t>(width) * height, dst);
+            }
+            break;
+    }
+    return true;
+}
+
+bool OrthogonalTransformer::GetRotateOp(float degrees, OrthogonalOp &op)
+{
+    float quarters = std::fmod(degrees, DEGREES_ROUND) / DEGREES_QUARTER;
+    float rounded = std::round(quarters);
+    if (std::fabs(quarters - rounded) > DEGREES_EPSILON) {
+        return false;
+    }
+    int32_t quarter = static_cast<int32_t>(rounded) % QUARTER_NUM;
+    if (quarter < 0) {
+        quarter += QUARTER_NUM;
+    }
+    switch (quarter) {
+        case QUARTER_90:
+            op = OrthogonalOp::ROTATE_90;
+            break;
+        case QUARTER_180:
+            op = OrthogonalOp::ROTATE_180;
+            break;
+        case QUARTER_270:
+            op = OrthogonalOp::ROTATE_270;
+            break;
+        default:
+            op = OrthogonalOp::NONE;
+            break;
+    }
+    return true;
+}
+
+OrthogonalOp OrthogonalTransformer::GetFlipOp(bool xAxis, bool yAxis)
+{
+    if (xAxis && yAxis) {
+        return OrthogonalOp::ROTATE_180;
+    }
+    if (xAxis) {
+        return OrthogonalOp::FLIP_X;
+    }
+    return yAxis ? OrthogonalOp::FLIP_Y : OrthogonalOp::NONE;
+}
+
+bool OrthogonalTransformer::IsSupported(PixelFormat format)
+{
+    switch (format) {
+        case PixelFormat::ARGB_8888:
+        case PixelFormat::RGB_565:
+        case PixelFormat::RGBA_8888:
+        case PixelFormat::BGRA_8888:
+        case PixelFormat::RGB_888:
+        case PixelFormat::ALPHA_8:
+        case PixelFormat::RGBA_F16:
+        case PixelFormat::CMYK:
+            return true;
+        default:
+            // the planes of yuv formats can not be moved as whole pixels
+            return false;
+    }
+}
+
+Size OrthogonalTransformer::GetDstSize(OrthogonalOp op, const Size &srcSize)
+{
+    if (op == OrthogonalOp::ROTATE_90 || op == OrthogonalOp::ROTATE_270) {
+        return { srcSize.height, srcSize.width };
+    }
+    return srcSize;
+}
+
+bool OrthogonalTransformer::CanTransformInPlace(OrthogonalOp op, const Size &srcSize)
+{
+    if (op == OrthogonalOp::ROTATE_90 || op == OrthogonalOp::ROTATE_270) {
+        return srcSize.width == srcSize.height;
+    }
+    return true;
+}
+
+bool OrthogonalTransformer::Transform(OrthogonalOp op, const uint8_t *src, uint8_t *dst, const Size &srcSize,
+                                      int32_t pixelBytes)
+{
+    if (src == nullptr || dst == nullptr || srcSize.width <= 0 || srcSize.height <= 0) {
+        IMAGE_LOGE("[OrthogonalTransformer]invalid param.");
+        return false;
+    }
+    if (src == dst && !CanTransformInPlace(op, srcSize)) {
+        IMAGE_LOGE("[OrthogonalTransformer]op %{public}d can not run in place.", static_cast<int32_t>(op));
+        return false;
+    }
+    switch (pixelBytes) {
+        case PIXEL_BYTES_1:
+            return TransformPixels<uint8_t>(op, src, dst, srcSize);
+        case PIXEL_BYTES_2:
+            return TransformPixels<uint16_t>(op, src, dst, srcSize);
+        case PIXEL_BYTES_3:
+            return TransformPixels<Pixel24>(op, src, dst, srcSize);
+        case PIXEL_BYTES_4:
+            return TransformPixels<uint32_t>(op, src, dst, srcSize);
+        case PIXEL_BYTES_8:
+            return TransformPixels<uint64_t>(op, src, dst, srcSize);
+        default:
+            IMAGE_LOGE("[OrthogonalTransformer]pixel bytes %{public}d not supported.", pixelBytes);
+            return false;
+    }
+}
+} // namespace Media
+} // namespace OHOS
@@ -14,8 +14,7 @@
  */
 
 #include "pixel_convert.h"
-#include <map>
-#include <mutex>
+#include "pixel_convert_kernels.h"
 
 namespace OHOS {
 namespace Media {
@@ -28,10 +27,11 @@ constexpr bool IS_LITTLE_ENDIAN = true;
 constexpr bool IS_LITTLE_ENDIAN = false;
 #endif
 
-static void AlphaTypeConvertOnRGB(uint32_t &A, uint32_t &R, uint32_t &G, uint32_t &B,
-                                  const ProcFuncExtension &extension)
+// ALPHA is a template argument, so the switch is resolved when the row procs are instantiated.
+template<AlphaConvertType ALPHA>
+static inline void AlphaTypeConvertOnRGB(uint32_t &A, uint32_t &R, uint32_t &G, uint32_t &B)
 {
-    switch (extension.alphaConvertType) {
+    switch (ALPHA) {
         case AlphaConvertType::PREMUL_CONVERT_UNPREMUL:
             R = Unpremul255(R, A);
             G = Unpremul255(G, A);
@@ -56,6 +56,16 @@ static void AlphaTypeConvertOnRGB(uint32_t &A, uint32_t &R, uint32_t &G, uint32_
     }
 }
 
+// Runs the vector body of a row proc, the caller converts the remaining pixels with the scalar loop.
+template<uint32_t SRC_FORMAT, uint32_t DST_FORMAT, AlphaConvertType ALPHA>
+static inline uint32_t ConvertByKernel(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth)
+{
+    // the kernel only depends on the cpu, so each instantiation looks it up once
+    static const PixelConvertKernels::RowKernel kernel =
+        PixelConvertKernels::GetRowKernel(SRC_FORMAT, DST_FORMAT, ALPHA);
+    return (kernel == nullptr) ? 0 : kernel(destinationRow, sourceRow, sourceWidth);
+}
+
 static uint32_t FillARGB8888(uint32_t A, uint32_t R, uint32_t G, uint32_t B)
 {
     if (IS_LITTLE_ENDIAN) {
@@ -191,16 +201,15 @@ static void GrayConvertRGB565(void *destinationRow, const uint8_t *sourceRow, ui
 
 constexpr uint32_t BRANCH_ARGB8888 = 0x10000001;
 constexpr uint32_t BRANCH_ALPHA = 0x10000002;
-template<typename T>
-static void GrayAlphaConvert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                             const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void GrayAlphaConvert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t A = sourceRow[1];
         uint32_t R = sourceRow[0];
         uint32_t G = sourceRow[0];
         uint32_t B = sourceRow[0];
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_ARGB8888) {
             destinationRow[i] = FillARGB8888(A, R, G, B);
         } else if (branch == BRANCH_ALPHA) {
@@ -212,18 +221,20 @@ static void GrayAlphaConvert(T *destinationRow, const uint8_t *sourceRow, uint32
     }
 }
 
+template<AlphaConvertType ALPHA>
 static void GrayAlphaConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                      const ProcFuncExtension &extension)
 {
     uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    GrayAlphaConvert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888, extension);
+    GrayAlphaConvert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void GrayAlphaConvertAlpha(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
     uint8_t *newDestinationRow = static_cast<uint8_t *>(destinationRow);
-    GrayAlphaConvert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ALPHA, extension);
+    GrayAlphaConvert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_ALPHA);
 }
 
 constexpr uint32_t BRANCH_BGR888_TO_ARGB8888 = 0x20000001;
@@ -262,22 +273,28 @@ static void BGR888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t
 static void BGR888ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGR888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGR888_TO_ARGB8888);
+    uint32_t done =
+        ConvertByKernel<BGR_888, ARGB_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGR888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_BGR888_TO_ARGB8888);
 }
 
 static void BGR888ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGR888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGR888_TO_RGBA8888);
+    uint32_t done =
+        ConvertByKernel<BGR_888, RGBA_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGR888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_BGR888_TO_RGBA8888);
 }
 
 static void BGR888ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGR888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGR888_TO_BGRA8888);
+    uint32_t done =
+        ConvertByKernel<BGR_888, BGRA_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGR888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_BGR888_TO_BGRA8888);
 }
 
 static void BGR888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
@@ -287,11 +304,10 @@ static void BGR888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow,
     BGR888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGR888_TO_RGB565);
 }
 
-static void BGR888ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+static void BGR888ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                 const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
     BGR888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGR888_TO_RGBAF16);
 }
 
@@ -330,22 +346,28 @@ static void RGB888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t
 static void RGB888ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGB888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB888_TO_ARGB8888);
+    uint32_t done =
+        ConvertByKernel<RGB_888, ARGB_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGB888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_RGB888_TO_ARGB8888);
 }
 
 static void RGB888ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGB888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB888_TO_RGBA8888);
+    uint32_t done =
+        ConvertByKernel<RGB_888, RGBA_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGB888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_RGB888_TO_RGBA8888);
 }
 
 static void RGB888ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGB888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB888_TO_BGRA8888);
+    uint32_t done =
+        ConvertByKernel<RGB_888, BGRA_8888, AlphaConvertType::NO_CONVERT>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGB888Convert(newDestinationRow, sourceRow + done * SIZE_3_BYTE, sourceWidth - done, BRANCH_RGB888_TO_BGRA8888);
 }
 
 static void RGB888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
@@ -355,11 +377,10 @@ static void RGB888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow,
     RGB888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB888_TO_RGB565);
 }
 
-static void RGB888ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+static void RGB888ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                 const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
     RGB888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB888_TO_RGBAF16);
 }
 constexpr uint32_t BRANCH_RGBA8888_TO_RGBA8888_ALPHA = 0x40000001;
@@ -367,16 +388,15 @@ constexpr uint32_t BRANCH_RGBA8888_TO_ARGB8888 = 0x40000002;
 constexpr uint32_t BRANCH_RGBA8888_TO_BGRA8888 = 0x40000003;
 constexpr uint32_t BRANCH_RGBA8888_TO_RGB565 = 0x40000004;
 constexpr uint32_t BRANCH_RGBA8888_TO_RGBAF16 = 0x40000005;
-template<typename T>
-static void RGBA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                            const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void RGBA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t R = sourceRow[0];
         uint32_t G = sourceRow[1];
         uint32_t B = sourceRow[2];
         uint32_t A = sourceRow[3];
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_RGBA8888_TO_RGBA8888_ALPHA) {
             destinationRow[i] = FillRGBA8888(R, G, B, A);
         } else if (branch == BRANCH_RGBA8888_TO_ARGB8888) {
@@ -397,55 +417,66 @@ static void RGBA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_
     }
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA8888ConvertRGBA8888Alpha(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                          const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_RGBA8888_ALPHA, extension);
+    uint32_t done = ConvertByKernel<RGBA_8888, RGBA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGBA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_RGBA8888_TO_RGBA8888_ALPHA);
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA8888ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_ARGB8888, extension);
+    uint32_t done = ConvertByKernel<RGBA_8888, ARGB_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGBA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_RGBA8888_TO_ARGB8888);
 }
+template<AlphaConvertType ALPHA>
 static void RGBA8888ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_BGRA8888, extension);
+    uint32_t done = ConvertByKernel<RGBA_8888, BGRA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    RGBA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_RGBA8888_TO_BGRA8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA8888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow);
-    RGBA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_RGB565, extension);
+    uint32_t done = ConvertByKernel<RGBA_8888, RGB_565, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow) + done;
+    RGBA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_RGBA8888_TO_RGB565);
 }
 
-static void RGBA8888ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBA8888ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
-    RGBA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_RGBAF16, extension);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
+    RGBA8888Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA8888_TO_RGBAF16);
 }
 constexpr uint32_t BRANCH_BGRA8888_TO_BGRA8888_ALPHA = 0x80000001;
 constexpr uint32_t BRANCH_BGRA8888_TO_ARGB8888 = 0x80000002;
 constexpr uint32_t BRANCH_BGRA8888_TO_RGBA8888 = 0x80000003;
 constexpr uint32_t BRANCH_BGRA8888_TO_RGB565 = 0x80000004;
 constexpr uint32_t BRANCH_BGRA8888_TO_RGBAF16 = 0x80000005;
-template<typename T>
-static void BGRA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                            const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void BGRA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t B = sourceRow[0];
         uint32_t G = sourceRow[1];
         uint32_t R = sourceRow[2];
         uint32_t A = sourceRow[3];
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_BGRA8888_TO_BGRA8888_ALPHA) {
             destinationRow[i] = FillBGRA8888(B, G, R, A);
         } else if (branch == BRANCH_BGRA8888_TO_ARGB8888) {
@@ -466,40 +497,52 @@ static void BGRA8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_
     }
 }
 
+template<AlphaConvertType ALPHA>
 static void BGRA8888ConvertBGRA8888Alpha(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                          const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGRA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_BGRA8888_ALPHA, extension);
+    uint32_t done = ConvertByKernel<BGRA_8888, BGRA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGRA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_BGRA8888_TO_BGRA8888_ALPHA);
 }
 
+template<AlphaConvertType ALPHA>
 static void BGRA8888ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGRA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_ARGB8888, extension);
+    uint32_t done = ConvertByKernel<BGRA_8888, ARGB_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGRA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_BGRA8888_TO_ARGB8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void BGRA8888ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    BGRA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_RGBA8888, extension);
+    uint32_t done = ConvertByKernel<BGRA_8888, RGBA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    BGRA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_BGRA8888_TO_RGBA8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void BGRA8888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow);
-    BGRA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_RGB565, extension);
+    uint32_t done = ConvertByKernel<BGRA_8888, RGB_565, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow) + done;
+    BGRA8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_BGRA8888_TO_RGB565);
 }
 
-static void BGRA8888ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void BGRA8888ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
-    BGRA8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_RGBAF16, extension);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
+    BGRA8888Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_BGRA8888_TO_RGBAF16);
 }
 
 constexpr uint32_t BRANCH_ARGB8888_TO_ARGB8888_ALPHA = 0x90000001;
@@ -507,16 +550,15 @@ constexpr uint32_t BRANCH_ARGB8888_TO_RGBA8888 = 0x90000002;
 constexpr uint32_t BRANCH_ARGB8888_TO_BGRA8888 = 0x90000003;
 constexpr uint32_t BRANCH_ARGB8888_TO_RGB565 = 0x90000004;
 constexpr uint32_t BRANCH_ARGB8888_TO_RGBAF16 = 0x90000005;
-template<typename T>
-static void ARGB8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                            const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void ARGB8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t A = sourceRow[0];
         uint32_t R = sourceRow[1];
         uint32_t G = sourceRow[2];
         uint32_t B = sourceRow[3];
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_ARGB8888_TO_ARGB8888_ALPHA) {
             destinationRow[i] = FillARGB8888(A, R, G, B);
         } else if (branch == BRANCH_ARGB8888_TO_RGBA8888) {
@@ -537,40 +579,52 @@ static void ARGB8888Convert(T *destinationRow, const uint8_t *sourceRow, uint32_
     }
 }
 
+template<AlphaConvertType ALPHA>
 static void ARGB8888ConvertARGB8888Alpha(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                          const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    ARGB8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_ARGB8888_ALPHA, extension);
+    uint32_t done = ConvertByKernel<ARGB_8888, ARGB_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    ARGB8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_ARGB8888_TO_ARGB8888_ALPHA);
 }
 
+template<AlphaConvertType ALPHA>
 static void ARGB8888ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    ARGB8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_RGBA8888, extension);
+    uint32_t done = ConvertByKernel<ARGB_8888, RGBA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    ARGB8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_ARGB8888_TO_RGBA8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void ARGB8888ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                     const ProcFuncExtension &extension)
 {
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    ARGB8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_BGRA8888, extension);
+    uint32_t done = ConvertByKernel<ARGB_8888, BGRA_8888, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow) + done;
+    ARGB8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_ARGB8888_TO_BGRA8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void ARGB8888ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                   const ProcFuncExtension &extension)
 {
-    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow);
-    ARGB8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_RGB565, extension);
+    uint32_t done = ConvertByKernel<ARGB_8888, RGB_565, ALPHA>(destinationRow, sourceRow, sourceWidth);
+    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow) + done;
+    ARGB8888Convert<ALPHA>(newDestinationRow, sourceRow + done * SIZE_4_BYTE, sourceWidth - done,
+                           BRANCH_ARGB8888_TO_RGB565);
 }
 
-static void ARGB8888ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void ARGB8888ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
-    ARGB8888Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_RGBAF16, extension);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
+    ARGB8888Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_ARGB8888_TO_RGBAF16);
 }
 
 constexpr uint32_t BRANCH_RGB161616_TO_ARGB8888 = 0x50000001;
@@ -644,11 +698,10 @@ static void RGB161616ConvertRGB565(void *destinationRow, const uint8_t *sourceRo
     RGB161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB161616_TO_RGB565);
 }
 
-static void RGB161616ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+static void RGB161616ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                    const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
     RGB161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB161616_TO_RGBAF16);
 }
 
@@ -657,16 +710,15 @@ constexpr uint32_t BRANCH_RGBA16161616_TO_ABGR8888 = 0x60000002;
 constexpr uint32_t BRANCH_RGBA16161616_TO_RGBA8888 = 0x60000003;
 constexpr uint32_t BRANCH_RGBA16161616_TO_BGRA8888 = 0x60000004;
 constexpr uint32_t BRANCH_RGBA16161616_TO_RGBAF16 = 0x60000005;
-template<typename T>
-static void RGBA16161616Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                                const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void RGBA16161616Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t R = sourceRow[0];
         uint32_t G = sourceRow[2];
         uint32_t B = sourceRow[4];
         uint32_t A = sourceRow[6];
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_RGBA16161616_TO_ARGB8888) {
             destinationRow[i] = FillARGB8888(A, R, G, B);
         } else if (branch == BRANCH_RGBA16161616_TO_ABGR8888) {
@@ -684,40 +736,44 @@ static void RGBA16161616Convert(T *destinationRow, const uint8_t *sourceRow, uin
     }
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA16161616ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                         const ProcFuncExtension &extension)
 {
     uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA16161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_ARGB8888, extension);
+    RGBA16161616Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_ARGB8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA16161616ConvertABGR8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                         const ProcFuncExtension &extension)
 {
     uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA16161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_ABGR8888, extension);
+    RGBA16161616Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_ABGR8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA16161616ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                         const ProcFuncExtension &extension)
 {
     uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA16161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_RGBA8888, extension);
+    RGBA16161616Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_RGBA8888);
 }
 
+template<AlphaConvertType ALPHA>
 static void RGBA16161616ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
                                         const ProcFuncExtension &extension)
 {
     uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
-    RGBA16161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_BGRA8888, extension);
+    RGBA16161616Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_BGRA8888);
 }
 
-static void RGBA16161616ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBA16161616ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                       const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
-    RGBA16161616Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_RGBAF16, extension);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
+    RGBA16161616Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBA16161616_TO_RGBAF16);
 }
 
 constexpr uint32_t BRANCH_CMYK_TO_ARGB8888 = 0x70000001;
@@ -840,11 +896,10 @@ static void RGB565ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow
     RGB565Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB565_TO_BGRA8888);
 }
 
-static void RGB565ConvertRGBAF16(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+static void RGB565ConvertRGBAF16(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                 const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint64_t *newDestinationRow = static_cast<uint64_t *>(tmp);
+    uint64_t *newDestinationRow = static_cast<uint64_t *>(destinationRow);
     RGB565Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGB565_TO_RGBAF16);
 }
 
@@ -853,16 +908,15 @@ constexpr uint32_t BRANCH_RGBAF16_TO_RGBA8888 = 0x13000002;
 constexpr uint32_t BRANCH_RGBAF16_TO_BGRA8888 = 0x13000003;
 constexpr uint32_t BRANCH_RGBAF16_TO_ABGR8888 = 0x13000004;
 constexpr uint32_t BRANCH_RGBAF16_TO_RGB565 = 0x13000005;
-template<typename T>
-static void RGBAF16Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch,
-                           const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA, typename T>
+static void RGBAF16Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth, uint32_t branch)
 {
     for (uint32_t i = 0; i < sourceWidth; i++) {
         uint32_t R = HalfToUint32(sourceRow, IS_LITTLE_ENDIAN);
         uint32_t G = HalfToUint32(sourceRow + 2, IS_LITTLE_ENDIAN);
         uint32_t B = HalfToUint32(sourceRow + 4, IS_LITTLE_ENDIAN);
         uint32_t A = HalfToUint32(sourceRow + 6, IS_LITTLE_ENDIAN);
-        AlphaTypeConvertOnRGB(A, R, G, B, extension);
+        AlphaTypeConvertOnRGB<ALPHA>(A, R, G, B);
         if (branch == BRANCH_RGBAF16_TO_ARGB8888) {
             destinationRow[i] = FillARGB8888(A, R, G, B);
         } else if (branch == BRANCH_RGBAF16_TO_RGBA8888) {
@@ -883,170 +937,188 @@ static void RGBAF16Convert(T *destinationRow, const uint8_t *sourceRow, uint32_t
     }
 }
 
-static void RGBAF16ConvertARGB8888(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
-{
-    void* tmp = static_cast<void *>(destinationRow);
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(tmp);
-    RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_ARGB8888, extension);
-}
-
-static void RGBAF16ConvertRGBA8888(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBAF16ConvertARGB8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(tmp);
-    RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_RGBA8888, extension);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
+    RGBAF16Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_ARGB8888);
 }
 
-static void RGBAF16ConvertBGRA8888(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBAF16ConvertRGBA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(tmp);
-    RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_BGRA8888, extension);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
+    RGBAF16Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_RGBA8888);
 }
 
-static void RGBAF16ConvertABGR8888(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBAF16ConvertBGRA8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint32_t *newDestinationRow = static_cast<uint32_t *>(tmp);
-    RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_ABGR8888, extension);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
+    RGBAF16Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_BGRA8888);
 }
 
-static void RGBAF16ConvertRGB565(uint8_t *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
-    const ProcFuncExtension &extension)
+template<AlphaConvertType ALPHA>
+static void RGBAF16ConvertABGR8888(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                   const ProcFuncExtension &extension)
 {
-    void* tmp = static_cast<void *>(destinationRow);
-    uint16_t *newDestinationRow = static_cast<uint16_t *>(tmp);
-    RGBAF16Convert(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_RGB565, extension);
+    uint32_t *newDestinationRow = static_cast<uint32_t *>(destinationRow);
+    RGBAF16Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_ABGR8888);
 }
 
-static map<string, ProcFuncType> g_procMapping;
-static mutex g_procMutex;
-
-static string MakeKey(uint32_t srcFormat, uint32_t dstFormat)
+template<AlphaConvertType ALPHA>
+static void RGBAF16ConvertRGB565(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth,
+                                 const ProcFuncExtension &extension)
 {
-    return to_string(srcFormat) + ("_") + to_string(dstFormat);
+    uint16_t *newDestinationRow = static_cast<uint16_t *>(destinationRow);
+    RGBAF16Convert<ALPHA>(newDestinationRow, sourceRow, sourceWidth, BRANCH_RGBAF16_TO_RGB565);
 }
 
-static void InitGrayProc()
-{
-    g_procMapping.emplace(MakeKey(GRAY_BIT, ARGB_8888), &BitConvertARGB8888);
-    g_procMapping.emplace(MakeKey(GRAY_BIT, RGB_565), &BitConvertRGB565);
-    g_procMapping.emplace(MakeKey(GRAY_BIT, ALPHA_8), &BitConvertGray);
-
-    g_procMapping.emplace(MakeKey(ALPHA_8, ARGB_8888), &GrayConvertARGB8888);
-    g_procMapping.emplace(MakeKey(ALPHA_8, RGB_565), &GrayConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(GRAY_ALPHA, ARGB_8888), &GrayAlphaConvertARGB8888);
-    g_procMapping.emplace(MakeKey(GRAY_ALPHA, ALPHA_8), &GrayAlphaConvertAlpha);
+// One instantiation of the row proc for each AlphaConvertType, in the order of the enum values.
+#define ALPHA_PROCS(proc)                                                                   \
+    {                                                                                       \
+        &proc<AlphaConvertType::NO_CONVERT>,                                                \
+        &proc<AlphaConvertType::PREMUL_CONVERT_UNPREMUL>,                                   \
+        &proc<AlphaConvertType::PREMUL_CONVERT_OPAQUE>,                                     \
+        &proc<AlphaConvertType::UNPREMUL_CONVERT_PREMUL>,                                   \
+        &proc<AlphaConvertType::UNPREMUL_CONVERT_OPAQUE>                                    \
+    }
+// Row procs which do not touch alpha serve every AlphaConvertType.
+#define SAME_PROCS(proc) { &proc, &proc, &proc, &proc, &proc }
+
+constexpr uint32_t ALPHA_CONVERT_TYPE_COUNT = static_cast<uint32_t>(AlphaConvertType::UNPREMUL_CONVERT_OPAQUE) + 1;
+
+struct ProcEntry {
+    uint32_t srcFormat;
+    uint32_t dstFormat;
+    ProcFuncType procs[ALPHA_CONVERT_TYPE_COUNT];  // indexed by AlphaConvertType
+};
+
+constexpr ProcEntry PROC_ENTRIES[] = {
+    { GRAY_BIT, ARGB_8888, SAME_PROCS(BitConvertARGB8888) },
+    { GRAY_BIT, RGB_565, SAME_PROCS(BitConvertRGB565) },
+    { GRAY_BIT, ALPHA_8, SAME_PROCS(BitConvertGray) },
+
+    { ALPHA_8, ARGB_8888, SAME_PROCS(GrayConvertARGB8888) },
+    { ALPHA_8, RGB_565, SAME_PROCS(GrayConvertRGB565) },
+
+    { GRAY_ALPHA, ARGB_8888, ALPHA_PROCS(GrayAlphaConvertARGB8888) },
+    { GRAY_ALPHA, ALPHA_8, ALPHA_PROCS(GrayAlphaConvertAlpha) },
+
+    { RGB_888, ARGB_8888, SAME_PROCS(RGB888ConvertARGB8888) },
+    { RGB_888, RGBA_8888, SAME_PROCS(RGB888ConvertRGBA8888) },
+    { RGB_888, BGRA_8888, SAME_PROCS(RGB888ConvertBGRA8888) },
+    { RGB_888, RGB_565, SAME_PROCS(RGB888ConvertRGB565) },
+    { RGB_888, RGBA_F16, SAME_PROCS(RGB888ConvertRGBAF16) },
+
+    { BGR_888, ARGB_8888, SAME_PROCS(BGR888ConvertARGB8888) },
+    { BGR_888, RGBA_8888, SAME_PROCS(BGR888ConvertRGBA8888) },
+    { BGR_888, BGRA_8888, SAME_PROCS(BGR888ConvertBGRA8888) },
+    { BGR_888, RGB_565, SAME_PROCS(BGR888ConvertRGB565) },
+    { BGR_888, RGBA_F16, SAME_PROCS(BGR888ConvertRGBAF16) },
+
+    { RGB_161616, ARGB_8888, SAME_PROCS(RGB161616ConvertARGB8888) },
+    { RGB_161616, ABGR_8888, SAME_PROCS(RGB161616ConvertABGR8888) },
+    { RGB_161616, RGBA_8888, SAME_PROCS(RGB161616ConvertRGBA8888) },
+    { RGB_161616, BGRA_8888, SAME_PROCS(RGB161616ConvertBGRA8888) },
+    { RGB_161616, RGB_565, SAME_PROCS(RGB161616ConvertRGB565) },
+    { RGB_161616, RGBA_F16, SAME_PROCS(RGB161616ConvertRGBAF16) },
+
+    { RGB_565, ARGB_8888, SAME_PROCS(RGB565ConvertARGB8888) },
+    { RGB_565, RGBA_8888, SAME_PROCS(RGB565ConvertRGBA8888) },
+    { RGB_565, BGRA_8888, SAME_PROCS(RGB565ConvertBGRA8888) },
+    { RGB_565, RGBA_F16, SAME_PROCS(RGB565ConvertRGBAF16) },
+
+    { RGBA_8888, RGBA_8888, ALPHA_PROCS(RGBA8888ConvertRGBA8888Alpha) },
+    { RGBA_8888, ARGB_8888, ALPHA_PROCS(RGBA8888ConvertARGB8888) },
+    { RGBA_8888, BGRA_8888, ALPHA_PROCS(RGBA8888ConvertBGRA8888) },
+    { RGBA_8888, RGB_565, ALPHA_PROCS(RGBA8888ConvertRGB565) },
+    { RGBA_8888, RGBA_F16, ALPHA_PROCS(RGBA8888ConvertRGBAF16) },
+
+    { BGRA_8888, RGBA_8888, ALPHA_PROCS(BGRA8888ConvertRGBA8888) },
+    { BGRA_8888, ARGB_8888, ALPHA_PROCS(BGRA8888ConvertARGB8888) },
+    { BGRA_8888, BGRA_8888, ALPHA_PROCS(BGRA8888ConvertBGRA8888Alpha) },
+    { BGRA_8888, RGB_565, ALPHA_PROCS(BGRA8888ConvertRGB565) },
+    { BGRA_8888, RGBA_F16, ALPHA_PROCS(BGRA8888ConvertRGBAF16) },
+
+    { ARGB_8888, RGBA_8888, ALPHA_PROCS(ARGB8888ConvertRGBA8888) },
+    { ARGB_8888, ARGB_8888, ALPHA_PROCS(ARGB8888ConvertARGB8888Alpha) },
+    { ARGB_8888, BGRA_8888, ALPHA_PROCS(ARGB8888ConvertBGRA8888) },
+    { ARGB_8888, RGB_565, ALPHA_PROCS(ARGB8888ConvertRGB565) },
+    { ARGB_8888, RGBA_F16, ALPHA_PROCS(ARGB8888ConvertRGBAF16) },
+
+    { RGBA_16161616, ARGB_8888, ALPHA_PROCS(RGBA16161616ConvertARGB8888) },
+    { RGBA_16161616, RGBA_8888, ALPHA_PROCS(RGBA16161616ConvertRGBA8888) },
+    { RGBA_16161616, BGRA_8888, ALPHA_PROCS(RGBA16161616ConvertBGRA8888) },
+    { RGBA_16161616, ABGR_8888, ALPHA_PROCS(RGBA16161616ConvertABGR8888) },
+    { RGBA_16161616, RGBA_F16, ALPHA_PROCS(RGBA16161616ConvertRGBAF16) },
+
+    { CMKY, ARGB_8888, SAME_PROCS(CMYKConvertARGB8888) },
+    { CMKY, RGBA_8888, SAME_PROCS(CMYKConvertRGBA8888) },
+    { CMKY, BGRA_8888, SAME_PROCS(CMYKConvertBGRA8888) },
+    { CMKY, ABGR_8888, SAME_PROCS(CMYKConvertABGR8888) },
+    { CMKY, RGB_565, SAME_PROCS(CMYKConvertRGB565) },
+
+    { RGBA_F16, ARGB_8888, ALPHA_PROCS(RGBAF16ConvertARGB8888) },
+    { RGBA_F16, RGBA_8888, ALPHA_PROCS(RGBAF16ConvertRGBA8888) },
+    { RGBA_F16, BGRA_8888, ALPHA_PROCS(RGBAF16ConvertBGRA8888) },
+    { RGBA_F16, ABGR_8888, ALPHA_PROCS(RGBAF16ConvertABGR8888) },
+    { RGBA_F16, RGB_565, ALPHA_PROCS(RGBAF16ConvertRGB565) },
+};
+
+#undef ALPHA_PROCS
+#undef SAME_PROCS
+
+// The position in this list is the dense index of a pixel format in the dispatch table.
+constexpr uint32_t PROC_FORMATS[] = {
+    GRAY_BIT, GRAY_ALPHA, ARGB_8888, RGB_565, RGBA_8888, BGRA_8888, RGB_888,
+    ALPHA_8, RGBA_F16, ABGR_8888, BGR_888, RGB_161616, RGBA_16161616, CMKY,
+};
+constexpr uint32_t PROC_FORMAT_COUNT = sizeof(PROC_FORMATS) / sizeof(PROC_FORMATS[0]);
+
+static constexpr uint32_t GetProcFormatIndex(uint32_t pixelFormat)
+{
+    for (uint32_t i = 0; i < PROC_FORMAT_COUNT; i++) {
+        if (PROC_FORMATS[i] == pixelFormat) {
+            return i;
+        }
+    }
+    return PROC_FORMAT_COUNT;
 }
 
-static void InitRGBProc()
-{
-    g_procMapping.emplace(MakeKey(RGB_888, ARGB_8888), &RGB888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_888, RGBA_8888), &RGB888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_888, BGRA_8888), &RGB888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGB_888, RGB_565), &RGB888ConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(BGR_888, ARGB_8888), &BGR888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(BGR_888, RGBA_8888), &BGR888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(BGR_888, BGRA_8888), &BGR888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(BGR_888, RGB_565), &BGR888ConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(RGB_161616, ARGB_8888), &RGB161616ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, ABGR_8888), &RGB161616ConvertABGR8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, RGBA_8888), &RGB161616ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, BGRA_8888), &RGB161616ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGB_161616, RGB_565), &RGB161616ConvertRGB565);
+struct ProcTable {
+    ProcFuncType procs[PROC_FORMAT_COUNT][PROC_FORMAT_COUNT][ALPHA_CONVERT_TYPE_COUNT];
+};
 
-    g_procMapping.emplace(MakeKey(RGB_565, ARGB_8888), &RGB565ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGB_565, RGBA_8888), &RGB565ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGB_565, BGRA_8888), &RGB565ConvertBGRA8888);
-}
-
-static void InitRGBAProc()
+static constexpr ProcTable MakeProcTable()
 {
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGBA_8888), &RGBA8888ConvertRGBA8888Alpha);
-    g_procMapping.emplace(MakeKey(RGBA_8888, ARGB_8888), &RGBA8888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGBA_8888, BGRA_8888), &RGBA8888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGB_565), &RGBA8888ConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGBA_8888), &BGRA8888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(BGRA_8888, ARGB_8888), &BGRA8888ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(BGRA_8888, BGRA_8888), &BGRA8888ConvertBGRA8888Alpha);
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGB_565), &BGRA8888ConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGBA_8888), &ARGB8888ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(ARGB_8888, ARGB_8888), &ARGB8888ConvertARGB8888Alpha);
-    g_procMapping.emplace(MakeKey(ARGB_8888, BGRA_8888), &ARGB8888ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGB_565), &ARGB8888ConvertRGB565);
-
-    g_procMapping.emplace(MakeKey(RGBA_16161616, ARGB_8888), &RGBA16161616ConvertARGB8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, RGBA_8888), &RGBA16161616ConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, BGRA_8888), &RGBA16161616ConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(RGBA_16161616, ABGR_8888), &RGBA16161616ConvertABGR8888);
+    ProcTable table = {};
+    for (const ProcEntry &entry : PROC_ENTRIES) {
+        const uint32_t src = GetProcFormatIndex(entry.srcFormat);
+        const uint32_t dst = GetProcFormatIndex(entry.dstFormat);
+        for (uint32_t alpha = 0; alpha < ALPHA_CONVERT_TYPE_COUNT; alpha++) {
+            table.procs[src][dst][alpha] = entry.procs[alpha];
+        }
+    }
+    return table;
 }
 
-static void InitCMYKProc()
-{
-    g_procMapping.emplace(MakeKey(CMKY, ARGB_8888), &CMYKConvertARGB8888);
-    g_procMapping.emplace(MakeKey(CMKY, RGBA_8888), &CMYKConvertRGBA8888);
-    g_procMapping.emplace(MakeKey(CMKY, BGRA_8888), &CMYKConvertBGRA8888);
-    g_procMapping.emplace(MakeKey(CMKY, ABGR_8888), &CMYKConvertABGR8888);
-    g_procMapping.emplace(MakeKey(CMKY, RGB_565), &CMYKConvertRGB565);
-}
+// Built by the compiler, lookups need neither a lock nor an allocation.
+static constexpr ProcTable PROC_TABLE = MakeProcTable();
 
-static void InitF16Proc()
+static ProcFuncType GetProcFuncType(uint32_t srcPixelFormat, uint32_t dstPixelFormat,
+                                    AlphaConvertType alphaConvertType)
 {
-    g_procMapping.emplace(MakeKey(RGBA_F16, ARGB_8888),
-        reinterpret_cast<ProcFuncType>(&RGBAF16ConvertARGB8888));
-    g_procMapping.emplace(MakeKey(RGBA_F16, RGBA_8888),
-        reinterpret_cast<ProcFuncType>(&RGBAF16ConvertRGBA8888));
-    g_procMapping.emplace(MakeKey(RGBA_F16, BGRA_8888),
-        reinterpret_cast<ProcFuncType>(&RGBAF16ConvertBGRA8888));
-    g_procMapping.emplace(MakeKey(RGBA_F16, ABGR_8888),
-        reinterpret_cast<ProcFuncType>(&RGBAF16ConvertABGR8888));
-    g_procMapping.emplace(MakeKey(RGBA_F16, RGB_565),
-        reinterpret_cast<ProcFuncType>(&RGBAF16ConvertRGB565));
-
-    g_procMapping.emplace(MakeKey(BGR_888, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&BGR888ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(RGB_888, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&RGB888ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(RGB_161616, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&RGB161616ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(ARGB_8888, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&ARGB8888ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(RGBA_8888, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&RGBA8888ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(BGRA_8888, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&BGRA8888ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(RGB_565, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&RGB565ConvertRGBAF16));
-    g_procMapping.emplace(MakeKey(RGBA_16161616, RGBA_F16),
-        reinterpret_cast<ProcFuncType>(&RGBA16161616ConvertRGBAF16));
-}
-
-static ProcFuncType GetProcFuncType(uint32_t srcPixelFormat, uint32_t dstPixelFormat)
-{
-    unique_lock<mutex> guard(g_procMutex);
-    if (g_procMapping.empty()) {
-        InitGrayProc();
-        InitRGBProc();
-        InitRGBAProc();
-        InitCMYKProc();
-        InitF16Proc();
-    }
-    guard.unlock();
-    string procKey = MakeKey(srcPixelFormat, dstPixelFormat);
-    map<string, ProcFuncType>::iterator iter = g_procMapping.find(procKey);
-    if (iter != g_procMapping.end()) {
-        return iter->second;
+    const uint32_t src = GetProcFormatIndex(srcPixelFormat);
+    const uint32_t dst = GetProcFormatIndex(dstPixelFormat);
+    const uint32_t alpha = static_cast<uint32_t>(alphaConvertType);
+    if (src >= PROC_FORMAT_COUNT || dst >= PROC_FORMAT_COUNT || alpha >= ALPHA_CONVERT_TYPE_COUNT) {
+        return nullptr;
     }
-    return nullptr;
+    return PROC_TABLE.procs[src][dst][alpha];
 }
 
 PixelConvert::PixelConvert(ProcFuncType funcPtr, ProcFuncExtension extension, bool isNeedConvert)
@@ -1062,13 +1134,13 @@ std::unique_ptr<PixelConvert> PixelConvert::Create(const ImageInfo &srcInfo, con
     }
     uint32_t srcFormat = static_cast<uint32_t>(srcInfo.pixelFormat);
     uint32_t dstFormat = static_cast<uint32_t>(dstInfo.pixelFormat);
-    ProcFuncType funcPtr = GetProcFuncType(srcFormat, dstFormat);
+    ProcFuncExtension extension;
+    extension.alphaConvertType = GetAlphaConvertType(srcInfo.alphaType, dstInfo.alphaType);
+    ProcFuncType funcPtr = GetProcFuncType(srcFormat, dstFormat, extension.alphaConvertType);
     if (funcPtr == nullptr) {
         HiLog::Error(LABEL, "not found convert function. pixelFormat %{public}u -> %{public}u", srcFormat, dstFormat);
         return nullptr;
     }
-    ProcFuncExtension extension;
-    extension.alphaConvertType = GetAlphaConvertType(srcInfo.alphaType, dstInfo.alphaType);
     bool isNeedConvert = true;
     if ((srcInfo.pixelFormat == dstInfo.pixelFormat) && (extension.alphaConvertType == AlphaConvertType::NO_CONVERT)) {
         isNeedConvert = false;
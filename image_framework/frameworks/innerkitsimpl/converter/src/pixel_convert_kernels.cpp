@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_convert_kernels.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_CONVERT_SSE2
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#define PIXEL_CONVERT_NEON
+#endif
+
+namespace {
+constexpr uint32_t CHANNEL_R = 0;
+constexpr uint32_t CHANNEL_G = 1;
+constexpr uint32_t CHANNEL_B = 2;
+constexpr uint32_t CHANNEL_A = 3;
+constexpr uint32_t CHANNEL_NUM = 4;
+constexpr uint32_t TABLE_SIZE = 256;
+constexpr uint32_t PREMUL_ROUND = 0x80;
+constexpr uint32_t PREMUL_SHIFT = 8;
+/*
+ * RECIP_TABLE[a] = ceil(255 * 2^16 / a), so (min(c, a) * RECIP_TABLE[a] + 2^15) >> 16 equals
+ * Unpremul255(c, a) for every 8 bit c and a. 16 is the smallest shift that is exact for all of them.
+ */
+constexpr uint32_t RECIP_SHIFT = 16;
+constexpr uint32_t RECIP_ROUND = 1u << (RECIP_SHIFT - 1);
+constexpr uint32_t RECIP_LOW_MASK = 0xFFFF;
+constexpr uint32_t RECIP_LOW_ROUND_SHIFT = 15;
+constexpr uint32_t RGB565_R_SHIFT = 3;
+constexpr uint32_t RGB565_G_SHIFT = 5;
+constexpr uint32_t RGB565_B_SHIFT = 8;
+constexpr uint32_t RGB565_R_MASK = 0x001F;
+constexpr uint32_t RGB565_G_MASK = 0x07E0;
+constexpr uint32_t RGB565_B_MASK = 0xF800;
+constexpr uint32_t LANE_16_SHIFT = 16;
+constexpr uint32_t SSE_PIXELS = 4;
+constexpr uint32_t SSE_PAIR_OFFSET = 2;
+constexpr uint32_t NEON_PIXELS = 16;
+constexpr uint32_t NEON_HALF_PIXELS = 8;
+constexpr uint32_t SHUFFLE_LANE_BITS = 2;
+constexpr uint32_t RGB888_GATHER_OFFSET_1 = 3;
+constexpr uint32_t RGB888_GATHER_OFFSET_2 = 6;
+constexpr uint32_t RGB888_GATHER_OFFSET_3 = 9;
+}
+
+namespace OHOS {
+namespace Media {
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+constexpr bool IS_LITTLE_ENDIAN = true;
+#else
+constexpr bool IS_LITTLE_ENDIAN = false;
+#endif
+
+// Byte layouts of the formats, RGB_888 and BGR_888 are read as RGBA and BGRA with an opaque alpha.
+enum class PixelLayout : uint32_t {
+    RGBA = 0,
+    BGRA,
+    ARGB,
+    RGB,
+    BGR,
+    RGB565,
+};
+
+struct RecipTable {
+    uint32_t value[TABLE_SIZE];
+};
+
+static constexpr RecipTable MakeRecipTable()
+{
+    RecipTable table {};
+    for (uint32_t alpha = 1; alpha < TABLE_SIZE; alpha++) {
+        table.value[alpha] = ((ALPHA_OPAQUE << RECIP_SHIFT) + alpha - 1) / alpha;
+    }
+    return table;
+}
+
+static constexpr RecipTable RECIP_TABLE = MakeRecipTable();
+
+// Byte position of a channel inside a pixel, RGB_565 is packed from the RGBA order.
+static constexpr uint32_t ChannelIndex(PixelLayout layout, uint32_t channel)
+{
+    if (layout == PixelLayout::BGRA || layout == PixelLayout::BGR) {
+        return (channel == CHANNEL_A) ? CHANNEL_A : (CHANNEL_B - channel);
+    }
+    if (layout == PixelLayout::ARGB) {
+        return (channel + 1) % CHANNEL_NUM;
+    }
+    return channel;
+}
+
+// The channel stored at a byte position, the inverse of ChannelIndex.
+static constexpr uint32_t ChannelAt(PixelLayout layout, uint32_t index)
+{
+    if (layout == PixelLayout::BGRA || layout == PixelLayout::BGR) {
+        return (index == CHANNEL_A) ? CHANNEL_A : (CHANNEL_B - index);
+    }
+    if (layout == PixelLayout::ARGB) {
+        return (index + CHANNEL_A) % CHANNEL_NUM;
+    }
+    return index;
+}
+
+static constexpr bool IsThreeBytes(PixelLayout layout)
+{
+    return layout == PixelLayout::RGB || layout == PixelLayout::BGR;
+}
+
+static constexpr uint32_t PixelBytes(PixelLayout layout)
+{
+    return IsThreeBytes(layout) ? SIZE_3_BYTE : SIZE_4_BYTE;
+}
+
+// A 3 byte source has no alpha, its alpha channel is always written opaque.
+static constexpr AlphaConvertType KernelAlpha(PixelLayout src, AlphaConvertType alphaType)
+{
+    return IsThreeBytes(src) ? AlphaConvertType::UNPREMUL_CONVERT_OPAQUE : alphaType;
+}
+
+#ifdef PIXEL_CONVERT_SSE2
+static inline int32_t Load32(const uint8_t *src)
+{
+    int32_t value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+// Source byte position feeding each 16 bit lane of the destination pixel.
+template <PixelLayout SRC, PixelLayout DST>
+static constexpr int ShuffleImm()
+{
+    constexpr PixelLayout order = (DST == PixelLayout::RGB565) ? PixelLayout::RGBA : DST;
+    int imm = 0;
+    for (uint32_t index = 0; index < CHANNEL_NUM; index++) {
+        imm |= static_cast<int>(ChannelIndex(SRC, ChannelAt(order, index)) << (index * SHUFFLE_LANE_BITS));
+    }
+    return imm;
+}
+
+template <PixelLayout SRC>
+static inline __m128i LoadSse2(const uint8_t *src)
+{
+    if (IsThreeBytes(SRC)) {
+        // the 4th byte belongs to the next pixel, the caller keeps one more pixel after the block
+        return _mm_setr_epi32(Load32(src), Load32(src + RGB888_GATHER_OFFSET_1),
+                              Load32(src + RGB888_GATHER_OFFSET_2), Load32(src + RGB888_GATHER_OFFSET_3));
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+}
+
+// x holds two pixels as 16 bit lanes, pair points to the source bytes of the same two pixels.
+template <PixelLayout SRC, AlphaConvertType ALPHA>
+static inline __m128i AlphaConvertSse2(__m128i x, const uint8_t *pair)
+{
+    constexpr uint32_t alphaIndex = ChannelIndex(SRC, CHANNEL_A);
+    constexpr int alphaImm = static_cast<int>(alphaIndex * 0x55);
+    const __m128i alphaLanes = _mm_slli_epi64(_mm_set1_epi64x(RECIP_LOW_MASK), alphaIndex * LANE_16_SHIFT);
+    const __m128i opaque = _mm_and_si128(alphaLanes, _mm_set1_epi16(ALPHA_OPAQUE));
+    if (ALPHA == AlphaConvertType::UNPREMUL_CONVERT_OPAQUE) {
+        return _mm_or_si128(x, opaque);
+    }
+    if (ALPHA == AlphaConvertType::NO_CONVERT) {
+        return x;
+    }
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, alphaImm), alphaImm);
+    __m128i result;
+    if (ALPHA == AlphaConvertType::UNPREMUL_CONVERT_PREMUL) {
+        __m128i product = _mm_add_epi16(_mm_mullo_epi16(x, alpha), _mm_set1_epi16(PREMUL_ROUND));
+        result = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, PREMUL_SHIFT)), PREMUL_SHIFT);
+    } else {
+        // min(c, a) * recip fits 24 bits, split the reciprocal so all products stay in 16 bit lanes
+        uint32_t recip0 = RECIP_TABLE.value[pair[alphaIndex]];
+        uint32_t recip1 = RECIP_TABLE.value[pair[SIZE_4_BYTE + alphaIndex]];
+        short hi0 = static_cast<short>(recip0 >> RECIP_SHIFT);
+        short hi1 = static_cast<short>(recip1 >> RECIP_SHIFT);
+        short lo0 = static_cast<short>(recip0 & RECIP_LOW_MASK);
+        short lo1 = static_cast<short>(recip1 & RECIP_LOW_MASK);
+        __m128i recipHi = _mm_set_epi16(hi1, hi1, hi1, hi1, hi0, hi0, hi0, hi0);
+        __m128i recipLo = _mm_set_epi16(lo1, lo1, lo1, lo1, lo0, lo0, lo0, lo0);
+        __m128i color = _mm_min_epi16(x, alpha);
+        __m128i low = _mm_mullo_epi16(color, recipLo);
+        result = _mm_add_epi16(_mm_mullo_epi16(color, recipHi), _mm_mulhi_epu16(color, recipLo));
+        result = _mm_add_epi16(result, _mm_srli_epi16(low, RECIP_LOW_ROUND_SHIFT));
+    }
+    result = _mm_or_si128(_mm_and_si128(alphaLanes, x), _mm_andnot_si128(alphaLanes, result));
+    if (ALPHA == AlphaConvertType::PREMUL_CONVERT_OPAQUE) {
+        result = _mm_or_si128(result, opaque);
+    }
+    return result;
+}
+
+template <int IMM>
+static inline __m128i ShuffleSse2(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, IMM), IMM);
+}
+
+// Four RGBA pixels to RGB_565, the same bit order as FillRGB565 on little endian.
+static inline void StoreRGB565Sse2(uint16_t *dst, __m128i rgba)
+{
+    __m128i r = _mm_and_si128(_mm_srli_epi32(rgba, RGB565_R_SHIFT), _mm_set1_epi32(RGB565_R_MASK));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(rgba, RGB565_G_SHIFT), _mm_set1_epi32(RGB565_G_MASK));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(rgba, RGB565_B_SHIFT), _mm_set1_epi32(RGB565_B_MASK));
+    __m128i packed = _mm_or_si128(_mm_or_si128(r, g), b);
+    // sign extend the low half so the saturating pack keeps all 16 bits
+    packed = _mm_srai_epi32(_mm_slli_epi32(packed, LANE_16_SHIFT), LANE_16_SHIFT);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packs_epi32(packed, packed));
+}
+
+template <PixelLayout SRC, PixelLayout DST, AlphaConvertType ALPHA>
+static uint32_t ConvertRowSse2(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth)
+{
+    constexpr uint32_t srcBytes = PixelBytes(SRC);
+    constexpr uint32_t extra = IsThreeBytes(SRC) ? 1 : 0;
+    constexpr int imm = ShuffleImm<SRC, DST>();
+    constexpr int identity = ShuffleImm<PixelLayout::RGBA, PixelLayout::RGBA>();
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t i = 0;
+    for (; i + SSE_PIXELS + extra <= sourceWidth; i += SSE_PIXELS) {
+        const uint8_t *block = sourceRow + i * srcBytes;
+        __m128i pixels = LoadSse2<SRC>(block);
+        __m128i lo = AlphaConvertSse2<SRC, ALPHA>(_mm_unpacklo_epi8(pixels, zero), block);
+        __m128i hi = AlphaConvertSse2<SRC, ALPHA>(_mm_unpackhi_epi8(pixels, zero),
+                                                  block + SSE_PAIR_OFFSET * srcBytes);
+        if (imm != identity) {
+            lo = ShuffleSse2<imm>(lo);
+            hi = ShuffleSse2<imm>(hi);
+        }
+        __m128i out = _mm_packus_epi16(lo, hi);
+        if (DST == PixelLayout::RGB565) {
+            StoreRGB565Sse2(static_cast<uint16_t *>(destinationRow) + i, out);
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(static_cast<uint32_t *>(destinationRow) + i), out);
+        }
+    }
+    return i;
+}
+#endif
+
+#ifdef PIXEL_CONVERT_NEON
+static inline uint8x16_t PremulNeon(uint8x16_t color, uint8x16_t alpha)
+{
+    const uint16x8_t round = vdupq_n_u16(PREMUL_ROUND);
+    uint16x8_t lo = vaddq_u16(vmull_u8(vget_low_u8(color), vget_low_u8(alpha)), round);
+    uint16x8_t hi = vaddq_u16(vmull_u8(vget_high_u8(color), vget_high_u8(alpha)), round);
+    return vcombine_u8(vshrn_n_u16(vaddq_u16(lo, vshrq_n_u16(lo, PREMUL_SHIFT)), PREMUL_SHIFT),
+                       vshrn_n_u16(vaddq_u16(hi, vshrq_n_u16(hi, PREMUL_SHIFT)), PREMUL_SHIFT));
+}
+
+static inline uint8x8_t UnpremulHalfNeon(uint8x8_t color, uint16x8_t recipHi, uint16x8_t recipLo)
+{
+    const uint32x4_t round = vdupq_n_u32(RECIP_ROUND);
+    uint16x8_t c = vmovl_u8(color);
+    uint16x4_t lo = vshrn_n_u32(vaddq_u32(vmull_u16(vget_low_u16(c), vget_low_u16(recipLo)), round),
+                                RECIP_SHIFT);
+    uint16x4_t hi = vshrn_n_u32(vaddq_u32(vmull_u16(vget_high_u16(c), vget_high_u16(recipLo)), round),
+                                RECIP_SHIFT);
+    return vmovn_u16(vaddq_u16(vmulq_u16(c, recipHi), vcombine_u16(lo, hi)));
+}
+
+// channels are in R, G, B, A order
+template <AlphaConvertType ALPHA>
+static inline void AlphaConvertNeon(uint8x16_t channels[CHANNEL_NUM])
+{
+    uint8x16_t alpha = channels[CHANNEL_A];
+    if (ALPHA == AlphaConvertType::UNPREMUL_CONVERT_PREMUL) {
+        for (uint32_t c = CHANNEL_R; c < CHANNEL_A; c++) {
+            channels[c] = PremulNeon(channels[c], alpha);
+        }
+    } else if (ALPHA == AlphaConvertType::PREMUL_CONVERT_UNPREMUL ||
+               ALPHA == AlphaConvertType::PREMUL_CONVERT_OPAQUE) {
+        uint8_t alphas[NEON_PIXELS];
+        uint16_t recipHi[NEON_PIXELS];
+        uint16_t recipLo[NEON_PIXELS];
+        vst1q_u8(alphas, alpha);
+        for (uint32_t i = 0; i < NEON_PIXELS; i++) {
+            uint32_t recip = RECIP_TABLE.value[alphas[i]];
+            recipHi[i] = static_cast<uint16_t>(recip >> RECIP_SHIFT);
+            recipLo[i] = static_cast<uint16_t>(recip & RECIP_LOW_MASK);
+        }
+        uint16x8_t hi0 = vld1q_u16(recipHi);
+        uint16x8_t hi1 = vld1q_u16(recipHi + NEON_HALF_PIXELS);
+        uint16x8_t lo0 = vld1q_u16(recipLo);
+        uint16x8_t lo1 = vld1q_u16(recipLo + NEON_HALF_PIXELS);
+        for (uint32_t c = CHANNEL_R; c < CHANNEL_A; c++) {
+            uint8x16_t color = vminq_u8(channels[c], alpha);
+            channels[c] = vcombine_u8(UnpremulHalfNeon(vget_low_u8(color), hi0, lo0),
+                                      UnpremulHalfNeon(vget_high_u8(color), hi1, lo1));
+        }
+    }
+    if (ALPHA == AlphaConvertType::PREMUL_CONVERT_OPAQUE || ALPHA == AlphaConvertType::UNPREMUL_CONVERT_OPAQUE) {
+        channels[CHANNEL_A] = vdupq_n_u8(ALPHA_OPAQUE);
+    }
+}
+
+static inline uint16x8_t PackRGB565Neon(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+    uint16x8_t r16 = vmovl_u8(vshr_n_u8(r, SHIFT_3_BIT));
+    uint16x8_t g16 = vshlq_n_u16(vmovl_u8(vshr_n_u8(g, SHIFT_2_BIT)), SHIFT_5_BIT);
+    uint16x8_t b16 = vshlq_n_u16(vmovl_u8(vshr_n_u8(b, SHIFT_3_BIT)), SHIFT_11_BIT);
+    return vorrq_u16(vorrq_u16(r16, g16), b16);
+}
+
+template <PixelLayout SRC, PixelLayout DST, AlphaConvertType ALPHA>
+static uint32_t ConvertRowNeon(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth)
+{
+    constexpr uint32_t srcBytes = PixelBytes(SRC);
+    uint32_t i = 0;
+    for (; i + NEON_PIXELS <= sourceWidth; i += NEON_PIXELS) {
+        const uint8_t *block = sourceRow + i * srcBytes;
+        uint8x16_t channels[CHANNEL_NUM];
+        if (IsThreeBytes(SRC)) {
+            uint8x16x3_t pixels = vld3q_u8(block);
+            for (uint32_t c = CHANNEL_R; c < CHANNEL_A; c++) {
+                channels[c] = pixels.val[ChannelIndex(SRC, c)];
+            }
+            channels[CHANNEL_A] = vdupq_n_u8(ALPHA_OPAQUE);
+        } else {
+            uint8x16x4_t pixels = vld4q_u8(block);
+            for (uint32_t c = CHANNEL_R; c < CHANNEL_NUM; c++) {
+                channels[c] = pixels.val[ChannelIndex(SRC, c)];
+            }
+        }
+        AlphaConvertNeon<ALPHA>(channels);
+        if (DST == PixelLayout::RGB565) {
+            uint16_t *dst = static_cast<uint16_t *>(destinationRow) + i;
+            vst1q_u16(dst, PackRGB565Neon(vget_low_u8(channels[CHANNEL_R]), vget_low_u8(channels[CHANNEL_G]),
+                                          vget_low_u8(channels[CHANNEL_B])));
+            vst1q_u16(dst + NEON_HALF_PIXELS, PackRGB565Neon(vget_high_u8(channels[CHANNEL_R]),
+                                                             vget_high_u8(channels[CHANNEL_G]),
+                                                             vget_high_u8(channels[CHANNEL_B])));
+        } else {
+            uint8x16x4_t out;
+            for (uint32_t index = 0; index < CHANNEL_NUM; index++) {
+                out.val[index] = channels[ChannelAt(DST, index)];
+            }
+            vst4q_u8(reinterpret_cast<uint8_t *>(static_cast<uint32_t *>(destinationRow) + i), out);
+        }
+    }
+    return i;
+}
+#endif
+
+#if defined(PIXEL_CONVERT_SSE2) || defined(PIXEL_CONVERT_NEON)
+template <PixelLayout SRC, PixelLayout DST, AlphaConvertType ALPHA>
+static uint32_t ConvertRow(void *destinationRow, const uint8_t *sourceRow, uint32_t sourceWidth)
+{
+#ifdef PIXEL_CONVERT_SSE2
+    return ConvertRowSse2<SRC, DST, KernelAlpha(SRC, ALPHA)>(destinationRow, sourceRow, sourceWidth);
+#else
+    return ConvertRowNeon<SRC, DST, KernelAlpha(SRC, ALPHA)>(destinationRow, sourceRow, sourceWidth);
+#endif
+}
+
+template <PixelLayout SRC, PixelLayout DST>
+static PixelConvertKernels::RowKernel SelectAlpha(AlphaConvertType alphaType)
+{
+    switch (alphaType) {
+        case AlphaConvertType::NO_CONVERT:
+            return ConvertRow<SRC, DST, AlphaConvertType::NO_CONVERT>;
+        case AlphaConvertType::PREMUL_CONVERT_UNPREMUL:
+            return ConvertRow<SRC, DST, AlphaConvertType::PREMUL_CONVERT_UNPREMUL>;
+        case AlphaConvertType::PREMUL_CONVERT_OPAQUE:
+            return ConvertRow<SRC, DST, AlphaConvertType::PREMUL_CONVERT_OPAQUE>;
+        case AlphaConvertType::UNPREMUL_CONVERT_PREMUL:
+            return ConvertRow<SRC, DST, AlphaConvertType::UNPREMUL_CONVERT_PREMUL>;
+        case AlphaConvertType::UNPREMUL_CONVERT_OPAQUE:
+            return ConvertRow<SRC, DST, AlphaConvertType::UNPREMUL_CONVERT_OPAQUE>;
+        default:
+            return nullptr;
+    }
+}
+
+template <PixelLayout SRC>
+static PixelConvertKernels::RowKernel SelectDst(uint32_t dstFormat, AlphaConvertType alphaType)
+{
+    switch (dstFormat) {
+        case RGBA_8888:
+            return SelectAlpha<SRC, PixelLayout::RGBA>(alphaType);
+        case BGRA_8888:
+            return SelectAlpha<SRC, PixelLayout::BGRA>(alphaType);
+        case ARGB_8888:
+            return SelectAlpha<SRC, PixelLayout::ARGB>(alphaType);
+        case RGB_565:
+            // the 3 byte procs pack RGB_565 in their own bit order
+            if (IsThreeBytes(SRC) || !IS_LITTLE_ENDIAN) {
+                return nullptr;
+            }
+            return SelectAlpha<SRC, PixelLayout::RGB565>(alphaType);
+        default:
+            return nullptr;
+    }
+}
+#endif
+
+PixelConvertKernels::RowKernel PixelConvertKernels::GetRowKernel(uint32_t srcFormat, uint32_t dstFormat,
+                                                                 AlphaConvertType alphaType)
+{
+#if defined(PIXEL_CONVERT_SSE2) || defined(PIXEL_CONVERT_NEON)
+    switch (srcFormat) {
+        case RGBA_8888:
+            return SelectDst<PixelLayout::RGBA>(dstFormat, alphaType);
+        case BGRA_8888:
+            return SelectDst<PixelLayout::BGRA>(dstFormat, alphaType);
+        case ARGB_8888:
+            return SelectDst<PixelLayout::ARGB>(dstFormat, alphaType);
+        case RGB_888:
+            return SelectDst<PixelLayout::RGB>(dstFormat, AlphaConvertType::NO_CONVERT);
+        case BGR_888:
+            return SelectDst<PixelLayout::BGR>(dstFormat, AlphaConvertType::NO_CONVERT);
+        default:
+            return nullptr;
+    }
+#else
+    return nullptr;
+#endif
+}
+
+const char *PixelConvertKernels::GetKernelName()
+{
+#ifdef PIXEL_CONVERT_SSE2
+    return "sse2";
+#elif defined(PIXEL_CONVERT_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+uint32_t PixelConvertKernels::UnpremulByTable(uint32_t colorComponent, uint32_t alpha)
+{
+    if (colorComponent > ALPHA_OPAQUE || alpha > ALPHA_OPAQUE) {
+        return 0;
+    }
+    uint32_t color = (colorComponent < alpha) ? colorComponent : alpha;
+    return (color * RECIP_TABLE.value[alpha] + RECIP_ROUND) >> RECIP_SHIFT;
+}
+} // namespace Media
+} // namespace OHOS
@@ -17,6 +17,7 @@
 #include <unistd.h>
 #include "basic_transformer.h"
 #include "image_log.h"
+#include "image_metrics.h"
 #include "image_trace.h"
 #include "image_utils.h"
 #include "media_errors.h"
@@ -41,6 +42,7 @@ constexpr uint8_t HALF = 2;
 
 uint32_t PostProc::DecodePostProc(const DecodeOptions &opts, PixelMap &pixelMap, FinalOutputStep finalOutputStep)
 {
+    ImageMetricsSpan span(SPAN_POST_PROC);
     ImageInfo srcImageInfo;
     pixelMap.GetImageInfo(srcImageInfo);
     ImageInfo dstImageInfo;
@@ -257,6 +259,7 @@ uint32_t PostProc::ConvertProc(const Rect &cropRect, ImageInfo &dstImageInfo, Pi
     if (ret != NEED_NEXT) {
         return ret;
     }
+    ImageMetricsSpan span(SPAN_CONVERT);
 
     // we suppose a quick method to scanline in mostly seen cases: NO CROP && hasPixelConvert
     if (GetCropValue(cropRect, srcImageInfo.size) == CropValue::NOCROP
@@ -335,6 +338,7 @@ uint32_t PostProc::AllocBuffer(ImageInfo imageInfo, uint8_t **resultData, uint64
             return ERR_IMAGE_CROP;
         }
     }
+    ImageMetrics::AddAllocation(bufferSize);
     return SUCCESS;
 }
 
@@ -446,6 +450,11 @@ void PostProc::ConvertPixelMapToPixmapInfo(PixelMap &pixelMap, PixmapInfo &pixma
 
 bool PostProc::RotatePixelMap(float rotateDegrees, PixelMap &pixelMap)
 {
+    OrthogonalOp op = OrthogonalOp::NONE;
+    if (OrthogonalTransformer::GetRotateOp(rotateDegrees, op) &&
+        OrthogonalTransformer::IsSupported(pixelMap.GetPixelFormat())) {
+        return OrthogonalTransform(op, pixelMap);
+    }
     BasicTransformer trans;
     PixmapInfo input(false);
     ConvertPixelMapToPixmapInfo(pixelMap, input);
@@ -474,6 +483,10 @@ bool PostProc::ScalePixelMap(float scaleX, float scaleY, PixelMap &pixelMap)
     if ((fabs(scaleX - 1.0f) < EPSILON) && (fabs(scaleY - 1.0f) < EPSILON)) {
         return true;
     }
+    // a scale of -1 only mirrors the pixels
+    if ((fabs(fabs(scaleX) - 1.0f) < EPSILON) && (fabs(fabs(scaleY) - 1.0f) < EPSILON)) {
+        return FlipPixelMap(scaleX < 0, scaleY < 0, pixelMap);
+    }
     BasicTransformer trans;
     PixmapInfo input(false);
     ConvertPixelMapToPixmapInfo(pixelMap, input);
@@ -481,6 +494,62 @@ bool PostProc::ScalePixelMap(float scaleX, float scaleY, PixelMap &pixelMap)
     trans.SetScaleParam(scaleX, scaleY);
     return Transform(trans, input, pixelMap);
 }
+bool PostProc::FlipPixelMap(bool xAxis, bool yAxis, PixelMap &pixelMap)
+{
+    OrthogonalOp op = OrthogonalTransformer::GetFlipOp(xAxis, yAxis);
+    if (OrthogonalTransformer::IsSupported(pixelMap.GetPixelFormat())) {
+        return OrthogonalTransform(op, pixelMap);
+    }
+    if (op == OrthogonalOp::NONE) {
+        return true;
+    }
+    BasicTransformer trans;
+    PixmapInfo input(false);
+    ConvertPixelMapToPixmapInfo(pixelMap, input);
+    trans.SetScaleParam(xAxis ? -1.0f : 1.0f, yAxis ? -1.0f : 1.0f);
+    return Transform(trans, input, pixelMap);
+}
+
+bool PostProc::OrthogonalTransform(OrthogonalOp op, PixelMap &pixelMap)
+{
+    if (op == OrthogonalOp::NONE) {
+        return true;
+    }
+    ImageInfo srcImageInfo;
+    pixelMap.GetImageInfo(srcImageInfo);
+    uint8_t *srcData = const_cast<uint8_t *>(pixelMap.GetPixels());
+    int32_t pixelBytes = pixelMap.GetPixelBytes();
+    if (srcData == nullptr || pixelBytes <= 0) {
+        IMAGE_LOGE("[PostProc]orthogonal transform: invalid pixel map.");
+        return false;
+    }
+    if (OrthogonalTransformer::CanTransformInPlace(op, srcImageInfo.size)) {
+        return OrthogonalTransformer::Transform(op, srcData, srcData, srcImageInfo.size, pixelBytes);
+    }
+
+    ImageInfo dstImageInfo = srcImageInfo;
+    dstImageInfo.size = OrthogonalTransformer::GetDstSize(op, srcImageInfo.size);
+    uint8_t *dstData = nullptr;
+    uint64_t bufferSize = 0;
+    int fd = 0;
+    if (AllocBuffer(dstImageInfo, &dstData, bufferSize, fd) != SUCCESS) {
+        ReleaseBuffer(decodeOpts_.allocatorType, fd, bufferSize, &dstData);
+        return false;
+    }
+    if (!OrthogonalTransformer::Transform(op, srcData, dstData, srcImageInfo.size, pixelBytes) ||
+        pixelMap.SetImageInfo(dstImageInfo) != SUCCESS) {
+        ReleaseBuffer(decodeOpts_.allocatorType, fd, bufferSize, &dstData);
+        return false;
+    }
+    void *context = nullptr;
+    if (decodeOpts_.allocatorType == AllocatorType::SHARE_MEM_ALLOC) {
+        auto fdPtr = std::make_unique<int32_t>(fd);
+        context = fdPtr.release();
+    }
+    pixelMap.SetPixelsAddr(dstData, context, bufferSize, decodeOpts_.allocatorType, nullptr);
+    return true;
+}
+
 bool PostProc::TranslatePixelMap(float tX, float tY, PixelMap &pixelMap)
 {
     BasicTransformer trans;
@@ -0,0 +1,548 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "yuv420sp_converter.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "image_log.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define YUV420SP_SSE2
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#define YUV420SP_NEON
+#endif
+
+namespace {
+constexpr int32_t YUV_SHIFT = 13;
+constexpr int32_t YUV_ROUND = 1 << (YUV_SHIFT - 1);
+constexpr float YUV_SCALE = 1 << YUV_SHIFT;
+constexpr int32_t UV_BIAS = 128;
+constexpr int32_t CHANNEL_MAX = 255;
+constexpr int32_t PIXELS_PER_UV = 2;
+constexpr int32_t RGBA_BYTES = 4;
+constexpr int32_t RGB565_BYTES = 2;
+constexpr uint32_t RGB565_R_SHIFT = 11;
+constexpr uint32_t RGB565_G_SHIFT = 5;
+constexpr uint32_t RGB565_R_DROP = 3;
+constexpr uint32_t RGB565_G_DROP = 2;
+constexpr uint32_t RGB565_B_DROP = 3;
+// 8 bit channels move to their 565 positions in 16 bit lanes
+constexpr int32_t RGB565_R_LANE_SHIFT = 8;
+constexpr int32_t RGB565_G_LANE_SHIFT = 3;
+constexpr uint32_t ROWS_PER_UV = 2;
+// Smaller images finish before the threads are started.
+constexpr uint64_t PARALLEL_MIN_PIXELS = 1024 * 1024;
+constexpr uint32_t MAX_THREADS = 4;
+#if defined(YUV420SP_SSE2) || defined(YUV420SP_NEON)
+constexpr int32_t SIMD_PIXELS = 16;
+#endif
+}
+
+namespace OHOS {
+namespace Media {
+struct YuvMatrixCoefs {
+    float yScale;
+    int16_t yOffset;
+    float rv;
+    float gu;
+    float gv;
+    float bu;
+};
+
+// Rec. ITU-R BT.601 and BT.709, the limited range expands luma [16, 235] and chroma [16, 240].
+static const YuvMatrixCoefs BT601_FULL_COEFS = { 1.0f, 0, 1.402f, 0.344136f, 0.714136f, 1.772f };
+static const YuvMatrixCoefs BT601_LIMITED_COEFS = { 1.164383f, 16, 1.596027f, 0.391762f, 0.812968f, 2.017232f };
+static const YuvMatrixCoefs BT709_FULL_COEFS = { 1.0f, 0, 1.5748f, 0.187324f, 0.468124f, 1.8556f };
+static const YuvMatrixCoefs BT709_LIMITED_COEFS = { 1.164383f, 16, 1.792741f, 0.213249f, 0.532909f, 2.112402f };
+
+static inline int16_t ToFixed(float coef)
+{
+    return static_cast<int16_t>(std::lround(coef * YUV_SCALE));
+}
+
+static inline uint8_t ClampChannel(int32_t value)
+{
+    return static_cast<uint8_t>(std::min(std::max(value, 0), CHANNEL_MAX));
+}
+
+template <PixelFormat F>
+constexpr int32_t DstPixelBytes()
+{
+    return (F == PixelFormat::RGB_565) ? RGB565_BYTES : RGBA_BYTES;
+}
+
+template <PixelFormat F>
+static inline void StorePixel(uint8_t *dst, int32_t x, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (F == PixelFormat::RGB_565) {
+        reinterpret_cast<uint16_t *>(dst)[x] = static_cast<uint16_t>(((r >> RGB565_R_DROP) << RGB565_R_SHIFT) |
+            ((g >> RGB565_G_DROP) << RGB565_G_SHIFT) | (b >> RGB565_B_DROP));
+        return;
+    }
+    uint8_t *pixel = dst + x * RGBA_BYTES;
+    pixel[0] = (F == PixelFormat::BGRA_8888) ? b : r;
+    pixel[1] = g;
+    pixel[2] = (F == PixelFormat::BGRA_8888) ? r : b;
+    pixel[3] = CHANNEL_MAX;
+}
+
+template <PixelFormat F>
+static inline void ConvertPixel(const YuvConstants &k, uint8_t y, const int32_t chroma[3], uint8_t *dst, int32_t x)
+{
+    int32_t luma = k.yScale * (y - k.yOffset) + YUV_ROUND;
+    StorePixel<F>(dst, x, ClampChannel((luma + chroma[0]) >> YUV_SHIFT),
+        ClampChannel((luma + chroma[1]) >> YUV_SHIFT), ClampChannel((luma + chroma[2]) >> YUV_SHIFT));
+}
+
+// Convert the pixels from start, which is even, to the end of the rows.
+template <PixelFormat F>
+static void ConvertRowScalar(const Yuv420spRowArgs &args, int32_t start)
+{
+    const YuvConstants &k = *args.constants;
+    for (int32_t x = start; x < args.width; x += PIXELS_PER_UV) {
+        const int32_t c0 = args.uv[x] - UV_BIAS;
+        const int32_t c1 = args.uv[x + 1] - UV_BIAS;
+        const int32_t chroma[] = {
+            k.rCoef[0] * c0 + k.rCoef[1] * c1,
+            k.gCoef[0] * c0 + k.gCoef[1] * c1,
+            k.bCoef[0] * c0 + k.bCoef[1] * c1,
+        };
+        const int32_t end = std::min(x + PIXELS_PER_UV, args.width);
+        for (int32_t i = x; i < end; i++) {
+            ConvertPixel<F>(k, args.y0[i], chroma, args.dst0, i);
+            if (args.y1 != nullptr) {
+                ConvertPixel<F>(k, args.y1[i], chroma, args.dst1, i);
+            }
+        }
+    }
+}
+
+template <PixelFormat F>
+static void ConvertRowsScalar(const Yuv420spRowArgs &args)
+{
+    ConvertRowScalar<F>(args, 0);
+}
+
+#ifdef YUV420SP_SSE2
+struct YuvSse2Constants {
+    __m128i yCoef;
+    __m128i yOffset;
+    __m128i rCoef;
+    __m128i gCoef;
+    __m128i bCoef;
+};
+
+static inline __m128i PairSse2(int16_t first, int16_t second)
+{
+    return _mm_set_epi16(second, first, second, first, second, first, second, first);
+}
+
+// 16 duplicated chroma terms from 8 chroma samples, one term covers two neighbour pixels.
+static inline void ChromaSse2(__m128i uvLo, __m128i uvHi, __m128i coef, __m128i chroma[4])
+{
+    __m128i lo = _mm_madd_epi16(uvLo, coef);
+    __m128i hi = _mm_madd_epi16(uvHi, coef);
+    chroma[0] = _mm_unpacklo_epi32(lo, lo);
+    chroma[1] = _mm_unpackhi_epi32(lo, lo);
+    chroma[2] = _mm_unpacklo_epi32(hi, hi);
+    chroma[3] = _mm_unpackhi_epi32(hi, hi);
+}
+
+// yScale * (y - yOffset) + YUV_ROUND of 16 pixels, the rounding rides on the second lane of madd.
+static inline void LumaSse2(const uint8_t *y, const YuvSse2Constants &k, __m128i luma[4])
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y));
+    __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), k.yOffset);
+    __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(y8, zero), k.yOffset);
+    luma[0] = _mm_madd_epi16(_mm_unpacklo_epi16(lo, one), k.yCoef);
+    luma[1] = _mm_madd_epi16(_mm_unpackhi_epi16(lo, one), k.yCoef);
+    luma[2] = _mm_madd_epi16(_mm_unpacklo_epi16(hi, one), k.yCoef);
+    luma[3] = _mm_madd_epi16(_mm_unpackhi_epi16(hi, one), k.yCoef);
+}
+
+static inline __m128i ChannelSse2(const __m128i luma[4], const __m128i chroma[4])
+{
+    __m128i v0 = _mm_srai_epi32(_mm_add_epi32(luma[0], chroma[0]), YUV_SHIFT);
+    __m128i v1 = _mm_srai_epi32(_mm_add_epi32(luma[1], chroma[1]), YUV_SHIFT);
+    __m128i v2 = _mm_srai_epi32(_mm_add_epi32(luma[2], chroma[2]), YUV_SHIFT);
+    __m128i v3 = _mm_srai_epi32(_mm_add_epi32(luma[3], chroma[3]), YUV_SHIFT);
+    return _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+}
+
+static inline void StoreQuadSse2(uint8_t *dst, __m128i c0, __m128i c1, __m128i c2)
+{
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(CHANNEL_MAX));
+    __m128i lo01 = _mm_unpacklo_epi8(c0, c1);
+    __m128i hi01 = _mm_unpackhi_epi8(c0, c1);
+    __m128i lo23 = _mm_unpacklo_epi8(c2, alpha);
+    __m128i hi23 = _mm_unpackhi_epi8(c2, alpha);
+    __m128i *out = reinterpret_cast<__m128i *>(dst);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(lo01, lo23));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+}
+
+static inline __m128i Pack565Sse2(__m128i r, __m128i g, __m128i b)
+{
+    const __m128i rMask = _mm_set1_epi16(static_cast<int16_t>(0xF800));
+    const __m128i gMask = _mm_set1_epi16(0x07E0);
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi16(r, RGB565_R_LANE_SHIFT), rMask),
+        _mm_and_si128(_mm_slli_epi16(g, RGB565_G_LANE_SHIFT), gMask)), _mm_srli_epi16(b, RGB565_B_DROP));
+}
+
+template <PixelFormat F>
+static inline void StoreSse2(uint8_t *dst, __m128i r, __m128i g, __m128i b)
+{
+    if (F == PixelFormat::RGBA_8888) {
+        StoreQuadSse2(dst, r, g, b);
+    } else if (F == PixelFormat::BGRA_8888) {
+        StoreQuadSse2(dst, b, g, r);
+    } else {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i *out = reinterpret_cast<__m128i *>(dst);
+        _mm_storeu_si128(out, Pack565Sse2(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero),
+            _mm_unpacklo_epi8(b, zero)));
+        _mm_storeu_si128(out + 1, Pack565Sse2(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero),
+            _mm_unpackhi_epi8(b, zero)));
+    }
+}
+
+template <PixelFormat F>
+static inline void ConvertLumaSse2(const uint8_t *y, uint8_t *dst, const YuvSse2Constants &k,
+    const __m128i chroma[][4])
+{
+    __m128i luma[4];
+    LumaSse2(y, k, luma);
+    StoreSse2<F>(dst, ChannelSse2(luma, chroma[0]), ChannelSse2(luma, chroma[1]), ChannelSse2(luma, chroma[2]));
+}
+
+template <PixelFormat F>
+static void ConvertRowsSse2(const Yuv420spRowArgs &args)
+{
+    const YuvConstants &constants = *args.constants;
+    YuvSse2Constants k;
+    k.yCoef = PairSse2(constants.yScale, YUV_ROUND);
+    k.yOffset = _mm_set1_epi16(constants.yOffset);
+    k.rCoef = PairSse2(constants.rCoef[0], constants.rCoef[1]);
+    k.gCoef = PairSse2(constants.gCoef[0], constants.gCoef[1]);
+    k.bCoef = PairSse2(constants.bCoef[0], constants.bCoef[1]);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(UV_BIAS);
+    int32_t x = 0;
+    for (; x + SIMD_PIXELS <= args.width; x += SIMD_PIXELS) {
+        __m128i uv8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(args.uv + x));
+        __m128i uvLo = _mm_sub_epi16(_mm_unpacklo_epi8(uv8, zero), bias);
+        __m128i uvHi = _mm_sub_epi16(_mm_unpackhi_epi8(uv8, zero), bias);
+        __m128i chroma[3][4];
+        ChromaSse2(uvLo, uvHi, k.rCoef, chroma[0]);
+        ChromaSse2(uvLo, uvHi, k.gCoef, chroma[1]);
+        ChromaSse2(uvLo, uvHi, k.bCoef, chroma[2]);
+        ConvertLumaSse2<F>(args.y0 + x, args.dst0 + x * DstPixelBytes<F>(), k, chroma);
+        if (args.y1 != nullptr) {
+            ConvertLumaSse2<F>(args.y1 + x, args.dst1 + x * DstPixelBytes<F>(), k, chroma);
+        }
+    }
+    ConvertRowScalar<F>(args, x);
+}
+#endif
+
+#ifdef YUV420SP_NEON
+static inline void ChromaNeon(int16x8_t c0, int16x8_t c1, const int16_t coef[2], int32x4_t chroma[4])
+{
+    int32x4_t lo = vmlal_n_s16(vmull_n_s16(vget_low_s16(c0), coef[0]), vget_low_s16(c1), coef[1]);
+    int32x4_t hi = vmlal_n_s16(vmull_n_s16(vget_high_s16(c0), coef[0]), vget_high_s16(c1), coef[1]);
+    int32x4x2_t loPair = vzipq_s32(lo, lo);
+    int32x4x2_t hiPair = vzipq_s32(hi, hi);
+    chroma[0] = loPair.val[0];
+    chroma[1] = loPair.val[1];
+    chroma[2] = hiPair.val[0];
+    chroma[3] = hiPair.val[1];
+}
+
+static inline void LumaNeon(const uint8_t *y, const YuvConstants &k, int32x4_t luma[4])
+{
+    const uint8x8_t offset = vdup_n_u8(static_cast<uint8_t>(k.yOffset));
+    const int32x4_t round = vdupq_n_s32(YUV_ROUND);
+    uint8x16_t y8 = vld1q_u8(y);
+    int16x8_t lo = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(y8), offset));
+    int16x8_t hi = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(y8), offset));
+    luma[0] = vmlal_n_s16(round, vget_low_s16(lo), k.yScale);
+    luma[1] = vmlal_n_s16(round, vget_high_s16(lo), k.yScale);
+    luma[2] = vmlal_n_s16(round, vget_low_s16(hi), k.yScale);
+    luma[3] = vmlal_n_s16(round, vget_high_s16(hi), k.yScale);
+}
+
+static inline uint8x16_t ChannelNeon(const int32x4_t luma[4], const int32x4_t chroma[4])
+{
+    int16x8_t lo = vcombine_s16(vqmovn_s32(vshrq_n_s32(vaddq_s32(luma[0], chroma[0]), YUV_SHIFT)),
+        vqmovn_s32(vshrq_n_s32(vaddq_s32(luma[1], chroma[1]), YUV_SHIFT)));
+    int16x8_t hi = vcombine_s16(vqmovn_s32(vshrq_n_s32(vaddq_s32(luma[2], chroma[2]), YUV_SHIFT)),
+        vqmovn_s32(vshrq_n_s32(vaddq_s32(luma[3], chroma[3]), YUV_SHIFT)));
+    return vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi));
+}
+
+static inline uint16x8_t Pack565Neon(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+    // shift the channels to the top of the lanes, then insert them below the previous ones
+    uint16x8_t result = vshll_n_u8(r, RGB565_R_LANE_SHIFT);
+    result = vsriq_n_u16(result, vshll_n_u8(g, RGB565_R_LANE_SHIFT), RGB565_G_SHIFT);
+    return vsriq_n_u16(result, vshll_n_u8(b, RGB565_R_LANE_SHIFT), RGB565_R_SHIFT);
+}
+
+template <PixelFormat F>
+static inline void StoreNeon(uint8_t *dst, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+    if (F == PixelFormat::RGB_565) {
+        uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+        vst1q_u16(out, Pack565Neon(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)));
+        vst1q_u16(out + SIMD_PIXELS / 2, Pack565Neon(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+        return;
+    }
+    uint8x16x4_t pixels;
+    pixels.val[0] = (F == PixelFormat::BGRA_8888) ? b : r;
+    pixels.val[1] = g;
+    pixels.val[2] = (F == PixelFormat::BGRA_8888) ? r : b;
+    pixels.val[3] = vdupq_n_u8(CHANNEL_MAX);
+    vst4q_u8(dst, pixels);
+}
+
+template <PixelFormat F>
+static inline void ConvertLumaNeon(const uint8_t *y, uint8_t *dst, const YuvConstants &k,
+    const int32x4_t chroma[][4])
+{
+    int32x4_t luma[4];
+    LumaNeon(y, k, luma);
+    StoreNeon<F>(dst, ChannelNeon(luma, chroma[0]), ChannelNeon(luma, chroma[1]), ChannelNeon(luma, chroma[2]));
+}
+
+template <PixelFormat F>
+static void ConvertRowsNeon(const Yuv420spRowArgs &args)
+{
+    const YuvConstants &k = *args.constants;
+    const uint8x8_t bias = vdup_n_u8(UV_BIAS);
+    int32_t x = 0;
+    for (; x + SIMD_PIXELS <= args.width; x += SIMD_PIXELS) {
+        uint8x8x2_t uv = vld2_u8(args.uv + x);
+        int16x8_t c0 = vreinterpretq_s16_u16(vsubl_u8(uv.val[0], bias));
+        int16x8_t c1 = vreinterpretq_s16_u16(vsubl_u8(uv.val[1], bias));
+        int32x4_t chroma[3][4];
+        ChromaNeon(c0, c1, k.rCoef, chroma[0]);
+        ChromaNeon(c0, c1, k.gCoef, chroma[1]);
+        ChromaNeon(c0, c1, k.bCoef, chroma[2]);
+        ConvertLumaNeon<F>(args.y0 + x, args.dst0 + x * DstPixelBytes<F>(), k, chroma);
+        if (args.y1 != nullptr) {
+            ConvertLumaNeon<F>(args.y1 + x, args.dst1 + x * DstPixelBytes<F>(), k, chroma);
+        }
+    }
+    ConvertRowScalar<F>(args, x);
+}
+#endif
+
+template <PixelFormat F>
+static Yuv420spConverter::RowProc SelectRowProc()
+{
+#if defined(YUV420SP_SSE2)
+    return ConvertRowsSse2<F>;
+#elif defined(YUV420SP_NEON)
+    return ConvertRowsNeon<F>;
+#else
+    return ConvertRowsScalar<F>;
+#endif
+}
+
+bool Yuv420spConverter::IsSupportedDstFormat(PixelFormat format)
+{
+    return format == PixelFormat::RGBA_8888 || format == PixelFormat::BGRA_8888 || format == PixelFormat::RGB_565;
+}
+
+bool Yuv420spConverter::GetConstants(PixelFormat srcFormat, YuvColorMatrix matrix, YuvConstants &constants)
+{
+    if (srcFormat != PixelFormat::NV21 && srcFormat != PixelFormat::NV12) {
+        return false;
+    }
+    const YuvMatrixCoefs *coefs = nullptr;
+    switch (matrix) {
+        case YuvColorMatrix::BT601_FULL:
+            coefs = &BT601_FULL_COEFS;
+            break;
+        case YuvColorMatrix::BT601_LIMITED:
+            coefs = &BT601_LIMITED_COEFS;
+            break;
+        case YuvColorMatrix::BT709_FULL:
+            coefs = &BT709_FULL_COEFS;
+            break;
+        case YuvColorMatrix::BT709_LIMITED:
+            coefs = &BT709_LIMITED_COEFS;
+            break;
+        default:
+            return false;
+    }
+    // the chroma plane of NV21 is vu, NV12 is uv
+    const bool vFirst = (srcFormat == PixelFormat::NV21);
+    const int16_t rv = ToFixed(coefs->rv);
+    const int16_t gu = -ToFixed(coefs->gu);
+    const int16_t gv = -ToFixed(coefs->gv);
+    const int16_t bu = ToFixed(coefs->bu);
+    constants.yScale = ToFixed(coefs->yScale);
+    constants.yOffset = coefs->yOffset;
+    constants.rCoef[0] = vFirst ? rv : 0;
+    constants.rCoef[1] = vFirst ? 0 : rv;
+    constants.gCoef[0] = vFirst ? gv : gu;
+    constants.gCoef[1] = vFirst ? gu : gv;
+    constants.bCoef[0] = vFirst ? 0 : bu;
+    constants.bCoef[1] = vFirst ? bu : 0;
+    return true;
+}
+
+Yuv420spConverter::RowProc Yuv420spConverter::GetRowProc(PixelFormat dstFormat)
+{
+    switch (dstFormat) {
+        case PixelFormat::RGBA_8888:
+            return SelectRowProc<PixelFormat::RGBA_8888>();
+        case PixelFormat::BGRA_8888:
+            return SelectRowProc<PixelFormat::BGRA_8888>();
+        case PixelFormat::RGB_565:
+            return SelectRowProc<PixelFormat::RGB_565>();
+        default:
+            return nullptr;
+    }
+}
+
+Yuv420spConverter::RowProc Yuv420spConverter::GetScalarRowProc(PixelFormat dstFormat)
+{
+    switch (dstFormat) {
+        case PixelFormat::RGBA_8888:
+            return ConvertRowsScalar<PixelFormat::RGBA_8888>;
+        case PixelFormat::BGRA_8888:
+            return ConvertRowsScalar<PixelFormat::BGRA_8888>;
+        case PixelFormat::RGB_565:
+            return ConvertRowsScalar<PixelFormat::RGB_565>;
+        default:
+            return nullptr;
+    }
+}
+
+const char *Yuv420spConverter::GetRowProcName()
+{
+#if defined(YUV420SP_SSE2)
+    return "sse2";
+#elif defined(YUV420SP_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+struct YuvBand {
+    const Yuv420spInfo *src;
+    const YuvConstants *constants;
+    Yuv420spConverter::RowProc proc;
+    uint32_t uvStride;
+    uint8_t *dst;
+    size_t dstRowBytes;
+};
+
+// Convert the row pairs [begin, end), a pair is two luma rows and the chroma row under them.
+static void ConvertBand(const YuvBand &band, int32_t begin, int32_t end)
+{
+    const int32_t width = band.src->size.width;
+    const int32_t height = band.src->size.height;
+    const uint8_t *yPlane = band.src->data;
+    const uint8_t *uvPlane = yPlane + static_cast<size_t>(width) * height;
+    Yuv420spRowArgs args;
+    args.width = width;
+    args.constants = band.constants;
+    for (int32_t pair = begin; pair < end; pair++) {
+        const int32_t row = pair * ROWS_PER_UV;
+        args.uv = uvPlane + static_cast<size_t>(pair) * band.uvStride;
+        args.y0 = yPlane + static_cast<size_t>(row) * width;
+        args.dst0 = band.dst + row * band.dstRowBytes;
+        const bool hasSecondRow = (row + 1) < height;
+        args.y1 = hasSecondRow ? (args.y0 + width) : nullptr;
+        args.dst1 = hasSecondRow ? (args.dst0 + band.dstRowBytes) : nullptr;
+        band.proc(args);
+    }
+}
+
+static uint32_t GetThreadCount(const Size &size, uint32_t threadCount, int32_t pairs)
+{
+    uint32_t count = threadCount;
+    if (count == 0) {
+        const uint64_t pixels = static_cast<uint64_t>(size.width) * size.height;
+        count = (pixels < PARALLEL_MIN_PIXELS) ? 1 : std::min(std::thread::hardware_concurrency(), MAX_THREADS);
+    }
+    return std::max(std::min(count, static_cast<uint32_t>(pairs)), 1u);
+}
+
+bool Yuv420spConverter::Convert(const Yuv420spInfo &src, PixelFormat dstFormat, uint8_t *dst, size_t dstSize,
+                                uint32_t threadCount)
+{
+    YuvConstants constants;
+    if (src.data == nullptr || dst == nullptr || src.size.width <= 0 || src.size.height <= 0 ||
+        !GetConstants(src.format, src.matrix, constants)) {
+        IMAGE_LOGE("[Yuv420spConverter]invalid source, format:%{public}d.", static_cast<int32_t>(src.format));
+        return false;
+    }
+    RowProc proc = GetRowProc(dstFormat);
+    if (proc == nullptr) {
+        IMAGE_LOGE("[Yuv420spConverter]dst format %{public}d not supported.", static_cast<int32_t>(dstFormat));
+        return false;
+    }
+    const size_t width = static_cast<size_t>(src.size.width);
+    const size_t height = static_cast<size_t>(src.size.height);
+    const size_t uvRowBytes = (width + 1) & ~static_cast<size_t>(1);
+    const uint32_t uvStride = (src.uvStride == 0) ? static_cast<uint32_t>(uvRowBytes) : src.uvStride;
+    const int32_t pairs = static_cast<int32_t>((height + 1) / ROWS_PER_UV);
+    // the last chroma pair of an odd width row is read whole
+    const size_t needSize = width * height + static_cast<size_t>(uvStride) * (pairs - 1) + uvRowBytes;
+    if (uvStride < (width & ~static_cast<size_t>(1)) || src.dataSize < needSize) {
+        IMAGE_LOGE("[Yuv420spConverter]source data too short, size:%{public}zu, need:%{public}zu.",
+            src.dataSize, needSize);
+        return false;
+    }
+    const size_t dstRowBytes = width * ((dstFormat == PixelFormat::RGB_565) ? RGB565_BYTES : RGBA_BYTES);
+    if (dstSize < dstRowBytes * height) {
+        IMAGE_LOGE("[Yuv420spConverter]dst size %{public}zu too small.", dstSize);
+        return false;
+    }
+
+    YuvBand band = { &src, &constants, proc, uvStride, dst, dstRowBytes };
+    const uint32_t count = GetThreadCount(src.size, threadCount, pairs);
+    const int32_t pairsPerBand = (pairs + static_cast<int32_t>(count) - 1) / static_cast<int32_t>(count);
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < count; i++) {
+        const int32_t begin = static_cast<int32_t>(i) * pairsPerBand;
+        if (begin >= pairs) {
+            break;
+        }
+        workers.emplace_back(ConvertBand, std::cref(band), begin, std::min(begin + pairsPerBand, pairs));
+    }
+    ConvertBand(band, 0, std::min(pairsPerBand, pairs));
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return true;
+}
+} // namespace Media
+} // namespace OHOS
@@ -19,6 +19,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <vector>
 #include "image/input_data_stream.h"
 #include "source_stream.h"
 
@@ -43,6 +44,10 @@ public:
 private:
     DISALLOW_COPY_AND_MOVE(FileSourceStream);
     FileSourceStream(std::FILE *file, size_t size, size_t offset, size_t original);
+    void InitFileData(int fd);
+    bool MapFile(int fd, size_t size);
+    bool ReadWholeStream(int fd);
+    bool GetFileData(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData);
     bool GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_t bufferSize, uint32_t &readSize);
     bool GetData(uint32_t desiredSize, ImagePlugin::DataStreamBuffer &outData);
     void ResetReadBuffer();
@@ -51,6 +56,13 @@ private:
     size_t fileOffset_ = 0;
     size_t fileOriginalOffset_ = 0;
     uint8_t *readBuffer_ = nullptr;
+    /*
+     * The whole stream: mapped for regular files, read into pipeData_ for pipes and other fds
+     * that can not seek. nullptr falls back to stdio reads.
+     */
+    uint8_t *fileData_ = nullptr;
+    size_t mappedSize_ = 0;
+    std::vector<uint8_t> pipeData_;
 };
 } // namespace Media
 } // namespace OHOS
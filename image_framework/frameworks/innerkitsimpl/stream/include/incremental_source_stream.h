@@ -17,6 +17,7 @@
 #define FRAMEWORKS_INNERKITSIMPL_STREAM_INCLUDE_INCREMENTAL_SOURCE_STREAM_H_
 
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <vector>
 #include "image/input_data_stream.h"
@@ -39,14 +40,22 @@ public:
     uint32_t UpdateData(const uint8_t *data, uint32_t size, bool isCompleted) override;
     bool IsStreamCompleted() override;
     size_t GetStreamSize() override;
+    // upper bound of the buffered bytes, UpdateData fails with ERR_IMAGE_TOO_LARGE beyond it.
+    void SetMaxBufferSize(size_t maxSize);
 
 private:
     explicit IncrementalSourceStream(IncrementalMode mode);
+    const uint8_t *GetContiguousData(size_t offset, size_t size, size_t &contiguousSize);
+    void CopyData(size_t offset, uint8_t *outBuffer, size_t size) const;
     IncrementalMode incrementalMode_;
     bool isFinalize_;
+    // contiguous view of the head of the stream, chunks are joined into it only when a peek spans them.
     std::vector<uint8_t> sourceData_;
+    // the rest of the stream in arrival order.
+    std::deque<std::vector<uint8_t>> chunks_;
     size_t dataSize_ = 0;
     size_t dataOffset_ = 0;
+    size_t maxBufferSize_;
 };
 } // namespace Media
 } // namespace OHOS
@@ -17,6 +17,7 @@
 
 #include <string>
 #include "image_log.h"
+#include "image_metrics.h"
 #ifndef _WIN32
 #include "securec.h"
 #else
@@ -69,6 +70,7 @@ bool BufferSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
         return false;
     }
     dataOffset_ += outData.dataSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, outData.dataSize);
     return true;
 }
 
@@ -101,6 +103,7 @@ bool BufferSourceStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t
         return false;
     }
     dataOffset_ += readSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, readSize);
     return true;
 }
 
@@ -13,12 +13,29 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <limits>
 #include <unistd.h>
 #include "image_log.h"
+#include "image_metrics.h"
 #include "image_utils.h"
 #include "media_errors.h"
 #include "directory_ex.h"
 #include "file_source_stream.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "securec.h"
+#else
+#include "memory.h"
+#endif
+
+namespace {
+// the head of the file is read by every format agent and decoder, ask the kernel to prefetch it
+constexpr size_t WILLNEED_SIZE = 1024 * 1024;
+constexpr size_t PIPE_READ_CHUNK = 64 * 1024;
+}
 
 namespace OHOS {
 namespace Media {
@@ -32,10 +49,25 @@ FileSourceStream::FileSourceStream(std::FILE *file, size_t size, size_t offset,
 
 FileSourceStream::~FileSourceStream()
 {
+#ifndef _WIN32
+    if (mappedSize_ != 0) {
+        munmap(fileData_, mappedSize_);
+    }
+#endif
     fclose(filePtr_);
     ResetReadBuffer();
 }
 
+static bool IsRegularFile(int fd)
+{
+#ifndef _WIN32
+    struct stat fileStat;
+    return (fstat(fd, &fileStat) == 0) && S_ISREG(fileStat.st_mode);
+#else
+    return true;
+#endif
+}
+
 unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const string &pathName)
 {
     string realPath;
@@ -53,13 +85,16 @@ unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const string &
         IMAGE_LOGE("[FileSourceStream]open file fail.");
         return nullptr;
     }
-    int64_t offset = ftell(filePtr);
+    int fd = fileno(filePtr);
+    int64_t offset = IsRegularFile(fd) ? ftell(filePtr) : 0;
     if (offset < 0) {
         IMAGE_LOGE("[FileSourceStream]get the position fail.");
         fclose(filePtr);
         return nullptr;
     }
-    return (unique_ptr<FileSourceStream>(new FileSourceStream(filePtr, size, offset, offset)));
+    unique_ptr<FileSourceStream> stream(new FileSourceStream(filePtr, size, offset, offset));
+    stream->InitFileData(fd);
+    return stream;
 }
 
 unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const int fd)
@@ -74,26 +109,115 @@ unique_ptr<FileSourceStream> FileSourceStream::CreateSourceStream(const int fd)
 
     if (!ImageUtils::GetFileSize(dupFd, size)) {
         IMAGE_LOGE("[FileSourceStream]get the file size fail.");
+        close(dupFd);
         return nullptr;
     }
     FILE *filePtr = fdopen(dupFd, "rb");
     if (filePtr == nullptr) {
         IMAGE_LOGE("[FileSourceStream]open file fail.");
+        close(dupFd);
         return nullptr;
     }
 
-    int ret = fseek(filePtr, 0, SEEK_SET);
-    if (ret != 0) {
-        IMAGE_LOGE("[FileSourceStream]Go to 0 position fail, ret:%{public}d.", ret);
+    int64_t offset = 0;
+    // pipes and sockets can not seek, they are read into memory from the current position
+    if (IsRegularFile(dupFd)) {
+        int ret = fseek(filePtr, 0, SEEK_SET);
+        if (ret != 0) {
+            IMAGE_LOGE("[FileSourceStream]Go to 0 position fail, ret:%{public}d.", ret);
+        }
+        offset = ftell(filePtr);
     }
-
-    int64_t offset = ftell(filePtr);
     if (offset < 0) {
         IMAGE_LOGE("[FileSourceStream]get the position fail.");
         fclose(filePtr);
         return nullptr;
     }
-    return (unique_ptr<FileSourceStream>(new FileSourceStream(filePtr, size, offset, offset)));
+    unique_ptr<FileSourceStream> stream(new FileSourceStream(filePtr, size, offset, offset));
+    stream->InitFileData(dupFd);
+    return stream;
+}
+
+void FileSourceStream::InitFileData(int fd)
+{
+#ifndef _WIN32
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0) {
+        IMAGE_LOGE("[FileSourceStream]stat fd fail, use buffered read, errno:%{public}d.", errno);
+        return;
+    }
+    if (!S_ISREG(fileStat.st_mode)) {
+        ReadWholeStream(fd);
+        return;
+    }
+    // the file may have shrunk since its size was taken, never map past its end
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    if (size < fileSize_) {
+        fileSize_ = size;
+        fileOffset_ = std::min(fileOffset_, fileSize_);
+    }
+    MapFile(fd, fileSize_);
+#endif
+}
+
+bool FileSourceStream::MapFile(int fd, size_t size)
+{
+#ifndef _WIN32
+    if (size == 0) {
+        return false;
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        IMAGE_LOGE("[FileSourceStream]map file fail, use buffered read, errno:%{public}d.", errno);
+        return false;
+    }
+    // decoders walk the file front to back, and format sniffing reads the head right away
+    if (madvise(data, size, MADV_SEQUENTIAL) != 0 || madvise(data, std::min(size, WILLNEED_SIZE), MADV_WILLNEED) != 0) {
+        IMAGE_LOGD("[FileSourceStream]madvise fail, errno:%{public}d.", errno);
+    }
+    fileData_ = static_cast<uint8_t *>(data);
+    mappedSize_ = size;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileSourceStream::ReadWholeStream(int fd)
+{
+    size_t total = 0;
+    while (true) {
+        if (total > MALLOC_MAX_LENTH) {
+            IMAGE_LOGE("[FileSourceStream]stream is too large, read size:%{public}zu.", total);
+            std::vector<uint8_t>().swap(pipeData_);
+            return false;
+        }
+        if (pipeData_.size() < total + PIPE_READ_CHUNK) {
+            pipeData_.resize(total + PIPE_READ_CHUNK);
+        }
+        ssize_t bytesRead = read(fd, pipeData_.data() + total, PIPE_READ_CHUNK);
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            IMAGE_LOGE("[FileSourceStream]read stream fail, errno:%{public}d.", errno);
+            std::vector<uint8_t>().swap(pipeData_);
+            return false;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        total += static_cast<size_t>(bytesRead);
+    }
+    pipeData_.resize(total);
+    if (total == 0) {
+        return false;
+    }
+    fileData_ = pipeData_.data();
+    fileSize_ = total;
+    fileOffset_ = 0;
+    fileOriginalOffset_ = 0;
+    return true;
 }
 
 bool FileSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
@@ -107,6 +231,7 @@ bool FileSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
         return false;
     }
     fileOffset_ += outData.dataSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, outData.dataSize);
     return true;
 }
 
@@ -120,6 +245,9 @@ bool FileSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outData)
         IMAGE_LOGE("[FileSourceStream]peek fail.");
         return false;
     }
+    if (fileData_ != nullptr) {
+        return true;
+    }
     int ret = fseek(filePtr_, fileOffset_, SEEK_SET);
     if (ret != 0) {
         IMAGE_LOGE("[FileSourceStream]go to original position fail, ret:%{public}d.", ret);
@@ -141,6 +269,7 @@ bool FileSourceStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_t b
         return false;
     }
     fileOffset_ += readSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, readSize);
     return true;
 }
 
@@ -156,6 +285,9 @@ bool FileSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uint32_t b
         IMAGE_LOGE("[FileSourceStream]peek fail.");
         return false;
     }
+    if (fileData_ != nullptr) {
+        return true;
+    }
     int ret = fseek(filePtr_, fileOffset_, SEEK_SET);
     if (ret != 0) {
         IMAGE_LOGE("[FileSourceStream]go to original position fail, ret:%{public}d.", ret);
@@ -172,6 +304,9 @@ bool FileSourceStream::Seek(uint32_t position)
     }
     size_t targetPosition = position + fileOriginalOffset_;
     fileOffset_ = ((targetPosition < fileSize_) ? targetPosition : fileSize_);
+    if (fileData_ != nullptr) {
+        return true;
+    }
     int ret = fseek(filePtr_, fileOffset_, SEEK_SET);
     if (ret != 0) {
         IMAGE_LOGE("[FileSourceStream]go to offset position fail, ret:%{public}d.", ret);
@@ -194,6 +329,15 @@ bool FileSourceStream::GetData(uint32_t desiredSize, uint8_t *outBuffer, uint32_
     if (desiredSize > (fileSize_ - fileOffset_)) {
         desiredSize = fileSize_ - fileOffset_;
     }
+    if (fileData_ != nullptr) {
+        errno_t ret = memcpy_s(outBuffer, bufferSize, fileData_ + fileOffset_, desiredSize);
+        if (ret != EOK) {
+            IMAGE_LOGE("[FileSourceStream]copy data fail, ret:%{public}d.", ret);
+            return false;
+        }
+        readSize = desiredSize;
+        return true;
+    }
     size_t bytesRead = fread(outBuffer, sizeof(outBuffer[0]), desiredSize, filePtr_);
     if (bytesRead < desiredSize) {
         IMAGE_LOGE("[FileSourceStream]read fail, bytesRead:%{public}zu", bytesRead);
@@ -214,6 +358,9 @@ bool FileSourceStream::GetData(uint32_t desiredSize, DataStreamBuffer &outData)
         IMAGE_LOGE("[FileSourceStream]Invalid value, desiredSize out of size.");
         return false;
     }
+    if (fileData_ != nullptr) {
+        return GetFileData(desiredSize, outData);
+    }
 
     ResetReadBuffer();
     readBuffer_ = static_cast<uint8_t *>(malloc(desiredSize));
@@ -237,6 +384,19 @@ bool FileSourceStream::GetData(uint32_t desiredSize, DataStreamBuffer &outData)
     return true;
 }
 
+// Points into the mapped or buffered stream, valid as long as the stream lives.
+bool FileSourceStream::GetFileData(uint32_t desiredSize, DataStreamBuffer &outData)
+{
+    outData.bufferSize = static_cast<uint32_t>(
+        std::min(fileSize_ - fileOffset_, static_cast<size_t>(std::numeric_limits<uint32_t>::max())));
+    if (desiredSize > (fileSize_ - fileOffset_)) {
+        desiredSize = fileSize_ - fileOffset_;
+    }
+    outData.inputStreamBuffer = fileData_ + fileOffset_;
+    outData.dataSize = desiredSize;
+    return true;
+}
+
 size_t FileSourceStream::GetStreamSize()
 {
     return fileSize_;
@@ -244,7 +404,7 @@ size_t FileSourceStream::GetStreamSize()
 
 uint8_t *FileSourceStream::GetDataPtr()
 {
-    return nullptr;
+    return fileData_;
 }
 
 uint32_t FileSourceStream::GetStreamType()
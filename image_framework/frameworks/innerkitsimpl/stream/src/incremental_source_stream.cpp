@@ -18,6 +18,8 @@
 #include <algorithm>
 #include <vector>
 #include "image_log.h"
+#include "image_metrics.h"
+#include "image_utils.h"
 #ifndef _WIN32
 #include "securec.h"
 #else
@@ -31,7 +33,7 @@ using namespace std;
 using namespace ImagePlugin;
 
 IncrementalSourceStream::IncrementalSourceStream(IncrementalMode mode)
-    : incrementalMode_(mode), isFinalize_(false), dataSize_(0), dataOffset_(0)
+    : incrementalMode_(mode), isFinalize_(false), dataSize_(0), dataOffset_(0), maxBufferSize_(MALLOC_MAX_LENTH)
 {}
 
 unique_ptr<IncrementalSourceStream> IncrementalSourceStream::CreateSourceStream(IncrementalMode mode)
@@ -47,6 +49,7 @@ bool IncrementalSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outDa
         return false;
     }
     dataOffset_ += outData.dataSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, outData.dataSize);
     return true;
 }
 
@@ -56,17 +59,18 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, DataStreamBuffer &outDa
         IMAGE_LOGE("[IncrementalSourceStream]input the parameter exception.");
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu, dataOffset_:%{public}zu.",
                    dataSize_, dataOffset_);
         return false;
     }
-    outData.bufferSize = dataSize_ - dataOffset_;
     if (desiredSize > dataSize_ - dataOffset_) {
         desiredSize = dataSize_ - dataOffset_;
     }
+    size_t contiguousSize = 0;
+    outData.inputStreamBuffer = GetContiguousData(dataOffset_, desiredSize, contiguousSize);
+    outData.bufferSize = contiguousSize;
     outData.dataSize = desiredSize;
-    outData.inputStreamBuffer = sourceData_.data() + dataOffset_;
     IMAGE_LOGD("[IncrementalSourceStream]Peek end. desiredSize:%{public}u, offset:%{public}zu, dataSize_:%{public}zu, \
                dataOffset_:%{public}zu.",
                desiredSize, dataOffset_, dataSize_, dataOffset_);
@@ -80,6 +84,7 @@ bool IncrementalSourceStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uin
         return false;
     }
     dataOffset_ += readSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, readSize);
     return true;
 }
 
@@ -90,7 +95,7 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
                    desiredSize, bufferSize);
         return false;
     }
-    if (sourceData_.empty() || dataSize_ == 0 || dataOffset_ >= dataSize_) {
+    if (dataSize_ == 0 || dataOffset_ >= dataSize_) {
         IMAGE_LOGE("[IncrementalSourceStream]source data exception. dataSize_:%{public}zu, dataOffset_:%{public}zu.",
                    dataSize_, dataOffset_);
         return false;
@@ -98,13 +103,8 @@ bool IncrementalSourceStream::Peek(uint32_t desiredSize, uint8_t *outBuffer, uin
     if (desiredSize > (dataSize_ - dataOffset_)) {
         desiredSize = dataSize_ - dataOffset_;
     }
-    errno_t ret = memcpy_s(outBuffer, bufferSize, sourceData_.data() + dataOffset_, desiredSize);
-    if (ret != 0) {
-        IMAGE_LOGE("[IncrementalSourceStream]copy data fail, ret:%{public}d, bufferSize:%{public}u, \
-                    offset:%{public}zu, desiredSize:%{public}u, dataSize:%{public}zu.",
-                   ret, bufferSize, dataOffset_, desiredSize, dataSize_);
-        return false;
-    }
+    // copies straight out of the chunks, nothing is joined for a caller owned buffer.
+    CopyData(dataOffset_, outBuffer, desiredSize);
     readSize = desiredSize;
     return true;
 }
@@ -135,23 +135,90 @@ uint32_t IncrementalSourceStream::UpdateData(const uint8_t *data, uint32_t size,
         return SUCCESS;
     }
     if (incrementalMode_ == IncrementalMode::INCREMENTAL_DATA) {
-        vector<uint8_t> newData;
-        newData.resize(size);
-        copy(data, data + size, newData.begin());
-        sourceData_.resize(dataSize_ + size);
-        sourceData_.insert(sourceData_.begin() + dataSize_, newData.begin(), newData.end());
+        if (size > maxBufferSize_ || dataSize_ > maxBufferSize_ - size) {
+            IMAGE_LOGE("[IncrementalSourceStream]buffered data too large, dataSize_:%{public}zu, size:%{public}u, \
+                       max:%{public}zu.", dataSize_, size, maxBufferSize_);
+            return ERR_IMAGE_TOO_LARGE;
+        }
+        // only the new bytes are copied, the buffered ones never move on append.
+        chunks_.emplace_back(data, data + size);
         dataSize_ += size;
         isFinalize_ = isCompleted;
     } else {
-        sourceData_.clear();
-        sourceData_.resize(size);
+        if (size > maxBufferSize_) {
+            IMAGE_LOGE("[IncrementalSourceStream]data too large, size:%{public}u, max:%{public}zu.", size,
+                       maxBufferSize_);
+            return ERR_IMAGE_TOO_LARGE;
+        }
+        chunks_.clear();
+        sourceData_.assign(data, data + size);
         dataSize_ = size;
-        copy(data, data + size, sourceData_.begin());
         isFinalize_ = true;
     }
     return SUCCESS;
 }
 
+void IncrementalSourceStream::SetMaxBufferSize(size_t maxSize)
+{
+    maxBufferSize_ = maxSize;
+}
+
+const uint8_t *IncrementalSourceStream::GetContiguousData(size_t offset, size_t size, size_t &contiguousSize)
+{
+    size_t end = offset + size;
+    if (end <= sourceData_.size()) {
+        contiguousSize = sourceData_.size() - offset;
+        return sourceData_.data() + offset;
+    }
+    size_t chunkStart = sourceData_.size();
+    for (const auto &chunk : chunks_) {
+        size_t chunkEnd = chunkStart + chunk.size();
+        if (end <= chunkEnd) {
+            if (offset >= chunkStart) {
+                contiguousSize = chunkEnd - offset;
+                return chunk.data() + (offset - chunkStart);
+            }
+            break;
+        }
+        chunkStart = chunkEnd;
+    }
+    // the range spans a chunk boundary, join the chunks up to its end into the contiguous view. every byte is
+    // joined once and the view grows geometrically, the chunks after the range are left alone.
+    while (sourceData_.size() < end && !chunks_.empty()) {
+        if (sourceData_.empty()) {
+            sourceData_.swap(chunks_.front());
+        } else {
+            sourceData_.insert(sourceData_.end(), chunks_.front().begin(), chunks_.front().end());
+        }
+        chunks_.pop_front();
+    }
+    contiguousSize = sourceData_.size() - offset;
+    return sourceData_.data() + offset;
+}
+
+void IncrementalSourceStream::CopyData(size_t offset, uint8_t *outBuffer, size_t size) const
+{
+    size_t chunkStart = 0;
+    const vector<uint8_t> *chunk = &sourceData_;
+    auto next = chunks_.begin();
+    while (size > 0) {
+        size_t chunkEnd = chunkStart + chunk->size();
+        if (offset < chunkEnd) {
+            size_t count = min(size, chunkEnd - offset);
+            copy(chunk->begin() + (offset - chunkStart), chunk->begin() + (offset - chunkStart + count), outBuffer);
+            outBuffer += count;
+            offset += count;
+            size -= count;
+        }
+        if (size == 0 || next == chunks_.end()) {
+            break;
+        }
+        chunkStart = chunkEnd;
+        chunk = &(*next);
+        ++next;
+    }
+}
+
 bool IncrementalSourceStream::IsStreamCompleted()
 {
     return isFinalize_;
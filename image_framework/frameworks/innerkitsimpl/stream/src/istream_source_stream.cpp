@@ -15,6 +15,7 @@
 
 #include "istream_source_stream.h"
 #include "image_log.h"
+#include "image_metrics.h"
 #include "image_utils.h"
 
 namespace OHOS {
@@ -64,6 +65,7 @@ bool IstreamSourceStream::Read(uint32_t desiredSize, DataStreamBuffer &outData)
         return false;
     }
     streamOffset_ += outData.dataSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, outData.dataSize);
     return true;
 }
 
@@ -93,6 +95,7 @@ bool IstreamSourceStream::Read(uint32_t desiredSize, uint8_t *outBuffer, uint32_
         return false;
     }
     streamOffset_ += readSize;
+    ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, readSize);
     return true;
 }
 
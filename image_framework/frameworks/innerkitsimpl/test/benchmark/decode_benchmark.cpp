@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "animation_decoder.h"
+#include "image_benchmark.h"
+
+#include "image_source.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Multimedia {
+using namespace OHOS::Media;
+namespace {
+constexpr uint64_t RGBA_BYTES = 4;
+constexpr int32_t SEEK_IMAGE_SIZE = 480;
+constexpr int32_t SEEK_FRAME_COUNT = 120;
+constexpr uint32_t SEEK_STEP = 37;
+
+using Encoder = std::vector<uint8_t> (*)(int32_t width, int32_t height);
+
+void DecodeBuffer(BenchmarkState &state, const std::vector<uint8_t> &encoded, const std::string &formatHint)
+{
+    if (encoded.empty()) {
+        state.SkipWithError("no input for " + formatHint);
+        return;
+    }
+    SourceOptions sourceOpts;
+    sourceOpts.formatHint = formatHint;
+    DecodeOptions decodeOpts;
+    uint64_t pixels = 0;
+    while (state.KeepRunning()) {
+        uint32_t errorCode = 0;
+        std::unique_ptr<ImageSource> imageSource =
+            ImageSource::CreateImageSource(encoded.data(), encoded.size(), sourceOpts, errorCode);
+        if (errorCode != SUCCESS || imageSource == nullptr) {
+            state.SkipWithError("create " + formatHint + " source failed");
+            break;
+        }
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        if (errorCode != SUCCESS || pixelMap == nullptr) {
+            state.SkipWithError("decode " + formatHint + " failed");
+            break;
+        }
+        pixels = static_cast<uint64_t>(pixelMap->GetWidth()) * pixelMap->GetHeight();
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * pixels * RGBA_BYTES);
+}
+
+std::vector<uint8_t> EncodeJpeg(int32_t width, int32_t height)
+{
+    return EncodeWithPacker("image/jpeg", width, height);
+}
+
+std::vector<uint8_t> EncodeWebp(int32_t width, int32_t height)
+{
+    return EncodeWithPacker("image/webp", width, height);
+}
+
+void RunDecode(BenchmarkState &state, Encoder encoder, const std::string &formatHint)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(0));
+    DecodeBuffer(state, encoder(edge, edge), formatHint);
+}
+
+void BM_DecodeJpeg(BenchmarkState &state)
+{
+    RunDecode(state, EncodeJpeg, "image/jpeg");
+}
+
+void BM_DecodePng(BenchmarkState &state)
+{
+    RunDecode(state, EncodePng, "image/png");
+}
+
+void BM_DecodeGif(BenchmarkState &state)
+{
+    RunDecode(state, EncodeGif, "image/gif");
+}
+
+// frames of an animation picked out of order, args: keyframe interval, 0 composes every seek from the first frame.
+void BM_DecodeGifSeek(BenchmarkState &state)
+{
+    std::vector<uint8_t> encoded = EncodeAnimatedGif(SEEK_IMAGE_SIZE, SEEK_IMAGE_SIZE, SEEK_FRAME_COUNT);
+    SourceOptions sourceOpts;
+    sourceOpts.formatHint = "image/gif";
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(encoded.data(), encoded.size(), sourceOpts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        state.SkipWithError("create animated gif source failed");
+        return;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.keyframeInterval = static_cast<uint32_t>(state.Range(0));
+    uint32_t index = 0;
+    while (state.KeepRunning()) {
+        index = (index + SEEK_STEP) % SEEK_FRAME_COUNT;
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(index, decodeOpts, errorCode);
+        if (errorCode != SUCCESS || pixelMap == nullptr) {
+            state.SkipWithError("decode animated gif frame failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+// an animation played in order, args: 0 decodes a pixel map per frame, 1 plays it through an animation decoder.
+void BM_DecodeGifAnimation(BenchmarkState &state)
+{
+    std::vector<uint8_t> encoded = EncodeAnimatedGif(SEEK_IMAGE_SIZE, SEEK_IMAGE_SIZE, SEEK_FRAME_COUNT);
+    SourceOptions sourceOpts;
+    sourceOpts.formatHint = "image/gif";
+    uint32_t errorCode = 0;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(encoded.data(), encoded.size(), sourceOpts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        state.SkipWithError("create animated gif source failed");
+        return;
+    }
+    DecodeOptions decodeOpts;
+    if (state.Range(0) == 0) {
+        uint32_t index = 0;
+        while (state.KeepRunning()) {
+            std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(index, decodeOpts, errorCode);
+            if (errorCode != SUCCESS || pixelMap == nullptr) {
+                state.SkipWithError("decode animated gif frame failed");
+                break;
+            }
+            index = (index + 1) % SEEK_FRAME_COUNT;
+        }
+        state.SetItemsProcessed(state.Iterations());
+        return;
+    }
+    std::unique_ptr<AnimationDecoder> animationDecoder = imageSource->CreateAnimationDecoder(decodeOpts, errorCode);
+    if (errorCode != SUCCESS || animationDecoder == nullptr) {
+        state.SkipWithError("create animation decoder failed");
+        return;
+    }
+    uint64_t byteCount = animationDecoder->GetFrameByteCount();
+    std::vector<uint8_t> front(byteCount);
+    std::vector<uint8_t> back(byteCount);
+    animationDecoder->SetOutputBuffers(front.data(), back.data(), byteCount);
+    AnimationFrame frame;
+    while (state.KeepRunning()) {
+        if (animationDecoder->DecodeNextFrame(frame) != SUCCESS) {
+            state.SkipWithError("play animated gif frame failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+}
+
+void BM_DecodeWebp(BenchmarkState &state)
+{
+    RunDecode(state, EncodeWebp, "image/webp");
+}
+
+void BM_DecodeBmp(BenchmarkState &state)
+{
+    RunDecode(state, EncodeBmp, "image/bmp");
+}
+} // namespace
+
+IMAGE_BENCHMARK(BM_DecodeJpeg, GetImageSizes());
+IMAGE_BENCHMARK(BM_DecodePng, GetImageSizes());
+IMAGE_BENCHMARK(BM_DecodeGif, GetImageSizes());
+IMAGE_BENCHMARK(BM_DecodeGifSeek, { { 0 }, { DecodeOptions::DEFAULT_KEYFRAME_INTERVAL } });
+IMAGE_BENCHMARK(BM_DecodeGifAnimation, { { 0 }, { 1 } });
+IMAGE_BENCHMARK(BM_DecodeWebp, GetImageSizes());
+IMAGE_BENCHMARK(BM_DecodeBmp, GetImageSizes());
+} // namespace Multimedia
+} // namespace OHOS
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark.h"
+
+#include "image_packer.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Multimedia {
+using namespace OHOS::Media;
+namespace {
+constexpr uint64_t RGBA_BYTES = 4;
+constexpr uint8_t ENCODE_QUALITY = 90;
+constexpr uint32_t PACK_EXTRA_BYTES = 4096;
+constexpr int64_t TUNING_IMAGE_SIZE = 1024;
+// one restart marker every 64 MCUs, against none.
+constexpr int64_t TUNING_RESTART_INTERVAL = 64;
+// the zlib level of the preset.
+constexpr int64_t DEFAULT_PNG_LEVEL = -1;
+enum TuningArg : size_t {
+    ARG_EDGE = 0,
+    ARG_SUBSAMPLING,
+    ARG_OPTIMIZE_CODING,
+    ARG_PROGRESSIVE,
+    ARG_DCT_METHOD,
+    ARG_RESTART_INTERVAL,
+};
+enum PngTuningArg : size_t {
+    ARG_PNG_EDGE = 0,
+    ARG_PNG_SCREEN_CONTENT,
+    ARG_PNG_PRESET,
+    ARG_PNG_LEVEL,
+    ARG_PNG_FILTER,
+    ARG_PNG_STRATEGY,
+};
+
+void RunEncode(BenchmarkState &state, const PackOption &option, bool screenContent = false)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(ARG_EDGE));
+    std::vector<uint32_t> pixels = screenContent ? MakeScreenPixels(edge, edge) : MakeArgbPixels(edge, edge);
+    InitializationOptions opts;
+    opts.size.width = edge;
+    opts.size.height = edge;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(pixels.data(), pixels.size(), opts);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create pixel map failed");
+        return;
+    }
+    std::vector<uint8_t> out(static_cast<size_t>(edge) * edge * RGBA_BYTES + PACK_EXTRA_BYTES);
+    int64_t packedSize = 0;
+    while (state.KeepRunning()) {
+        ImagePacker packer;
+        if (packer.StartPacking(out.data(), out.size(), option) != SUCCESS ||
+            packer.AddImage(*pixelMap) != SUCCESS || packer.FinalizePacking(packedSize) != SUCCESS) {
+            state.SkipWithError("encode " + option.format + " failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * static_cast<uint64_t>(edge) * edge * RGBA_BYTES);
+    state.SetCounter("encoded_bytes", static_cast<double>(packedSize));
+}
+
+PackOption MakePackOption(const std::string &format)
+{
+    PackOption option;
+    option.format = format;
+    option.quality = ENCODE_QUALITY;
+    return option;
+}
+
+void BM_EncodeJpeg(BenchmarkState &state)
+{
+    RunEncode(state, MakePackOption("image/jpeg"));
+}
+
+void BM_EncodePng(BenchmarkState &state)
+{
+    RunEncode(state, MakePackOption("image/png"));
+}
+
+void BM_EncodeWebp(BenchmarkState &state)
+{
+    RunEncode(state, MakePackOption("image/webp"));
+}
+
+// The args are edge/subsampling/optimizeCoding/progressive/dctMethod/restartInterval.
+void BM_EncodeJpegTuning(BenchmarkState &state)
+{
+    PackOption option = MakePackOption("image/jpeg");
+    option.subsampling = static_cast<ChromaSubsampling>(state.Range(ARG_SUBSAMPLING));
+    option.optimizeCoding = (state.Range(ARG_OPTIMIZE_CODING) != 0);
+    option.progressive = (state.Range(ARG_PROGRESSIVE) != 0);
+    option.dctMethod = static_cast<DctMethod>(state.Range(ARG_DCT_METHOD));
+    option.restartInterval = static_cast<uint32_t>(state.Range(ARG_RESTART_INTERVAL));
+    RunEncode(state, option);
+}
+
+std::vector<std::vector<int64_t>> GetJpegTuningArgs()
+{
+    const std::vector<ChromaSubsampling> subsamplings = {
+        ChromaSubsampling::YUV444, ChromaSubsampling::YUV422, ChromaSubsampling::YUV420
+    };
+    const std::vector<DctMethod> dctMethods = { DctMethod::ISLOW, DctMethod::IFAST, DctMethod::FLOAT };
+    std::vector<std::vector<int64_t>> argsList;
+    for (ChromaSubsampling subsampling : subsamplings) {
+        for (int64_t optimizeCoding = 0; optimizeCoding <= 1; optimizeCoding++) {
+            for (int64_t progressive = 0; progressive <= 1; progressive++) {
+                for (DctMethod dctMethod : dctMethods) {
+                    for (int64_t restartInterval : { static_cast<int64_t>(0), TUNING_RESTART_INTERVAL }) {
+                        argsList.push_back({ TUNING_IMAGE_SIZE, static_cast<int64_t>(subsampling), optimizeCoding,
+                            progressive, static_cast<int64_t>(dctMethod), restartInterval });
+                    }
+                }
+            }
+        }
+    }
+    return argsList;
+}
+
+// The args are edge/screenContent/preset/compressionLevel/pngFilter/compressionStrategy, encoded_bytes against
+// bytes_per_second is the size and speed trade of each setting.
+void BM_EncodePngTuning(BenchmarkState &state)
+{
+    PackOption option = MakePackOption("image/png");
+    option.preset = static_cast<EncodePreset>(state.Range(ARG_PNG_PRESET));
+    option.compressionLevel = static_cast<int32_t>(state.Range(ARG_PNG_LEVEL));
+    option.pngFilter = static_cast<PngFilter>(state.Range(ARG_PNG_FILTER));
+    option.compressionStrategy = static_cast<CompressionStrategy>(state.Range(ARG_PNG_STRATEGY));
+    RunEncode(state, option, state.Range(ARG_PNG_SCREEN_CONTENT) != 0);
+}
+
+std::vector<std::vector<int64_t>> GetPngTuningArgs()
+{
+    const std::vector<int64_t> levels = { 1, 6, 9 };
+    const std::vector<PngFilter> filters = { PngFilter::NONE, PngFilter::SUB, PngFilter::UP, PngFilter::ADAPTIVE };
+    const std::vector<CompressionStrategy> strategies = { CompressionStrategy::DEFAULT, CompressionStrategy::RLE };
+    std::vector<std::vector<int64_t>> argsList;
+    for (int64_t screenContent = 0; screenContent <= 1; screenContent++) {
+        for (EncodePreset preset : { EncodePreset::DEFAULT, EncodePreset::FAST }) {
+            argsList.push_back({ TUNING_IMAGE_SIZE, screenContent, static_cast<int64_t>(preset), DEFAULT_PNG_LEVEL,
+                static_cast<int64_t>(PngFilter::DEFAULT), static_cast<int64_t>(CompressionStrategy::DEFAULT) });
+        }
+        for (int64_t level : levels) {
+            for (PngFilter filter : filters) {
+                for (CompressionStrategy strategy : strategies) {
+                    argsList.push_back({ TUNING_IMAGE_SIZE, screenContent, static_cast<int64_t>(EncodePreset::DEFAULT),
+                        level, static_cast<int64_t>(filter), static_cast<int64_t>(strategy) });
+                }
+            }
+        }
+    }
+    return argsList;
+}
+} // namespace
+
+IMAGE_BENCHMARK(BM_EncodeJpeg, GetImageSizes());
+IMAGE_BENCHMARK(BM_EncodePng, GetImageSizes());
+IMAGE_BENCHMARK(BM_EncodeWebp, GetImageSizes());
+IMAGE_BENCHMARK(BM_EncodeJpegTuning, GetJpegTuningArgs());
+IMAGE_BENCHMARK(BM_EncodePngTuning, GetPngTuningArgs());
+} // namespace Multimedia
+} // namespace OHOS
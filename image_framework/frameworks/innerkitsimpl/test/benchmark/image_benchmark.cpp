@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "pixel_convert_kernels.h"
+
+namespace {
+std::atomic<uint64_t> g_allocCount(0);
+std::atomic<uint64_t> g_allocBytes(0);
+
+inline void CountAlloc(size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+}
+} // namespace
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+// Interposes the allocator of the whole process, operator new and the decoder libraries included.
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    CountAlloc(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    CountAlloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    CountAlloc(size);
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace OHOS {
+namespace Multimedia {
+namespace {
+constexpr double DEFAULT_MIN_TIME = 0.5;
+constexpr uint64_t MAX_ITERATIONS = 1000000;
+constexpr double NS_PER_SECOND = 1e9;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+constexpr int64_t IMAGE_SIZE_SMALL = 256;
+constexpr int64_t IMAGE_SIZE_MEDIUM = 1024;
+constexpr int64_t IMAGE_SIZE_LARGE = 2048;
+constexpr size_t DATE_LENGTH = 64;
+
+struct BenchmarkCase {
+    std::string name;
+    BenchmarkFunction function;
+    std::vector<int64_t> args;
+};
+
+std::vector<BenchmarkCase> &GetCases()
+{
+    static std::vector<BenchmarkCase> cases;
+    return cases;
+}
+
+int64_t GetCpuTime()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<int64_t>(now.tv_sec) * static_cast<int64_t>(NS_PER_SECOND) + now.tv_nsec;
+}
+
+std::string EscapeJson(const std::string &value)
+{
+    std::string result;
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+} // namespace
+
+BenchmarkState::BenchmarkState(const std::vector<int64_t> &args, double minTime)
+    : args_(args), minTime_(minTime), maxIterations_(MAX_ITERATIONS)
+{}
+
+bool BenchmarkState::KeepRunning()
+{
+    if (finished_) {
+        return false;
+    }
+    if (!started_) {
+        started_ = true;
+        if (error_.empty()) {
+            StartTimer();
+            return true;
+        }
+    } else {
+        iterations_++;
+    }
+    double elapsed = realTime_;
+    if (running_) {
+        elapsed += std::chrono::duration<double>(Clock::now() - startTime_).count();
+    }
+    if (!error_.empty() || iterations_ >= maxIterations_ || elapsed >= minTime_) {
+        if (running_) {
+            StopTimer();
+        }
+        finished_ = true;
+        return false;
+    }
+    return true;
+}
+
+void BenchmarkState::StartTimer()
+{
+    running_ = true;
+    allocStart_ = g_allocCount.load(std::memory_order_relaxed);
+    allocBytesStart_ = g_allocBytes.load(std::memory_order_relaxed);
+    cpuStartTime_ = GetCpuTime();
+    startTime_ = Clock::now();
+}
+
+void BenchmarkState::StopTimer()
+{
+    realTime_ += std::chrono::duration<double>(Clock::now() - startTime_).count();
+    cpuTime_ += static_cast<double>(GetCpuTime() - cpuStartTime_) / NS_PER_SECOND;
+    allocCount_ += g_allocCount.load(std::memory_order_relaxed) - allocStart_;
+    allocBytes_ += g_allocBytes.load(std::memory_order_relaxed) - allocBytesStart_;
+    running_ = false;
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (running_) {
+        StopTimer();
+    }
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (!running_ && started_ && !finished_) {
+        StartTimer();
+    }
+}
+
+void BenchmarkState::SetBytesProcessed(uint64_t bytes)
+{
+    bytesProcessed_ = bytes;
+}
+
+void BenchmarkState::SetItemsProcessed(uint64_t items)
+{
+    itemsProcessed_ = items;
+}
+
+void BenchmarkState::SetCounter(const std::string &name, double value)
+{
+    for (auto &counter : counters_) {
+        if (counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    counters_.emplace_back(name, value);
+}
+
+void BenchmarkState::SkipWithError(const std::string &message)
+{
+    error_ = message;
+}
+
+int64_t BenchmarkState::Range(size_t index) const
+{
+    return (index < args_.size()) ? args_[index] : 0;
+}
+
+uint64_t BenchmarkState::Iterations() const
+{
+    return iterations_;
+}
+
+bool RegisterBenchmark(const std::string &name, BenchmarkFunction function,
+                       const std::vector<std::vector<int64_t>> &argsList)
+{
+    for (const auto &args : argsList) {
+        std::string fullName = name;
+        for (int64_t arg : args) {
+            fullName += "/" + std::to_string(arg);
+        }
+        GetCases().push_back(BenchmarkCase { fullName, function, args });
+    }
+    return true;
+}
+
+const std::vector<std::vector<int64_t>> &GetImageSizes()
+{
+    static const std::vector<std::vector<int64_t>> sizes = {
+        { IMAGE_SIZE_SMALL }, { IMAGE_SIZE_MEDIUM }, { IMAGE_SIZE_LARGE }
+    };
+    return sizes;
+}
+
+class BenchmarkRunner {
+public:
+    int Run(int argc, char **argv);
+
+private:
+    void ParseArgs(int argc, char **argv);
+    std::string ToJson() const;
+    void PrintConsole(const std::string &name, const BenchmarkState &state) const;
+    void AddResult(const std::string &name, const BenchmarkState &state);
+    std::string filter_;
+    std::string format_ = "console";
+    std::string outPath_;
+    double minTime_ = DEFAULT_MIN_TIME;
+    bool listOnly_ = false;
+    std::vector<std::string> results_;
+};
+
+void BenchmarkRunner::ParseArgs(int argc, char **argv)
+{
+    const std::string filterFlag = "--benchmark_filter=";
+    const std::string formatFlag = "--benchmark_format=";
+    const std::string outFlag = "--benchmark_out=";
+    const std::string minTimeFlag = "--benchmark_min_time=";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, filterFlag.size(), filterFlag) == 0) {
+            filter_ = arg.substr(filterFlag.size());
+        } else if (arg.compare(0, formatFlag.size(), formatFlag) == 0) {
+            format_ = arg.substr(formatFlag.size());
+        } else if (arg.compare(0, outFlag.size(), outFlag) == 0) {
+            outPath_ = arg.substr(outFlag.size());
+        } else if (arg.compare(0, minTimeFlag.size(), minTimeFlag) == 0) {
+            minTime_ = std::atof(arg.substr(minTimeFlag.size()).c_str());
+        } else if (arg == "--benchmark_list_tests") {
+            listOnly_ = true;
+        } else {
+            std::cerr << "unknown argument " << arg << std::endl;
+        }
+    }
+}
+
+void BenchmarkRunner::PrintConsole(const std::string &name, const BenchmarkState &state) const
+{
+    if (!state.error_.empty()) {
+        std::printf("%-44s ERROR: %s\n", name.c_str(), state.error_.c_str());
+        return;
+    }
+    double iterations = static_cast<double>(state.iterations_);
+    double megaBytesPerSecond = (state.realTime_ > 0) ?
+        static_cast<double>(state.bytesProcessed_) / state.realTime_ / BYTES_PER_MB : 0;
+    std::printf("%-44s %14.0f %14.0f %10llu %10.2f %12.1f", name.c_str(),
+        state.realTime_ * NS_PER_SECOND / iterations, state.cpuTime_ * NS_PER_SECOND / iterations,
+        static_cast<unsigned long long>(state.iterations_), megaBytesPerSecond,
+        static_cast<double>(state.allocCount_) / iterations);
+    for (const auto &counter : state.counters_) {
+        std::printf(" %s=%g", counter.first.c_str(), counter.second);
+    }
+    std::printf("\n");
+}
+
+void BenchmarkRunner::AddResult(const std::string &name, const BenchmarkState &state)
+{
+    std::ostringstream out;
+    out << "    {\n";
+    out << "      \"name\": \"" << EscapeJson(name) << "\",\n";
+    out << "      \"run_name\": \"" << EscapeJson(name) << "\",\n";
+    out << "      \"run_type\": \"iteration\",\n";
+    if (!state.error_.empty()) {
+        out << "      \"error_occurred\": true,\n";
+        out << "      \"error_message\": \"" << EscapeJson(state.error_) << "\"\n";
+        out << "    }";
+        results_.push_back(out.str());
+        return;
+    }
+    double iterations = static_cast<double>(state.iterations_);
+    out << "      \"iterations\": " << state.iterations_ << ",\n";
+    out << "      \"real_time\": " << state.realTime_ * NS_PER_SECOND / iterations << ",\n";
+    out << "      \"cpu_time\": " << state.cpuTime_ * NS_PER_SECOND / iterations << ",\n";
+    out << "      \"time_unit\": \"ns\",\n";
+    if (state.realTime_ > 0) {
+        out << "      \"bytes_per_second\": " << static_cast<double>(state.bytesProcessed_) / state.realTime_ << ",\n";
+        out << "      \"items_per_second\": " << static_cast<double>(state.itemsProcessed_) / state.realTime_ << ",\n";
+    }
+    for (const auto &counter : state.counters_) {
+        out << "      \"" << EscapeJson(counter.first) << "\": " << counter.second << ",\n";
+    }
+    out << "      \"allocs_per_iter\": " << static_cast<double>(state.allocCount_) / iterations << ",\n";
+    out << "      \"alloc_bytes_per_iter\": " << static_cast<double>(state.allocBytes_) / iterations << "\n";
+    out << "    }";
+    results_.push_back(out.str());
+}
+
+std::string BenchmarkRunner::ToJson() const
+{
+    char date[DATE_LENGTH] = { 0 };
+    time_t now = time(nullptr);
+    struct tm localTime = {};
+    localtime_r(&now, &localTime);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &localTime);
+    std::ostringstream out;
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"pixel_convert_kernel\": \"" << Media::PixelConvertKernels::GetKernelName() << "\",\n";
+    out << "    \"min_time\": " << minTime_ << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results_.size(); i++) {
+        out << results_[i] << ((i + 1 < results_.size()) ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return out.str();
+}
+
+int BenchmarkRunner::Run(int argc, char **argv)
+{
+    ParseArgs(argc, argv);
+    bool console = (format_ != "json");
+    if (console && !listOnly_) {
+        std::printf("%-44s %14s %14s %10s %10s %12s\n", "Benchmark", "Time(ns)", "CPU(ns)", "Iterations",
+            "MB/s", "Allocs/iter");
+    }
+    for (const auto &benchmarkCase : GetCases()) {
+        if (!filter_.empty() && benchmarkCase.name.find(filter_) == std::string::npos) {
+            continue;
+        }
+        if (listOnly_) {
+            std::printf("%s\n", benchmarkCase.name.c_str());
+            continue;
+        }
+        BenchmarkState state(benchmarkCase.args, minTime_);
+        benchmarkCase.function(state);
+        if (state.iterations_ == 0 && state.error_.empty()) {
+            state.SkipWithError("the benchmark did not run");
+        }
+        if (console) {
+            PrintConsole(benchmarkCase.name, state);
+        }
+        AddResult(benchmarkCase.name, state);
+    }
+    if (listOnly_) {
+        return 0;
+    }
+    std::string json = ToJson();
+    if (!console) {
+        std::printf("%s", json.c_str());
+    }
+    if (!outPath_.empty()) {
+        std::ofstream out(outPath_);
+        if (!out) {
+            std::cerr << "can not write " << outPath_ << std::endl;
+            return 1;
+        }
+        out << json;
+    }
+    return 0;
+}
+} // namespace Multimedia
+} // namespace OHOS
+
+int main(int argc, char **argv)
+{
+    OHOS::Multimedia::BenchmarkRunner runner;
+    return runner.Run(argc, argv);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARK_IMAGE_BENCHMARK_H_
+#define FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARK_IMAGE_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Multimedia {
+/*
+ * A small runner in the manner of Google Benchmark, so the suite builds without extra dependencies.
+ * A benchmark runs its setup, then loops on KeepRunning. Only the loop is timed, and the heap
+ * allocations made inside the loop are counted.
+ */
+class BenchmarkState {
+public:
+    BenchmarkState(const std::vector<int64_t> &args, double minTime);
+    bool KeepRunning();
+    // Excludes per iteration setup (copying the input of an in place transform, ...) from the time.
+    void PauseTiming();
+    void ResumeTiming();
+    void SetBytesProcessed(uint64_t bytes);
+    void SetItemsProcessed(uint64_t items);
+    // A user counter, reported next to the timings like the counters of Google Benchmark.
+    void SetCounter(const std::string &name, double value);
+    void SkipWithError(const std::string &message);
+    int64_t Range(size_t index) const;
+    uint64_t Iterations() const;
+
+private:
+    friend class BenchmarkRunner;
+    using Clock = std::chrono::steady_clock;
+    void StartTimer();
+    void StopTimer();
+    std::vector<int64_t> args_;
+    double minTime_ = 0;
+    bool started_ = false;
+    bool running_ = false;
+    bool finished_ = false;
+    uint64_t iterations_ = 0;
+    uint64_t maxIterations_ = 0;
+    Clock::time_point startTime_;
+    int64_t cpuStartTime_ = 0;
+    uint64_t allocStart_ = 0;
+    uint64_t allocBytesStart_ = 0;
+    double realTime_ = 0;
+    double cpuTime_ = 0;
+    uint64_t allocCount_ = 0;
+    uint64_t allocBytes_ = 0;
+    uint64_t bytesProcessed_ = 0;
+    uint64_t itemsProcessed_ = 0;
+    std::vector<std::pair<std::string, double>> counters_;
+    std::string error_;
+};
+
+using BenchmarkFunction = void (*)(BenchmarkState &state);
+
+// The name is reported as name/arg0/arg1.
+bool RegisterBenchmark(const std::string &name, BenchmarkFunction function,
+                       const std::vector<std::vector<int64_t>> &argsList = { {} });
+
+// Edges of the square synthetic images.
+const std::vector<std::vector<int64_t>> &GetImageSizes();
+
+/*
+ * Synthetic inputs, the same for every run. The pattern mixes gradients and noise so the encoders
+ * and the decoders see neither a flat image nor pure noise.
+ */
+std::vector<uint32_t> MakeArgbPixels(int32_t width, int32_t height);
+// Flat areas, text and icons, the content of a screen shot.
+std::vector<uint32_t> MakeScreenPixels(int32_t width, int32_t height);
+std::vector<uint8_t> MakeNv21Buffer(int32_t width, int32_t height);
+std::vector<uint8_t> EncodeBmp(int32_t width, int32_t height);
+std::vector<uint8_t> EncodePng(int32_t width, int32_t height);
+std::vector<uint8_t> EncodeGif(int32_t width, int32_t height);
+// A full first frame, then a patch moving over it in every other frame.
+std::vector<uint8_t> EncodeAnimatedGif(int32_t width, int32_t height, int32_t frameCount);
+// Through ImagePacker, empty on error.
+std::vector<uint8_t> EncodeWithPacker(const std::string &format, int32_t width, int32_t height);
+} // namespace Multimedia
+} // namespace OHOS
+
+#define IMAGE_BENCHMARK(function, ...) \
+    static const bool function##_REGISTERED = OHOS::Multimedia::RegisterBenchmark(#function, function, __VA_ARGS__)
+
+#endif // FRAMEWORKS_INNERKITSIMPL_TEST_BENCHMARK_IMAGE_BENCHMARK_H_
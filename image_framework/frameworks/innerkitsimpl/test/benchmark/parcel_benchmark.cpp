@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark.h"
+
+#include "parcel.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Multimedia {
+using namespace OHOS::Media;
+namespace {
+constexpr uint64_t RGBA_BYTES = 4;
+
+std::unique_ptr<PixelMap> CreatePixelMap(int32_t edge)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(edge, edge);
+    InitializationOptions opts;
+    opts.size.width = edge;
+    opts.size.height = edge;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    return PixelMap::Create(pixels.data(), pixels.size(), opts);
+}
+
+void BM_PixelMapMarshalling(BenchmarkState &state)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(0));
+    std::unique_ptr<PixelMap> pixelMap = CreatePixelMap(edge);
+    if (pixelMap == nullptr) {
+        state.SkipWithError("create pixel map failed");
+        return;
+    }
+    while (state.KeepRunning()) {
+        Parcel parcel;
+        if (!pixelMap->Marshalling(parcel)) {
+            state.SkipWithError("marshalling failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * static_cast<uint64_t>(edge) * edge * RGBA_BYTES);
+}
+
+void BM_PixelMapUnmarshalling(BenchmarkState &state)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(0));
+    std::unique_ptr<PixelMap> pixelMap = CreatePixelMap(edge);
+    Parcel parcel;
+    if (pixelMap == nullptr || !pixelMap->Marshalling(parcel)) {
+        state.SkipWithError("marshalling failed");
+        return;
+    }
+    while (state.KeepRunning()) {
+        parcel.RewindRead(0);
+        std::unique_ptr<PixelMap> result(PixelMap::Unmarshalling(parcel));
+        if (result == nullptr) {
+            state.SkipWithError("unmarshalling failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * static_cast<uint64_t>(edge) * edge * RGBA_BYTES);
+}
+} // namespace
+
+IMAGE_BENCHMARK(BM_PixelMapMarshalling, GetImageSizes());
+IMAGE_BENCHMARK(BM_PixelMapUnmarshalling, GetImageSizes());
+} // namespace Multimedia
+} // namespace OHOS
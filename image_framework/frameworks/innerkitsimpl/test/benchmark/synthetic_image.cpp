@@ -0,0 +1,422 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark.h"
+
+#include <algorithm>
+#include "image_packer.h"
+#include "media_errors.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Multimedia {
+using namespace OHOS::Media;
+namespace {
+constexpr uint32_t LCG_MUL = 1103515245;
+constexpr uint32_t LCG_ADD = 12345;
+constexpr uint32_t NOISE_SHIFT = 16;
+constexpr uint32_t NOISE_MASK = 0x1F;
+constexpr uint32_t BYTE_MASK = 0xFF;
+constexpr uint32_t SHIFT_8 = 8;
+constexpr uint32_t SHIFT_16 = 16;
+constexpr uint32_t SHIFT_24 = 24;
+constexpr uint32_t OPAQUE = 0xFF;
+constexpr uint32_t BMP_FILE_HEADER_SIZE = 14;
+constexpr uint32_t BMP_INFO_HEADER_SIZE = 40;
+constexpr uint32_t BMP_BITS_PER_PIXEL = 24;
+constexpr uint32_t BMP_ROW_ALIGN = 4;
+constexpr uint32_t RGB_BYTES = 3;
+constexpr uint32_t RGBA_BYTES = 4;
+constexpr uint32_t PNG_BIT_DEPTH = 8;
+constexpr uint32_t PNG_COLOR_RGBA = 6;
+constexpr uint32_t DEFLATE_STORED_MAX = 65535;
+constexpr uint32_t ADLER_MOD = 65521;
+constexpr uint32_t CRC_POLY = 0xEDB88320;
+constexpr uint32_t CRC_TABLE_SIZE = 256;
+constexpr uint32_t GIF_COLORS = 256;
+constexpr uint32_t GIF_CODE_SIZE = 8;
+constexpr uint32_t GIF_CLEAR_CODE = 256;
+constexpr uint32_t GIF_END_CODE = 257;
+constexpr uint32_t GIF_CODE_BITS = 9;
+// literals between clear codes, keeps the code table and so the code width fixed at 9 bits.
+constexpr uint32_t GIF_CLEAR_INTERVAL = 250;
+constexpr uint32_t GIF_SUB_BLOCK_MAX = 255;
+// global color table present, 8 bit color resolution, 256 entries
+constexpr uint8_t GIF_SCREEN_FLAGS = 0xF7;
+// animation frames: a graphic control extension, kept disposal, 10 ms delay, then a patch moving over the screen.
+constexpr uint8_t GIF_CONTROL_LABEL = 0xF9;
+constexpr uint8_t GIF_CONTROL_SIZE = 4;
+constexpr uint8_t GIF_DISPOSE_NONE = 0x04;
+constexpr uint8_t GIF_DELAY = 1;
+constexpr int32_t GIF_PATCH_DIVISOR = 4;
+constexpr int32_t GIF_PATCH_STEP = 7;
+// palette index bits: rrrgggbb
+constexpr uint32_t GIF_RED_SHIFT = 5;
+constexpr uint32_t GIF_GREEN_SHIFT = 2;
+constexpr uint32_t GIF_RED_GREEN_MAX = 7;
+constexpr uint32_t GIF_BLUE_MAX = 3;
+constexpr uint32_t GIF_RED_MASK = 0xE0;
+constexpr uint32_t GIF_GREEN_MASK = 0x1C;
+constexpr uint32_t GIF_GREEN_DROP = 3;
+constexpr uint32_t GIF_BLUE_DROP = 6;
+constexpr uint8_t ZLIB_CMF = 0x78;
+constexpr uint8_t ZLIB_FLG = 0x01;
+constexpr uint8_t JPEG_QUALITY = 90;
+constexpr uint32_t PACK_EXTRA_BYTES = 4096;
+// screen content: a title bar, a side panel, lines of glyphs and a few icons on a flat background.
+constexpr uint32_t SCREEN_BACKGROUND = 0xFFF5F5F8;
+constexpr uint32_t SCREEN_TITLE_BAR = 0xFF2196F3;
+constexpr uint32_t SCREEN_PANEL = 0xFFFFFFFF;
+constexpr uint32_t SCREEN_TEXT = 0xFF303030;
+constexpr int32_t SCREEN_TITLE_DIVISOR = 16;
+constexpr int32_t SCREEN_PANEL_DIVISOR = 5;
+constexpr int32_t GLYPH_WIDTH = 7;
+constexpr int32_t GLYPH_HEIGHT = 12;
+constexpr int32_t GLYPH_ADVANCE = 9;
+constexpr int32_t LINE_ADVANCE = 24;
+// one glyph cell in this many is a space.
+constexpr uint32_t GLYPH_SPACE_PERIOD = 6;
+constexpr int32_t ICON_EDGE = 48;
+constexpr int32_t ICON_PERIOD = 4;
+
+void PutLe16(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back(value & BYTE_MASK);
+    out.push_back((value >> SHIFT_8) & BYTE_MASK);
+}
+
+void PutLe32(std::vector<uint8_t> &out, uint32_t value)
+{
+    PutLe16(out, value);
+    PutLe16(out, value >> SHIFT_16);
+}
+
+void PutBe32(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back((value >> SHIFT_24) & BYTE_MASK);
+    out.push_back((value >> SHIFT_16) & BYTE_MASK);
+    out.push_back((value >> SHIFT_8) & BYTE_MASK);
+    out.push_back(value & BYTE_MASK);
+}
+
+uint32_t Crc32(const uint8_t *data, size_t size)
+{
+    static uint32_t table[CRC_TABLE_SIZE] = { 0 };
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < CRC_TABLE_SIZE; i++) {
+            uint32_t c = i;
+            for (uint32_t k = 0; k < SHIFT_8; k++) {
+                c = (c & 1) ? (CRC_POLY ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        ready = true;
+    }
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & BYTE_MASK] ^ (crc >> SHIFT_8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+void PutPngChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data)
+{
+    PutBe32(out, data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + RGBA_BYTES);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBe32(out, Crc32(out.data() + start, out.size() - start));
+}
+
+uint8_t GetChannel(uint32_t argb, uint32_t shift)
+{
+    return static_cast<uint8_t>((argb >> shift) & BYTE_MASK);
+}
+void PutGifScreen(std::vector<uint8_t> &out, int32_t width, int32_t height)
+{
+    const uint8_t signature[] = { 'G', 'I', 'F', '8', '9', 'a' };
+    out.insert(out.end(), signature, signature + sizeof(signature));
+    PutLe16(out, width);
+    PutLe16(out, height);
+    out.push_back(GIF_SCREEN_FLAGS);
+    out.push_back(0);
+    out.push_back(0);
+    for (uint32_t i = 0; i < GIF_COLORS; i++) {
+        out.push_back((i >> GIF_RED_SHIFT) * BYTE_MASK / GIF_RED_GREEN_MAX);
+        out.push_back(((i >> GIF_GREEN_SHIFT) & GIF_RED_GREEN_MAX) * BYTE_MASK / GIF_RED_GREEN_MAX);
+        out.push_back((i & GIF_BLUE_MAX) * BYTE_MASK / GIF_BLUE_MAX);
+    }
+}
+
+// an image block of pixels, width by height, drawn at left and top of the screen.
+void PutGifImage(std::vector<uint8_t> &out, const std::vector<uint32_t> &pixels, int32_t left, int32_t top,
+                 int32_t width, int32_t height)
+{
+    out.push_back(',');
+    PutLe16(out, left);
+    PutLe16(out, top);
+    PutLe16(out, width);
+    PutLe16(out, height);
+    out.push_back(0);
+    out.push_back(GIF_CODE_SIZE);
+
+    std::vector<uint8_t> codes;
+    uint32_t bitBuffer = 0;
+    uint32_t bitCount = 0;
+    auto putCode = [&codes, &bitBuffer, &bitCount](uint32_t code) {
+        bitBuffer |= code << bitCount;
+        bitCount += GIF_CODE_BITS;
+        while (bitCount >= SHIFT_8) {
+            codes.push_back(bitBuffer & BYTE_MASK);
+            bitBuffer >>= SHIFT_8;
+            bitCount -= SHIFT_8;
+        }
+    };
+    uint32_t sinceClear = GIF_CLEAR_INTERVAL;
+    for (uint32_t argb : pixels) {
+        if (sinceClear == GIF_CLEAR_INTERVAL) {
+            putCode(GIF_CLEAR_CODE);
+            sinceClear = 0;
+        }
+        uint32_t index = (GetChannel(argb, SHIFT_16) & GIF_RED_MASK) |
+            ((GetChannel(argb, SHIFT_8) >> GIF_GREEN_DROP) & GIF_GREEN_MASK) | (GetChannel(argb, 0) >> GIF_BLUE_DROP);
+        putCode(index);
+        sinceClear++;
+    }
+    putCode(GIF_END_CODE);
+    if (bitCount > 0) {
+        codes.push_back(bitBuffer & BYTE_MASK);
+    }
+    for (size_t offset = 0; offset < codes.size(); offset += GIF_SUB_BLOCK_MAX) {
+        size_t blockSize = std::min<size_t>(GIF_SUB_BLOCK_MAX, codes.size() - offset);
+        out.push_back(blockSize);
+        out.insert(out.end(), codes.begin() + offset, codes.begin() + offset + blockSize);
+    }
+    out.push_back(0);
+}
+} // namespace
+
+std::vector<uint32_t> MakeArgbPixels(int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+    uint32_t seed = 1;
+    for (int32_t y = 0; y < height; y++) {
+        for (int32_t x = 0; x < width; x++) {
+            seed = seed * LCG_MUL + LCG_ADD;
+            uint32_t noise = (seed >> NOISE_SHIFT) & NOISE_MASK;
+            uint32_t red = (static_cast<uint32_t>(x) * BYTE_MASK / width + noise) & BYTE_MASK;
+            uint32_t green = (static_cast<uint32_t>(y) * BYTE_MASK / height + noise) & BYTE_MASK;
+            uint32_t blue = ((static_cast<uint32_t>(x) ^ static_cast<uint32_t>(y)) + noise) & BYTE_MASK;
+            pixels[static_cast<size_t>(y) * width + x] =
+                (OPAQUE << SHIFT_24) | (red << SHIFT_16) | (green << SHIFT_8) | blue;
+        }
+    }
+    return pixels;
+}
+
+std::vector<uint32_t> MakeScreenPixels(int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height, SCREEN_BACKGROUND);
+    int32_t titleHeight = height / SCREEN_TITLE_DIVISOR;
+    int32_t panelWidth = width / SCREEN_PANEL_DIVISOR;
+    for (int32_t y = 0; y < height; y++) {
+        uint32_t *row = pixels.data() + static_cast<size_t>(y) * width;
+        for (int32_t x = 0; x < width; x++) {
+            if (y < titleHeight) {
+                row[x] = SCREEN_TITLE_BAR;
+                continue;
+            }
+            if (x < panelWidth) {
+                bool icon = ((y - titleHeight) / ICON_EDGE) % ICON_PERIOD == 0 && x < ICON_EDGE;
+                uint32_t shade = static_cast<uint32_t>(x + y) & BYTE_MASK;
+                row[x] = icon ? ((OPAQUE << SHIFT_24) | (shade << SHIFT_16) | (BYTE_MASK - shade)) : SCREEN_PANEL;
+                continue;
+            }
+            int32_t glyphX = (x - panelWidth) % GLYPH_ADVANCE;
+            int32_t glyphY = (y - titleHeight) % LINE_ADVANCE;
+            if (glyphX >= GLYPH_WIDTH || glyphY >= GLYPH_HEIGHT) {
+                continue;
+            }
+            // a hash of the glyph position picks the glyph, a hash of the glyph and the pixel lights its pixels.
+            uint32_t glyph = static_cast<uint32_t>((x - panelWidth) / GLYPH_ADVANCE * LCG_ADD +
+                (y - titleHeight) / LINE_ADVANCE) * LCG_MUL >> NOISE_SHIFT;
+            uint32_t cell = (glyph + static_cast<uint32_t>(glyphX * GLYPH_HEIGHT + glyphY)) * LCG_MUL >> NOISE_SHIFT;
+            if (glyph % GLYPH_SPACE_PERIOD != 0 && (cell & 1) != 0) {
+                row[x] = SCREEN_TEXT;
+            }
+        }
+    }
+    return pixels;
+}
+
+std::vector<uint8_t> MakeNv21Buffer(int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(width, height);
+    size_t ySize = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> buffer(ySize + ((width + 1) / 2) * ((height + 1) / 2) * 2);
+    for (size_t i = 0; i < ySize; i++) {
+        buffer[i] = GetChannel(pixels[i], SHIFT_8);
+    }
+    // the chroma follows the noise of the red and blue channels, its exact values do not matter.
+    for (size_t i = ySize; i < buffer.size(); i++) {
+        buffer[i] = GetChannel(pixels[(i - ySize) % ySize], (i & 1) ? 0 : SHIFT_16);
+    }
+    return buffer;
+}
+
+std::vector<uint8_t> EncodeBmp(int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(width, height);
+    uint32_t rowSize = (width * RGB_BYTES + BMP_ROW_ALIGN - 1) / BMP_ROW_ALIGN * BMP_ROW_ALIGN;
+    uint32_t imageSize = rowSize * height;
+    std::vector<uint8_t> out;
+    out.reserve(BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE + imageSize);
+    out.push_back('B');
+    out.push_back('M');
+    PutLe32(out, BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE + imageSize);
+    PutLe32(out, 0);
+    PutLe32(out, BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE);
+    PutLe32(out, BMP_INFO_HEADER_SIZE);
+    PutLe32(out, width);
+    PutLe32(out, height);
+    PutLe16(out, 1);
+    PutLe16(out, BMP_BITS_PER_PIXEL);
+    PutLe32(out, 0);
+    PutLe32(out, imageSize);
+    PutLe32(out, 0);
+    PutLe32(out, 0);
+    PutLe32(out, 0);
+    PutLe32(out, 0);
+    // bottom up rows of b, g, r
+    for (int32_t y = height - 1; y >= 0; y--) {
+        size_t rowStart = out.size();
+        for (int32_t x = 0; x < width; x++) {
+            uint32_t argb = pixels[static_cast<size_t>(y) * width + x];
+            out.push_back(GetChannel(argb, 0));
+            out.push_back(GetChannel(argb, SHIFT_8));
+            out.push_back(GetChannel(argb, SHIFT_16));
+        }
+        out.resize(rowStart + rowSize, 0);
+    }
+    return out;
+}
+
+std::vector<uint8_t> EncodePng(int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(width, height);
+    std::vector<uint8_t> raw;
+    raw.reserve((static_cast<size_t>(width) * RGBA_BYTES + 1) * height);
+    for (int32_t y = 0; y < height; y++) {
+        // filter type none
+        raw.push_back(0);
+        for (int32_t x = 0; x < width; x++) {
+            uint32_t argb = pixels[static_cast<size_t>(y) * width + x];
+            raw.push_back(GetChannel(argb, SHIFT_16));
+            raw.push_back(GetChannel(argb, SHIFT_8));
+            raw.push_back(GetChannel(argb, 0));
+            raw.push_back(GetChannel(argb, SHIFT_24));
+        }
+    }
+    // zlib stream of stored deflate blocks, the decode cost is in inflate and the row handling all the same.
+    std::vector<uint8_t> zlib = { ZLIB_CMF, ZLIB_FLG };
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    for (size_t offset = 0; offset < raw.size(); offset += DEFLATE_STORED_MAX) {
+        uint32_t blockSize = std::min<size_t>(DEFLATE_STORED_MAX, raw.size() - offset);
+        zlib.push_back((offset + blockSize == raw.size()) ? 1 : 0);
+        PutLe16(zlib, blockSize);
+        PutLe16(zlib, ~blockSize);
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        for (uint32_t i = 0; i < blockSize; i++) {
+            adlerA = (adlerA + raw[offset + i]) % ADLER_MOD;
+            adlerB = (adlerB + adlerA) % ADLER_MOD;
+        }
+    }
+    PutBe32(zlib, (adlerB << SHIFT_16) | adlerA);
+
+    std::vector<uint8_t> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> header;
+    PutBe32(header, width);
+    PutBe32(header, height);
+    header.push_back(PNG_BIT_DEPTH);
+    header.push_back(PNG_COLOR_RGBA);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+    PutPngChunk(out, "IHDR", header);
+    PutPngChunk(out, "IDAT", zlib);
+    PutPngChunk(out, "IEND", std::vector<uint8_t>());
+    return out;
+}
+
+std::vector<uint8_t> EncodeGif(int32_t width, int32_t height)
+{
+    std::vector<uint8_t> out;
+    PutGifScreen(out, width, height);
+    PutGifImage(out, MakeArgbPixels(width, height), 0, 0, width, height);
+    out.push_back(';');
+    return out;
+}
+
+std::vector<uint8_t> EncodeAnimatedGif(int32_t width, int32_t height, int32_t frameCount)
+{
+    std::vector<uint8_t> out;
+    PutGifScreen(out, width, height);
+    PutGifImage(out, MakeArgbPixels(width, height), 0, 0, width, height);
+    int32_t patchWidth = std::max(width / GIF_PATCH_DIVISOR, 1);
+    int32_t patchHeight = std::max(height / GIF_PATCH_DIVISOR, 1);
+    std::vector<uint32_t> patch = MakeArgbPixels(patchWidth, patchHeight);
+    for (int32_t frame = 1; frame < frameCount; frame++) {
+        const uint8_t control[] = { '!', GIF_CONTROL_LABEL, GIF_CONTROL_SIZE, GIF_DISPOSE_NONE, GIF_DELAY, 0, 0, 0 };
+        out.insert(out.end(), control, control + sizeof(control));
+        for (uint32_t &argb : patch) {
+            argb = ~argb | (OPAQUE << SHIFT_24);
+        }
+        int32_t left = (frame * GIF_PATCH_STEP) % (width - patchWidth + 1);
+        int32_t top = (frame * GIF_PATCH_STEP / GIF_PATCH_DIVISOR) % (height - patchHeight + 1);
+        PutGifImage(out, patch, left, top, patchWidth, patchHeight);
+    }
+    out.push_back(';');
+    return out;
+}
+
+std::vector<uint8_t> EncodeWithPacker(const std::string &format, int32_t width, int32_t height)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(width, height);
+    InitializationOptions opts;
+    opts.size.width = width;
+    opts.size.height = height;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(pixels.data(), pixels.size(), opts);
+    if (pixelMap == nullptr) {
+        return std::vector<uint8_t>();
+    }
+    std::vector<uint8_t> out(static_cast<size_t>(width) * height * RGBA_BYTES + PACK_EXTRA_BYTES);
+    ImagePacker packer;
+    PackOption option;
+    option.format = format;
+    option.quality = JPEG_QUALITY;
+    int64_t packedSize = 0;
+    if (packer.StartPacking(out.data(), out.size(), option) != SUCCESS || packer.AddImage(*pixelMap) != SUCCESS ||
+        packer.FinalizePacking(packedSize) != SUCCESS || packedSize <= 0) {
+        return std::vector<uint8_t>();
+    }
+    out.resize(packedSize);
+    return out;
+}
+} // namespace Multimedia
+} // namespace OHOS
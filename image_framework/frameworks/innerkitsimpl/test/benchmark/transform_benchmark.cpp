@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_benchmark.h"
+
+#include "image_source.h"
+#include "media_errors.h"
+#include "pixel_convert.h"
+#include "pixel_map.h"
+#include "post_proc.h"
+
+namespace OHOS {
+namespace Multimedia {
+using namespace OHOS::Media;
+namespace {
+constexpr uint64_t RGBA_BYTES = 4;
+constexpr uint32_t MAX_PIXEL_BYTES = 8;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr float HALF_SCALE = 0.5f;
+constexpr float ROTATE_DEGREES = 90.0f;
+
+std::unique_ptr<PixelMap> CreateSourcePixelMap(int32_t edge)
+{
+    std::vector<uint32_t> pixels = MakeArgbPixels(edge, edge);
+    InitializationOptions opts;
+    opts.size.width = edge;
+    opts.size.height = edge;
+    opts.pixelFormat = PixelFormat::RGBA_8888;
+    opts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    opts.editable = true;
+    return PixelMap::Create(pixels.data(), pixels.size(), opts);
+}
+
+template<typename Transform>
+void RunTransform(BenchmarkState &state, Transform transform)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(0));
+    std::unique_ptr<PixelMap> source = CreateSourcePixelMap(edge);
+    if (source == nullptr) {
+        state.SkipWithError("create pixel map failed");
+        return;
+    }
+    InitializationOptions copyOpts;
+    copyOpts.pixelFormat = PixelFormat::RGBA_8888;
+    copyOpts.editable = true;
+    while (state.KeepRunning()) {
+        // the transforms work in place, every iteration starts from a fresh copy.
+        state.PauseTiming();
+        std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(*source, copyOpts);
+        state.ResumeTiming();
+        if (pixelMap == nullptr || !transform(*pixelMap)) {
+            state.SkipWithError("transform failed");
+            break;
+        }
+        state.PauseTiming();
+        pixelMap = nullptr;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * static_cast<uint64_t>(edge) * edge * RGBA_BYTES);
+}
+
+void BM_ScalePixelMap(BenchmarkState &state)
+{
+    RunTransform(state, [](PixelMap &pixelMap) {
+        PostProc postProc;
+        return postProc.ScalePixelMap(HALF_SCALE, HALF_SCALE, pixelMap);
+    });
+}
+
+void BM_RotatePixelMap(BenchmarkState &state)
+{
+    RunTransform(state, [](PixelMap &pixelMap) {
+        PostProc postProc;
+        return postProc.RotatePixelMap(ROTATE_DEGREES, pixelMap);
+    });
+}
+
+template<PixelFormat SRC_FORMAT, AlphaType SRC_ALPHA, PixelFormat DST_FORMAT, AlphaType DST_ALPHA>
+void BM_PixelConvert(BenchmarkState &state)
+{
+    uint32_t edge = static_cast<uint32_t>(state.Range(0));
+    ImageInfo srcInfo;
+    srcInfo.pixelFormat = SRC_FORMAT;
+    srcInfo.alphaType = SRC_ALPHA;
+    ImageInfo dstInfo;
+    dstInfo.pixelFormat = DST_FORMAT;
+    dstInfo.alphaType = DST_ALPHA;
+    std::unique_ptr<PixelConvert> convert = PixelConvert::Create(srcInfo, dstInfo);
+    if (convert == nullptr) {
+        state.SkipWithError("format pair not supported");
+        return;
+    }
+    // rows are contiguous, the whole image is converted as one row.
+    uint32_t pixelCount = edge * edge;
+    std::vector<uint32_t> argb = MakeArgbPixels(edge, edge);
+    std::vector<uint8_t> src(static_cast<size_t>(pixelCount) * MAX_PIXEL_BYTES);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<uint8_t>(argb[(i / RGBA_BYTES) % pixelCount] >> ((i % RGBA_BYTES) * BITS_PER_BYTE));
+    }
+    std::vector<uint8_t> dst(static_cast<size_t>(pixelCount) * MAX_PIXEL_BYTES);
+    while (state.KeepRunning()) {
+        convert->Convert(dst.data(), src.data(), pixelCount);
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * pixelCount * RGBA_BYTES);
+}
+
+void BM_ConvertYUV420ToRGBA(BenchmarkState &state)
+{
+    int32_t edge = static_cast<int32_t>(state.Range(0));
+    std::vector<uint8_t> nv21 = MakeNv21Buffer(edge, edge);
+    SourceOptions sourceOpts;
+    sourceOpts.pixelFormat = PixelFormat::NV21;
+    sourceOpts.size.width = edge;
+    sourceOpts.size.height = edge;
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    while (state.KeepRunning()) {
+        uint32_t errorCode = 0;
+        std::unique_ptr<ImageSource> imageSource =
+            ImageSource::CreateImageSource(nv21.data(), nv21.size(), sourceOpts, errorCode);
+        if (errorCode != SUCCESS || imageSource == nullptr) {
+            state.SkipWithError("create yuv source failed");
+            break;
+        }
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        if (errorCode != SUCCESS || pixelMap == nullptr) {
+            state.SkipWithError("convert yuv failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * static_cast<uint64_t>(edge) * edge * RGBA_BYTES);
+}
+
+constexpr AlphaType OPAQUE = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+constexpr AlphaType PREMUL = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+constexpr AlphaType UNPREMUL = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+} // namespace
+
+IMAGE_BENCHMARK(BM_ScalePixelMap, GetImageSizes());
+IMAGE_BENCHMARK(BM_RotatePixelMap, GetImageSizes());
+IMAGE_BENCHMARK(BM_ConvertYUV420ToRGBA, GetImageSizes());
+static const bool PIXEL_CONVERT_REGISTERED = RegisterBenchmark("BM_PixelConvert/RGBA_8888-BGRA_8888",
+    BM_PixelConvert<PixelFormat::RGBA_8888, OPAQUE, PixelFormat::BGRA_8888, OPAQUE>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/RGBA_8888-RGB_565",
+    BM_PixelConvert<PixelFormat::RGBA_8888, OPAQUE, PixelFormat::RGB_565, OPAQUE>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/ARGB_8888-RGBA_8888",
+    BM_PixelConvert<PixelFormat::ARGB_8888, OPAQUE, PixelFormat::RGBA_8888, OPAQUE>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/RGB_888-RGBA_8888",
+    BM_PixelConvert<PixelFormat::RGB_888, OPAQUE, PixelFormat::RGBA_8888, OPAQUE>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/RGBA_8888-RGBA_8888/unpremul-premul",
+    BM_PixelConvert<PixelFormat::RGBA_8888, UNPREMUL, PixelFormat::RGBA_8888, PREMUL>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/BGRA_8888-RGBA_8888/premul-unpremul",
+    BM_PixelConvert<PixelFormat::BGRA_8888, PREMUL, PixelFormat::RGBA_8888, UNPREMUL>, GetImageSizes()) &&
+    RegisterBenchmark("BM_PixelConvert/RGBA_8888-RGBA_F16",
+    BM_PixelConvert<PixelFormat::RGBA_8888, OPAQUE, PixelFormat::RGBA_F16, OPAQUE>, GetImageSizes());
+} // namespace Multimedia
+} // namespace OHOS
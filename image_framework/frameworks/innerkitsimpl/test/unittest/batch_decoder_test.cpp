@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include "batch_decoder.h"
+#include "image_source_util.h"
+#include "image_utils.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+namespace OHOS {
+namespace Multimedia {
+static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg";
+static const std::string IMAGE_INPUT_MISSING_PATH = "/data/local/tmp/image/not_exist.jpg";
+static constexpr uint32_t ITEM_COUNT = 9;
+static constexpr uint32_t THREAD_COUNT = 3;
+static constexpr uint32_t DEFAULT_DELAY_MS = 5;
+
+class BatchDecoderTest : public testing::Test {
+public:
+    BatchDecoderTest() {}
+    ~BatchDecoderTest() {}
+};
+
+/**
+ * @tc.name: BatchDecoderTest001
+ * @tc.desc: decode paths, fds and buffers, the future returns the results in item order
+ * @tc.type: FUNC
+ */
+HWTEST_F(BatchDecoderTest, BatchDecoderTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest001 start";
+    size_t bufferSize = 0;
+    ASSERT_EQ(ImageUtils::GetFileSize(IMAGE_INPUT_JPEG_PATH, bufferSize), true);
+    std::vector<uint8_t> buffer(bufferSize);
+    ASSERT_EQ(ImageSourceUtil::ReadFileToBuffer(IMAGE_INPUT_JPEG_PATH, buffer.data(), bufferSize), true);
+    int fd = open(IMAGE_INPUT_JPEG_PATH.c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+
+    std::vector<BatchDecodeItem> items(ITEM_COUNT);
+    for (uint32_t i = 0; i < ITEM_COUNT; i++) {
+        items[i].sourceType = static_cast<BatchSourceType>(i % THREAD_COUNT);
+        items[i].pathName = IMAGE_INPUT_JPEG_PATH;
+        items[i].fd = fd;
+        items[i].data = buffer.data();
+        items[i].size = bufferSize;
+        // every item asks for a different size, so the order of the results can be checked
+        items[i].decodeOptions.desiredSize.width = i + 1;
+        items[i].decodeOptions.desiredSize.height = i + 1;
+    }
+    BatchDecodeOptions opts;
+    opts.threadCount = THREAD_COUNT;
+    std::unique_ptr<BatchDecoder> decoder = BatchDecoder::Create(opts);
+    ASSERT_NE(decoder, nullptr);
+    ASSERT_EQ(decoder->GetThreadCount(), THREAD_COUNT);
+    std::vector<BatchDecodeResult> results = decoder->Submit(items).get();
+    close(fd);
+    ASSERT_EQ(results.size(), ITEM_COUNT);
+    for (uint32_t i = 0; i < ITEM_COUNT; i++) {
+        ASSERT_EQ(results[i].itemIndex, i);
+        ASSERT_EQ(results[i].errorCode, SUCCESS);
+        ASSERT_NE(results[i].pixelMap, nullptr);
+        ASSERT_EQ(results[i].pixelMap->GetWidth(), static_cast<int32_t>(i + 1));
+    }
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest001 end";
+}
+
+/**
+ * @tc.name: BatchDecoderTest002
+ * @tc.desc: a bad item reports its own error and does not fail the others
+ * @tc.type: FUNC
+ */
+HWTEST_F(BatchDecoderTest, BatchDecoderTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest002 start";
+    std::vector<BatchDecodeItem> items(ITEM_COUNT);
+    for (uint32_t i = 0; i < ITEM_COUNT; i++) {
+        items[i].pathName = (i % THREAD_COUNT == 0) ? IMAGE_INPUT_MISSING_PATH : IMAGE_INPUT_JPEG_PATH;
+    }
+    BatchDecodeOptions opts;
+    opts.threadCount = THREAD_COUNT;
+    std::unique_ptr<BatchDecoder> decoder = BatchDecoder::Create(opts);
+    ASSERT_NE(decoder, nullptr);
+    std::atomic<uint32_t> errorCount(0);
+    std::atomic<uint32_t> doneCount(0);
+    uint32_t ret = decoder->Submit(items, [&errorCount, &doneCount](BatchDecodeResult &result) {
+        if (result.errorCode != SUCCESS) {
+            EXPECT_EQ(result.pixelMap, nullptr);
+            EXPECT_EQ(result.itemIndex % THREAD_COUNT, 0u);
+            errorCount++;
+        } else {
+            EXPECT_NE(result.pixelMap, nullptr);
+        }
+        doneCount++;
+    });
+    ASSERT_EQ(ret, SUCCESS);
+    decoder->Wait();
+    ASSERT_EQ(doneCount.load(), ITEM_COUNT);
+    ASSERT_EQ(errorCount.load(), ITEM_COUNT / THREAD_COUNT);
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest002 end";
+}
+
+/**
+ * @tc.name: BatchDecoderTest003
+ * @tc.desc: items larger than the in flight bound run one at a time
+ * @tc.type: FUNC
+ */
+HWTEST_F(BatchDecoderTest, BatchDecoderTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest003 start";
+    std::vector<BatchDecodeItem> items(ITEM_COUNT);
+    for (auto &item : items) {
+        item.pathName = IMAGE_INPUT_JPEG_PATH;
+    }
+    BatchDecodeOptions opts;
+    opts.threadCount = THREAD_COUNT;
+    opts.maxInflightBytes = 1;
+    std::unique_ptr<BatchDecoder> decoder = BatchDecoder::Create(opts);
+    ASSERT_NE(decoder, nullptr);
+    std::atomic<uint32_t> active(0);
+    std::atomic<uint32_t> maxActive(0);
+    uint32_t ret = decoder->Submit(items, [&active, &maxActive](BatchDecodeResult &result) {
+        EXPECT_EQ(result.errorCode, SUCCESS);
+        uint32_t now = ++active;
+        if (now > maxActive) {
+            maxActive = now;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_DELAY_MS));
+        active--;
+    });
+    ASSERT_EQ(ret, SUCCESS);
+    decoder->Wait();
+    ASSERT_EQ(maxActive.load(), 1u);
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest003 end";
+}
+
+/**
+ * @tc.name: BatchDecoderTest004
+ * @tc.desc: an empty callback is refused and an empty list completes at once
+ * @tc.type: FUNC
+ */
+HWTEST_F(BatchDecoderTest, BatchDecoderTest004, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest004 start";
+    BatchDecodeOptions opts;
+    std::unique_ptr<BatchDecoder> decoder = BatchDecoder::Create(opts);
+    ASSERT_NE(decoder, nullptr);
+    ASSERT_GE(decoder->GetThreadCount(), 1u);
+    ASSERT_LE(decoder->GetThreadCount(), BatchDecoder::MAX_THREAD_COUNT);
+    std::vector<BatchDecodeItem> items(1);
+    ASSERT_EQ(decoder->Submit(items, BatchDecoder::Callback()), ERR_IMAGE_INVALID_PARAMETER);
+    std::vector<BatchDecodeResult> results = decoder->Submit(std::vector<BatchDecodeItem>()).get();
+    ASSERT_EQ(results.empty(), true);
+    GTEST_LOG_(INFO) << "BatchDecoderTest: BatchDecoderTest004 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
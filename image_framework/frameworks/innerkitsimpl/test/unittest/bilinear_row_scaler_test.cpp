@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+#include "bilinear_row_scaler.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace Multimedia {
+static constexpr uint32_t SUB_VALUE_COUNT = 16;
+static constexpr uint32_t ROW_LENGTH = 37;
+
+class BilinearRowScalerTest : public testing::Test {
+public:
+    BilinearRowScalerTest() {}
+    ~BilinearRowScalerTest() {}
+};
+
+static uint32_t NextColor(uint32_t &seed)
+{
+    // simple lcg, keeps the test data reproducible
+    seed = seed * 1103515245 + 12345;
+    return seed;
+}
+
+/**
+ * @tc.name: BilinearRowScalerTest001
+ * @tc.desc: the selected row filter is bit exact with the scalar filter
+ * @tc.type: FUNC
+ */
+HWTEST_F(BilinearRowScalerTest, BilinearRowScalerTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest001 start";
+    GTEST_LOG_(INFO) << "row filter: " << BilinearRowScaler::GetFilterRowName();
+    std::vector<uint32_t> color00(ROW_LENGTH);
+    std::vector<uint32_t> color01(ROW_LENGTH);
+    std::vector<uint32_t> color10(ROW_LENGTH);
+    std::vector<uint32_t> color11(ROW_LENGTH);
+    std::vector<uint32_t> subx(ROW_LENGTH);
+    std::vector<uint32_t> expect(ROW_LENGTH);
+    std::vector<uint32_t> result(ROW_LENGTH);
+    uint32_t seed = 1;
+    for (uint32_t suby = 0; suby < SUB_VALUE_COUNT; suby++) {
+        for (uint32_t i = 0; i < ROW_LENGTH; i++) {
+            color00[i] = NextColor(seed);
+            color01[i] = NextColor(seed);
+            color10[i] = NextColor(seed);
+            color11[i] = NextColor(seed);
+            subx[i] = (i + suby) % SUB_VALUE_COUNT;
+        }
+        BilinearRowArgs args;
+        args.color00 = color00.data();
+        args.color01 = color01.data();
+        args.color10 = color10.data();
+        args.color11 = color11.data();
+        args.subx = subx.data();
+        args.suby = suby;
+        args.count = ROW_LENGTH;
+        args.out = expect.data();
+        BilinearRowScaler::GetScalarFilterRowProc()(args);
+        args.out = result.data();
+        BilinearRowScaler::GetFilterRowProc()(args);
+        EXPECT_EQ(expect, result);
+    }
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest001 end";
+}
+
+/**
+ * @tc.name: BilinearRowScalerTest002
+ * @tc.desc: ScaleRows with unsupported pixel format
+ * @tc.type: FUNC
+ */
+HWTEST_F(BilinearRowScalerTest, BilinearRowScalerTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest002 start";
+    uint8_t src[8] = { 0 };
+    uint8_t dst[8] = { 0 };
+    PixmapInfo pixmapInfo(false);
+    pixmapInfo.imageInfo.size.width = 1;
+    pixmapInfo.imageInfo.size.height = 1;
+    pixmapInfo.imageInfo.pixelFormat = PixelFormat::RGBA_F16;
+    pixmapInfo.data = src;
+    BilinearAxis axis;
+    BilinearRowScaler::AppendSample(axis, 0, 0.5f, 1);
+    Size dstSize = { 1, 1 };
+    EXPECT_FALSE(BilinearRowScaler::IsSupported(PixelFormat::RGBA_F16));
+    EXPECT_FALSE(BilinearRowScaler::ScaleRows(pixmapInfo, axis, axis, dstSize, dst));
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest002 end";
+}
+
+/**
+ * @tc.name: BilinearRowScalerTest003
+ * @tc.desc: BasicTransformer scale goes through the row scaler and keeps the filter result
+ * @tc.type: FUNC
+ */
+HWTEST_F(BilinearRowScalerTest, BilinearRowScalerTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest003 start";
+    const int32_t width = 2;
+    const int32_t height = 2;
+    uint32_t src[width * height] = { 0xFF000000, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000 };
+    PixmapInfo inPutInfo(false);
+    inPutInfo.imageInfo.size.width = width;
+    inPutInfo.imageInfo.size.height = height;
+    inPutInfo.imageInfo.pixelFormat = PixelFormat::RGBA_8888;
+    inPutInfo.data = reinterpret_cast<uint8_t *>(src);
+    inPutInfo.bufferSize = sizeof(src);
+
+    PixmapInfo outPutInfo;
+    BasicTransformer trans;
+    trans.SetScaleParam(2.0f, 2.0f);
+    ASSERT_EQ(trans.TransformPixmap(inPutInfo, outPutInfo), IMAGE_SUCCESS);
+    ASSERT_NE(outPutInfo.data, nullptr);
+    EXPECT_EQ(outPutInfo.imageInfo.size.width, width * 2);
+    EXPECT_EQ(outPutInfo.imageInfo.size.height, height * 2);
+    const uint32_t *out = reinterpret_cast<const uint32_t *>(outPutInfo.data);
+    // the corners are not interpolated
+    EXPECT_EQ(out[0], src[0]);
+    EXPECT_EQ(out[width * 2 - 1], src[1]);
+    EXPECT_EQ(out[(height * 2 - 1) * width * 2], src[2]);
+    EXPECT_EQ(out[height * width * 4 - 1], src[3]);
+    free(outPutInfo.data);
+    outPutInfo.data = nullptr;
+    GTEST_LOG_(INFO) << "BilinearRowScalerTest: BilinearRowScalerTest003 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <fstream>
 #include <fcntl.h>
+#include <unistd.h>
 #include "file_source_stream.h"
 #include "image_type.h"
 #include "image_utils.h"
@@ -422,7 +423,7 @@ HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0019, TestSize.Level3)
     std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(IMAGE_INPUT_JPG_PATH);
     ASSERT_NE(fileSourceStream, nullptr);
     uint8_t *ret = fileSourceStream->GetDataPtr();
-    ASSERT_EQ(ret, nullptr);
+    ASSERT_NE(ret, nullptr);
     GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0019 end";
 }
 
@@ -440,5 +441,63 @@ HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0020, TestSize.Level3)
     ASSERT_EQ(ret, ImagePlugin::FILE_STREAM_TYPE);
     GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0020 end";
 }
+
+/**
+ * @tc.name: FileSourceStreamTest0021
+ * @tc.desc: Peek and Read return pointers into the mapped file without copying
+ * @tc.type: FUNC
+ */
+HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0021, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0021 start";
+    std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(IMAGE_INPUT_JPG_PATH);
+    ASSERT_NE(fileSourceStream, nullptr);
+    uint8_t *data = fileSourceStream->GetDataPtr();
+    ASSERT_NE(data, nullptr);
+    DataStreamBuffer peekData;
+    ASSERT_TRUE(fileSourceStream->Peek(2, peekData));
+    ASSERT_EQ(peekData.inputStreamBuffer, data);
+    ASSERT_EQ(peekData.dataSize, 2);
+    ASSERT_EQ(fileSourceStream->Tell(), 0);
+    DataStreamBuffer readData;
+    ASSERT_TRUE(fileSourceStream->Read(2, readData));
+    ASSERT_TRUE(fileSourceStream->Read(2, readData));
+    ASSERT_EQ(readData.inputStreamBuffer, data + 2);
+    ASSERT_TRUE(fileSourceStream->Seek(fileSourceStream->GetStreamSize() - 1));
+    ASSERT_TRUE(fileSourceStream->Read(MAXSIZE, readData));
+    ASSERT_EQ(readData.dataSize, 1);
+    ASSERT_FALSE(fileSourceStream->Read(1, readData));
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0021 end";
+}
+
+/**
+ * @tc.name: FileSourceStreamTest0022
+ * @tc.desc: a pipe can not be mapped, its data is read into memory and can still seek
+ * @tc.type: FUNC
+ */
+HWTEST_F(FileSourceStreamTest, FileSourceStreamTest0022, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0022 start";
+    int fds[2] = { -1, -1 };
+    ASSERT_EQ(pipe(fds), 0);
+    const uint8_t content[] = { 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10 };
+    ASSERT_EQ(write(fds[1], content, sizeof(content)), static_cast<ssize_t>(sizeof(content)));
+    close(fds[1]);
+    std::unique_ptr<FileSourceStream> fileSourceStream = FileSourceStream::CreateSourceStream(fds[0]);
+    close(fds[0]);
+    ASSERT_NE(fileSourceStream, nullptr);
+    ASSERT_EQ(fileSourceStream->GetStreamSize(), sizeof(content));
+    uint8_t buffer[sizeof(content)] = { 0 };
+    uint32_t readSize = 0;
+    ASSERT_TRUE(fileSourceStream->Peek(sizeof(content), buffer, sizeof(buffer), readSize));
+    ASSERT_EQ(readSize, sizeof(content));
+    ASSERT_EQ(memcmp(buffer, content, sizeof(content)), 0);
+    ASSERT_TRUE(fileSourceStream->Seek(4));
+    DataStreamBuffer readData;
+    ASSERT_TRUE(fileSourceStream->Read(MAXSIZE, readData));
+    ASSERT_EQ(readData.dataSize, 2);
+    ASSERT_EQ(readData.inputStreamBuffer[1], 0x10);
+    GTEST_LOG_(INFO) << "FileSourceStreamTest: FileSourceStreamTest0022 end";
+}
+}
 }
-}
\ No newline at end of file
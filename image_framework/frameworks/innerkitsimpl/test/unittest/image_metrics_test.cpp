@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "image_metrics.h"
+#include "image_trace.h"
+#include "media_errors.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+
+namespace OHOS {
+namespace Multimedia {
+static const std::string TRACE_OUTPUT_PATH = "/data/local/tmp/image/image_metrics_trace.json";
+static constexpr uint64_t BYTES_READ = 100;
+static constexpr uint64_t EXTRA_SPANS = 10;
+
+class ImageMetricsTest : public testing::Test {
+public:
+    ImageMetricsTest() {}
+    ~ImageMetricsTest() {}
+};
+
+static size_t CountOf(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @tc.name: ImageMetricsTest001
+ * @tc.desc: nothing is recorded while disabled
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageMetricsTest, ImageMetricsTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest001 start";
+    ImageMetrics::SetEnabled(false);
+    ImageMetrics::Reset();
+    {
+        ImageTrace trace("ImageMetricsTest001");
+        ImageMetricsSpan span(SPAN_PIXEL_DECODE);
+        ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, BYTES_READ);
+        ImageMetrics::AddAllocation(BYTES_READ);
+    }
+    ASSERT_EQ(ImageMetrics::GetSpanCount(), 0u);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::BYTES_READ), 0u);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::ALLOCATIONS), 0u);
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest001 end";
+}
+
+/**
+ * @tc.name: ImageMetricsTest002
+ * @tc.desc: nested spans and counters are exported as Chrome trace events
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageMetricsTest, ImageMetricsTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest002 start";
+    ImageMetrics::SetEnabled(true);
+    ImageMetrics::Reset();
+    {
+        ImageTrace trace("Create \"%s\"", "test");
+        ImageMetricsSpan span(SPAN_HEADER_DECODE);
+        ImageMetrics::AddCounter(MetricsCounter::BYTES_READ, BYTES_READ);
+        ImageMetrics::AddCounter(MetricsCounter::CACHE_HITS, 1);
+        ImageMetrics::AddAllocation(BYTES_READ);
+    }
+    ImageMetrics::SetEnabled(false);
+    ASSERT_EQ(ImageMetrics::GetSpanCount(), 2u);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::BYTES_READ), BYTES_READ);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::CACHE_HITS), 1u);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::ALLOCATIONS), 1u);
+    ASSERT_EQ(ImageMetrics::GetCounter(MetricsCounter::ALLOCATED_BYTES), BYTES_READ);
+    std::string json = ImageMetrics::ExportChromeTrace();
+    ASSERT_EQ(CountOf(json, "\"ph\":\"X\""), 2u);
+    ASSERT_NE(json.find("\"name\":\"HeaderDecode\""), std::string::npos);
+    ASSERT_NE(json.find("\"name\":\"Create \\\"test\\\"\""), std::string::npos);
+    ASSERT_NE(json.find("\"bytesRead\":100"), std::string::npos);
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest002 end";
+}
+
+/**
+ * @tc.name: ImageMetricsTest003
+ * @tc.desc: every thread keeps its latest spans, and the trace is written to a file
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageMetricsTest, ImageMetricsTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest003 start";
+    ImageMetrics::SetEnabled(true);
+    ImageMetrics::Reset();
+    std::thread worker([] {
+        for (uint64_t i = 0; i < ImageMetrics::RING_CAPACITY + EXTRA_SPANS; i++) {
+            ImageMetricsSpan span(SPAN_ENCODE);
+        }
+    });
+    worker.join();
+    {
+        ImageMetricsSpan span(SPAN_CONVERT);
+    }
+    ImageMetrics::SetEnabled(false);
+    ASSERT_EQ(ImageMetrics::GetSpanCount(), ImageMetrics::RING_CAPACITY + 1);
+    ASSERT_EQ(ImageMetrics::ExportChromeTrace(TRACE_OUTPUT_PATH), SUCCESS);
+    std::ifstream file(TRACE_OUTPUT_PATH);
+    ASSERT_EQ(file.is_open(), true);
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_EQ(CountOf(content.str(), "\"name\":\"Encode\""), ImageMetrics::RING_CAPACITY);
+    ASSERT_EQ(CountOf(content.str(), "\"name\":\"Convert\""), 1u);
+    ASSERT_NE(ImageMetrics::ExportChromeTrace(""), SUCCESS);
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest003 end";
+}
+/**
+ * @tc.name: ImageMetricsTest004
+ * @tc.desc: the rings of exited threads are capped and freed once exported
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageMetricsTest, ImageMetricsTest004, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest004 start";
+    ImageMetrics::SetEnabled(true);
+    ImageMetrics::Reset();
+    for (uint64_t i = 0; i < ImageMetrics::MAX_EXITED_THREADS + EXTRA_SPANS; i++) {
+        std::thread worker([] {
+            ImageMetricsSpan span(SPAN_PIXEL_DECODE);
+        });
+        worker.join();
+    }
+    ASSERT_EQ(ImageMetrics::GetSpanCount(), ImageMetrics::MAX_EXITED_THREADS);
+    std::string json = ImageMetrics::ExportChromeTrace();
+    ASSERT_EQ(CountOf(json, "\"name\":\"PixelDecode\""), ImageMetrics::MAX_EXITED_THREADS);
+    ASSERT_EQ(ImageMetrics::GetSpanCount(), 0u);
+    ImageMetrics::SetEnabled(false);
+    GTEST_LOG_(INFO) << "ImageMetricsTest: ImageMetricsTest004 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
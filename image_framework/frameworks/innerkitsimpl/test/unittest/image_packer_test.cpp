@@ -39,6 +39,51 @@ constexpr uint32_t NUM_1 = 1;
 constexpr uint32_t NUM_100 = 100;
 constexpr int64_t BUFFER_SIZE = 2 * 1024 * 1024;
 static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test_packing.jpg";
+static constexpr int32_t PNG_PACK_WIDTH = 67;
+static constexpr int32_t PNG_PACK_HEIGHT = 45;
+static constexpr int32_t PNG_PACK_INVALID_LEVEL = 10;
+static constexpr uint32_t OPAQUE_ALPHA = 0xFF000000;
+
+// packs an opaque RGBA_8888 pixel map to png, decodes it and checks every pixel came back unchanged.
+static void PackPngAndCompare(const PackOption &option)
+{
+    std::vector<uint32_t> colors(PNG_PACK_WIDTH * PNG_PACK_HEIGHT);
+    for (size_t i = 0; i < colors.size(); i++) {
+        colors[i] = OPAQUE_ALPHA | static_cast<uint32_t>(i * i * NUM_100 + i);
+    }
+    InitializationOptions initOpts;
+    initOpts.size.width = PNG_PACK_WIDTH;
+    initOpts.size.height = PNG_PACK_HEIGHT;
+    initOpts.pixelFormat = PixelFormat::RGBA_8888;
+    initOpts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(colors.data(), colors.size(), initOpts);
+    ASSERT_NE(pixelMap, nullptr);
+    std::vector<uint8_t> packed(BUFFER_SIZE);
+    ImagePacker packer;
+    ASSERT_EQ(packer.StartPacking(packed.data(), packed.size(), option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(packer.AddImage(*pixelMap), OHOS::Media::SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(packer.FinalizePacking(packedSize), OHOS::Media::SUCCESS);
+    ASSERT_GT(packedSize, 0);
+
+    uint32_t errorCode = 0;
+    SourceOptions sourceOpts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(packed.data(), static_cast<uint32_t>(packedSize), sourceOpts, errorCode);
+    ASSERT_EQ(errorCode, OHOS::Media::SUCCESS);
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    std::unique_ptr<PixelMap> decoded = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, OHOS::Media::SUCCESS);
+    ASSERT_NE(decoded, nullptr);
+    ASSERT_EQ(decoded->GetWidth(), PNG_PACK_WIDTH);
+    ASSERT_EQ(decoded->GetHeight(), PNG_PACK_HEIGHT);
+    for (int32_t y = 0; y < PNG_PACK_HEIGHT; y++) {
+        const uint8_t *expected = pixelMap->GetPixels() + y * pixelMap->GetRowBytes();
+        const uint8_t *actual = decoded->GetPixels() + y * decoded->GetRowBytes();
+        ASSERT_EQ(memcmp(expected, actual, PNG_PACK_WIDTH * pixelMap->GetPixelBytes()), 0);
+    }
+}
 class ImagePackerTest : public testing::Test {
 public:
     ImagePackerTest() {}
@@ -352,5 +397,74 @@ HWTEST_F(ImagePackerTest, FinalizePacking002, TestSize.Level3)
     pack.FinalizePacking(packedSize);
     GTEST_LOG_(INFO) << "ImagePackerTest: FinalizePacking002 end";
 }
+
+/**
+ * @tc.name: PackPng001
+ * @tc.desc: a pixel map packed to png with the default options decodes to the same pixels
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, PackPng001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng001 start";
+    PackOption option;
+    option.format = "image/png";
+    PackPngAndCompare(option);
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng001 end";
+}
+
+/**
+ * @tc.name: PackPng002
+ * @tc.desc: the fast preset and explicit zlib settings stay lossless, a level out of range is rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, PackPng002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng002 start";
+    PackOption option;
+    option.format = "image/png";
+    option.preset = EncodePreset::FAST;
+    PackPngAndCompare(option);
+    option.compressionLevel = 0;
+    option.pngFilter = PngFilter::NONE;
+    PackPngAndCompare(option);
+    option.compressionLevel = NUM_1;
+    option.pngFilter = PngFilter::SUB;
+    option.compressionStrategy = CompressionStrategy::RLE;
+    PackPngAndCompare(option);
+
+    option.compressionLevel = PNG_PACK_INVALID_LEVEL;
+    std::vector<uint8_t> packed(BUFFER_SIZE);
+    ImagePacker packer;
+    ASSERT_EQ(packer.StartPacking(packed.data(), packed.size(), option), OHOS::Media::ERR_IMAGE_INVALID_PARAMETER);
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng002 end";
+}
+
+/**
+ * @tc.name: PackPng003
+ * @tc.desc: an ALPHA_8 pixel map is rejected instead of being written as grayscale
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImagePackerTest, PackPng003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng003 start";
+    InitializationOptions initOpts;
+    initOpts.size.width = PNG_PACK_WIDTH;
+    initOpts.size.height = PNG_PACK_HEIGHT;
+    initOpts.pixelFormat = PixelFormat::ALPHA_8;
+    initOpts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(initOpts);
+    ASSERT_NE(pixelMap, nullptr);
+    ASSERT_EQ(pixelMap->GetPixelFormat(), PixelFormat::ALPHA_8);
+
+    PackOption option;
+    option.format = "image/png";
+    std::vector<uint8_t> packed(BUFFER_SIZE);
+    ImagePacker packer;
+    ASSERT_EQ(packer.StartPacking(packed.data(), packed.size(), option), OHOS::Media::SUCCESS);
+    ASSERT_EQ(packer.AddImage(*pixelMap), OHOS::Media::SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(packer.FinalizePacking(packedSize), OHOS::Media::ERR_IMAGE_INVALID_PARAMETER);
+    GTEST_LOG_(INFO) << "ImagePackerTest: PackPng003 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -14,7 +14,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <fstream>
+#include "animation_decoder.h"
 #include "directory_ex.h"
 #include "hilog/log.h"
 #include "image_packer.h"
@@ -38,6 +40,10 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL_TEST = {
     LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImageSourceGifTest"
 };
 static constexpr uint32_t DEFAULT_DELAY_UTIME = 10000;  // 10 ms.
+static constexpr uint32_t MOVING_FRAME_COUNT = 3;
+// image descriptor of each frame of moving_test.gif, the first one covers the whole 198x202 canvas.
+static const Rect MOVING_FRAME_RECTS[] = { { 0, 0, 198, 202 }, { 0, 102, 100, 100 }, { 100, 101, 98, 100 } };
+static constexpr int32_t RGBA_BYTES = 4;
 
 class ImageSourceGifTest : public testing::Test {
 public:
@@ -371,5 +377,141 @@ HWTEST_F(ImageSourceGifTest, GifImageDecode007, TestSize.Level3)
     ASSERT_EQ(errorCode, SUCCESS);
     ASSERT_EQ(3, imageCount);
 }
+
+static std::vector<uint8_t> DecodeGifFrame(ImageSource &imageSource, uint32_t index, const DecodeOptions &decodeOpts)
+{
+    uint32_t errorCode = 0;
+    std::unique_ptr<PixelMap> pixelMap = imageSource.CreatePixelMap(index, decodeOpts, errorCode);
+    if (errorCode != SUCCESS || pixelMap == nullptr) {
+        return std::vector<uint8_t>();
+    }
+    const uint8_t *pixels = pixelMap->GetPixels();
+    return std::vector<uint8_t>(pixels, pixels + pixelMap->GetByteCount());
+}
+
+/**
+ * @tc.name: GifImageDecode008
+ * @tc.desc: Decode moving gif frames out of order, with and without kept keyframes
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifTest, GifImageDecode008, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode every frame in order as the reference.
+     * @tc.expected: step1. decode image source to pixel maps success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/gif";
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint32_t i = 0; i < 3; i++) {
+        frames.push_back(DecodeGifFrame(*imageSource, i, decodeOpts));
+        ASSERT_FALSE(frames.back().empty());
+    }
+    /**
+     * @tc.steps: step2. seek back and forth, keeping every frame and keeping none.
+     * @tc.expected: step2. every frame equals the one decoded in order.
+     */
+    const uint32_t seekOrder[] = { 2, 0, 1, 2, 1, 0, 2 };
+    for (uint32_t interval : { 1u, 0u }) {
+        std::unique_ptr<ImageSource> seekSource =
+            ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(seekSource.get(), nullptr);
+        DecodeOptions seekOpts;
+        seekOpts.keyframeInterval = interval;
+        for (uint32_t index : seekOrder) {
+            EXPECT_EQ(DecodeGifFrame(*seekSource, index, seekOpts), frames[index]);
+        }
+    }
+}
+
+/**
+ * @tc.name: GifImageDecode009
+ * @tc.desc: Play moving gif frames into two buffers with the animation decoder
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceGifTest, GifImageDecode009, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. decode every frame to a pixel map as the reference.
+     * @tc.expected: step1. decode image source to pixel maps success.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    opts.formatHint = "image/gif";
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint32_t i = 0; i < MOVING_FRAME_COUNT; i++) {
+        frames.push_back(DecodeGifFrame(*imageSource, i, decodeOpts));
+        ASSERT_FALSE(frames.back().empty());
+    }
+    /**
+     * @tc.steps: step2. create the animation decoder and set two output buffers.
+     * @tc.expected: step2. the buffers hold one frame each.
+     */
+    std::unique_ptr<ImageSource> animSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/moving_test.gif", opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(animSource.get(), nullptr);
+    std::unique_ptr<AnimationDecoder> animationDecoder = animSource->CreateAnimationDecoder(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(animationDecoder.get(), nullptr);
+    uint64_t byteCount = animationDecoder->GetFrameByteCount();
+    ASSERT_EQ(byteCount, frames[0].size());
+    std::vector<uint8_t> front(byteCount);
+    std::vector<uint8_t> back(byteCount);
+    ASSERT_EQ(animationDecoder->SetOutputBuffers(front.data(), back.data(), byteCount), SUCCESS);
+    /**
+     * @tc.steps: step3. play the animation twice, rewinding in between.
+     * @tc.expected: step3. every frame equals its pixel map and is dirty over its image descriptor, the first frame
+     *                      in full, outside the dirty rect it equals the frame before it, held by the other buffer.
+     */
+    const ImageInfo &info = animationDecoder->GetImageInfo();
+    for (uint32_t round = 0; round < 2; round++) {
+        for (uint32_t i = 0; i < MOVING_FRAME_COUNT; i++) {
+            AnimationFrame frame;
+            ASSERT_EQ(animationDecoder->DecodeNextFrame(frame), SUCCESS);
+            ASSERT_EQ(frame.index, i);
+            ASSERT_EQ(frame.frameCount, MOVING_FRAME_COUNT);
+            ASSERT_EQ(frame.pixels, (i % 2 == 0) ? front.data() : back.data());
+            EXPECT_EQ(std::vector<uint8_t>(frame.pixels, frame.pixels + byteCount), frames[i]);
+            // a frame disposed to the previous one draws nothing.
+            Rect expected = (frame.disposal == DisposalType::PREVIOUS) ? Rect() : MOVING_FRAME_RECTS[i];
+            EXPECT_EQ(frame.dirtyRect.left, expected.left);
+            EXPECT_EQ(frame.dirtyRect.top, expected.top);
+            EXPECT_EQ(frame.dirtyRect.width, expected.width);
+            EXPECT_EQ(frame.dirtyRect.height, expected.height);
+            if (i == 0) {
+                EXPECT_EQ(frame.dirtyRect.width, info.size.width);
+                EXPECT_EQ(frame.dirtyRect.height, info.size.height);
+                continue;
+            }
+            const uint8_t *previous = (i % 2 == 0) ? back.data() : front.data();
+            for (int32_t y = 0; y < info.size.height; y++) {
+                for (int32_t x = 0; x < info.size.width; x++) {
+                    bool isDirty = x >= expected.left && x < expected.left + expected.width &&
+                        y >= expected.top && y < expected.top + expected.height;
+                    if (isDirty) {
+                        continue;
+                    }
+                    int32_t offset = (y * info.size.width + x) * RGBA_BYTES;
+                    ASSERT_EQ(memcmp(frame.pixels + offset, previous + offset, RGBA_BYTES), 0);
+                }
+            }
+        }
+        animationDecoder->Rewind();
+        ASSERT_EQ(animationDecoder->SetOutputBuffers(front.data(), back.data(), byteCount), SUCCESS);
+    }
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -14,10 +14,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <fcntl.h>
 #include "directory_ex.h"
 #include "hilog/log.h"
+#include "image_metrics.h"
 #include "image_packer.h"
 #include "image_source.h"
 #include "image_type.h"
@@ -42,9 +46,33 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL_TEST = {
     LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImageSourceJpegTest"
 };
 static constexpr uint32_t DEFAULT_DELAY_UTIME = 10000;  // 10 ms.
+static constexpr int32_t SCALE_DIVISOR = 4;
+// 4 is an IDCT scale, 3 is not, 16 is below the smallest one.
+static constexpr uint32_t SAMPLE_SIZES[] = { 3, 4, 16 };
+static constexpr double MIN_SCALE_PSNR = 35.0;
+static constexpr double MAX_PIXEL_VALUE = 255.0;
+static constexpr int32_t RGB_CHANNELS = 3;
+static constexpr int32_t REGION_LEFT = 13;
+static constexpr int32_t REGION_TOP = 17;
+static constexpr int32_t REGION_WIDTH = 256;
+static constexpr int32_t REGION_HEIGHT = 128;
+static constexpr float REGION_ROTATE_DEGREES = 90;
+static constexpr double MIN_REGION_PSNR = 45.0;
+static constexpr uint32_t DECODE_THREAD_COUNT = 4;
+static constexpr size_t MIN_DECODE_BANDS = 2;
+static constexpr uint32_t ENCODE_THREAD_COUNT = 4;
+static constexpr uint8_t TUNING_QUALITY = 90;
+static constexpr uint32_t TUNING_RESTART_INTERVAL = 16;
+static constexpr uint32_t YUV_CHROMA_SAMPLE = 2;
+static constexpr int32_t RGBA_CHANNELS = 4;
+static constexpr int32_t COLOR_CONVERT_TOLERANCE = 1;
 static const std::string IMAGE_INPUT_JPEG_PATH = "/data/local/tmp/image/test.jpg";
 static const std::string IMAGE_INPUT_HW_JPEG_PATH = "/data/local/tmp/image/test_hw.jpg";
 static const std::string IMAGE_INPUT_EXIF_JPEG_PATH = "/data/local/tmp/image/test_exif.jpg";
+static const std::string IMAGE_INPUT_RESTART_JPEG_PATH = "/data/local/tmp/image/test_restart.jpg";
+static const std::string IMAGE_INPUT_RESTART_P3_JPEG_PATH = "/data/local/tmp/image/test_restart_p3.jpg";
+static const std::string IMAGE_INPUT_RESTART_P3_LUT_JPEG_PATH = "/data/local/tmp/image/test_restart_p3_lut.jpg";
+static const std::string IMAGE_INPUT_NO_EXIF_JPEG_PATH = "/data/local/tmp/image/hasNoExif.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_FILE_PATH = "/data/test/test_file.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_BUFFER_PATH = "/data/test/test_buffer.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_ISTREAM_PATH = "/data/test/test_istream.jpg";
@@ -56,6 +84,8 @@ static const std::string IMAGE_OUTPUT_JPEG_MULTI_INC1_PATH = "/data/test/test_in
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME1_PATH = "/data/test/test_onetime1.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_INC2_PATH = "/data/test/test_inc2.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME2_PATH = "/data/test/test_onetime2.jpg";
+static const std::string IMAGE_OUTPUT_EXIF_JPEG_PATH = "/data/test/test_exif_modify.jpg";
+static const std::string IMAGE_OUTPUT_NO_EXIF_JPEG_PATH = "/data/test/test_no_exif_modify.jpg";
 
 const std::string ORIENTATION = "Orientation";
 const std::string IMAGE_HEIGHT = "ImageHeight";
@@ -64,6 +94,16 @@ const std::string GPS_LATITUDE = "GPSLatitude";
 const std::string GPS_LONGITUDE = "GPSLongitude";
 const std::string GPS_LATITUDE_REF = "GPSLatitudeRef";
 const std::string GPS_LONGITUDE_REF = "GPSLongitudeRef";
+const std::string DATE_TIME_ORIGINAL = "DateTimeOriginal";
+const std::string BITS_PER_SAMPLE = "BitsPerSample";
+const std::string IMAGE_LENGTH = "ImageLength";
+const std::string EXIF_DATE_TIME_ORIGINAL = "2022:06:02 15:51:35";
+const std::string EXIF_GPS_LATITUDE_REF = "N";
+const std::string EXIF_ORIENTATION_RIGHT_TOP = "6";
+const std::string EXIF_BITS_PER_SAMPLE = "8,8";
+const std::string EXIF_IMAGE_WIDTH = "4000";
+const std::string EXIF_IMAGE_LENGTH = "3000";
+static constexpr int32_t ORIENTATION_RIGHT_TOP_DEGREES = 90;
 
 class ImageSourceJpegTest : public testing::Test {
 public:
@@ -71,6 +111,145 @@ public:
     ~ImageSourceJpegTest() {}
 };
 
+// PSNR of the colour channels of two RGBA_8888 pixel maps of the same size.
+static double GetRgbPsnr(PixelMap &first, PixelMap &second)
+{
+    double squareSum = 0;
+    uint64_t count = 0;
+    for (int32_t y = 0; y < first.GetHeight(); y++) {
+        const uint8_t *firstRow = first.GetPixels() + y * first.GetRowBytes();
+        const uint8_t *secondRow = second.GetPixels() + y * second.GetRowBytes();
+        for (int32_t x = 0; x < first.GetWidth() * first.GetPixelBytes(); x++) {
+            if (x % first.GetPixelBytes() >= RGB_CHANNELS) {
+                continue;
+            }
+            double diff = static_cast<double>(firstRow[x]) - static_cast<double>(secondRow[x]);
+            squareSum += diff * diff;
+            count++;
+        }
+    }
+    if (count == 0 || squareSum == 0) {
+        return INFINITY;
+    }
+    return 10 * log10(MAX_PIXEL_VALUE * MAX_PIXEL_VALUE * count / squareSum);
+}
+
+static std::unique_ptr<PixelMap> DecodeWithThreads(const std::string &path, uint32_t threadCount)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(path, opts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.threadCount = threadCount;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return (errorCode == SUCCESS) ? std::move(pixelMap) : nullptr;
+}
+
+// band spans recorded since the metrics were last reset.
+static size_t CountRecordedBands()
+{
+    std::string trace = ImageMetrics::ExportChromeTrace();
+    std::string pattern = std::string("\"name\":\"") + SPAN_DECODE_BAND + "\"";
+    size_t count = 0;
+    for (size_t pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// band spans recorded while the jpeg is decoded with threadCount threads.
+static size_t CountDecodeBands(const std::string &path, uint32_t threadCount)
+{
+    ImageMetrics::SetEnabled(true);
+    ImageMetrics::Reset();
+    std::unique_ptr<PixelMap> pixelMap = DecodeWithThreads(path, threadCount);
+    ImageMetrics::SetEnabled(false);
+    return (pixelMap == nullptr) ? 0 : CountRecordedBands();
+}
+
+static std::unique_ptr<PixelMap> DecodeToFormat(const std::string &path, PixelFormat format)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(path, opts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = format;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return (errorCode == SUCCESS) ? std::move(pixelMap) : nullptr;
+}
+
+static std::unique_ptr<PixelMap> DecodeToColorSpace(const std::string &path, bool convert, ColorSpace colorSpace,
+    uint32_t threadCount = 1)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(path, opts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    decodeOpts.convertColorSpace = convert;
+    decodeOpts.desiredColorSpace = colorSpace;
+    decodeOpts.threadCount = threadCount;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return (errorCode == SUCCESS) ? std::move(pixelMap) : nullptr;
+}
+
+static int32_t GetChannelSpread(const uint8_t *pixel)
+{
+    int32_t maxValue = std::max({ pixel[0], pixel[1], pixel[2] });
+    int32_t minValue = std::min({ pixel[0], pixel[1], pixel[2] });
+    return maxValue - minValue;
+}
+
+static std::vector<uint8_t> PackJpeg(PixelMap &pixelMap, PackOption option)
+{
+    std::vector<uint8_t> output(static_cast<size_t>(pixelMap.GetRowBytes()) * pixelMap.GetHeight());
+    ImagePacker imagePacker;
+    option.format = "image/jpeg";
+    int64_t packedSize = 0;
+    if (imagePacker.StartPacking(output.data(), output.size(), option) != SUCCESS ||
+        imagePacker.AddImage(pixelMap) != SUCCESS || imagePacker.FinalizePacking(packedSize) != SUCCESS) {
+        return {};
+    }
+    output.resize(static_cast<size_t>(packedSize));
+    return output;
+}
+
+static std::vector<uint8_t> ReadFileData(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static bool WriteFileData(const std::string &path, const std::vector<uint8_t> &data)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    return file.good();
+}
+
+static std::unique_ptr<PixelMap> DecodeBuffer(const std::vector<uint8_t> &data)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(data.data(), data.size(), opts,
+        errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return (errorCode == SUCCESS) ? std::move(pixelMap) : nullptr;
+}
+
 /**
  * @tc.name: TC028
  * @tc.desc: Create ImageSource(stream)
@@ -1023,5 +1202,559 @@ HWTEST_F(ImageSourceJpegTest, JpegImageHwDecode001, TestSize.Level3)
     int64_t packSize = OHOS::ImageSourceUtil::PackImage(IMAGE_OUTPUT_HW_JPEG_FILE_PATH, std::move(pixelMap));
     ASSERT_NE(packSize, 0);
 }
+
+/**
+ * @tc.name: JpegImageScaleDecode001
+ * @tc.desc: decode jpeg to a desired size in the DCT domain, compare with the full decode scaled down
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageScaleDecode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageScaleDecode001 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    ImageInfo info;
+    ASSERT_EQ(imageSource->GetImageInfo(info), SUCCESS);
+    DecodeOptions fullOpts;
+    std::unique_ptr<PixelMap> reference = imageSource->CreatePixelMap(fullOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(reference.get(), nullptr);
+
+    DecodeOptions scaleOpts;
+    scaleOpts.desiredSize.width = info.size.width / SCALE_DIVISOR;
+    scaleOpts.desiredSize.height = info.size.height / SCALE_DIVISOR;
+    std::unique_ptr<PixelMap> scaled = imageSource->CreatePixelMap(scaleOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(scaled.get(), nullptr);
+    ASSERT_EQ(scaled->GetWidth(), scaleOpts.desiredSize.width);
+    ASSERT_EQ(scaled->GetHeight(), scaleOpts.desiredSize.height);
+
+    reference->scale(static_cast<float>(scaleOpts.desiredSize.width) / info.size.width,
+        static_cast<float>(scaleOpts.desiredSize.height) / info.size.height);
+    ASSERT_EQ(reference->GetWidth(), scaled->GetWidth());
+    ASSERT_EQ(reference->GetHeight(), scaled->GetHeight());
+    ASSERT_EQ(reference->GetPixelFormat(), scaled->GetPixelFormat());
+    ASSERT_GE(GetRgbPsnr(*reference, *scaled), MIN_SCALE_PSNR);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageScaleDecode001 end";
+}
+
+/**
+ * @tc.name: JpegImageScaleDecode002
+ * @tc.desc: decode jpeg with sample sizes on and off the IDCT scales, the output is the source size divided
+ *           and rounded up
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageScaleDecode002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageScaleDecode002 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    ImageInfo info;
+    ASSERT_EQ(imageSource->GetImageInfo(info), SUCCESS);
+    for (uint32_t sampleSize : SAMPLE_SIZES) {
+        DecodeOptions decodeOpts;
+        decodeOpts.sampleSize = sampleSize;
+        std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+        ASSERT_EQ(errorCode, SUCCESS);
+        ASSERT_NE(pixelMap.get(), nullptr);
+        ASSERT_EQ(pixelMap->GetWidth(), static_cast<int32_t>((info.size.width + sampleSize - 1) / sampleSize));
+        ASSERT_EQ(pixelMap->GetHeight(), static_cast<int32_t>((info.size.height + sampleSize - 1) / sampleSize));
+    }
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageScaleDecode002 end";
+}
+
+/**
+ * @tc.name: JpegImageRegionDecode001
+ * @tc.desc: decode a region of a jpeg, the result matches the region cut out of the full image
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageRegionDecode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageRegionDecode001 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions fullOpts;
+    std::unique_ptr<PixelMap> reference = imageSource->CreatePixelMap(fullOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(reference.get(), nullptr);
+
+    DecodeOptions regionOpts;
+    regionOpts.CropRect = { REGION_LEFT, REGION_TOP, REGION_WIDTH, REGION_HEIGHT };
+    std::unique_ptr<PixelMap> region = imageSource->CreatePixelMap(regionOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(region.get(), nullptr);
+    ASSERT_EQ(region->GetWidth(), REGION_WIDTH);
+    ASSERT_EQ(region->GetHeight(), REGION_HEIGHT);
+
+    ASSERT_EQ(reference->crop(regionOpts.CropRect), SUCCESS);
+    ASSERT_EQ(reference->GetWidth(), region->GetWidth());
+    ASSERT_EQ(reference->GetHeight(), region->GetHeight());
+    ASSERT_EQ(reference->GetPixelFormat(), region->GetPixelFormat());
+    ASSERT_GE(GetRgbPsnr(*reference, *region), MIN_REGION_PSNR);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageRegionDecode001 end";
+}
+
+/**
+ * @tc.name: JpegImageRegionDecode002
+ * @tc.desc: decode the bottom right region of a jpeg and rotate it
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageRegionDecode002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageRegionDecode002 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_INPUT_JPEG_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    ImageInfo info;
+    ASSERT_EQ(imageSource->GetImageInfo(info), SUCCESS);
+    DecodeOptions decodeOpts;
+    decodeOpts.CropRect = { info.size.width - REGION_WIDTH, info.size.height - REGION_HEIGHT,
+        REGION_WIDTH, REGION_HEIGHT };
+    decodeOpts.rotateDegrees = REGION_ROTATE_DEGREES;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetWidth(), REGION_HEIGHT);
+    ASSERT_EQ(pixelMap->GetHeight(), REGION_WIDTH);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageRegionDecode002 end";
+}
+
+/**
+ * @tc.name: JpegImageParallelDecode001
+ * @tc.desc: decode a jpeg with restart markers in bands on several threads, the pixels match a single thread decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageParallelDecode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelDecode001 start";
+    std::unique_ptr<PixelMap> reference = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, 1);
+    ASSERT_NE(reference.get(), nullptr);
+    std::unique_ptr<PixelMap> parallel = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, DECODE_THREAD_COUNT);
+    ASSERT_NE(parallel.get(), nullptr);
+    ASSERT_EQ(parallel->GetWidth(), reference->GetWidth());
+    ASSERT_EQ(parallel->GetHeight(), reference->GetHeight());
+    ASSERT_EQ(GetRgbPsnr(*reference, *parallel), INFINITY);
+    ASSERT_EQ(CountDecodeBands(IMAGE_INPUT_RESTART_JPEG_PATH, 1), 0u);
+    ASSERT_GE(CountDecodeBands(IMAGE_INPUT_RESTART_JPEG_PATH, DECODE_THREAD_COUNT), MIN_DECODE_BANDS);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelDecode001 end";
+}
+
+/**
+ * @tc.name: JpegImageParallelDecode002
+ * @tc.desc: a jpeg without restart markers can't be split, it is decoded on one thread
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageParallelDecode002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelDecode002 start";
+    std::unique_ptr<PixelMap> reference = DecodeWithThreads(IMAGE_INPUT_JPEG_PATH, 1);
+    ASSERT_NE(reference.get(), nullptr);
+    std::unique_ptr<PixelMap> parallel = DecodeWithThreads(IMAGE_INPUT_JPEG_PATH, 0);
+    ASSERT_NE(parallel.get(), nullptr);
+    ASSERT_EQ(GetRgbPsnr(*reference, *parallel), INFINITY);
+    ASSERT_EQ(CountDecodeBands(IMAGE_INPUT_JPEG_PATH, 0), 0u);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelDecode002 end";
+}
+
+/**
+ * @tc.name: JpegImageParallelEncode001
+ * @tc.desc: encode a jpeg in strips on several threads, it decodes to the pixels of a single thread encode
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageParallelEncode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelEncode001 start";
+    std::unique_ptr<PixelMap> pixelMap = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, 1);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    PackOption option;
+    std::vector<uint8_t> sequence = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(sequence.empty());
+    option.threadCount = ENCODE_THREAD_COUNT;
+    std::vector<uint8_t> parallel = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(parallel.empty());
+    std::unique_ptr<PixelMap> reference = DecodeBuffer(sequence);
+    ASSERT_NE(reference.get(), nullptr);
+    std::unique_ptr<PixelMap> stitched = DecodeBuffer(parallel);
+    ASSERT_NE(stitched.get(), nullptr);
+    ASSERT_EQ(stitched->GetWidth(), reference->GetWidth());
+    ASSERT_EQ(stitched->GetHeight(), reference->GetHeight());
+    ASSERT_EQ(GetRgbPsnr(*reference, *stitched), INFINITY);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageParallelEncode001 end";
+}
+
+/**
+ * @tc.name: JpegImageEncodeTuning001
+ * @tc.desc: optimized huffman tables make a smaller jpeg, a progressive jpeg decodes to the baseline pixels
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageEncodeTuning001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageEncodeTuning001 start";
+    std::unique_ptr<PixelMap> pixelMap = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, 1);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    PackOption option;
+    option.quality = TUNING_QUALITY;
+    std::vector<uint8_t> baseline = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(baseline.empty());
+    option.optimizeCoding = true;
+    std::vector<uint8_t> optimized = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(optimized.empty());
+    ASSERT_LT(optimized.size(), baseline.size());
+    option.optimizeCoding = false;
+    option.progressive = true;
+    std::vector<uint8_t> progressive = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(progressive.empty());
+    std::unique_ptr<PixelMap> reference = DecodeBuffer(baseline);
+    ASSERT_NE(reference.get(), nullptr);
+    std::unique_ptr<PixelMap> decoded = DecodeBuffer(progressive);
+    ASSERT_NE(decoded.get(), nullptr);
+    ASSERT_EQ(GetRgbPsnr(*reference, *decoded), INFINITY);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageEncodeTuning001 end";
+}
+
+/**
+ * @tc.name: JpegImageEncodeTuning002
+ * @tc.desc: full resolution chroma makes a larger jpeg, a restart interval above 65535 is rejected
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageEncodeTuning002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageEncodeTuning002 start";
+    std::unique_ptr<PixelMap> pixelMap = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, 1);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    PackOption option;
+    option.quality = TUNING_QUALITY;
+    option.dctMethod = DctMethod::IFAST;
+    option.restartInterval = TUNING_RESTART_INTERVAL;
+    option.subsampling = ChromaSubsampling::YUV420;
+    std::vector<uint8_t> yuv420 = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(yuv420.empty());
+    option.subsampling = ChromaSubsampling::YUV444;
+    std::vector<uint8_t> yuv444 = PackJpeg(*pixelMap, option);
+    ASSERT_FALSE(yuv444.empty());
+    ASSERT_GT(yuv444.size(), yuv420.size());
+    std::unique_ptr<PixelMap> decoded = DecodeBuffer(yuv444);
+    ASSERT_NE(decoded.get(), nullptr);
+    ASSERT_EQ(decoded->GetWidth(), pixelMap->GetWidth());
+    ASSERT_EQ(decoded->GetHeight(), pixelMap->GetHeight());
+    option.restartInterval = UINT16_MAX + 1;
+    ASSERT_TRUE(PackJpeg(*pixelMap, option).empty());
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageEncodeTuning002 end";
+}
+
+/**
+ * @tc.name: JpegImageYuvDecode001
+ * @tc.desc: decode a jpeg straight to NV21 and NV12, the planes share the luma and swap the chroma order
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageYuvDecode001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageYuvDecode001 start";
+    std::unique_ptr<PixelMap> nv21 = DecodeToFormat(IMAGE_INPUT_RESTART_JPEG_PATH, PixelFormat::NV21);
+    ASSERT_NE(nv21.get(), nullptr);
+    ASSERT_EQ(nv21->GetPixelFormat(), PixelFormat::NV21);
+    std::unique_ptr<PixelMap> nv12 = DecodeToFormat(IMAGE_INPUT_RESTART_JPEG_PATH, PixelFormat::NV12);
+    ASSERT_NE(nv12.get(), nullptr);
+    ASSERT_EQ(nv12->GetPixelFormat(), PixelFormat::NV12);
+    std::unique_ptr<PixelMap> rgba = DecodeWithThreads(IMAGE_INPUT_RESTART_JPEG_PATH, 1);
+    ASSERT_NE(rgba.get(), nullptr);
+    ASSERT_EQ(nv21->GetWidth(), rgba->GetWidth());
+    ASSERT_EQ(nv21->GetHeight(), rgba->GetHeight());
+    size_t width = static_cast<size_t>(nv21->GetWidth());
+    size_t height = static_cast<size_t>(nv21->GetHeight());
+    size_t uvStride = (width + 1) & ~static_cast<size_t>(1);
+    size_t uvSize = uvStride * ((height + 1) / YUV_CHROMA_SAMPLE);
+    ASSERT_GE(static_cast<size_t>(nv21->GetByteCount()), width * height + uvSize);
+    const uint8_t *nv21Pixels = nv21->GetPixels();
+    const uint8_t *nv12Pixels = nv12->GetPixels();
+    ASSERT_EQ(memcmp(nv21Pixels, nv12Pixels, width * height), 0);
+    for (size_t i = width * height; i < width * height + uvSize; i += YUV_CHROMA_SAMPLE) {
+        ASSERT_EQ(nv21Pixels[i], nv12Pixels[i + 1]);
+        ASSERT_EQ(nv21Pixels[i + 1], nv12Pixels[i]);
+    }
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageYuvDecode001 end";
+}
+
+/**
+ * @tc.name: JpegImageExifSegment001
+ * @tc.desc: read exif properties of a path and an istream source, both parse only the APP1 segment
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageExifSegment001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageExifSegment001 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> pathSource = ImageSource::CreateImageSource(IMAGE_INPUT_EXIF_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pathSource.get(), nullptr);
+    std::string value;
+    ASSERT_EQ(pathSource->GetImagePropertyString(0, DATE_TIME_ORIGINAL, value), SUCCESS);
+    ASSERT_EQ(value, EXIF_DATE_TIME_ORIGINAL);
+    ASSERT_EQ(pathSource->GetImagePropertyString(0, GPS_LATITUDE_REF, value), SUCCESS);
+    ASSERT_EQ(value, EXIF_GPS_LATITUDE_REF);
+
+    std::unique_ptr<std::fstream> fs = std::make_unique<std::fstream>();
+    fs->open(IMAGE_INPUT_EXIF_JPEG_PATH, std::fstream::binary | std::fstream::in);
+    ASSERT_TRUE(fs->is_open());
+    std::unique_ptr<ImageSource> streamSource = ImageSource::CreateImageSource(std::move(fs), opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(streamSource.get(), nullptr);
+    ASSERT_EQ(streamSource->GetImagePropertyString(0, DATE_TIME_ORIGINAL, value), SUCCESS);
+    ASSERT_EQ(value, EXIF_DATE_TIME_ORIGINAL);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageExifSegment001 end";
+}
+
+/**
+ * @tc.name: JpegImageModifyProperties001
+ * @tc.desc: modify several exif properties of a jpeg file at once, the exif block is rewritten in place
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageModifyProperties001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties001 start";
+    {
+        std::ifstream src(IMAGE_INPUT_EXIF_JPEG_PATH, std::ios::binary);
+        std::ofstream dst(IMAGE_OUTPUT_EXIF_JPEG_PATH, std::ios::binary | std::ios::trunc);
+        ASSERT_TRUE(src.is_open() && dst.is_open());
+        dst << src.rdbuf();
+    }
+
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_EXIF_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::map<std::string, std::string> properties = {
+        { ORIENTATION, EXIF_ORIENTATION_RIGHT_TOP },
+        { BITS_PER_SAMPLE, EXIF_BITS_PER_SAMPLE },
+    };
+    ASSERT_EQ(imageSource->ModifyImageProperties(0, properties, IMAGE_OUTPUT_EXIF_JPEG_PATH), SUCCESS);
+
+    std::unique_ptr<ImageSource> modified = ImageSource::CreateImageSource(IMAGE_OUTPUT_EXIF_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(modified.get(), nullptr);
+    int32_t degrees = 0;
+    ASSERT_EQ(modified->GetImagePropertyInt(0, ORIENTATION, degrees), SUCCESS);
+    ASSERT_EQ(degrees, ORIENTATION_RIGHT_TOP_DEGREES);
+    std::string value;
+    ASSERT_EQ(modified->GetImagePropertyString(0, DATE_TIME_ORIGINAL, value), SUCCESS);
+    ASSERT_EQ(value, EXIF_DATE_TIME_ORIGINAL);
+    DecodeOptions decodeOpts;
+    std::unique_ptr<PixelMap> pixelMap = modified->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+
+    properties = { { "UnknownKey", "1" } };
+    ASSERT_NE(modified->ModifyImageProperties(0, properties, IMAGE_OUTPUT_EXIF_JPEG_PATH), SUCCESS);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties001 end";
+}
+
+/**
+ * @tc.name: JpegImageModifyProperties002
+ * @tc.desc: write exif into a jpeg without an APP1 segment, then grow the exif block, the image data is moved
+ *           behind it unchanged
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageModifyProperties002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties002 start";
+    std::vector<uint8_t> original = ReadFileData(IMAGE_INPUT_NO_EXIF_JPEG_PATH);
+    ASSERT_FALSE(original.empty());
+    ASSERT_TRUE(WriteFileData(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH, original));
+    std::unique_ptr<PixelMap> expected = DecodeBuffer(original);
+    ASSERT_NE(expected.get(), nullptr);
+    size_t byteCount = static_cast<size_t>(expected->GetByteCount());
+
+    /**
+     * @tc.steps: step1. insert an exif block with the orientation.
+     * @tc.expected: step1. the file grows by the new APP1 segment and decodes to the same pixels.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    std::map<std::string, std::string> properties = { { ORIENTATION, EXIF_ORIENTATION_RIGHT_TOP } };
+    ASSERT_EQ(imageSource->ModifyImageProperties(0, properties, IMAGE_OUTPUT_NO_EXIF_JPEG_PATH), SUCCESS);
+    std::vector<uint8_t> inserted = ReadFileData(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH);
+    ASSERT_GT(inserted.size(), original.size());
+    std::unique_ptr<PixelMap> pixelMap = DecodeBuffer(inserted);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetByteCount(), expected->GetByteCount());
+    ASSERT_EQ(memcmp(pixelMap->GetPixels(), expected->GetPixels(), byteCount), 0);
+
+    /**
+     * @tc.steps: step2. add tags the inserted block does not have yet.
+     * @tc.expected: step2. the file grows again, the orientation is kept and the pixels are still the same.
+     */
+    std::unique_ptr<ImageSource> insertedSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH,
+        opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(insertedSource.get(), nullptr);
+    properties = {
+        { IMAGE_WIDTH, EXIF_IMAGE_WIDTH },
+        { IMAGE_LENGTH, EXIF_IMAGE_LENGTH },
+        { BITS_PER_SAMPLE, EXIF_BITS_PER_SAMPLE },
+    };
+    ASSERT_EQ(insertedSource->ModifyImageProperties(0, properties, IMAGE_OUTPUT_NO_EXIF_JPEG_PATH), SUCCESS);
+    std::vector<uint8_t> grown = ReadFileData(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH);
+    ASSERT_GT(grown.size(), inserted.size());
+    std::unique_ptr<ImageSource> grownSource = ImageSource::CreateImageSource(IMAGE_OUTPUT_NO_EXIF_JPEG_PATH, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(grownSource.get(), nullptr);
+    int32_t degrees = 0;
+    ASSERT_EQ(grownSource->GetImagePropertyInt(0, ORIENTATION, degrees), SUCCESS);
+    ASSERT_EQ(degrees, ORIENTATION_RIGHT_TOP_DEGREES);
+    pixelMap = DecodeBuffer(grown);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    ASSERT_EQ(pixelMap->GetByteCount(), expected->GetByteCount());
+    ASSERT_EQ(memcmp(pixelMap->GetPixels(), expected->GetPixels(), byteCount), 0);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties002 end";
+}
+
+/**
+ * @tc.name: JpegImageModifyProperties003
+ * @tc.desc: a buffer can't grow, exif is only rewritten into an APP1 segment that is already there
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageModifyProperties003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties003 start";
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::vector<uint8_t> noExif = ReadFileData(IMAGE_INPUT_NO_EXIF_JPEG_PATH);
+    ASSERT_FALSE(noExif.empty());
+    std::vector<uint8_t> noExifCopy = noExif;
+    std::unique_ptr<ImageSource> noExifSource = ImageSource::CreateImageSource(noExif.data(), noExif.size(), opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(noExifSource.get(), nullptr);
+    std::map<std::string, std::string> properties = {
+        { ORIENTATION, EXIF_ORIENTATION_RIGHT_TOP },
+        { BITS_PER_SAMPLE, EXIF_BITS_PER_SAMPLE },
+    };
+    ASSERT_EQ(noExifSource->ModifyImageProperties(0, properties, noExif.data(), noExif.size()),
+        ERR_MEDIA_OUT_OF_RANGE);
+    ASSERT_EQ(noExif, noExifCopy);
+
+    std::vector<uint8_t> exif = ReadFileData(IMAGE_INPUT_EXIF_JPEG_PATH);
+    ASSERT_FALSE(exif.empty());
+    std::unique_ptr<ImageSource> exifSource = ImageSource::CreateImageSource(exif.data(), exif.size(), opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(exifSource.get(), nullptr);
+    size_t exifSize = exif.size();
+    ASSERT_EQ(exifSource->ModifyImageProperties(0, properties, exif.data(), exif.size()), SUCCESS);
+    ASSERT_EQ(exif.size(), exifSize);
+    std::unique_ptr<ImageSource> modified = ImageSource::CreateImageSource(exif.data(), exif.size(), opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(modified.get(), nullptr);
+    int32_t degrees = 0;
+    ASSERT_EQ(modified->GetImagePropertyInt(0, ORIENTATION, degrees), SUCCESS);
+    ASSERT_EQ(degrees, ORIENTATION_RIGHT_TOP_DEGREES);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageModifyProperties003 end";
+}
+
+/**
+ * @tc.name: JpegImageColorConvert001
+ * @tc.desc: decode a jpeg without icc profile converted from sRGB, to sRGB it is unchanged, to Display P3 the
+ *           wider gamut gives less saturated values
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageColorConvert001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert001 start";
+    std::unique_ptr<PixelMap> plain = DecodeToColorSpace(IMAGE_INPUT_JPEG_PATH, false, ColorSpace::DISPLAY_P3);
+    ASSERT_NE(plain.get(), nullptr);
+    std::unique_ptr<PixelMap> srgb = DecodeToColorSpace(IMAGE_INPUT_JPEG_PATH, true, ColorSpace::SRGB);
+    ASSERT_NE(srgb.get(), nullptr);
+    std::unique_ptr<PixelMap> p3 = DecodeToColorSpace(IMAGE_INPUT_JPEG_PATH, true, ColorSpace::DISPLAY_P3);
+    ASSERT_NE(p3.get(), nullptr);
+    ASSERT_EQ(p3->GetWidth(), plain->GetWidth());
+    ASSERT_EQ(p3->GetHeight(), plain->GetHeight());
+    size_t byteCount = static_cast<size_t>(plain->GetByteCount());
+    ASSERT_EQ(memcmp(srgb->GetPixels(), plain->GetPixels(), byteCount), 0);
+
+    const uint8_t *plainPixels = plain->GetPixels();
+    const uint8_t *p3Pixels = p3->GetPixels();
+    size_t changed = 0;
+    for (size_t i = 0; i < byteCount; i += RGBA_CHANNELS) {
+        ASSERT_LE(GetChannelSpread(p3Pixels + i), GetChannelSpread(plainPixels + i) + COLOR_CONVERT_TOLERANCE);
+        changed += (memcmp(p3Pixels + i, plainPixels + i, RGBA_CHANNELS) != 0) ? 1 : 0;
+    }
+    ASSERT_GT(changed, 0u);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert001 end";
+}
+
+// decode a jpeg with an embedded profile to sRGB, sequentially and in bands, and check both give the same pixels.
+static void CheckParallelColorConvert(const std::string &path)
+{
+    std::unique_ptr<PixelMap> plain = DecodeToColorSpace(path, false, ColorSpace::SRGB);
+    ASSERT_NE(plain.get(), nullptr);
+    std::unique_ptr<PixelMap> sequential = DecodeToColorSpace(path, true, ColorSpace::SRGB);
+    ASSERT_NE(sequential.get(), nullptr);
+    ImageMetrics::SetEnabled(true);
+    ImageMetrics::Reset();
+    std::unique_ptr<PixelMap> parallel = DecodeToColorSpace(path, true, ColorSpace::SRGB, DECODE_THREAD_COUNT);
+    ImageMetrics::SetEnabled(false);
+    ASSERT_NE(parallel.get(), nullptr);
+    ASSERT_GE(CountRecordedBands(), MIN_DECODE_BANDS);
+    ASSERT_EQ(parallel->GetWidth(), sequential->GetWidth());
+    ASSERT_EQ(parallel->GetHeight(), sequential->GetHeight());
+    size_t byteCount = static_cast<size_t>(sequential->GetByteCount());
+    ASSERT_EQ(memcmp(parallel->GetPixels(), sequential->GetPixels(), byteCount), 0);
+
+    const uint8_t *plainPixels = plain->GetPixels();
+    const uint8_t *convertedPixels = sequential->GetPixels();
+    size_t changed = 0;
+    for (size_t i = 0; i < byteCount; i += RGBA_CHANNELS) {
+        changed += (memcmp(convertedPixels + i, plainPixels + i, RGBA_CHANNELS) != 0) ? 1 : 0;
+    }
+    ASSERT_GT(changed, 0u);
+}
+
+/**
+ * @tc.name: JpegImageColorConvert002
+ * @tc.desc: decode a jpeg with restart markers and a Display P3 matrix/TRC profile to sRGB, the band decode gives
+ *           the same pixels as the sequential one
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageColorConvert002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert002 start";
+    CheckParallelColorConvert(IMAGE_INPUT_RESTART_P3_JPEG_PATH);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert002 end";
+}
+
+/**
+ * @tc.name: JpegImageColorConvert003
+ * @tc.desc: decode a jpeg with restart markers and a Display P3 A2B0 lut profile to sRGB, the profile goes through
+ *           the sampled lut and the band decode gives the same pixels as the sequential one
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceJpegTest, JpegImageColorConvert003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert003 start";
+    CheckParallelColorConvert(IMAGE_INPUT_RESTART_P3_LUT_JPEG_PATH);
+    GTEST_LOG_(INFO) << "ImageSourceJpegTest: JpegImageColorConvert003 end";
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
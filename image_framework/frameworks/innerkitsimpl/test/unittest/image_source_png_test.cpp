@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
 #include "directory_ex.h"
 #include "hilog/log.h"
@@ -37,6 +38,40 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL_TEST = {
     LOG_CORE, LOG_TAG_DOMAIN_ID_IMAGE, "ImageSourcePngTest"
 };
 static constexpr uint32_t DEFAULT_DELAY_UTIME = 10000;  // 10 ms.
+static constexpr uint32_t SAMPLE_SIZE = 2;
+static constexpr int32_t RGBA_CHANNELS = 4;
+static constexpr int32_t SAMPLED_WIDTH = 236;
+static constexpr int32_t SAMPLED_HEIGHT = 38;
+static constexpr int32_t DESIRED_WIDTH = 118;
+static constexpr int32_t DESIRED_HEIGHT = 18;
+static constexpr int32_t PNG_WIDTH = 472;
+static constexpr int32_t PNG_HEIGHT = 75;
+static constexpr size_t TRUNCATED_NUMERATOR = 2;
+static constexpr size_t TRUNCATED_DENOMINATOR = 3;
+static constexpr int32_t EDGE_WIDTH = 8;
+static constexpr int32_t EDGE_HEIGHT = 4;
+static constexpr uint32_t OPAQUE_RED = 0xFFFF0000;
+static constexpr uint32_t TRANSPARENT_BLACK = 0x00000000;
+static constexpr uint8_t HALF_ALPHA = 128;
+static constexpr uint8_t MAX_CHANNEL = 255;
+static constexpr int64_t PACK_BUFFER_SIZE = 64 * 1024;
+
+static std::unique_ptr<PixelMap> DecodeSampled(uint32_t sampleSize, const Size &desiredSize)
+{
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource("/data/local/tmp/image/test.png", opts, errorCode);
+    if (errorCode != SUCCESS || imageSource == nullptr) {
+        return nullptr;
+    }
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    decodeOpts.sampleSize = sampleSize;
+    decodeOpts.desiredSize = desiredSize;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    return (errorCode == SUCCESS) ? std::move(pixelMap) : nullptr;
+}
 
 class ImageSourcePngTest : public testing::Test {
 public:
@@ -604,5 +639,149 @@ HWTEST_F(ImageSourcePngTest, PngNinePatch003, TestSize.Level3)
     ASSERT_NE(ninePatch.ninePatch, nullptr);
     ASSERT_EQ(static_cast<int32_t>(ninePatch.patchSize), 84);
 }
+
+/**
+ * @tc.name: PngImageSampleDecode001
+ * @tc.desc: Decode png image with sample size, every pixel is the mean of its box in the full decode
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourcePngTest, PngImageSampleDecode001, TestSize.Level3)
+{
+    std::unique_ptr<PixelMap> full = DecodeSampled(DecodeOptions::DEFAULT_SAMPLE_SIZE, Size());
+    ASSERT_NE(full.get(), nullptr);
+    std::unique_ptr<PixelMap> sampled = DecodeSampled(SAMPLE_SIZE, Size());
+    ASSERT_NE(sampled.get(), nullptr);
+    ASSERT_EQ(sampled->GetWidth(), SAMPLED_WIDTH);
+    ASSERT_EQ(sampled->GetHeight(), SAMPLED_HEIGHT);
+
+    const uint8_t *fullPixels = full->GetPixels();
+    const uint8_t *sampledPixels = sampled->GetPixels();
+    int32_t fullWidth = full->GetWidth();
+    int32_t fullHeight = full->GetHeight();
+    for (int32_t y = 0; y < SAMPLED_HEIGHT; y++) {
+        for (int32_t x = 0; x < SAMPLED_WIDTH; x++) {
+            int32_t lastY = std::min<int32_t>((y + 1) * SAMPLE_SIZE, fullHeight);
+            int32_t lastX = std::min<int32_t>((x + 1) * SAMPLE_SIZE, fullWidth);
+            int32_t count = (lastY - y * SAMPLE_SIZE) * (lastX - x * SAMPLE_SIZE);
+            for (int32_t channel = 0; channel < RGBA_CHANNELS; channel++) {
+                int32_t sum = 0;
+                for (int32_t boxY = y * SAMPLE_SIZE; boxY < lastY; boxY++) {
+                    for (int32_t boxX = x * SAMPLE_SIZE; boxX < lastX; boxX++) {
+                        sum += fullPixels[(boxY * fullWidth + boxX) * RGBA_CHANNELS + channel];
+                    }
+                }
+                ASSERT_EQ(sampledPixels[(y * SAMPLED_WIDTH + x) * RGBA_CHANNELS + channel], (sum + count / 2) / count);
+            }
+        }
+    }
+}
+
+/**
+ * @tc.name: PngImageSampleDecode002
+ * @tc.desc: Decode png image to a smaller desired size
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourcePngTest, PngImageSampleDecode002, TestSize.Level3)
+{
+    Size desiredSize;
+    desiredSize.width = DESIRED_WIDTH;
+    desiredSize.height = DESIRED_HEIGHT;
+    std::unique_ptr<PixelMap> pixelMap = DecodeSampled(DecodeOptions::DEFAULT_SAMPLE_SIZE, desiredSize);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    EXPECT_EQ(pixelMap->GetWidth(), DESIRED_WIDTH);
+    EXPECT_EQ(pixelMap->GetHeight(), DESIRED_HEIGHT);
+}
+
+/**
+ * @tc.name: PngImagePartialDecode001
+ * @tc.desc: Decode a truncated png buffer, the rows before the end of the data give a partial image
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourcePngTest, PngImagePartialDecode001, TestSize.Level3)
+{
+    size_t bufferSize = 0;
+    bool fileRet = ImageUtils::GetFileSize("/data/local/tmp/image/test.png", bufferSize);
+    ASSERT_EQ(fileRet, true);
+    std::vector<uint8_t> buffer(bufferSize);
+    fileRet = ReadFileToBuffer("/data/local/tmp/image/test.png", buffer.data(), bufferSize);
+    ASSERT_EQ(fileRet, true);
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    uint32_t truncatedSize = static_cast<uint32_t>(bufferSize * TRUNCATED_NUMERATOR / TRUNCATED_DENOMINATOR);
+    std::unique_ptr<ImageSource> imageSource = ImageSource::CreateImageSource(buffer.data(), truncatedSize, opts,
+        errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    decodeOpts.allowPartialImage = true;
+    std::unique_ptr<PixelMap> pixelMap = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    EXPECT_EQ(pixelMap->GetWidth(), PNG_WIDTH);
+    EXPECT_EQ(pixelMap->GetHeight(), PNG_HEIGHT);
+}
+
+/**
+ * @tc.name: PngImageSampleDecode003
+ * @tc.desc: Transparent pixels do not bleed their color into the sampled edge of an opaque area
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourcePngTest, PngImageSampleDecode003, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. pack columns of transparent black and opaque red, straight alpha, to png.
+     * @tc.expected: step1. pack the pixel map success.
+     */
+    std::vector<uint32_t> colors(EDGE_WIDTH * EDGE_HEIGHT);
+    for (size_t i = 0; i < colors.size(); i++) {
+        colors[i] = (i % SAMPLE_SIZE == 0) ? TRANSPARENT_BLACK : OPAQUE_RED;
+    }
+    InitializationOptions initOpts;
+    initOpts.size.width = EDGE_WIDTH;
+    initOpts.size.height = EDGE_HEIGHT;
+    initOpts.pixelFormat = PixelFormat::RGBA_8888;
+    initOpts.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    std::unique_ptr<PixelMap> pixelMap = PixelMap::Create(colors.data(), colors.size(), initOpts);
+    ASSERT_NE(pixelMap.get(), nullptr);
+    PackOption option;
+    option.format = "image/png";
+    std::vector<uint8_t> packed(PACK_BUFFER_SIZE);
+    ImagePacker packer;
+    ASSERT_EQ(packer.StartPacking(packed.data(), packed.size(), option), SUCCESS);
+    ASSERT_EQ(packer.AddImage(*pixelMap), SUCCESS);
+    int64_t packedSize = 0;
+    ASSERT_EQ(packer.FinalizePacking(packedSize), SUCCESS);
+
+    /**
+     * @tc.steps: step2. decode the png with sample size 2, every box holds one pixel of each column.
+     * @tc.expected: step2. every pixel is red at half alpha, not a darker red.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(packed.data(), static_cast<uint32_t>(packedSize), opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    decodeOpts.sampleSize = SAMPLE_SIZE;
+    std::unique_ptr<PixelMap> sampled = imageSource->CreatePixelMap(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(sampled.get(), nullptr);
+    ASSERT_EQ(sampled->GetWidth(), EDGE_WIDTH / static_cast<int32_t>(SAMPLE_SIZE));
+    ASSERT_EQ(sampled->GetHeight(), EDGE_HEIGHT / static_cast<int32_t>(SAMPLE_SIZE));
+    // a premultiplied result carries the red scaled by the alpha.
+    uint8_t red = (sampled->GetAlphaType() == AlphaType::IMAGE_ALPHA_TYPE_PREMUL) ? HALF_ALPHA : MAX_CHANNEL;
+    for (int32_t y = 0; y < sampled->GetHeight(); y++) {
+        const uint8_t *row = sampled->GetPixels() + y * sampled->GetRowBytes();
+        for (int32_t x = 0; x < sampled->GetWidth(); x++) {
+            const uint8_t *pixel = row + x * RGBA_CHANNELS;
+            ASSERT_NEAR(pixel[0], red, 1);
+            ASSERT_EQ(pixel[1], 0);
+            ASSERT_EQ(pixel[2], 0);
+            ASSERT_EQ(pixel[3], HALF_ALPHA);
+        }
+    }
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -14,7 +14,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <fstream>
+#include "animation_decoder.h"
 #include "directory_ex.h"
 #include "hilog/log.h"
 #include "image_packer.h"
@@ -39,6 +41,7 @@ static constexpr OHOS::HiviewDFX::HiLogLabel LABEL_TEST = {
 };
 static constexpr uint32_t DEFAULT_DELAY_UTIME = 10000;  // 10 ms.
 static const std::string IMAGE_INPUT_WEBP_PATH = "/data/local/tmp/image/test_large.webp";
+static const std::string IMAGE_INPUT_ANIMATED_WEBP_PATH = "/data/local/tmp/image/test_animated.webp";
 static const std::string IMAGE_INPUT_HW_JPEG_PATH = "/data/local/tmp/image/test_hw.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_FILE_PATH = "/data/test/test_webp_file.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_BUFFER_PATH = "/data/test/test_webp_buffer.jpg";
@@ -51,6 +54,23 @@ static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME1_PATH = "/data/test/tes
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_INC2_PATH = "/data/test/test_webp_inc2.jpg";
 static const std::string IMAGE_OUTPUT_JPEG_MULTI_ONETIME2_PATH = "/data/test/test_webp_onetime2.jpg";
 
+// test_animated.webp: a 64x48 gradient, then a red 20x16 frame at (8, 6) disposed to the background, then a green
+// 16x12 frame at (32, 20).
+static constexpr uint32_t ANIMATED_FRAME_COUNT = 3;
+static constexpr int32_t ANIMATED_WIDTH = 64;
+static constexpr int32_t ANIMATED_HEIGHT = 48;
+static constexpr int32_t ANIMATED_DELAYS[] = { 100, 200, 300 };
+static constexpr DisposalType ANIMATED_DISPOSALS[] = { DisposalType::NONE, DisposalType::BACKGROUND,
+    DisposalType::NONE };
+// the last frame also changes the area of the frame before it, which was cleared.
+static const Rect ANIMATED_DIRTY_RECTS[] = { { 0, 0, 64, 48 }, { 8, 6, 20, 16 }, { 8, 6, 40, 26 } };
+static constexpr int32_t ANIMATED_PROBE_X[] = { 10, 10, 40 };
+static constexpr int32_t ANIMATED_PROBE_Y[] = { 10, 10, 25 };
+static constexpr uint8_t ANIMATED_PROBE_RGBA[][4] = { { 40, 50, 128, 255 }, { 255, 0, 0, 255 }, { 0, 255, 0, 255 } };
+static constexpr int32_t ANIMATED_CLEARED_X = 10;
+static constexpr int32_t ANIMATED_CLEARED_Y = 10;
+static constexpr int32_t RGBA_BYTES = 4;
+
 class ImageSourceWebpTest : public testing::Test {
 public:
     ImageSourceWebpTest() {}
@@ -536,5 +556,85 @@ HWTEST_F(ImageSourceWebpTest, WebpImageCrop001, TestSize.Level3)
     EXPECT_EQ(200, pixelMap->GetWidth());
     EXPECT_EQ(300, pixelMap->GetHeight());
 }
+
+static bool IsInRect(const Rect &rect, int32_t x, int32_t y)
+{
+    return x >= rect.left && x < rect.left + rect.width && y >= rect.top && y < rect.top + rect.height;
+}
+
+/**
+ * @tc.name: WebpImageDecode011
+ * @tc.desc: Play animated webp frames into two buffers with the animation decoder
+ * @tc.type: FUNC
+ */
+HWTEST_F(ImageSourceWebpTest, WebpImageDecode011, TestSize.Level3)
+{
+    /**
+     * @tc.steps: step1. create the animation decoder of an animated webp and set two output buffers.
+     * @tc.expected: step1. the buffers hold one frame of the canvas each.
+     */
+    uint32_t errorCode = 0;
+    SourceOptions opts;
+    std::unique_ptr<ImageSource> imageSource =
+        ImageSource::CreateImageSource(IMAGE_INPUT_ANIMATED_WEBP_PATH, opts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(imageSource.get(), nullptr);
+    DecodeOptions decodeOpts;
+    decodeOpts.desiredPixelFormat = PixelFormat::RGBA_8888;
+    std::unique_ptr<AnimationDecoder> animationDecoder = imageSource->CreateAnimationDecoder(decodeOpts, errorCode);
+    ASSERT_EQ(errorCode, SUCCESS);
+    ASSERT_NE(animationDecoder.get(), nullptr);
+    const ImageInfo &info = animationDecoder->GetImageInfo();
+    ASSERT_EQ(info.size.width, ANIMATED_WIDTH);
+    ASSERT_EQ(info.size.height, ANIMATED_HEIGHT);
+    uint64_t byteCount = animationDecoder->GetFrameByteCount();
+    ASSERT_EQ(byteCount, static_cast<uint64_t>(ANIMATED_WIDTH * ANIMATED_HEIGHT * RGBA_BYTES));
+    std::vector<uint8_t> front(byteCount);
+    std::vector<uint8_t> back(byteCount);
+    ASSERT_EQ(animationDecoder->SetOutputBuffers(front.data(), back.data(), byteCount), SUCCESS);
+    /**
+     * @tc.steps: step2. play the animation twice, rewinding in between.
+     * @tc.expected: step2. every frame reports its delay, disposal and dirty rect, its own pixels are drawn and
+     *                      outside the dirty rect it equals the frame before it, held by the other buffer.
+     */
+    for (uint32_t round = 0; round < 2; round++) {
+        for (uint32_t i = 0; i < ANIMATED_FRAME_COUNT; i++) {
+            AnimationFrame frame;
+            ASSERT_EQ(animationDecoder->DecodeNextFrame(frame), SUCCESS);
+            ASSERT_EQ(frame.index, i);
+            ASSERT_EQ(frame.frameCount, ANIMATED_FRAME_COUNT);
+            ASSERT_EQ(frame.pixels, (i % 2 == 0) ? front.data() : back.data());
+            EXPECT_EQ(frame.delayTime, ANIMATED_DELAYS[i]);
+            EXPECT_EQ(frame.disposal, ANIMATED_DISPOSALS[i]);
+            const Rect &expected = ANIMATED_DIRTY_RECTS[i];
+            EXPECT_EQ(frame.dirtyRect.left, expected.left);
+            EXPECT_EQ(frame.dirtyRect.top, expected.top);
+            EXPECT_EQ(frame.dirtyRect.width, expected.width);
+            EXPECT_EQ(frame.dirtyRect.height, expected.height);
+            const uint8_t *probe = frame.pixels + (ANIMATED_PROBE_Y[i] * ANIMATED_WIDTH + ANIMATED_PROBE_X[i]) *
+                RGBA_BYTES;
+            EXPECT_EQ(memcmp(probe, ANIMATED_PROBE_RGBA[i], RGBA_BYTES), 0);
+            if (i == 0) {
+                continue;
+            }
+            const uint8_t *previous = (i % 2 == 0) ? back.data() : front.data();
+            for (int32_t y = 0; y < ANIMATED_HEIGHT; y++) {
+                for (int32_t x = 0; x < ANIMATED_WIDTH; x++) {
+                    if (IsInRect(expected, x, y)) {
+                        continue;
+                    }
+                    int32_t offset = (y * ANIMATED_WIDTH + x) * RGBA_BYTES;
+                    ASSERT_EQ(memcmp(frame.pixels + offset, previous + offset, RGBA_BYTES), 0);
+                }
+            }
+        }
+        // the red frame was disposed to the background before the last one was drawn.
+        const uint8_t *last = ((ANIMATED_FRAME_COUNT - 1) % 2 == 0) ? front.data() : back.data();
+        const uint8_t *cleared = last + (ANIMATED_CLEARED_Y * ANIMATED_WIDTH + ANIMATED_CLEARED_X) * RGBA_BYTES;
+        EXPECT_EQ(cleared[RGBA_BYTES - 1], 0);
+        animationDecoder->Rewind();
+        ASSERT_EQ(animationDecoder->SetOutputBuffers(front.data(), back.data(), byteCount), SUCCESS);
+    }
+}
 } // namespace Multimedia
 } // namespace OHOS
\ No newline at end of file
@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
 #include <fcntl.h>
 #include "incremental_source_stream.h"
@@ -34,6 +35,8 @@ namespace Multimedia {
 static const std::string IMAGE_INPUT_JPG_PATH = "/data/local/tmp/image/test.jpg";
 static constexpr uint32_t MAXSIZE = 10000;
 static constexpr size_t SIZE_T = 0;
+static constexpr uint32_t CHUNK_SIZE = 16;
+static constexpr uint32_t CHUNK_COUNT = 64;
 class IncrementalSourceStreamTest : public testing::Test {
 public:
     IncrementalSourceStreamTest() {}
@@ -441,5 +444,101 @@ HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0017, TestSize.
     ASSERT_EQ(ret, SIZE_T);
     GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0017 end";
 }
+/**
+ * @tc.name: IncrementalSourceStreamTest0018
+ * @tc.desc: Read many small chunks back in order
+ * @tc.type: FUNC
+ */
+HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0018, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0018 start";
+    std::unique_ptr<IncrementalSourceStream> ins =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(ins, nullptr);
+    uint8_t chunk[CHUNK_SIZE];
+    for (uint32_t i = 0; i < CHUNK_COUNT; i++) {
+        for (uint32_t j = 0; j < CHUNK_SIZE; j++) {
+            chunk[j] = static_cast<uint8_t>(i * CHUNK_SIZE + j);
+        }
+        ASSERT_EQ(ins->UpdateData(chunk, CHUNK_SIZE, i == CHUNK_COUNT - 1), SUCCESS);
+    }
+    ASSERT_EQ(ins->GetStreamSize(), CHUNK_SIZE * CHUNK_COUNT);
+    ASSERT_EQ(ins->IsStreamCompleted(), true);
+    uint8_t data[CHUNK_SIZE * CHUNK_COUNT] = { 0 };
+    uint32_t readSize = 0;
+    // an odd read size, so most reads cross a chunk boundary
+    uint32_t step = CHUNK_SIZE + 3;
+    for (uint32_t offset = 0; offset < sizeof(data); offset += readSize) {
+        uint32_t desiredSize = std::min(step, static_cast<uint32_t>(sizeof(data)) - offset);
+        ASSERT_EQ(ins->Read(desiredSize, data + offset, sizeof(data) - offset, readSize), true);
+        ASSERT_EQ(readSize, desiredSize);
+    }
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        ASSERT_EQ(data[i], static_cast<uint8_t>(i));
+    }
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0018 end";
+}
+
+/**
+ * @tc.name: IncrementalSourceStreamTest0019
+ * @tc.desc: Peek a buffer inside a chunk and across chunks
+ * @tc.type: FUNC
+ */
+HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0019, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0019 start";
+    std::unique_ptr<IncrementalSourceStream> ins =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(ins, nullptr);
+    const uint8_t first[] = { 0, 1, 2, 3 };
+    const uint8_t second[] = { 4, 5, 6, 7 };
+    const uint8_t third[] = { 8, 9 };
+    ASSERT_EQ(ins->UpdateData(first, sizeof(first), false), SUCCESS);
+    ASSERT_EQ(ins->UpdateData(second, sizeof(second), false), SUCCESS);
+    ASSERT_EQ(ins->UpdateData(third, sizeof(third), false), SUCCESS);
+
+    DataStreamBuffer outData;
+    ASSERT_EQ(ins->Seek(5), true);
+    ASSERT_EQ(ins->Peek(2, outData), true);
+    ASSERT_EQ(outData.dataSize, 2u);
+    ASSERT_GE(outData.bufferSize, outData.dataSize);
+    ASSERT_EQ(outData.inputStreamBuffer[0], 5);
+    ASSERT_EQ(outData.inputStreamBuffer[1], 6);
+
+    ASSERT_EQ(ins->Seek(2), true);
+    ASSERT_EQ(ins->Read(7, outData), true);
+    ASSERT_EQ(outData.dataSize, 7u);
+    ASSERT_GE(outData.bufferSize, outData.dataSize);
+    for (uint32_t i = 0; i < outData.dataSize; i++) {
+        ASSERT_EQ(outData.inputStreamBuffer[i], i + 2);
+    }
+    ASSERT_EQ(ins->Tell(), 9u);
+    ASSERT_EQ(ins->Read(4, outData), true);
+    ASSERT_EQ(outData.dataSize, 1u);
+    ASSERT_EQ(outData.inputStreamBuffer[0], 9);
+    ASSERT_EQ(ins->Peek(1, outData), false);
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0019 end";
+}
+
+/**
+ * @tc.name: IncrementalSourceStreamTest0020
+ * @tc.desc: UpdateData beyond the max buffer size
+ * @tc.type: FUNC
+ */
+HWTEST_F(IncrementalSourceStreamTest, IncrementalSourceStreamTest0020, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0020 start";
+    std::unique_ptr<IncrementalSourceStream> ins =
+        IncrementalSourceStream::CreateSourceStream(IncrementalMode::INCREMENTAL_DATA);
+    ASSERT_NE(ins, nullptr);
+    ins->SetMaxBufferSize(CHUNK_SIZE + 1);
+    uint8_t chunk[CHUNK_SIZE] = { 0 };
+    ASSERT_EQ(ins->UpdateData(chunk, CHUNK_SIZE, false), SUCCESS);
+    ASSERT_EQ(ins->UpdateData(chunk, CHUNK_SIZE, false), ERR_IMAGE_TOO_LARGE);
+    ASSERT_EQ(ins->GetStreamSize(), CHUNK_SIZE);
+    ASSERT_EQ(ins->UpdateData(chunk, 1, true), SUCCESS);
+    ASSERT_EQ(ins->GetStreamSize(), CHUNK_SIZE + 1);
+    GTEST_LOG_(INFO) << "IncrementalSourceStreamTest: IncrementalSourceStreamTest0020 end";
+}
+}
 }
-}
\ No newline at end of file
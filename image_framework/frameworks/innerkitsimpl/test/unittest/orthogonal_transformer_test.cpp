@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "orthogonal_transformer.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace Multimedia {
+static constexpr int32_t RGB888_PIXEL_BYTES = 3;
+static constexpr int32_t RGBA_F16_PIXEL_BYTES = 8;
+
+class OrthogonalTransformerTest : public testing::Test {
+public:
+    OrthogonalTransformerTest() {}
+    ~OrthogonalTransformerTest() {}
+};
+
+/**
+ * @tc.name: OrthogonalTransformerTest001
+ * @tc.desc: GetRotateOp
+ * @tc.type: FUNC
+ */
+HWTEST_F(OrthogonalTransformerTest, OrthogonalTransformerTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest001 start";
+    OrthogonalOp op = OrthogonalOp::NONE;
+    EXPECT_TRUE(OrthogonalTransformer::GetRotateOp(90.0f, op));
+    EXPECT_EQ(op, OrthogonalOp::ROTATE_90);
+    EXPECT_TRUE(OrthogonalTransformer::GetRotateOp(-90.0f, op));
+    EXPECT_EQ(op, OrthogonalOp::ROTATE_270);
+    EXPECT_TRUE(OrthogonalTransformer::GetRotateOp(540.0f, op));
+    EXPECT_EQ(op, OrthogonalOp::ROTATE_180);
+    EXPECT_TRUE(OrthogonalTransformer::GetRotateOp(360.0f, op));
+    EXPECT_EQ(op, OrthogonalOp::NONE);
+    EXPECT_FALSE(OrthogonalTransformer::GetRotateOp(45.0f, op));
+    EXPECT_EQ(OrthogonalTransformer::GetFlipOp(true, true), OrthogonalOp::ROTATE_180);
+    EXPECT_FALSE(OrthogonalTransformer::IsSupported(PixelFormat::NV21));
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest001 end";
+}
+
+/**
+ * @tc.name: OrthogonalTransformerTest002
+ * @tc.desc: rotate a 3x2 RGB_888 image 90 degrees clockwise
+ * @tc.type: FUNC
+ */
+HWTEST_F(OrthogonalTransformerTest, OrthogonalTransformerTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest002 start";
+    /*
+     * |0 1 2|    |3 0|
+     * |3 4 5| -> |4 1|
+     *            |5 2|
+     */
+    Size srcSize = { 3, 2 };
+    std::vector<uint8_t> src;
+    for (uint8_t i = 0; i < srcSize.width * srcSize.height; i++) {
+        src.insert(src.end(), { i, i, i });
+    }
+    std::vector<uint8_t> dst(src.size());
+    Size dstSize = OrthogonalTransformer::GetDstSize(OrthogonalOp::ROTATE_90, srcSize);
+    EXPECT_EQ(dstSize.width, 2);
+    EXPECT_EQ(dstSize.height, 3);
+    EXPECT_FALSE(OrthogonalTransformer::CanTransformInPlace(OrthogonalOp::ROTATE_90, srcSize));
+    ASSERT_TRUE(OrthogonalTransformer::Transform(OrthogonalOp::ROTATE_90, src.data(), dst.data(), srcSize,
+                                                 RGB888_PIXEL_BYTES));
+    const uint8_t expect[] = { 3, 0, 4, 1, 5, 2 };
+    for (uint32_t i = 0; i < sizeof(expect); i++) {
+        EXPECT_EQ(dst[i * RGB888_PIXEL_BYTES], expect[i]);
+    }
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest002 end";
+}
+
+/**
+ * @tc.name: OrthogonalTransformerTest003
+ * @tc.desc: rotate a square RGBA_F16 image in place, four quarter turns restore it
+ * @tc.type: FUNC
+ */
+HWTEST_F(OrthogonalTransformerTest, OrthogonalTransformerTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest003 start";
+    Size size = { 70, 70 };
+    std::vector<uint64_t> pixels(size.width * size.height);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = i;
+    }
+    std::vector<uint64_t> origin = pixels;
+    uint8_t *data = reinterpret_cast<uint8_t *>(pixels.data());
+    ASSERT_TRUE(OrthogonalTransformer::Transform(OrthogonalOp::ROTATE_90, data, data, size, RGBA_F16_PIXEL_BYTES));
+    // the first row becomes the last column
+    EXPECT_EQ(pixels[size.width - 1], origin[0]);
+    for (int32_t i = 0; i < 3; i++) {
+        ASSERT_TRUE(OrthogonalTransformer::Transform(OrthogonalOp::ROTATE_90, data, data, size,
+                                                     RGBA_F16_PIXEL_BYTES));
+    }
+    EXPECT_EQ(pixels, origin);
+    ASSERT_TRUE(OrthogonalTransformer::Transform(OrthogonalOp::FLIP_X, data, data, size, RGBA_F16_PIXEL_BYTES));
+    EXPECT_EQ(pixels[0], origin[size.width - 1]);
+    GTEST_LOG_(INFO) << "OrthogonalTransformerTest: OrthogonalTransformerTest003 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "pixel_convert_kernels.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace Multimedia {
+// not a multiple of any vector width, so the scalar tail runs as well
+static constexpr uint32_t ROW_WIDTH = 83;
+static constexpr uint32_t MAX_PIXEL_BYTES = 4;
+static constexpr uint32_t CHANNEL_MAX = 255;
+
+class PixelConvertKernelsTest : public testing::Test {
+public:
+    PixelConvertKernelsTest() {}
+    ~PixelConvertKernelsTest() {}
+};
+
+static uint32_t GetPixelBytes(PixelFormat format)
+{
+    uint32_t value = static_cast<uint32_t>(format);
+    if (value == RGB_888 || value == BGR_888) {
+        return SIZE_3_BYTE;
+    }
+    return (value == RGB_565) ? SIZE_2_BYTE : SIZE_4_BYTE;
+}
+
+static std::vector<uint8_t> MakeRow()
+{
+    // simple lcg, keeps the test data reproducible
+    uint32_t seed = 1;
+    std::vector<uint8_t> row(ROW_WIDTH * MAX_PIXEL_BYTES);
+    for (auto &value : row) {
+        seed = seed * 1103515245 + 12345;
+        value = static_cast<uint8_t>(seed >> 16);
+    }
+    return row;
+}
+
+/**
+ * @tc.name: PixelConvertKernelsTest001
+ * @tc.desc: the reciprocal table unpremultiply is the same as Unpremul255 for all 8 bit values
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertKernelsTest, PixelConvertKernelsTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest001 start";
+    uint32_t mismatch = 0;
+    for (uint32_t alpha = 0; alpha <= CHANNEL_MAX; alpha++) {
+        for (uint32_t color = 0; color <= CHANNEL_MAX; color++) {
+            mismatch += (PixelConvertKernels::UnpremulByTable(color, alpha) != Unpremul255(color, alpha)) ? 1 : 0;
+        }
+    }
+    EXPECT_EQ(mismatch, 0u);
+    EXPECT_EQ(PixelConvertKernels::UnpremulByTable(CHANNEL_MAX + 1, 1), 0u);
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest001 end";
+}
+
+/**
+ * @tc.name: PixelConvertKernelsTest002
+ * @tc.desc: every vector row proc gives the same result as the scalar row proc
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertKernelsTest, PixelConvertKernelsTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest002 start";
+    GTEST_LOG_(INFO) << "kernel: " << PixelConvertKernels::GetKernelName();
+    const PixelFormat srcFormats[] = { PixelFormat::RGBA_8888, PixelFormat::BGRA_8888, PixelFormat::ARGB_8888,
+        PixelFormat::RGB_888, static_cast<PixelFormat>(BGR_888) };
+    const PixelFormat dstFormats[] = { PixelFormat::RGBA_8888, PixelFormat::BGRA_8888, PixelFormat::ARGB_8888,
+        PixelFormat::RGB_565 };
+    const AlphaType alphaTypes[] = { AlphaType::IMAGE_ALPHA_TYPE_OPAQUE, AlphaType::IMAGE_ALPHA_TYPE_PREMUL,
+        AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL };
+    std::vector<uint8_t> src = MakeRow();
+    for (PixelFormat srcFormat : srcFormats) {
+        for (PixelFormat dstFormat : dstFormats) {
+            for (AlphaType srcAlpha : alphaTypes) {
+                for (AlphaType dstAlpha : alphaTypes) {
+                    ImageInfo srcInfo;
+                    srcInfo.pixelFormat = srcFormat;
+                    srcInfo.alphaType = srcAlpha;
+                    ImageInfo dstInfo;
+                    dstInfo.pixelFormat = dstFormat;
+                    dstInfo.alphaType = dstAlpha;
+                    std::unique_ptr<PixelConvert> convert = PixelConvert::Create(srcInfo, dstInfo);
+                    ASSERT_NE(convert, nullptr);
+                    uint32_t srcBytes = GetPixelBytes(srcFormat);
+                    uint32_t dstBytes = GetPixelBytes(dstFormat);
+                    std::vector<uint8_t> expect(ROW_WIDTH * MAX_PIXEL_BYTES);
+                    std::vector<uint8_t> result(expect.size());
+                    // a single pixel is shorter than any vector body, so it always takes the scalar loop
+                    for (uint32_t i = 0; i < ROW_WIDTH; i++) {
+                        convert->Convert(expect.data() + i * dstBytes, src.data() + i * srcBytes, 1);
+                    }
+                    convert->Convert(result.data(), src.data(), ROW_WIDTH);
+                    EXPECT_EQ(expect, result) << static_cast<int32_t>(srcFormat) << " -> " <<
+                        static_cast<int32_t>(dstFormat) << " alpha " << static_cast<int32_t>(srcAlpha) << " -> " <<
+                        static_cast<int32_t>(dstAlpha);
+                }
+            }
+        }
+    }
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest002 end";
+}
+
+/**
+ * @tc.name: PixelConvertKernelsTest003
+ * @tc.desc: formats without a vector kernel report none
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertKernelsTest, PixelConvertKernelsTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest003 start";
+    EXPECT_EQ(PixelConvertKernels::GetRowKernel(RGBA_F16, RGBA_8888, AlphaConvertType::NO_CONVERT), nullptr);
+    EXPECT_EQ(PixelConvertKernels::GetRowKernel(RGB_888, RGB_565, AlphaConvertType::NO_CONVERT), nullptr);
+    EXPECT_EQ(PixelConvertKernels::GetRowKernel(RGBA_8888, ABGR_8888, AlphaConvertType::NO_CONVERT), nullptr);
+    GTEST_LOG_(INFO) << "PixelConvertKernelsTest: PixelConvertKernelsTest003 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
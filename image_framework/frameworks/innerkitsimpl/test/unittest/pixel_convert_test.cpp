@@ -1914,5 +1914,61 @@ HWTEST_F(PixelConvertTest, PixelConvertTest0052, TestSize.Level3)
     colorConverterPointer->Convert(destination, source, 2);
     GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertTest0052 start";
 }
+/**
+ * @tc.name: PixelConvertTest0053
+ * @tc.desc: RGBA_8888 PREMUL to RGBA_8888 UNPREMUL, the proc is picked by the alpha convert type.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertTest, PixelConvertTest0053, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertTest0053 start";
+    ImageInfo srcImageInfo;
+    srcImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_PREMUL;
+    srcImageInfo.pixelFormat = PixelFormat::RGBA_8888;
+
+    ImageInfo dstImageInfo;
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_UNPREMUL;
+    dstImageInfo.pixelFormat = PixelFormat::RGBA_8888;
+
+    uint8_t source[4] = { 0x40, 0x20, 0x10, 0x80 };
+    uint8_t destination[4] = { 0 };
+    std::unique_ptr<PixelConvert> colorConverterPointer = PixelConvert::Create(srcImageInfo, dstImageInfo);
+    ASSERT_NE(colorConverterPointer, nullptr);
+    colorConverterPointer->Convert(destination, source, 1);
+    EXPECT_EQ(destination[0], 0x80);
+    EXPECT_EQ(destination[1], 0x40);
+    EXPECT_EQ(destination[2], 0x20);
+    EXPECT_EQ(destination[3], 0x80);
+
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    colorConverterPointer = PixelConvert::Create(srcImageInfo, dstImageInfo);
+    ASSERT_NE(colorConverterPointer, nullptr);
+    colorConverterPointer->Convert(destination, source, 1);
+    EXPECT_EQ(destination[0], 0x80);
+    EXPECT_EQ(destination[3], ALPHA_OPAQUE);
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertTest0053 end";
+}
+
+/**
+ * @tc.name: PixelConvertTest0054
+ * @tc.desc: Create returns nullptr for a format pair without a convert function.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PixelConvertTest, PixelConvertTest0054, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertTest0054 start";
+    ImageInfo srcImageInfo;
+    srcImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    srcImageInfo.pixelFormat = PixelFormat::ALPHA_8;
+
+    ImageInfo dstImageInfo;
+    dstImageInfo.alphaType = AlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
+    dstImageInfo.pixelFormat = PixelFormat::BGRA_8888;
+    EXPECT_EQ(PixelConvert::Create(srcImageInfo, dstImageInfo), nullptr);
+
+    srcImageInfo.pixelFormat = static_cast<PixelFormat>(0x7FFFFFFF);
+    EXPECT_EQ(PixelConvert::Create(srcImageInfo, dstImageInfo), nullptr);
+    GTEST_LOG_(INFO) << "PixelConvertTest: PixelConvertTest0054 end";
+}
 }
 }
\ No newline at end of file
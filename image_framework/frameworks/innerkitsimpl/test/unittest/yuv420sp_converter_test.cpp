@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "yuv420sp_converter.h"
+
+using namespace testing::ext;
+using namespace OHOS::Media;
+namespace OHOS {
+namespace Multimedia {
+static constexpr int32_t ROW_WIDTH = 37;
+static constexpr int32_t RGBA_BYTES = 4;
+static constexpr int32_t RGB565_BYTES = 2;
+static constexpr int32_t CHANNEL_MAX = 255;
+
+class Yuv420spConverterTest : public testing::Test {
+public:
+    Yuv420spConverterTest() {}
+    ~Yuv420spConverterTest() {}
+};
+
+static std::vector<uint8_t> MakeYuv(const Size &size)
+{
+    // simple lcg, keeps the test data reproducible
+    uint32_t seed = 1;
+    size_t uvSize = static_cast<size_t>((size.width + 1) / 2) * 2 * ((size.height + 1) / 2);
+    std::vector<uint8_t> yuv(static_cast<size_t>(size.width) * size.height + uvSize);
+    for (auto &value : yuv) {
+        seed = seed * 1103515245 + 12345;
+        value = static_cast<uint8_t>(seed >> 16);
+    }
+    return yuv;
+}
+
+static uint8_t FloatToUint8(float f)
+{
+    int data = static_cast<int>(f + 0.5f);
+    return static_cast<uint8_t>((data < 0) ? 0 : ((data > CHANNEL_MAX) ? CHANNEL_MAX : data));
+}
+
+/**
+ * @tc.name: Yuv420spConverterTest001
+ * @tc.desc: the selected row proc is bit exact with the scalar row proc
+ * @tc.type: FUNC
+ */
+HWTEST_F(Yuv420spConverterTest, Yuv420spConverterTest001, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest001 start";
+    GTEST_LOG_(INFO) << "row proc: " << Yuv420spConverter::GetRowProcName();
+    const Size size = { ROW_WIDTH, 2 };
+    std::vector<uint8_t> yuv = MakeYuv(size);
+    const PixelFormat dstFormats[] = { PixelFormat::RGBA_8888, PixelFormat::BGRA_8888, PixelFormat::RGB_565 };
+    const YuvColorMatrix matrixes[] = { YuvColorMatrix::BT601_FULL, YuvColorMatrix::BT601_LIMITED,
+        YuvColorMatrix::BT709_FULL, YuvColorMatrix::BT709_LIMITED };
+    for (PixelFormat srcFormat : { PixelFormat::NV21, PixelFormat::NV12 }) {
+        for (YuvColorMatrix matrix : matrixes) {
+            YuvConstants constants;
+            ASSERT_TRUE(Yuv420spConverter::GetConstants(srcFormat, matrix, constants));
+            for (PixelFormat dstFormat : dstFormats) {
+                std::vector<uint8_t> expect(ROW_WIDTH * RGBA_BYTES * size.height);
+                std::vector<uint8_t> result(expect.size());
+                Yuv420spRowArgs args;
+                args.y0 = yuv.data();
+                args.y1 = yuv.data() + ROW_WIDTH;
+                args.uv = yuv.data() + ROW_WIDTH * size.height;
+                args.width = ROW_WIDTH;
+                args.constants = &constants;
+                args.dst0 = expect.data();
+                args.dst1 = expect.data() + ROW_WIDTH * RGBA_BYTES;
+                Yuv420spConverter::GetScalarRowProc(dstFormat)(args);
+                args.dst0 = result.data();
+                args.dst1 = result.data() + ROW_WIDTH * RGBA_BYTES;
+                Yuv420spConverter::GetRowProc(dstFormat)(args);
+                EXPECT_EQ(expect, result);
+            }
+        }
+    }
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest001 end";
+}
+
+/**
+ * @tc.name: Yuv420spConverterTest002
+ * @tc.desc: BT.601 full range NV21 to RGBA_8888 keeps the result of the float formula
+ * @tc.type: FUNC
+ */
+HWTEST_F(Yuv420spConverterTest, Yuv420spConverterTest002, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest002 start";
+    const Size size = { 34, 5 };
+    std::vector<uint8_t> yuv = MakeYuv(size);
+    Yuv420spInfo info;
+    info.data = yuv.data();
+    info.dataSize = yuv.size();
+    info.size = size;
+    info.format = PixelFormat::NV21;
+    std::vector<uint8_t> rgba(size.width * size.height * RGBA_BYTES);
+    ASSERT_TRUE(Yuv420spConverter::Convert(info, PixelFormat::RGBA_8888, rgba.data(), rgba.size()));
+    const uint8_t *uvPlane = yuv.data() + size.width * size.height;
+    for (int32_t h = 0; h < size.height; h++) {
+        for (int32_t w = 0; w < size.width; w++) {
+            const uint8_t *uv = uvPlane + (h / 2) * size.width + (w & ~1);
+            const float y = yuv[h * size.width + w];
+            const float v = uv[0];
+            const float u = uv[1];
+            const uint8_t *pixel = rgba.data() + (h * size.width + w) * RGBA_BYTES;
+            EXPECT_LE(std::abs(pixel[0] - FloatToUint8(y + 1.402f * v - 0.703749f * CHANNEL_MAX)), 1);
+            EXPECT_LE(std::abs(pixel[1] - FloatToUint8(y - 0.344136f * u - 0.714136f * v + 0.531211f * CHANNEL_MAX)),
+                1);
+            EXPECT_LE(std::abs(pixel[2] - FloatToUint8(y + 1.772f * u - 0.889475f * CHANNEL_MAX)), 1);
+            EXPECT_EQ(pixel[3], CHANNEL_MAX);
+        }
+    }
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest002 end";
+}
+
+/**
+ * @tc.name: Yuv420spConverterTest003
+ * @tc.desc: limited range black and white, and RGB_565 output
+ * @tc.type: FUNC
+ */
+HWTEST_F(Yuv420spConverterTest, Yuv420spConverterTest003, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest003 start";
+    // a 2x2 image, the left column is black and the right column is white
+    std::vector<uint8_t> yuv = { 16, 235, 16, 235, 128, 128 };
+    Yuv420spInfo info;
+    info.data = yuv.data();
+    info.dataSize = yuv.size();
+    info.size = { 2, 2 };
+    info.format = PixelFormat::NV12;
+    info.matrix = YuvColorMatrix::BT709_LIMITED;
+    uint16_t rgb565[4] = { 0 };
+    ASSERT_TRUE(Yuv420spConverter::Convert(info, PixelFormat::RGB_565, reinterpret_cast<uint8_t *>(rgb565),
+        sizeof(rgb565)));
+    EXPECT_EQ(rgb565[0], 0x0000);
+    EXPECT_EQ(rgb565[1], 0xFFFF);
+    EXPECT_EQ(rgb565[2], 0x0000);
+    EXPECT_EQ(rgb565[3], 0xFFFF);
+
+    uint8_t bgra[2 * 2 * RGBA_BYTES] = { 0 };
+    EXPECT_FALSE(Yuv420spConverter::Convert(info, PixelFormat::RGBA_F16, bgra, sizeof(bgra)));
+    EXPECT_FALSE(Yuv420spConverter::Convert(info, PixelFormat::BGRA_8888, bgra, sizeof(bgra) - 1));
+    info.dataSize = yuv.size() - 1;
+    EXPECT_FALSE(Yuv420spConverter::Convert(info, PixelFormat::BGRA_8888, bgra, sizeof(bgra)));
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest003 end";
+}
+
+/**
+ * @tc.name: Yuv420spConverterTest004
+ * @tc.desc: converting rows in parallel gives the same result, odd sizes included
+ * @tc.type: FUNC
+ */
+HWTEST_F(Yuv420spConverterTest, Yuv420spConverterTest004, TestSize.Level3)
+{
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest004 start";
+    const Size size = { 67, 41 };
+    std::vector<uint8_t> yuv = MakeYuv(size);
+    Yuv420spInfo info;
+    info.data = yuv.data();
+    info.dataSize = yuv.size();
+    info.size = size;
+    info.format = PixelFormat::NV12;
+    std::vector<uint8_t> expect(size.width * size.height * RGB565_BYTES);
+    std::vector<uint8_t> result(expect.size());
+    ASSERT_TRUE(Yuv420spConverter::Convert(info, PixelFormat::RGB_565, expect.data(), expect.size(), 1));
+    ASSERT_TRUE(Yuv420spConverter::Convert(info, PixelFormat::RGB_565, result.data(), result.size(), 3));
+    EXPECT_EQ(expect, result);
+    GTEST_LOG_(INFO) << "Yuv420spConverterTest: Yuv420spConverterTest004 end";
+}
+} // namespace Multimedia
+} // namespace OHOS
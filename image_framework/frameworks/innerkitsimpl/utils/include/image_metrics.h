@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRAMEWORKS_INNERKITSIMPL_UTILS_INCLUDE_IMAGE_METRICS_H_
+#define FRAMEWORKS_INNERKITSIMPL_UTILS_INCLUDE_IMAGE_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace Media {
+// names of the spans recorded by the framework itself.
+constexpr char SPAN_FORMAT_DETECT[] = "FormatDetect";
+constexpr char SPAN_HEADER_DECODE[] = "HeaderDecode";
+constexpr char SPAN_PIXEL_DECODE[] = "PixelDecode";
+constexpr char SPAN_POST_PROC[] = "PostProc";
+constexpr char SPAN_CONVERT[] = "Convert";
+constexpr char SPAN_ENCODE[] = "Encode";
+// one band of a jpeg decoded on several threads.
+constexpr char SPAN_DECODE_BAND[] = "DecodeBand";
+
+enum class MetricsCounter : uint32_t {
+    BYTES_READ = 0,
+    // pixel buffers only, not every heap allocation.
+    ALLOCATIONS,
+    ALLOCATED_BYTES,
+    CACHE_HITS,
+    CACHE_MISSES,
+    COUNTER_NUM
+};
+
+/*
+ * In-process recorder of spans and counters. Every thread records its spans into its own ring buffer, the
+ * oldest spans are overwritten when the ring is full. The ring of an exited thread is freed once exported, and
+ * only the rings of the latest MAX_EXITED_THREADS exited threads are kept until then. Nothing is recorded until
+ * SetEnabled(true), or when the IMAGE_METRICS_TRACE_FILE environment variable names a file the trace is written
+ * to at exit.
+ * When disabled, a span or a counter costs one relaxed atomic load.
+ */
+class ImageMetrics {
+public:
+    static constexpr uint32_t RING_CAPACITY = 1024;
+    static constexpr uint32_t MAX_SPAN_DEPTH = 32;
+    static constexpr uint32_t MAX_SPAN_NAME = 64;
+    static constexpr uint32_t MAX_EXITED_THREADS = 16;
+
+    static bool IsEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    static void AddCounter(MetricsCounter counter, uint64_t value)
+    {
+        if (IsEnabled()) {
+            counters_[static_cast<uint32_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+    // one pixel buffer of the given size.
+    static void AddAllocation(uint64_t bytes)
+    {
+        if (IsEnabled()) {
+            counters_[static_cast<uint32_t>(MetricsCounter::ALLOCATIONS)].fetch_add(1, std::memory_order_relaxed);
+            counters_[static_cast<uint32_t>(MetricsCounter::ALLOCATED_BYTES)].fetch_add(bytes,
+                std::memory_order_relaxed);
+        }
+    }
+    static void SetEnabled(bool enabled);
+    static void BeginSpan(const char *name);
+    static void EndSpan();
+    static uint64_t GetCounter(MetricsCounter counter);
+    // number of spans held in the ring buffers of all threads.
+    static uint64_t GetSpanCount();
+    // drops the recorded spans and zeroes the counters, spans still open are kept.
+    static void Reset();
+    // Chrome trace-event JSON, loadable by chrome://tracing and Perfetto.
+    static std::string ExportChromeTrace();
+    static uint32_t ExportChromeTrace(const std::string &path);
+
+private:
+    static std::atomic<bool> enabled_;
+    static std::atomic<uint64_t> counters_[static_cast<uint32_t>(MetricsCounter::COUNTER_NUM)];
+};
+
+class ImageMetricsSpan {
+public:
+    explicit ImageMetricsSpan(const char *name) : active_(ImageMetrics::IsEnabled())
+    {
+        if (active_) {
+            ImageMetrics::BeginSpan(name);
+        }
+    }
+    ~ImageMetricsSpan()
+    {
+        if (active_) {
+            ImageMetrics::EndSpan();
+        }
+    }
+    ImageMetricsSpan(const ImageMetricsSpan &) = delete;
+    ImageMetricsSpan &operator=(const ImageMetricsSpan &) = delete;
+
+private:
+    bool active_;
+};
+} // namespace Media
+} // namespace OHOS
+#endif // FRAMEWORKS_INNERKITSIMPL_UTILS_INCLUDE_IMAGE_METRICS_H_
@@ -27,7 +27,9 @@ public:
     ~ImageTrace();
 
 private:
+    void Start();
     std::string title_;
+    bool recording_ = false;
 };
 } // namespace Media
 } // namespace OHOS
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "image_log.h"
+#include "media_errors.h"
+
+namespace OHOS {
+namespace Media {
+using namespace std;
+
+namespace {
+constexpr char TRACE_FILE_ENV[] = "IMAGE_METRICS_TRACE_FILE";
+constexpr double NS_PER_US = 1000.0;
+constexpr uint32_t COUNTER_NUM = static_cast<uint32_t>(MetricsCounter::COUNTER_NUM);
+constexpr const char *COUNTER_NAMES[COUNTER_NUM] = {
+    "bytesRead", "allocations", "allocatedBytes", "cacheHits", "cacheMisses"
+};
+
+struct SpanRecord {
+    char name[ImageMetrics::MAX_SPAN_NAME];
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+struct OpenSpan {
+    char name[ImageMetrics::MAX_SPAN_NAME];
+    uint64_t beginNs;
+};
+
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t id) : tid(id), records(ImageMetrics::RING_CAPACITY) {}
+    // the owner thread takes it to commit a span, the exporter to read the ring.
+    mutex recordMutex;
+    uint32_t tid;
+    vector<SpanRecord> records;
+    uint64_t written = 0;
+    // owner thread only, spans deeper than MAX_SPAN_DEPTH are counted but not recorded.
+    OpenSpan openSpans[ImageMetrics::MAX_SPAN_DEPTH];
+    uint32_t depth = 0;
+    // set under the registry mutex when the owner thread exits.
+    bool exited = false;
+};
+
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct Registry {
+    Registry() : startNs(NowNs()) {}
+    mutex registryMutex;
+    // the buffer of an exited thread stays until its spans are exported or dropped, at most
+    // MAX_EXITED_THREADS of them, so short lived threads do not grow the registry without bound.
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    uint32_t nextTid = 1;
+    uint64_t startNs;
+};
+
+Registry &GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// registry mutex held.
+void RemoveExitedBuffers(Registry &registry, bool keepRecorded)
+{
+    uint32_t exitedCount = 0;
+    for (auto &buffer : registry.buffers) {
+        if (buffer->exited) {
+            exitedCount++;
+        }
+    }
+    auto iter = registry.buffers.begin();
+    while (iter != registry.buffers.end()) {
+        ThreadBuffer &buffer = **iter;
+        if (!buffer.exited) {
+            ++iter;
+            continue;
+        }
+        bool recorded = false;
+        {
+            lock_guard<mutex> recordGuard(buffer.recordMutex);
+            recorded = (buffer.written != 0);
+        }
+        // the oldest exited threads go first when over the cap.
+        if (keepRecorded && recorded && exitedCount <= ImageMetrics::MAX_EXITED_THREADS) {
+            ++iter;
+            continue;
+        }
+        iter = registry.buffers.erase(iter);
+        exitedCount--;
+    }
+}
+
+struct ThreadBufferHolder {
+    ~ThreadBufferHolder()
+    {
+        if (buffer == nullptr) {
+            return;
+        }
+        Registry &registry = GetRegistry();
+        lock_guard<mutex> guard(registry.registryMutex);
+        buffer->exited = true;
+        RemoveExitedBuffers(registry, true);
+    }
+    shared_ptr<ThreadBuffer> buffer;
+};
+
+ThreadBuffer &GetThreadBuffer()
+{
+    thread_local ThreadBufferHolder holder;
+    if (holder.buffer == nullptr) {
+        Registry &registry = GetRegistry();
+        lock_guard<mutex> guard(registry.registryMutex);
+        holder.buffer = make_shared<ThreadBuffer>(registry.nextTid++);
+        registry.buffers.push_back(holder.buffer);
+    }
+    return *holder.buffer;
+}
+
+void CopyName(char *dst, const char *src)
+{
+    if (src == nullptr) {
+        dst[0] = '\0';
+        return;
+    }
+    size_t len = strnlen(src, ImageMetrics::MAX_SPAN_NAME - 1);
+    copy(src, src + len, dst);
+    dst[len] = '\0';
+}
+
+void AppendEscaped(string &out, const char *str)
+{
+    for (const char *p = str; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') {
+            out.push_back('\\');
+            out.push_back(*p);
+        } else if (static_cast<unsigned char>(*p) < ' ') {
+            out.push_back(' ');
+        } else {
+            out.push_back(*p);
+        }
+    }
+}
+
+int GetPid()
+{
+#ifdef _WIN32
+    return _getpid();
+#else
+    return static_cast<int>(getpid());
+#endif
+}
+
+// IMAGE_METRICS_TRACE_FILE turns recording on at load and writes the trace at exit.
+class TraceFileWriter {
+public:
+    TraceFileWriter()
+    {
+        // constructed first, so the registry outlives this writer.
+        GetRegistry();
+        const char *path = getenv(TRACE_FILE_ENV);
+        if (path != nullptr && path[0] != '\0') {
+            path_ = path;
+            ImageMetrics::SetEnabled(true);
+        }
+    }
+    ~TraceFileWriter()
+    {
+        if (!path_.empty()) {
+            ImageMetrics::ExportChromeTrace(path_);
+        }
+    }
+
+private:
+    string path_;
+};
+
+TraceFileWriter g_traceFileWriter;
+} // namespace
+
+atomic<bool> ImageMetrics::enabled_(false);
+atomic<uint64_t> ImageMetrics::counters_[COUNTER_NUM] = {};
+
+void ImageMetrics::SetEnabled(bool enabled)
+{
+    enabled_.store(enabled, memory_order_relaxed);
+}
+
+void ImageMetrics::BeginSpan(const char *name)
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    if (buffer.depth < MAX_SPAN_DEPTH) {
+        OpenSpan &span = buffer.openSpans[buffer.depth];
+        CopyName(span.name, name);
+        span.beginNs = NowNs();
+    }
+    buffer.depth++;
+}
+
+void ImageMetrics::EndSpan()
+{
+    ThreadBuffer &buffer = GetThreadBuffer();
+    if (buffer.depth == 0) {
+        return;
+    }
+    buffer.depth--;
+    if (buffer.depth >= MAX_SPAN_DEPTH) {
+        return;
+    }
+    const OpenSpan &span = buffer.openSpans[buffer.depth];
+    uint64_t endNs = NowNs();
+    lock_guard<mutex> guard(buffer.recordMutex);
+    SpanRecord &record = buffer.records[buffer.written % RING_CAPACITY];
+    copy(span.name, span.name + MAX_SPAN_NAME, record.name);
+    record.beginNs = span.beginNs;
+    record.endNs = endNs;
+    buffer.written++;
+}
+
+uint64_t ImageMetrics::GetCounter(MetricsCounter counter)
+{
+    uint32_t index = static_cast<uint32_t>(counter);
+    if (index >= COUNTER_NUM) {
+        return 0;
+    }
+    return counters_[index].load(memory_order_relaxed);
+}
+
+uint64_t ImageMetrics::GetSpanCount()
+{
+    Registry &registry = GetRegistry();
+    lock_guard<mutex> guard(registry.registryMutex);
+    uint64_t count = 0;
+    for (auto &buffer : registry.buffers) {
+        lock_guard<mutex> recordGuard(buffer->recordMutex);
+        count += min<uint64_t>(buffer->written, RING_CAPACITY);
+    }
+    return count;
+}
+
+void ImageMetrics::Reset()
+{
+    Registry &registry = GetRegistry();
+    lock_guard<mutex> guard(registry.registryMutex);
+    RemoveExitedBuffers(registry, false);
+    for (auto &buffer : registry.buffers) {
+        lock_guard<mutex> recordGuard(buffer->recordMutex);
+        buffer->written = 0;
+    }
+    for (auto &counter : counters_) {
+        counter.store(0, memory_order_relaxed);
+    }
+}
+
+string ImageMetrics::ExportChromeTrace()
+{
+    Registry &registry = GetRegistry();
+    int pid = GetPid();
+    string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto beginEvent = [&out, &first]() {
+        out += first ? "\n" : ",\n";
+        first = false;
+    };
+    char event[128];
+    lock_guard<mutex> guard(registry.registryMutex);
+    for (auto &buffer : registry.buffers) {
+        beginEvent();
+        snprintf(event, sizeof(event), "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%u,"
+            "\"args\":{\"name\":\"image thread %u\"}}", pid, buffer->tid, buffer->tid);
+        out += event;
+        lock_guard<mutex> recordGuard(buffer->recordMutex);
+        uint64_t count = min<uint64_t>(buffer->written, RING_CAPACITY);
+        for (uint64_t i = buffer->written - count; i < buffer->written; i++) {
+            const SpanRecord &record = buffer->records[i % RING_CAPACITY];
+            beginEvent();
+            out += "{\"ph\":\"X\",\"cat\":\"image\",\"name\":\"";
+            AppendEscaped(out, record.name);
+            uint64_t beginNs = (record.beginNs > registry.startNs) ? (record.beginNs - registry.startNs) : 0;
+            snprintf(event, sizeof(event), "\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", pid,
+                buffer->tid, beginNs / NS_PER_US, (record.endNs - record.beginNs) / NS_PER_US);
+            out += event;
+        }
+    }
+    beginEvent();
+    uint64_t nowNs = NowNs() - registry.startNs;
+    snprintf(event, sizeof(event), "{\"ph\":\"C\",\"name\":\"ImageMetrics\",\"pid\":%d,\"tid\":0,"
+        "\"ts\":%.3f,\"args\":{", pid, nowNs / NS_PER_US);
+    out += event;
+    for (uint32_t i = 0; i < COUNTER_NUM; i++) {
+        snprintf(event, sizeof(event), "%s\"%s\":%llu", (i == 0) ? "" : ",", COUNTER_NAMES[i],
+            static_cast<unsigned long long>(counters_[i].load(memory_order_relaxed)));
+        out += event;
+    }
+    out += "}}\n],\"displayTimeUnit\":\"ms\"}\n";
+    // the spans of exited threads are exported now, nothing can add to them.
+    RemoveExitedBuffers(registry, false);
+    return out;
+}
+
+uint32_t ImageMetrics::ExportChromeTrace(const string &path)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        IMAGE_LOGE("[ImageMetrics]open trace file fail.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    string trace = ExportChromeTrace();
+    size_t written = fwrite(trace.data(), 1, trace.size(), file);
+    int ret = fclose(file);
+    if (written != trace.size() || ret != 0) {
+        IMAGE_LOGE("[ImageMetrics]write trace file fail.");
+        return ERROR;
+    }
+    return SUCCESS;
+}
+} // namespace Media
+} // namespace OHOS
@@ -14,6 +14,7 @@
  */
 #include "image_trace.h"
 #include "hitrace_meter.h"
+#include "image_metrics.h"
 #include "securec.h"
 
 namespace OHOS {
@@ -22,12 +23,24 @@ static constexpr int32_t FORMAT_BUF_SIZE = 128;
 
 ImageTrace::ImageTrace(const std::string &title) : title_(title)
 {
-    StartTrace(HITRACE_TAG_ZIMAGE, title);
+    Start();
 }
 
 ImageTrace::~ImageTrace()
 {
     FinishTrace(HITRACE_TAG_ZIMAGE);
+    if (recording_) {
+        ImageMetrics::EndSpan();
+    }
+}
+
+void ImageTrace::Start()
+{
+    StartTrace(HITRACE_TAG_ZIMAGE, title_);
+    recording_ = ImageMetrics::IsEnabled();
+    if (recording_) {
+        ImageMetrics::BeginSpan(title_.c_str());
+    }
 }
 
 ImageTrace::ImageTrace(const char *fmt, ...)
@@ -46,7 +59,7 @@ ImageTrace::ImageTrace(const char *fmt, ...)
             title_ = "ImageTraceFmt Format Error";
         }
     }
-    StartTrace(HITRACE_TAG_ZIMAGE, title_);
+    Start();
 }
 } // namespace Media
 } // namespace OHOS
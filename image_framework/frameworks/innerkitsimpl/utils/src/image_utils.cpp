@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <mutex>
 #include <string>
 #include "hilog/log_cpp.h"
 #include "image_log.h"
@@ -47,6 +48,7 @@ constexpr int32_t NV21_BYTES = 2;  // Each pixel is sorted on 3/2 bytes.
 constexpr float EPSILON = 1e-6;
 constexpr int MAX_DIMENSION = INT32_MAX >> 2;
 static bool g_pluginRegistered = false;
+static std::mutex g_pluginRegisterMutex;
 
 bool ImageUtils::GetFileSize(const string &pathName, size_t &size)
 {
@@ -151,6 +153,8 @@ uint32_t ImageUtils::RegisterPluginServer()
 
 PluginServer& ImageUtils::GetPluginServer()
 {
+    // decoders created on several threads at once must not register the plugins twice.
+    std::lock_guard<std::mutex> guard(g_pluginRegisterMutex);
     if (!g_pluginRegistered) {
         uint32_t result = RegisterPluginServer();
         if (result != SUCCESS) {
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANIMATION_DECODER_H
+#define ANIMATION_DECODER_H
+
+#include "image_type.h"
+#include "nocopyable.h"
+#include "peer_listener.h"
+
+namespace OHOS {
+namespace Media {
+class ImageSource;
+
+struct AnimationFrame {
+    // the output buffer the frame was written to, the other one still holds the frame before it.
+    uint8_t *pixels = nullptr;
+    uint32_t index = 0;
+    uint32_t frameCount = 0;
+    // display time of the frame in milliseconds.
+    int32_t delayTime = 0;
+    DisposalType disposal = DisposalType::UNSPECIFIED;
+    // area that differs from the frame returned before, the whole image for the first frame.
+    Rect dirtyRect;
+};
+
+/*
+ * Plays an animated GIF or WebP frame after frame into two buffers owned by the caller, written in turn, so a
+ * frame can be displayed while the next one is decoded. No memory is allocated per frame: the decoder composes
+ * each frame on its own canvas and only the area changed since a buffer was last written is copied into it.
+ * The rows are GetImageInfo().size.width pixels of 4 bytes, RGBA_8888 or BGRA_8888.
+ */
+class AnimationDecoder : public PeerListener {
+public:
+    AnimationDecoder() = delete;
+    ~AnimationDecoder();
+    const ImageInfo &GetImageInfo() const;
+    uint64_t GetFrameByteCount() const;
+    // both buffers hold at least GetFrameByteCount() bytes, setting them again writes the next frame in full.
+    uint32_t SetOutputBuffers(uint8_t *front, uint8_t *back, uint64_t bufferSize);
+    // the frame after the last one is the first frame again.
+    uint32_t DecodeNextFrame(AnimationFrame &frame);
+    // the next frame decoded is the first one.
+    void Rewind();
+
+private:
+    // declare friend class, only ImageSource can create AnimationDecoder object.
+    friend class ImageSource;
+    static constexpr uint32_t BUFFER_COUNT = 2;
+    DISALLOW_COPY_AND_MOVE(AnimationDecoder);
+    AnimationDecoder(ImageSource *imageSource, const ImageInfo &info);
+    void OnPeerDestory() override;
+    void CopyToBuffer(const uint8_t *canvas, uint8_t *buffer, const Rect &rect);
+    ImageSource *imageSource_ = nullptr;
+    ImageInfo imageInfo_;
+    uint8_t *buffers_[BUFFER_COUNT] = { nullptr, nullptr };
+    // area of each buffer that is behind the canvas, whole when the buffer has not been written yet.
+    Rect staleRects_[BUFFER_COUNT];
+    uint32_t bufferIndex_ = 0;
+    uint32_t nextIndex_ = 0;
+    uint32_t frameCount_ = 0;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // ANIMATION_DECODER_H
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_INNERKITS_INCLUDE_BATCH_DECODER_H_
+#define INTERFACES_INNERKITS_INCLUDE_BATCH_DECODER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "image_source.h"
+#include "image_type.h"
+#include "media_errors.h"
+#include "nocopyable.h"
+#include "pixel_map.h"
+
+namespace OHOS {
+namespace Media {
+enum class BatchSourceType : int32_t {
+    PATH = 0,
+    FD = 1,
+    BUFFER = 2
+};
+
+struct BatchDecodeItem {
+    BatchSourceType sourceType = BatchSourceType::PATH;
+    std::string pathName;
+    int fd = -1;
+    /**
+     * The buffer is not copied, it must stay valid until the result of the item is delivered.
+     */
+    const uint8_t *data = nullptr;
+    uint32_t size = 0;
+    SourceOptions sourceOptions;
+    DecodeOptions decodeOptions;
+    /**
+     * Index of the image (frame) to decode.
+     */
+    uint32_t index = 0;
+};
+
+struct BatchDecodeResult {
+    /**
+     * Position of the item in the submitted list.
+     */
+    uint32_t itemIndex = 0;
+    uint32_t errorCode = SUCCESS;
+    std::unique_ptr<PixelMap> pixelMap;
+};
+
+struct BatchDecodeOptions {
+    /**
+     * Number of decode threads, 0 uses the hardware concurrency. At most MAX_THREAD_COUNT.
+     */
+    uint32_t threadCount = 0;
+    /**
+     * Upper bound of the pixel bytes being decoded or delivered at the same time, 0 means no bound.
+     * An item larger than the bound still runs, but alone.
+     */
+    uint64_t maxInflightBytes = 0;
+};
+
+/*
+ * Decodes many sources on a bounded pool of threads. Every worker owns a queue of items and takes
+ * work from the other queues once its own is empty. Each item gets its own ImageSource, so items
+ * never wait on each other's decoding lock.
+ */
+class BatchDecoder {
+public:
+    static constexpr uint32_t MAX_THREAD_COUNT = 16;
+    // runs on a worker thread, once for every item. The pixel bytes of the item count as in flight until it returns.
+    using Callback = std::function<void(BatchDecodeResult &result)>;
+
+    static std::unique_ptr<BatchDecoder> Create(const BatchDecodeOptions &opts);
+    ~BatchDecoder();
+    uint32_t Submit(const std::vector<BatchDecodeItem> &items, const Callback &callback);
+    /**
+     * The results are in the order of the items. The pixel bytes of a result stop counting as in
+     * flight once the result is stored, so the bound only covers the decoding itself.
+     */
+    std::future<std::vector<BatchDecodeResult>> Submit(const std::vector<BatchDecodeItem> &items);
+    // blocks until every submitted item has been delivered, must not be called from a callback.
+    void Wait();
+    uint32_t GetThreadCount() const;
+
+private:
+    DISALLOW_COPY_AND_MOVE(BatchDecoder);
+    struct Task {
+        BatchDecodeItem item;
+        uint32_t itemIndex = 0;
+        std::shared_ptr<Callback> callback;
+    };
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    explicit BatchDecoder(const BatchDecodeOptions &opts);
+    void Start();
+    void WorkerLoop(uint32_t workerId);
+    bool PopTask(uint32_t workerId, Task &task);
+    void RunTask(Task &task);
+    std::unique_ptr<ImageSource> CreateSource(const BatchDecodeItem &item, uint32_t &errorCode);
+    uint64_t EstimatePixelBytes(ImageSource &source, const BatchDecodeItem &item);
+    void AcquireBytes(uint64_t bytes);
+    void ReleaseBytes(uint64_t bytes);
+
+    BatchDecodeOptions opts_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+    uint32_t nextQueue_ = 0;
+    // protects the counters below and pairs with the condition variables.
+    std::mutex stateMutex_;
+    std::condition_variable taskCond_;
+    std::condition_variable doneCond_;
+    std::condition_variable bytesCond_;
+    uint64_t queuedCount_ = 0;
+    uint64_t pendingCount_ = 0;
+    uint64_t inflightBytes_ = 0;
+    bool stop_ = false;
+};
+} // namespace Media
+} // namespace OHOS
+
+#endif // INTERFACES_INNERKITS_INCLUDE_BATCH_DECODER_H_
@@ -52,6 +52,56 @@ struct PackOption {
      * Hint to how many images will be packed into the image file.
      */
     uint32_t numberHint = 1;
+
+    /**
+     * Threads an encoder may split the image across, 0 uses the hardware concurrency.
+     */
+    uint32_t threadCount = 1;
+
+    /**
+     * Chroma subsampling of a JPEG encoded from rgb pixels.
+     */
+    ChromaSubsampling subsampling = ChromaSubsampling::DEFAULT;
+
+    /**
+     * Compute Huffman tables for the image, smaller files for a slower encode.
+     */
+    bool optimizeCoding = false;
+
+    /**
+     * Write a progressive JPEG with the standard scan script.
+     */
+    bool progressive = false;
+
+    /**
+     * Forward DCT used by the JPEG encoder.
+     */
+    DctMethod dctMethod = DctMethod::DEFAULT;
+
+    /**
+     * MCUs between two JPEG restart markers, 0 writes none. At most 65535.
+     */
+    uint32_t restartInterval = 0;
+
+    /**
+     * zlib level of a PNG, 0 stores the data, 9 is the smallest and slowest. -1 follows the preset.
+     */
+    int32_t compressionLevel = -1;
+
+    /**
+     * Row filter of a PNG.
+     */
+    PngFilter pngFilter = PngFilter::DEFAULT;
+
+    /**
+     * zlib strategy of a PNG.
+     */
+    CompressionStrategy compressionStrategy = CompressionStrategy::DEFAULT;
+
+    /**
+     * Encoder preset, the level, filter and strategy set above override it.
+     */
+    EncodePreset preset = EncodePreset::DEFAULT;
 };
 
 class PackerStream;
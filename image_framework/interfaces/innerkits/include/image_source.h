@@ -23,6 +23,7 @@
 #include <mutex>
 #include <set>
 
+#include "animation_decoder.h"
 #include "decode_listener.h"
 #include "image_type.h"
 #include "incremental_pixel_map.h"
@@ -41,6 +42,7 @@ namespace OHOS {
 namespace ImagePlugin {
 class AbsImageFormatAgent;
 class AbsImageDecoder;
+struct AnimationFrameContext;
 struct PixelDecodeOptions;
 struct PlImageInfo;
 } // namespace ImagePlugin
@@ -53,6 +55,7 @@ struct SourceOptions {
     int32_t baseDensity = 0;
     PixelFormat pixelFormat = PixelFormat::UNKNOWN;
     Size size;
+    YuvColorMatrix yuvColorMatrix = YuvColorMatrix::BT601_FULL;
 };
 
 struct IncrementalSourceOptions {
@@ -119,6 +122,8 @@ struct IncrementalDecodingContext {
     std::unique_ptr<ImagePlugin::AbsImageDecoder> decoder;
     ImageDecodingState IncrementalState = ImageDecodingState::UNRESOLVED;
     uint8_t decodingProgress = 0;
+    // the decoder crops by itself, the post-proc must not crop again.
+    bool cropApplied = false;
 };
 
 class SourceStream;
@@ -149,6 +154,9 @@ public:
     NATIVEEXPORT std::unique_ptr<IncrementalPixelMap> CreateIncrementalPixelMap(uint32_t index,
                                                                                 const DecodeOptions &opts,
                                                                                 uint32_t &errorCode);
+    // plays the frames of an animated image one after another into buffers of the caller.
+    NATIVEEXPORT std::unique_ptr<AnimationDecoder> CreateAnimationDecoder(const DecodeOptions &opts,
+                                                                          uint32_t &errorCode);
     // for incremental source.
     NATIVEEXPORT uint32_t UpdateData(const uint8_t *data, uint32_t size, bool isCompleted);
     // for obtaining basic image information without decoding image data.
@@ -172,6 +180,13 @@ public:
         const int fd);
     NATIVEEXPORT uint32_t ModifyImageProperty(uint32_t index, const std::string &key, const std::string &value,
         uint8_t *data, uint32_t size);
+    // writes all the properties in one pass, the EXIF block of a JPEG is rewritten in place when it still fits.
+    NATIVEEXPORT uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const std::string &path);
+    NATIVEEXPORT uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const int fd);
+    NATIVEEXPORT uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        uint8_t *data, uint32_t size);
     NATIVEEXPORT const NinePatchInfo &GetNinePatchInfo() const;
     NATIVEEXPORT void SetMemoryUsagePreference(const MemoryUsagePreference preference);
     NATIVEEXPORT MemoryUsagePreference GetMemoryUsagePreference();
@@ -182,6 +197,7 @@ private:
     using FormatAgentMap = std::map<std::string, ImagePlugin::AbsImageFormatAgent *>;
     using ImageStatusMap = std::map<uint32_t, ImageDecodingStatus>;
     using IncrementalRecordMap = std::map<PixelMap *, IncrementalDecodingContext>;
+    using AnimationRecordMap = std::map<AnimationDecoder *, std::unique_ptr<ImagePlugin::AbsImageDecoder>>;
     ImageSource(std::unique_ptr<SourceStream> &&stream, const SourceOptions &opts);
     uint32_t CheckEncodedFormat(ImagePlugin::AbsImageFormatAgent &agent);
     static FormatAgentMap InitClass();
@@ -204,6 +220,11 @@ private:
     uint32_t PromoteDecoding(uint32_t index, const DecodeOptions &opts, PixelMap &pixelMap, ImageDecodingState &state,
                              uint8_t &decodeProgress);
     void DetachIncrementalDecoding(PixelMap &pixelMap);
+    // declare friend class, only AnimationDecoder can decode frames with the decoder kept for it.
+    friend class AnimationDecoder;
+    uint32_t DecodeAnimationFrame(AnimationDecoder &animationDecoder, uint32_t index,
+                                  ImagePlugin::AnimationFrameContext &context);
+    void DetachAnimationDecoding(AnimationDecoder &animationDecoder);
     ImageStatusMap::iterator GetValidImageStatus(uint32_t index, uint32_t &errorCode);
     uint32_t AddIncrementalContext(PixelMap &pixelMap, IncrementalRecordMap::iterator &iterator);
     uint32_t DoIncrementalDecoding(uint32_t index, const DecodeOptions &opts, PixelMap &pixelMap,
@@ -218,8 +239,9 @@ private:
     static std::unique_ptr<SourceStream> DecodeBase64(const uint8_t *data, uint32_t size);
     static std::unique_ptr<SourceStream> DecodeBase64(const std::string &data);
     bool IsSpecialYUV();
-    bool ConvertYUV420ToRGBA(uint8_t *data, uint32_t size, bool isSupportOdd, bool isAddUV, uint32_t &errorCode);
-    std::unique_ptr<PixelMap> CreatePixelMapForYUV(uint32_t &errorCode);
+    bool ConvertYUV420ToRGBA(uint8_t *data, uint32_t size, PixelFormat dstFormat, bool isSupportOdd, bool isAddUV,
+                             uint32_t &errorCode);
+    std::unique_ptr<PixelMap> CreatePixelMapForYUV(const DecodeOptions &opts, uint32_t &errorCode);
 
     const std::string NINE_PATCH = "ninepatch";
     const std::string SKIA_DECODER = "SKIA_DECODER";
@@ -232,6 +254,7 @@ private:
     NinePatchInfo ninePatchInfo_;
     ImageStatusMap imageStatusMap_;
     IncrementalRecordMap incDecodingMap_;
+    AnimationRecordMap animDecodingMap_;
     // The main decoder is responsible for ordinary decoding (non-Incremental decoding),
     // as well as decoding SourceInfo and ImageInfo.
     std::unique_ptr<ImagePlugin::AbsImageDecoder> mainDecoder_;
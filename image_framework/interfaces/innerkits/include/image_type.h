@@ -87,6 +87,14 @@ enum class ColorSpace : int32_t {
     SMPTE_C = 16,
 };
 
+// Matrix and range of the yuv samples, used when a yuv buffer is converted to rgb.
+enum class YuvColorMatrix : int32_t {
+    BT601_FULL = 0,     // the same as jpeg
+    BT601_LIMITED = 1,
+    BT709_FULL = 2,
+    BT709_LIMITED = 3,
+};
+
 enum class EncodedFormat : int32_t {
     UNKNOWN = 0,
     JPEG = 1,
@@ -121,6 +129,54 @@ enum class MemoryUsagePreference : int32_t {
     LOW_RAM = 1,  // low memory
 };
 
+// Sampling of the chroma planes against the luma plane, DEFAULT leaves it to the encoder.
+enum class ChromaSubsampling : int32_t {
+    DEFAULT = 0,
+    YUV444 = 1,
+    YUV422 = 2,   // chroma halved horizontally.
+    YUV420 = 3,   // chroma halved in both directions.
+};
+
+// Forward DCT of the jpeg encoder, DEFAULT leaves it to the encoder.
+enum class DctMethod : int32_t {
+    DEFAULT = 0,
+    ISLOW = 1,   // accurate integer.
+    IFAST = 2,   // faster integer, less accurate.
+    FLOAT = 3,
+};
+
+// Row filter of the png encoder, DEFAULT leaves it to the encoder.
+enum class PngFilter : int32_t {
+    DEFAULT = 0,
+    NONE = 1,
+    SUB = 2,        // difference to the pixel on the left.
+    UP = 3,         // difference to the pixel above.
+    ADAPTIVE = 4,   // every filter tried on each row, the smallest kept.
+};
+
+// zlib strategy of a deflate based encoder, DEFAULT leaves it to the encoder.
+enum class CompressionStrategy : int32_t {
+    DEFAULT = 0,
+    FILTERED = 1,
+    HUFFMAN_ONLY = 2,
+    RLE = 3,
+    FIXED = 4,
+};
+
+// Speed against size trade of an encoder, the options set explicitly still apply over it.
+enum class EncodePreset : int32_t {
+    DEFAULT = 0,
+    FAST = 1,   // tuned for screen content: flat areas, text and ui elements.
+};
+
+// What becomes of an animation frame before the next one is drawn over it.
+enum class DisposalType : int32_t {
+    UNSPECIFIED = 0,
+    NONE = 1,         // left in place.
+    BACKGROUND = 2,   // its area cleared to the background.
+    PREVIOUS = 3,     // its area restored to what it was before the frame.
+};
+
 enum class FinalOutputStep : int32_t {
     NO_CHANGE = 0,
     CONVERT_CHANGE = 1,
@@ -169,6 +225,16 @@ struct DecodeOptions {
     bool allowPartialImage = true;
     bool editable = false;
     MemoryUsagePreference preference = MemoryUsagePreference::DEFAULT;
+    // threads a decoder may split this one image across, 0 uses the hardware concurrency.
+    uint32_t threadCount = 1;
+    // convert the pixels from the embedded ICC profile, sRGB without one, to desiredColorSpace.
+    bool convertColorSpace = false;
+    // animated images: a composed frame is kept every keyframeInterval frames so seeking back replays from it
+    // instead of the first frame. keyframeCacheSize bounds the bytes kept, 0 for either turns the cache off.
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 8;
+    static constexpr uint64_t DEFAULT_KEYFRAME_CACHE_SIZE = 32 * 1024 * 1024;
+    uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint64_t keyframeCacheSize = DEFAULT_KEYFRAME_CACHE_SIZE;
 };
 
 enum class ScaleMode : int32_t {
@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include "abs_image_decoder.h"
 #include "gif_lib.h"
@@ -44,6 +45,7 @@ public:
     void Reset() override;
     uint32_t SetDecodeOptions(uint32_t index, const PixelDecodeOptions &opts, PlImageInfo &info) override;
     uint32_t Decode(uint32_t index, DecodeContext &context) override;
+    uint32_t DecodeAnimationFrame(uint32_t index, AnimationFrameContext &context) override;
     uint32_t PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context) override;
     uint32_t GetTopLevelImageNum(uint32_t &num) override;
     uint32_t GetImageSize(uint32_t index, PlSize &size) override;
@@ -53,6 +55,7 @@ private:
     static int32_t InputStreamReader(GifFileType *gif, GifByteType *bytes, int32_t size);
     DISALLOW_COPY_AND_MOVE(GifDecoder);
     uint32_t CheckIndex(uint32_t index);
+    uint32_t ComposeFrame(uint32_t index);
     uint32_t OverlapFrame(uint32_t startIndex, uint32_t endIndex);
     uint32_t RedirectOutputBuffer(DecodeContext &context);
     void GetTransparentAndDisposal(uint32_t index, int32_t &transparentColor, int32_t &disposalMode);
@@ -73,6 +76,8 @@ private:
     uint32_t AllocateLocalPixelMapBuffer();
     void FreeLocalPixelMapBuffer();
     uint32_t DisposeBackground(uint32_t frameIndex, const SavedImage *curSavedImage);
+    uint32_t RestoreKeyframe(uint32_t index, uint32_t startIndex);
+    void SaveKeyframe(uint32_t frameIndex);
     uint32_t GetImageDelayTime(uint32_t index, int32_t &value);
     uint32_t GetImageLoopCount(uint32_t index, int32_t &value);
 
@@ -83,6 +88,12 @@ private:
     int32_t lastPixelMapIndex_ = -1;
     bool isLoadAllFrame_ = false;
     int32_t savedFrameIndex_ = -1;
+    // composed canvas of every keyframeStride_ frame, kept while replaying so seeking back starts from the nearest.
+    std::map<uint32_t, std::unique_ptr<uint32_t[]>> keyframes_;
+    uint32_t keyframeInterval_ = PixelDecodeOptions::DEFAULT_KEYFRAME_INTERVAL;
+    uint64_t keyframeCacheSize_ = PixelDecodeOptions::DEFAULT_KEYFRAME_CACHE_SIZE;
+    // keyframeInterval_, doubled each time the kept frames outgrow keyframeCacheSize_.
+    uint32_t keyframeStride_ = PixelDecodeOptions::DEFAULT_KEYFRAME_INTERVAL;
 };
 } // namespace ImagePlugin
 } // namespace OHOS
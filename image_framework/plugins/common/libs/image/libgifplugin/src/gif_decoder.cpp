@@ -15,6 +15,7 @@
 
 #include "gif_decoder.h"
 
+#include <algorithm>
 #include <limits.h>
 
 namespace OHOS {
@@ -126,6 +127,12 @@ uint32_t GifDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
     info.alphaType = PlAlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
     // only support RGBA pixel format for performance.
     info.pixelFormat = PlPixelFormat::RGBA_8888;
+    if (opts.keyframeInterval != keyframeInterval_ || opts.keyframeCacheSize != keyframeCacheSize_) {
+        keyframeInterval_ = opts.keyframeInterval;
+        keyframeCacheSize_ = opts.keyframeCacheSize;
+        keyframeStride_ = keyframeInterval_;
+        keyframes_.clear();
+    }
     return SUCCESS;
 }
 
@@ -137,6 +144,64 @@ uint32_t GifDecoder::Decode(uint32_t index, DecodeContext &context)
         HiLog::Error(LABEL, "[Decode]index %{public}u is invalid %{public}u", index, errorCode);
         return errorCode;
     }
+    errorCode = ComposeFrame(index);
+    if (errorCode != SUCCESS) {
+        return errorCode;
+    }
+    errorCode = RedirectOutputBuffer(context);
+    if (errorCode != SUCCESS) {
+        HiLog::Error(LABEL, "[Decode]redirect output stream failed %{public}u", errorCode);
+        return errorCode;
+    }
+    return SUCCESS;
+}
+
+uint32_t GifDecoder::DecodeAnimationFrame(uint32_t index, AnimationFrameContext &context)
+{
+    uint32_t errorCode = GetTopLevelImageNum(context.frameCount);
+    if (errorCode != SUCCESS) {
+        HiLog::Error(LABEL, "[DecodeAnimationFrame]get frame number failed %{public}u", errorCode);
+        return errorCode;
+    }
+    PlSize imageSize;
+    errorCode = GetImageSize(index, imageSize);
+    if (errorCode != SUCCESS) {
+        HiLog::Error(LABEL, "[DecodeAnimationFrame]index %{public}u is invalid %{public}u", index, errorCode);
+        return errorCode;
+    }
+    bool isCanvasKept = localPixelMapBuffer_ != nullptr;
+    int32_t lastIndex = lastPixelMapIndex_;
+    errorCode = ComposeFrame(index);
+    if (errorCode != SUCCESS) {
+        return errorCode;
+    }
+    GraphicsControlBlock graphicsControlBlock = GetGraphicsControlBlock(index);
+    context.pixels = reinterpret_cast<const uint8_t *>(localPixelMapBuffer_);
+    context.delayTime = graphicsControlBlock.DelayTime * DELAY_TIME_TO_MS_RATIO;
+    context.disposal = static_cast<PlDisposalType>(graphicsControlBlock.DisposalMode);
+    context.dirtyRect = { 0, 0, imageSize.width, imageSize.height };
+    int32_t acquiredIndex = static_cast<int32_t>(index);
+    if (!isCanvasKept || acquiredIndex > lastIndex + 1 || acquiredIndex < lastIndex) {
+        return SUCCESS;
+    }
+    // only the frame area is drawn, nothing at all for a frame disposed to the previous one.
+    const GifImageDesc &frameDesc = gifPtr_->SavedImages[index].ImageDesc;
+    if (acquiredIndex == lastIndex || graphicsControlBlock.DisposalMode == DISPOSE_PREVIOUS ||
+        frameDesc.Left < 0 || frameDesc.Top < 0 || static_cast<uint32_t>(frameDesc.Left) >= imageSize.width ||
+        static_cast<uint32_t>(frameDesc.Top) >= imageSize.height) {
+        context.dirtyRect = {};
+        return SUCCESS;
+    }
+    context.dirtyRect.left = static_cast<uint32_t>(frameDesc.Left);
+    context.dirtyRect.top = static_cast<uint32_t>(frameDesc.Top);
+    context.dirtyRect.width = std::min(static_cast<uint32_t>(frameDesc.Width), imageSize.width - frameDesc.Left);
+    context.dirtyRect.height = std::min(static_cast<uint32_t>(frameDesc.Height), imageSize.height - frameDesc.Top);
+    return SUCCESS;
+}
+
+// composes frame index on the local pixel map buffer.
+uint32_t GifDecoder::ComposeFrame(uint32_t index)
+{
     // compute start index and end index.
     bool isOverlapped = false;
     uint32_t startIndex = 0;
@@ -152,22 +217,18 @@ uint32_t GifDecoder::Decode(uint32_t index, DecodeContext &context)
         startIndex = 0;
         isOverlapped = false;
     }
-    HiLog::Debug(LABEL, "[Decode]start frame: %{public}u, last frame: %{public}u,"
+    HiLog::Debug(LABEL, "[ComposeFrame]start frame: %{public}u, last frame: %{public}u,"
                  "last pixelMapIndex: %{public}d, isOverlapped: %{public}d",
                  startIndex, endIndex, lastPixelMapIndex_, isOverlapped);
 
     if (!isOverlapped) {
-        errorCode = OverlapFrame(startIndex, endIndex);
+        startIndex = RestoreKeyframe(index, startIndex);
+        uint32_t errorCode = OverlapFrame(startIndex, endIndex);
         if (errorCode != SUCCESS) {
-            HiLog::Error(LABEL, "[Decode]overlap frame failed %{public}u", errorCode);
+            HiLog::Error(LABEL, "[ComposeFrame]overlap frame failed %{public}u", errorCode);
             return errorCode;
         }
     }
-    errorCode = RedirectOutputBuffer(context);
-    if (errorCode != SUCCESS) {
-        HiLog::Error(LABEL, "[Decode]redirect output stream failed %{public}u", errorCode);
-        return errorCode;
-    }
     return SUCCESS;
 }
 
@@ -186,6 +247,8 @@ void GifDecoder::Reset()
         gifPtr_ = nullptr;
     }
     FreeLocalPixelMapBuffer();  // free local pixelmap buffer
+    keyframes_.clear();
+    keyframeStride_ = keyframeInterval_;
     inputStreamPtr_ = nullptr;
     isLoadAllFrame_ = false;
     lastPixelMapIndex_ = -1;
@@ -301,11 +364,72 @@ uint32_t GifDecoder::OverlapFrame(uint32_t startIndex, uint32_t endIndex)
             HiLog::Error(LABEL, "[OverlapFrame]dispose frame %{public}u data color failed", frameIndex);
             return ERR_IMAGE_DECODE_ABNORMAL;
         }
+        // only replays keep frames, playing frame by frame never copies the canvas.
+        if (startIndex != endIndex) {
+            SaveKeyframe(frameIndex);
+        }
     }
     lastPixelMapIndex_ = endIndex;
     return SUCCESS;
 }
 
+// returns the frame to compose from, after restoring the nearest kept frame when it is closer than startIndex.
+uint32_t GifDecoder::RestoreKeyframe(uint32_t index, uint32_t startIndex)
+{
+    auto iter = keyframes_.upper_bound(index);
+    if (iter == keyframes_.begin()) {
+        return startIndex;
+    }
+    --iter;
+    if (iter->first < startIndex) {
+        return startIndex;
+    }
+    if (localPixelMapBuffer_ == nullptr && AllocateLocalPixelMapBuffer() != SUCCESS) {
+        return startIndex;
+    }
+    uint64_t canvasBytes = static_cast<uint64_t>(gifPtr_->SWidth) * gifPtr_->SHeight * sizeof(uint32_t);
+    if (memcpy_s(localPixelMapBuffer_, canvasBytes, iter->second.get(), canvasBytes) != 0) {
+        HiLog::Error(LABEL, "[RestoreKeyframe]restore frame %{public}u failed", iter->first);
+        return 0;
+    }
+    HiLog::Debug(LABEL, "[RestoreKeyframe]frame %{public}u replays from frame %{public}u", index, iter->first);
+    lastPixelMapIndex_ = static_cast<int32_t>(iter->first);
+    return iter->first + 1;
+}
+
+void GifDecoder::SaveKeyframe(uint32_t frameIndex)
+{
+    if (keyframeStride_ == 0 || frameIndex == 0 || frameIndex % keyframeStride_ != 0 ||
+        keyframes_.find(frameIndex) != keyframes_.end()) {
+        return;
+    }
+    uint64_t canvasSize = static_cast<uint64_t>(gifPtr_->SWidth) * gifPtr_->SHeight;
+    uint64_t canvasBytes = canvasSize * sizeof(uint32_t);
+    if (canvasBytes == 0 || canvasBytes > keyframeCacheSize_) {
+        return;
+    }
+    // over budget, double the stride and drop the frames off it, so the kept ones stay evenly spread.
+    while (keyframes_.size() >= keyframeCacheSize_ / canvasBytes) {
+        keyframeStride_ *= 2;
+        for (auto iter = keyframes_.begin(); iter != keyframes_.end();) {
+            iter = (iter->first % keyframeStride_ != 0) ? keyframes_.erase(iter) : std::next(iter);
+        }
+        if (frameIndex % keyframeStride_ != 0) {
+            return;
+        }
+    }
+    std::unique_ptr<uint32_t[]> keyframe(new (std::nothrow) uint32_t[canvasSize]);
+    if (keyframe == nullptr) {
+        HiLog::Warn(LABEL, "[SaveKeyframe]allocate frame %{public}u copy failed", frameIndex);
+        return;
+    }
+    if (memcpy_s(keyframe.get(), canvasBytes, localPixelMapBuffer_, canvasBytes) != 0) {
+        HiLog::Warn(LABEL, "[SaveKeyframe]copy frame %{public}u failed", frameIndex);
+        return;
+    }
+    keyframes_.emplace(frameIndex, std::move(keyframe));
+}
+
 uint32_t GifDecoder::DisposeBackground(uint32_t frameIndex, const SavedImage *curSavedImage)
 {
     int32_t preTransColor = NO_TRANSPARENT_COLOR;
@@ -332,12 +456,13 @@ bool GifDecoder::IsFramePreviousCoveredCurrent(const SavedImage *preSavedImage,
              curSavedImage->ImageDesc.Top + curSavedImage->ImageDesc.Height));
 }
 
+// the first frame is drawn on a clean background, also when seeking back reuses the buffer.
 uint32_t GifDecoder::AllocateLocalPixelMapBuffer()
 {
+    int32_t bgWidth = gifPtr_->SWidth;
+    int32_t bgHeight = gifPtr_->SHeight;
+    uint64_t pixelMapBufferSize = static_cast<uint64_t>(bgWidth * bgHeight * sizeof(uint32_t));
     if (localPixelMapBuffer_ == nullptr) {
-        int32_t bgWidth = gifPtr_->SWidth;
-        int32_t bgHeight = gifPtr_->SHeight;
-        uint64_t pixelMapBufferSize = static_cast<uint64_t>(bgWidth * bgHeight * sizeof(uint32_t));
         // create local pixelmap buffer, next frame depends on the previous
         if (pixelMapBufferSize > PIXEL_MAP_MAX_RAM_SIZE) {
             HiLog::Error(LABEL, "[AllocateLocalPixelMapBuffer]pixelmap buffer size %{public}llu out of max size",
@@ -349,21 +474,21 @@ uint32_t GifDecoder::AllocateLocalPixelMapBuffer()
             HiLog::Error(LABEL, "[AllocateLocalPixelMapBuffer]allocate local pixelmap buffer memory error");
             return ERR_IMAGE_MALLOC_ABNORMAL;
         }
+    }
 #ifdef _WIN32
-        errno_t backRet = memset_s(localPixelMapBuffer_, bgColor_, pixelMapBufferSize);
-        if (backRet != EOK) {
-            HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed", backRet);
-            FreeLocalPixelMapBuffer();
-            return ERR_IMAGE_MALLOC_ABNORMAL;
-        }
+    errno_t backRet = memset_s(localPixelMapBuffer_, bgColor_, pixelMapBufferSize);
+    if (backRet != EOK) {
+        HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed", backRet);
+        FreeLocalPixelMapBuffer();
+        return ERR_IMAGE_MALLOC_ABNORMAL;
+    }
 #else
-        if (memset_s(localPixelMapBuffer_, pixelMapBufferSize, bgColor_, pixelMapBufferSize) != EOK) {
-            HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed");
-            FreeLocalPixelMapBuffer();
-            return ERR_IMAGE_MALLOC_ABNORMAL;
-        }
-#endif
+    if (memset_s(localPixelMapBuffer_, pixelMapBufferSize, bgColor_, pixelMapBufferSize) != EOK) {
+        HiLog::Error(LABEL, "[DisposeFirstPixelMap]memset local pixelmap buffer background failed");
+        FreeLocalPixelMapBuffer();
+        return ERR_IMAGE_MALLOC_ABNORMAL;
     }
+#endif
     return SUCCESS;
 }
 
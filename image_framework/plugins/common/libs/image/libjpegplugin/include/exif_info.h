@@ -15,8 +15,11 @@
 #ifndef EXIF_INFO_H
 #define EXIF_INFO_H
 #include <libexif/exif-data.h>
+#include <functional>
 #include <map>
 #include <string>
+#include <sys/types.h>
+#include <utility>
 #include <vector>
 #include "hilog/log.h"
 #include "log_tags.h"
@@ -50,6 +53,15 @@ public:
     uint32_t ModifyExifData(const ExifTag &tag, const std::string &value, const std::string &path);
     uint32_t ModifyExifData(const ExifTag &tag, const std::string &value, const int fd);
     uint32_t ModifyExifData(const ExifTag &tag, const std::string &value, unsigned char *data, uint32_t size);
+    /*
+     * Sets all the tags in one pass over the file. The new EXIF data is written over the old APP1 segment when it
+     * fits, zero padded and only the changed bytes, else the rest of the file is moved back to make room for it.
+     * A buffer can't grow, it only takes EXIF data that fits.
+     */
+    uint32_t ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags, const std::string &path);
+    uint32_t ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags, const int fd);
+    uint32_t ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags, unsigned char *data,
+        uint32_t size);
     uint32_t GetFilterArea(const uint8_t *buf,
                               const uint32_t &bufSize,
                               const int &privacyType,
@@ -77,16 +89,20 @@ private:
     void SetExifTagValues(const ExifTag &tag, const std::string &value);
     ExifEntry* InitExifTag(ExifData *exif, ExifIfd ifd, ExifTag tag);
     ExifEntry* CreateExifTag(ExifData *exif, ExifIfd ifd, ExifTag tag, size_t len, ExifFormat format);
-    unsigned long GetFileSize(FILE *fp);
-    void ReleaseSource(unsigned char **ptrBuf, FILE **ptrFile);
-    bool CreateExifData(unsigned char *buf, unsigned long length, ExifData **data, bool &isNewExifData);
-    unsigned int GetOrginExifDataLength(const bool &isNewExifData, unsigned char *buf);
-    ExifByteOrder GetExifByteOrder(const bool &isNewExifData, unsigned char *buf);
+    // reads length bytes at offset of the JPEG file.
+    using SegmentReader = std::function<bool(uint32_t offset, uint8_t *buf, uint32_t length)>;
+    // offset of the APP1 EXIF segment and its payload, the payload is empty when the file has none.
+    bool ReadExifSegment(const SegmentReader &reader, uint32_t fileLength, uint32_t &offset,
+        std::vector<uint8_t> &payload);
+    uint32_t CreateExifPayload(const std::vector<uint8_t> &payload,
+        const std::vector<std::pair<ExifTag, std::string>> &tags, std::vector<uint8_t> &newPayload);
     bool CreateExifEntry(const ExifTag &tag, ExifData *data, const std::string &value,
         ExifByteOrder order, ExifEntry **ptrEntry);
-    bool WriteExifDataToFile(ExifData *data, unsigned int orginExifDataLength, unsigned long fileLength,
-        unsigned char *buf, FILE *fp);
-    void UpdateCacheExifData(FILE *fp);
+    bool WriteExifSegment(int fd, uint32_t fileLength, uint32_t offset, const std::vector<uint8_t> &payload,
+        const std::vector<uint8_t> &newPayload);
+    bool MoveFileTail(int fd, uint32_t start, uint32_t fileLength, uint32_t distance);
+    bool PwriteAll(int fd, const uint8_t *buf, size_t length, off_t offset);
+    void UpdateCacheExifData(const std::vector<uint8_t> &payload);
     bool CheckExifEntryValid(const ExifIfd &ifd, const ExifTag &tag);
     void GetAreaFromExifEntries(const int &privacyType,
                                 const std::vector<DirectoryEntry> &entryArray,
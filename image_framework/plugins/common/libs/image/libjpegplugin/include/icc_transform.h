@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ICC_TRANSFORM_H
+#define ICC_TRANSFORM_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "image_plugin_type.h"
+#include "include/core/SkColorSpace.h"
+#include "include/third_party/skcms/skcms.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+/*
+ * Converts 8 bit RGB pixels from an ICC profile to one of the standard colour spaces. The transform is built
+ * once with skcms into lookup tables: a matrix and per channel curves for matrix/TRC profiles, a 3D LUT for
+ * the others. Built transforms are kept in a process wide cache, keyed by a hash of the profile and the target.
+ */
+class IccTransform {
+public:
+    // byte size of a pixel and the byte offsets of its colour channels.
+    struct PixelLayout {
+        uint32_t pixelBytes = 0;
+        uint32_t red = 0;
+        uint32_t green = 0;
+        uint32_t blue = 0;
+    };
+
+    /*
+     * profile is the embedded ICC data, nullptr when the image has none and is taken as sRGB.
+     * nullptr is returned when no conversion is needed, or the profile or target is not supported.
+     */
+    static std::shared_ptr<const IccTransform> Get(const uint8_t *profile, uint32_t size, PlColorSpace target);
+
+    IccTransform() = default;
+    ~IccTransform() = default;
+    bool Build(const skcms_ICCProfile &src, const skcms_ICCProfile &dst);
+    void TransformRow(uint8_t *row, uint32_t width, const PixelLayout &layout) const;
+    // colour space of the converted pixels.
+    sk_sp<SkColorSpace> GetTargetColorSpace() const;
+
+private:
+    bool BuildMatrix(const skcms_ICCProfile &src, const skcms_ICCProfile &dst);
+    bool BuildLut(const skcms_ICCProfile &src, const skcms_ICCProfile &dst);
+    void TransformMatrix(uint8_t *pixels, uint32_t count, const PixelLayout &layout) const;
+    void TransformLut(uint8_t *pixels, uint32_t count, const PixelLayout &layout) const;
+
+    sk_sp<SkColorSpace> targetColorSpace_;
+    // matrix path: 8 bit code to linear light per channel, linear to the target gamut, linear to 8 bit code.
+    std::vector<int32_t> linear_;
+    std::vector<int32_t> matrix_;
+    std::vector<uint8_t> encode_;
+    // LUT path: target colour of every grid point, in 1/256 of an 8 bit code, and the grid cell of each code.
+    std::vector<uint16_t> lut_;
+    std::vector<uint8_t> lutIndex_;
+    std::vector<uint16_t> lutFrac_;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // ICC_TRANSFORM_H
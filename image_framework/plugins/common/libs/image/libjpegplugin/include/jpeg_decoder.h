@@ -17,7 +17,10 @@
 #define JPEG_DECODER_H
 
 #include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include "abs_image_decoder.h"
 #include "abs_image_decompress_component.h"
 #ifdef IMAGE_COLORSPACE_FLAG
@@ -25,6 +28,7 @@
 #endif
 #include "hilog/log.h"
 #include "icc_profile_info.h"
+#include "icc_transform.h"
 #include "jpeg_utils.h"
 #include "jpeglib.h"
 #include "log_tags.h"
@@ -63,6 +67,12 @@ public:
         const int fd) override;
     uint32_t ModifyImageProperty(uint32_t index, const std::string &key, const std::string &value,
         uint8_t *data, uint32_t size) override;
+    uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const std::string &path) override;
+    uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const int fd) override;
+    uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        uint8_t *data, uint32_t size) override;
     uint32_t GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges) override;
 
 #ifdef IMAGE_COLORSPACE_FLAG
@@ -76,14 +86,34 @@ private:
     J_COLOR_SPACE GetDecodeFormat(PlPixelFormat format, PlPixelFormat &outputFormat);
     void CreateHwDecompressor();
     uint32_t DoSwDecode(DecodeContext &context);
+    bool DoParallelDecode(uint8_t *base, uint32_t rowStride);
+    uint32_t DoScanlineDecode(uint8_t *base, uint32_t rowStride);
+    void SetIccTransform(const PixelDecodeOptions &opts);
+    void TransformRows(uint8_t *base, uint32_t rowStride, uint32_t firstRow, uint32_t rowNum);
+    uint64_t GetYuvByteCount();
+    void WriteUvRow(uint8_t *base, uint32_t uvRow, const uint8_t *cbRow, const uint8_t *crRow);
+    uint32_t DoRawYuvDecode(uint8_t *base);
+    uint32_t DoScanlineYuvDecode(uint8_t *base);
     void FinishOldDecompress();
     uint32_t DecodeHeader();
     uint32_t StartDecompress(const PixelDecodeOptions &opts);
+    bool IsYuvDecodable(const PixelDecodeOptions &opts);
+    void SetYuvDecode(PlPixelFormat format);
+    bool GetScaleTarget(const PixelDecodeOptions &opts, uint32_t &width, uint32_t &height);
+    void SetDecodeScale(const PixelDecodeOptions &opts);
+    bool IsRegionDecodable(const PlRect &rect);
+    void SetDecodeRegion(const PixelDecodeOptions &opts);
+    uint32_t GetPixelBytes();
     uint32_t GetRowBytes();
     void CreateDecoder();
     bool IsMarker(uint8_t rawPrefix, uint8_t rawMarkderCode, uint8_t markerCode);
     bool FindMarker(InputDataStream &stream, uint8_t marker);
+    // offset and size of the payload of the first marker segment starting with signature, searched up to SOS.
+    bool FindMarkerSegment(InputDataStream &stream, uint8_t marker, const uint8_t *signature, uint32_t signatureSize,
+        uint32_t &offset, uint32_t &size);
     ExifTag getExifTagFromKey(const std::string &key);
+    bool GetExifTags(const std::map<std::string, std::string> &properties,
+        std::vector<std::pair<ExifTag, std::string>> &tags);
     void FormatTimeStamp(std::string &value, std::string &src);
 
     static MultimediaPlugin::PluginServer &pluginServer_;
@@ -95,6 +125,19 @@ private:
     uint32_t streamPosition_ = 0;  // may be changed by other decoders, record it and restore if needed.
     PlPixelFormat outputFormat_ = PlPixelFormat::UNKNOWN;
     PixelDecodeOptions opts_;
+    // rows and columns of the output image the pixels buffer holds, the full image unless a region is decoded.
+    PlRect decodeRegion_;
+    bool regionDecode_ = false;
+    // column of decodeRegion_ in the iMCU aligned scanlines, which are read into regionRows_ and trimmed.
+    uint32_t regionOffset_ = 0;
+    std::vector<uint8_t> regionRows_;
+    // NV21 or NV12 output, the luma plane and then the chroma plane with rows of the even rounded width.
+    bool yuvDecode_ = false;
+    // scratch rows of a YUV decode, the raw iMCU row planes or the scanlines of a chroma row pair.
+    std::vector<uint8_t> yuvRows_;
+    // converts the decoded rows to opts_.desiredColorSpace, nullptr when they are left as decoded.
+    std::shared_ptr<const IccTransform> iccTransform_;
+    IccTransform::PixelLayout iccLayout_;
     EXIFInfo exifInfo_;
     ICCProfileInfo iccProfileInfo_;
 };
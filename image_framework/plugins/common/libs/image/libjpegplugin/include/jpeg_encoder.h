@@ -42,7 +42,10 @@ private:
     void Deinterweave(uint8_t *uvPlane, uint8_t *uPlane, uint8_t *vPlane, uint32_t curRow, uint32_t width,
                       uint32_t height);
     uint32_t SetCommonConfig();
+    void SetTuningConfig();
     void SetYuv420spExtraConfig();
+    uint32_t WriteIccProfile(jpeg_compress_struct &cinfo);
+    bool DoParallelEncode(const uint8_t *data, uint32_t &errorCode);
     uint32_t SequenceEncoder(const uint8_t *data);
     uint32_t Yuv420spEncoder(const uint8_t *data);
     uint32_t RGBAF16Encoder(const uint8_t *data);
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JPEG_PARALLEL_DECODER_H
+#define JPEG_PARALLEL_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "jpeg_utils.h"
+#include "jpeglib.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+/*
+ * Decodes a single scan huffman JPEG with restart intervals in horizontal bands, every band on its own thread.
+ * A band is decoded from a stream made of the file header and the restart intervals covering it, and writes
+ * its rows straight into the shared pixel buffer. Bands are decoded with one band row of the neighbouring
+ * bands around them, so the upsampling at the band edges matches a sequential decode.
+ */
+class JpegParallelDecoder {
+public:
+    // called on every output row once it is decoded, on the thread of its band.
+    using RowTransform = std::function<void(uint8_t *row)>;
+
+    // data is the whole JPEG file, info the decompressor the image was started on, at full scale.
+    JpegParallelDecoder(const uint8_t *data, size_t size, const jpeg_decompress_struct &info);
+    ~JpegParallelDecoder() = default;
+    // false when the image can't be split into at least two bands.
+    bool Split(uint32_t threadCount);
+    // rowStride is the byte count of one output row, the rows are written from pixels on.
+    uint32_t Decode(uint8_t *pixels, uint32_t rowStride);
+    void SetRowTransform(const RowTransform &transform);
+
+private:
+    struct Band {
+        // MCU rows written by this band.
+        uint32_t firstRow = 0;
+        uint32_t endRow = 0;
+        // MCU rows decoded, the written rows and the neighbouring rows the upsampling needs.
+        uint32_t decodeFirstRow = 0;
+        uint32_t decodeEndRow = 0;
+        std::vector<uint8_t> stream;
+        // rows decoded only as context, they are dropped.
+        std::vector<uint8_t> scratchRows;
+        ErrorMgr jerr;
+    };
+
+    bool ParseMarkers();
+    bool ScanRestartMarkers();
+    uint32_t GetSegment(uint32_t mcuRow);
+    uint32_t GetSegmentStart(uint32_t segment);
+    uint32_t GetSegmentEnd(uint32_t segment);
+    void BuildBandStream(Band &band);
+    uint32_t DecodeBand(Band &band, uint8_t *pixels, uint32_t rowStride);
+    uint32_t DecodeBandStream(Band &band, jpeg_decompress_struct &dinfo, uint8_t *pixels, uint32_t rowStride);
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    J_COLOR_SPACE colorSpace_ = JCS_UNKNOWN;
+    uint32_t imageHeight_ = 0;
+    uint32_t outputWidth_ = 0;
+    uint32_t mcusPerRow_ = 0;
+    uint32_t mcuRows_ = 0;
+    uint32_t mcuHeight_ = 0;
+    uint32_t restartInterval_ = 0;
+    bool splittable_ = false;
+    // bytes from the SOI marker to the end of the SOS segment.
+    uint32_t headerSize_ = 0;
+    uint32_t sofHeightPos_ = 0;
+    uint32_t entropyEnd_ = 0;
+    uint32_t segmentNum_ = 0;
+    // offsets of the RSTn markers, one between every two restart intervals.
+    std::vector<uint32_t> restartPos_;
+    std::vector<Band> bands_;
+    RowTransform rowTransform_;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // JPEG_PARALLEL_DECODER_H
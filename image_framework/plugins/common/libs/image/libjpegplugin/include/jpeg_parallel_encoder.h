@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JPEG_PARALLEL_ENCODER_H
+#define JPEG_PARALLEL_ENCODER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "jpeg_utils.h"
+#include "jpeglib.h"
+#include "output_data_stream.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+/*
+ * Encodes a baseline JPEG in horizontal strips, every strip on its own thread. The image gets a restart
+ * marker after every MCU row and the strips start on a multiple of eight MCU rows, so the entropy coded
+ * data of the strips follow each other with the restart markers numbered as in a sequential encode.
+ * The file is the header of the first strip with the full image height, and the strip data behind it.
+ */
+class JpegParallelEncoder {
+public:
+    // writes the markers behind the JFIF header, on the compressor of the first strip.
+    using MarkerWriter = std::function<uint32_t(jpeg_compress_struct &)>;
+
+    // config is the compressor set up for the whole image, every strip is encoded with its parameters.
+    explicit JpegParallelEncoder(const jpeg_compress_struct &config);
+    ~JpegParallelEncoder();
+    // false when the image can't be split into at least two strips.
+    bool Split(uint32_t threadCount);
+    // rowStride is the byte count of one input row, the rows are read from pixels on.
+    uint32_t Encode(const uint8_t *pixels, uint32_t rowStride, const MarkerWriter &writeMarkers);
+    uint32_t Write(OutputDataStream &stream);
+
+private:
+    struct Strip {
+        // pixel rows of the image encoded by this strip.
+        uint32_t firstRow = 0;
+        uint32_t endRow = 0;
+        unsigned char *output = nullptr;
+        unsigned long outputSize = 0;
+        // bytes from the SOI marker to the end of the SOS segment.
+        uint32_t headerSize = 0;
+        uint32_t sofHeightPos = 0;
+        ErrorMgr jerr;
+    };
+
+    void ApplyConfig(jpeg_compress_struct &cinfo, uint32_t height);
+    bool ParseStripHeader(Strip &strip);
+    uint32_t EncodeStrip(Strip &strip, const uint8_t *pixels, uint32_t rowStride, const MarkerWriter *writeMarkers);
+    uint32_t EncodeStripRows(Strip &strip, jpeg_compress_struct &cinfo, const uint8_t *pixels, uint32_t rowStride,
+        const MarkerWriter *writeMarkers);
+
+    const jpeg_compress_struct &config_;
+    uint32_t imageHeight_ = 0;
+    uint32_t mcuHeight_ = 0;
+    uint32_t mcuRows_ = 0;
+    bool splittable_ = false;
+    std::vector<Strip> strips_;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+
+#endif // JPEG_PARALLEL_ENCODER_H
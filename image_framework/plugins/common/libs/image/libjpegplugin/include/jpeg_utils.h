@@ -30,7 +30,8 @@
 namespace OHOS {
 namespace ImagePlugin {
 static constexpr uint8_t SET_JUMP_VALUE = 1;
-static constexpr uint8_t RW_LINE_NUM = 1;
+// rows handed to one jpeg_read_scanlines or jpeg_write_scanlines call, at most one iMCU row.
+static constexpr uint32_t RW_MAX_LINE_NUM = 32;
 static constexpr uint16_t JPEG_BUFFER_SIZE = 1024;
 static constexpr uint32_t JPEG_IMAGE_NUM = 1;
 static constexpr uint32_t PRINTF_SUCCESS = 0;
@@ -77,6 +78,9 @@ void InitDstStream(j_compress_ptr cinfo);
 boolean EmptyOutputBuffer(j_compress_ptr cinfo);
 void TermDstStream(j_compress_ptr cinfo);
 std::string DoubleToString(double num);
+// rows of one iMCU row, which libjpeg upsamples and colour converts in one go.
+uint32_t GetDecodeLineNum(const jpeg_decompress_struct &dinfo);
+uint32_t GetEncodeLineNum(const jpeg_compress_struct &cinfo);
 } // namespace ImagePlugin
 } // namespace OHOS
 
@@ -16,7 +16,9 @@
 #include "exif_info.h"
 #include <algorithm>
 #include <cstdio>
+#include <fcntl.h>
 #include <memory>
+#include <sys/stat.h>
 #include <unistd.h>
 #include "media_errors.h"
 #include "string_ex.h"
@@ -30,15 +32,8 @@ namespace {
     static constexpr int PARSE_EXIF_SUCCESS = 0;
     static constexpr int PARSE_EXIF_DATA_ERROR = 10001;
     static constexpr int PARSE_EXIF_IFD_ERROR = 10002;
-    static constexpr int BUFFER_POSITION_4 = 4;
-    static constexpr int BUFFER_POSITION_5 = 5;
-    static constexpr int BUFFER_POSITION_6 = 6;
-    static constexpr int BUFFER_POSITION_7 = 7;
-    static constexpr int BUFFER_POSITION_8 = 8;
-    static constexpr int BUFFER_POSITION_9 = 9;
     static constexpr int BUFFER_POSITION_12 = 12;
     static constexpr int BUFFER_POSITION_13 = 13;
-    static constexpr int LENGTH_OFFSET_2 = 2;
     static constexpr int BYTE_COUNTS_12 = 12;
     static constexpr int MOVE_OFFSET_8 = 8;
     static constexpr int MOVE_OFFSET_16 = 16;
@@ -50,9 +45,21 @@ namespace {
     static constexpr uint32_t ERROR_PARSE_EXIF_FAILED = 1;
     static constexpr uint32_t ERROR_NO_EXIF_TAGS = 2;
 
-    /* raw EXIF header data */
-    static const unsigned char exifHeader[] = {
-        0xff, 0xd8, 0xff, 0xe1
+    static constexpr uint8_t MARKER_PREFIX = 0xFF;
+    static constexpr uint8_t MARKER_SOI = 0xD8;
+    static constexpr uint8_t MARKER_SOS = 0xDA;
+    static constexpr uint8_t MARKER_EOI = 0xD9;
+    static constexpr uint8_t MARKER_APP1 = 0xE1;
+    static constexpr uint32_t MARKER_SIZE = 2;
+    /* marker and big-endian length of a segment, the length counts itself and the payload */
+    static constexpr uint32_t SEGMENT_HEADER_SIZE = 4;
+    static constexpr uint32_t SEGMENT_LENGTH_HIGH = 2;
+    static constexpr uint32_t SEGMENT_LENGTH_LOW = 3;
+    static constexpr uint32_t MAX_SEGMENT_LENGTH = 0xFFFF;
+    static constexpr uint32_t MOVE_CHUNK_SIZE = 64 * 1024;
+    /* the APP1 payload holding the EXIF data starts with this */
+    static const unsigned char exifSignature[] = {
+        'E', 'x', 'i', 'f', 0x00, 0x00
     };
     /* Offset of tiff begin from jpeg file begin */
     static constexpr uint32_t TIFF_OFFSET_FROM_FILE_BEGIN = 12;
@@ -263,6 +270,9 @@ EXIFInfo::~EXIFInfo()
 int EXIFInfo::ParseExifData(const unsigned char *buf, unsigned len)
 {
     HiLog::Debug(LABEL, "ParseExifData ENTER");
+    if (exifData_ != nullptr) {
+        exif_data_unref(exifData_);
+    }
     exifData_ = exif_data_new_from_data(buf, len);
     if (!exifData_) {
         return PARSE_EXIF_DATA_ERROR;
@@ -343,284 +353,261 @@ void EXIFInfo::SetExifTagValues(const ExifTag &tag, const std::string &value)
 
 uint32_t EXIFInfo::ModifyExifData(const ExifTag &tag, const std::string &value, const std::string &path)
 {
-    FILE *file = fopen(path.c_str(), "rb");
-    if (file == nullptr) {
-        HiLog::Error(LABEL, "Error creating file %{public}s", path.c_str());
-        return Media::ERR_MEDIA_IO_ABNORMAL;
-    }
-
-    // read jpeg file to buff
-    unsigned long fileLength = GetFileSize(file);
-    if (fileLength == 0 || fileLength > MAX_FILE_SIZE) {
-        HiLog::Error(LABEL, "Get file size failed.");
-        (void)fclose(file);
-        return Media::ERR_MEDIA_BUFFER_TOO_SMALL;
-    }
-
-    unsigned char *fileBuf = static_cast<unsigned char *>(malloc(fileLength));
-    if (fileBuf == nullptr) {
-        HiLog::Error(LABEL, "Allocate buf for %{public}s failed.", path.c_str());
-        (void)fclose(file);
-        return Media::ERR_IMAGE_MALLOC_ABNORMAL;
-    }
-
-    if (fread(fileBuf, fileLength, 1, file) != 1) {
-        HiLog::Error(LABEL, "Read %{public}s failed.", path.c_str());
-        ReleaseSource(&fileBuf, &file);
-        return Media::ERR_MEDIA_READ_PARCEL_FAIL;
-    }
+    return ModifyExifData({ { tag, value } }, path);
+}
 
-    if (!(fileBuf[0] == 0xFF && fileBuf[1] == 0xD8)) {
-        HiLog::Error(LABEL, "%{public}s is not jpeg file.", path.c_str());
-        ReleaseSource(&fileBuf, &file);
-        return Media::ERR_IMAGE_MISMATCHED_FORMAT;
-    }
+uint32_t EXIFInfo::ModifyExifData(const ExifTag &tag, const std::string &value, const int fd)
+{
+    return ModifyExifData({ { tag, value } }, fd);
+}
 
-    ExifData *ptrExifData = nullptr;
-    bool isNewExifData = false;
-    if (!CreateExifData(fileBuf, fileLength, &ptrExifData, isNewExifData)) {
-        ReleaseSource(&fileBuf, &file);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
-    }
-    (void)fclose(file);
-    file = nullptr;
-
-    unsigned int orginExifDataLength = GetOrginExifDataLength(isNewExifData, fileBuf);
-    if (!isNewExifData && orginExifDataLength == 0) {
-        HiLog::Error(LABEL, "There is no orginExifDataLength node in %{public}s.", path.c_str());
-        exif_data_unref(ptrExifData);
-        free(fileBuf);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
-    }
+uint32_t EXIFInfo::ModifyExifData(const ExifTag &tag, const std::string &value,
+    unsigned char *data, uint32_t size)
+{
+    return ModifyExifData({ { tag, value } }, data, size);
+}
 
-    ExifByteOrder order = GetExifByteOrder(isNewExifData, fileBuf);
-    FILE *newFile = fopen(path.c_str(), "wb+");
-    if (newFile == nullptr) {
-        HiLog::Error(LABEL, "Error create new file %{public}s", path.c_str());
-        ReleaseSource(&fileBuf, &newFile);
+uint32_t EXIFInfo::ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags, const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        HiLog::Error(LABEL, "Error opening file %{public}s", path.c_str());
         return Media::ERR_MEDIA_IO_ABNORMAL;
     }
-    ExifEntry *entry = nullptr;
-    if (!CreateExifEntry(tag, ptrExifData, value, order, &entry)) {
-        ReleaseSource(&fileBuf, &newFile);
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
-    }
-    if (!WriteExifDataToFile(ptrExifData, orginExifDataLength, fileLength, fileBuf, newFile)) {
-        ReleaseSource(&fileBuf, &newFile);
-        exif_data_unref(ptrExifData);
-        return Media::ERR_MEDIA_WRITE_PARCEL_FAIL;
-    }
-    ReleaseSource(&fileBuf, &newFile);
-    exif_data_unref(ptrExifData);
-    return Media::SUCCESS;
+    uint32_t ret = ModifyExifData(tags, fd);
+    close(fd);
+    return ret;
 }
 
-uint32_t EXIFInfo::ModifyExifData(const ExifTag &tag, const std::string &value, const int fd)
+uint32_t EXIFInfo::ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags, const int fd)
 {
-    const int localFd = dup(fd);
-    FILE *file = fdopen(localFd, "wb+");
-    if (file == nullptr) {
-        HiLog::Error(LABEL, "Error creating file %{public}d", localFd);
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        HiLog::Error(LABEL, "Error reading file %{public}d", fd);
         return Media::ERR_MEDIA_IO_ABNORMAL;
     }
-
-    // read jpeg file to buff
-    unsigned long fileLength = GetFileSize(file);
-    if (fileLength == 0 || fileLength > MAX_FILE_SIZE) {
+    if (fileStat.st_size <= 0 || static_cast<unsigned long>(fileStat.st_size) > MAX_FILE_SIZE) {
         HiLog::Error(LABEL, "Get file size failed.");
-        (void)fclose(file);
         return Media::ERR_MEDIA_BUFFER_TOO_SMALL;
     }
-
-    unsigned char *fileBuf = static_cast<unsigned char *>(malloc(fileLength));
-    if (fileBuf == nullptr) {
-        HiLog::Error(LABEL, "Allocate buf for %{public}d failed.", localFd);
-        (void)fclose(file);
-        return Media::ERR_IMAGE_MALLOC_ABNORMAL;
-    }
-
-    // Set current position to begin of file.
-    (void)fseek(file, 0L, 0);
-    if (fread(fileBuf, fileLength, 1, file) != 1) {
-        HiLog::Error(LABEL, "Read %{public}d failed.", localFd);
-        ReleaseSource(&fileBuf, &file);
-        return Media::ERR_MEDIA_READ_PARCEL_FAIL;
-    }
-
-    if (!(fileBuf[0] == 0xFF && fileBuf[1] == 0xD8)) {
-        HiLog::Error(LABEL, "%{public}d is not jpeg file.", localFd);
-        ReleaseSource(&fileBuf, &file);
+    uint32_t fileLength = static_cast<uint32_t>(fileStat.st_size);
+    // only the marker headers and the APP1 segment are read, pread leaves the file offset of fd as it is.
+    SegmentReader reader = [fd](uint32_t offset, uint8_t *buf, uint32_t length) {
+        return pread(fd, buf, length, offset) == static_cast<ssize_t>(length);
+    };
+    uint8_t soi[MARKER_SIZE] = { 0 };
+    if (!reader(0, soi, MARKER_SIZE) || soi[0] != MARKER_PREFIX || soi[1] != MARKER_SOI) {
+        HiLog::Error(LABEL, "%{public}d is not jpeg file.", fd);
         return Media::ERR_IMAGE_MISMATCHED_FORMAT;
     }
-
-    ExifData *ptrExifData = nullptr;
-    bool isNewExifData = false;
-    if (!CreateExifData(fileBuf, fileLength, &ptrExifData, isNewExifData)) {
-        ReleaseSource(&fileBuf, &file);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
-    }
-
-    unsigned int orginExifDataLength = GetOrginExifDataLength(isNewExifData, fileBuf);
-    if (!isNewExifData && orginExifDataLength == 0) {
-        HiLog::Error(LABEL, "There is no orginExifDataLength node in %{public}d.", localFd);
-        free(fileBuf);
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    uint32_t offset = 0;
+    std::vector<uint8_t> payload;
+    if (!ReadExifSegment(reader, fileLength, offset, payload)) {
+        return Media::ERR_MEDIA_READ_PARCEL_FAIL;
     }
-
-    ExifByteOrder order = GetExifByteOrder(isNewExifData, fileBuf);
-    // Set current position to begin of new file.
-    (void)fseek(file, 0L, 0);
-    ExifEntry *entry = nullptr;
-    if (!CreateExifEntry(tag, ptrExifData, value, order, &entry)) {
-        ReleaseSource(&fileBuf, &file);
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    std::vector<uint8_t> newPayload;
+    uint32_t ret = CreateExifPayload(payload, tags, newPayload);
+    if (ret != Media::SUCCESS) {
+        return ret;
     }
-
-    if (!WriteExifDataToFile(ptrExifData, orginExifDataLength, fileLength, fileBuf, file)) {
-        ReleaseSource(&fileBuf, &file);
-        exif_data_unref(ptrExifData);
+    if (!WriteExifSegment(fd, fileLength, offset, payload, newPayload)) {
+        HiLog::Error(LABEL, "Error writing EXIF segment to file!");
         return Media::ERR_MEDIA_WRITE_PARCEL_FAIL;
     }
-    ReleaseSource(&fileBuf, &file);
-    exif_data_unref(ptrExifData);
+    UpdateCacheExifData(newPayload);
     return Media::SUCCESS;
 }
 
-uint32_t EXIFInfo::ModifyExifData(const ExifTag &tag, const std::string &value,
+uint32_t EXIFInfo::ModifyExifData(const std::vector<std::pair<ExifTag, std::string>> &tags,
     unsigned char *data, uint32_t size)
 {
     if (data == nullptr) {
         HiLog::Error(LABEL, "buffer is nullptr.");
         return Media::ERR_IMAGE_SOURCE_DATA;
     }
-
     if (size == 0) {
         HiLog::Error(LABEL, "buffer size is 0.");
         return Media::ERR_MEDIA_BUFFER_TOO_SMALL;
     }
-
-    if (!(data[0] == 0xFF && data[1] == 0xD8)) {
+    if (size < MARKER_SIZE || data[0] != MARKER_PREFIX || data[1] != MARKER_SOI) {
         HiLog::Error(LABEL, "This is not jpeg file.");
         return Media::ERR_IMAGE_MISMATCHED_FORMAT;
     }
-
-    ExifData *ptrExifData = nullptr;
-    bool isNewExifData = false;
-    if (!CreateExifData(data, size, &ptrExifData, isNewExifData)) {
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    SegmentReader reader = [data, size](uint32_t offset, uint8_t *buf, uint32_t length) {
+        return offset <= size && length <= size - offset && memcpy_s(buf, length, data + offset, length) == EOK;
+    };
+    uint32_t offset = 0;
+    std::vector<uint8_t> payload;
+    if (!ReadExifSegment(reader, size, offset, payload)) {
+        return Media::ERR_MEDIA_READ_PARCEL_FAIL;
+    }
+    std::vector<uint8_t> newPayload;
+    uint32_t ret = CreateExifPayload(payload, tags, newPayload);
+    if (ret != Media::SUCCESS) {
+        return ret;
+    }
+    // the buffer can't grow, the new EXIF data has to fit into the old segment.
+    if (payload.empty() || newPayload.size() > payload.size()) {
+        HiLog::Error(LABEL, "There is not enough space for writing EXIF data block!");
+        return Media::ERR_MEDIA_OUT_OF_RANGE;
     }
+    uint8_t *dst = data + offset + SEGMENT_HEADER_SIZE;
+    if (memcpy_s(dst, payload.size(), newPayload.data(), newPayload.size()) != EOK ||
+        memset_s(dst + newPayload.size(), payload.size() - newPayload.size(), 0,
+        payload.size() - newPayload.size()) != EOK) {
+        HiLog::Error(LABEL, "Error writing EXIF data block to buffer!");
+        return Media::ERR_MEDIA_WRITE_PARCEL_FAIL;
+    }
+    UpdateCacheExifData(newPayload);
+    return Media::SUCCESS;
+}
 
-    unsigned int orginExifDataLength = GetOrginExifDataLength(isNewExifData, data);
-    if (!isNewExifData && orginExifDataLength == 0) {
-        HiLog::Error(LABEL, "There is no orginExifDataLength node in buffer.");
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+bool EXIFInfo::ReadExifSegment(const SegmentReader &reader, uint32_t fileLength, uint32_t &offset,
+    std::vector<uint8_t> &payload)
+{
+    // without an EXIF segment the new one goes right behind SOI.
+    offset = MARKER_SIZE;
+    payload.clear();
+    uint8_t header[SEGMENT_HEADER_SIZE] = { 0 };
+    uint8_t signature[sizeof(exifSignature)] = { 0 };
+    uint32_t pos = MARKER_SIZE;
+    // the metadata segments come before the first scan, the walk stops there.
+    while (pos + SEGMENT_HEADER_SIZE <= fileLength && reader(pos, header, SEGMENT_HEADER_SIZE) &&
+        header[0] == MARKER_PREFIX) {
+        if (header[1] == MARKER_PREFIX) {
+            // fill byte before the marker
+            pos++;
+            continue;
+        }
+        uint32_t length = (static_cast<uint32_t>(header[SEGMENT_LENGTH_HIGH]) << MOVE_OFFSET_8) |
+            header[SEGMENT_LENGTH_LOW];
+        if (header[1] == MARKER_SOS || header[1] == MARKER_EOI || length < SEGMENT_HEADER_SIZE - MARKER_SIZE) {
+            break;
+        }
+        uint32_t payloadSize = length - (SEGMENT_HEADER_SIZE - MARKER_SIZE);
+        if (header[1] == MARKER_APP1 && payloadSize >= sizeof(exifSignature) &&
+            reader(pos + SEGMENT_HEADER_SIZE, signature, sizeof(signature)) &&
+            memcmp(signature, exifSignature, sizeof(exifSignature)) == 0) {
+            offset = pos;
+            payload.resize(payloadSize);
+            if (!reader(pos + SEGMENT_HEADER_SIZE, payload.data(), payloadSize)) {
+                HiLog::Error(LABEL, "Read EXIF segment failed.");
+                return false;
+            }
+            return true;
+        }
+        pos += MARKER_SIZE + length;
     }
+    HiLog::Debug(LABEL, "No EXIF segment, create a new one.");
+    return true;
+}
 
-    ExifByteOrder order = GetExifByteOrder(isNewExifData, data);
-    ExifEntry *entry = nullptr;
-    if (!CreateExifEntry(tag, ptrExifData, value, order, &entry)) {
-        exif_data_unref(ptrExifData);
+uint32_t EXIFInfo::CreateExifPayload(const std::vector<uint8_t> &payload,
+    const std::vector<std::pair<ExifTag, std::string>> &tags, std::vector<uint8_t> &newPayload)
+{
+    ExifData *ptrExifData = nullptr;
+    if (!payload.empty()) {
+        ptrExifData = exif_data_new_from_data(payload.data(), static_cast<unsigned int>(payload.size()));
+    } else {
+        ptrExifData = exif_data_new();
+        if (ptrExifData != nullptr) {
+            /* Set the image options */
+            exif_data_set_option(ptrExifData, EXIF_DATA_OPTION_FOLLOW_SPECIFICATION);
+            exif_data_set_data_type(ptrExifData, EXIF_DATA_TYPE_COMPRESSED);
+            exif_data_set_byte_order(ptrExifData, EXIF_BYTE_ORDER_INTEL);
+            /* Create the mandatory EXIF fields with default data */
+            exif_data_fix(ptrExifData);
+        }
+    }
+    if (ptrExifData == nullptr) {
+        HiLog::Error(LABEL, "Create exif data failed.");
         return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
     }
-
-    unsigned char* exifDataBuf = nullptr;
+    ExifByteOrder order = exif_data_get_byte_order(ptrExifData);
+    for (const auto &tag : tags) {
+        ExifEntry *entry = nullptr;
+        if (!CreateExifEntry(tag.first, ptrExifData, tag.second, order, &entry)) {
+            exif_data_unref(ptrExifData);
+            return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+        }
+    }
+    unsigned char *exifDataBuf = nullptr;
     unsigned int exifDataBufLength = 0;
     exif_data_save_data(ptrExifData, &exifDataBuf, &exifDataBufLength);
+    exif_data_unref(ptrExifData);
     if (exifDataBuf == nullptr) {
         HiLog::Error(LABEL, "Get Exif Data Buf failed!");
-        exif_data_unref(ptrExifData);
         return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
     }
-
-    if (size == 0 || size > MAX_FILE_SIZE) {
-        HiLog::Error(LABEL, "Buffer size is out of range.");
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
-    }
-    unsigned char *tempBuf = static_cast<unsigned char *>(malloc(size));
-    if (tempBuf == nullptr) {
-        HiLog::Error(LABEL, "Allocate temp buffer ailed.");
-        exif_data_unref(ptrExifData);
-        return Media::ERR_IMAGE_MALLOC_ABNORMAL;
-    }
-
-    // Write EXIF header to buffer
-    uint32_t index = 0;
-    if (sizeof(exifHeader) >= size) {
-        HiLog::Error(LABEL, "There is not enough space for EXIF header!");
-        free(tempBuf);
-        tempBuf = nullptr;
-        exif_data_unref(ptrExifData);
+    newPayload.assign(exifDataBuf, exifDataBuf + exifDataBufLength);
+    free(exifDataBuf);
+    if (newPayload.size() > MAX_SEGMENT_LENGTH - (SEGMENT_HEADER_SIZE - MARKER_SIZE)) {
+        HiLog::Error(LABEL, "EXIF data block of %{public}zu bytes exceeds a segment.", newPayload.size());
         return Media::ERR_MEDIA_OUT_OF_RANGE;
     }
+    return Media::SUCCESS;
+}
 
-    for (size_t i = 0; i < sizeof(exifHeader); i++) {
-        tempBuf[index] = exifHeader[i];
-        index += 1;
-    }
-
-    // Write EXIF block length in big-endian order
-    unsigned char highBit = static_cast<unsigned char>((exifDataBufLength + LENGTH_OFFSET_2) >> MOVE_OFFSET_8);
-    if (index >= size) {
-        HiLog::Error(LABEL, "There is not enough space for writing EXIF block length!");
-        free(tempBuf);
-        tempBuf = nullptr;
-        exif_data_unref(ptrExifData);
-        return Media::ERR_MEDIA_OUT_OF_RANGE;
-    }
-    tempBuf[index] = highBit;
-    index += 1;
-
-    unsigned char lowBit = static_cast<unsigned char>((exifDataBufLength + LENGTH_OFFSET_2) & 0xff);
-    if (index >= size) {
-        HiLog::Error(LABEL, "There is not enough space for writing EXIF block length!");
-        free(tempBuf);
-        tempBuf = nullptr;
-        exif_data_unref(ptrExifData);
-        return Media::ERR_MEDIA_OUT_OF_RANGE;
-    }
-    tempBuf[index] = lowBit;
-    index += 1;
-
-    // Write EXIF data block
-    if ((index +  exifDataBufLength) >= size) {
-        HiLog::Error(LABEL, "There is not enough space for writing EXIF data block!");
-        free(tempBuf);
-        tempBuf = nullptr;
-        exif_data_unref(ptrExifData);
-        return Media::ERR_MEDIA_OUT_OF_RANGE;
-    }
-    for (unsigned int i = 0; i < exifDataBufLength; i++) {
-        tempBuf[index] = exifDataBuf[i];
-        index += 1;
+bool EXIFInfo::WriteExifSegment(int fd, uint32_t fileLength, uint32_t offset, const std::vector<uint8_t> &payload,
+    const std::vector<uint8_t> &newPayload)
+{
+    if (!payload.empty() && newPayload.size() <= payload.size()) {
+        // fits into the old segment: zero padded to its size, and only the bytes that differ are written.
+        std::vector<uint8_t> padded(newPayload);
+        padded.resize(payload.size(), 0);
+        auto first = std::mismatch(padded.begin(), padded.end(), payload.begin());
+        if (first.first == padded.end()) {
+            return true;
+        }
+        auto last = std::mismatch(padded.rbegin(), padded.rend(), payload.rbegin());
+        size_t begin = static_cast<size_t>(first.first - padded.begin());
+        size_t end = padded.size() - static_cast<size_t>(last.first - padded.rbegin());
+        return PwriteAll(fd, padded.data() + begin, end - begin, offset + SEGMENT_HEADER_SIZE + begin);
+    }
+    // grows: the rest of the file moves back to make room for the new segment.
+    uint32_t oldSegmentSize = payload.empty() ? 0 : static_cast<uint32_t>(payload.size()) + SEGMENT_HEADER_SIZE;
+    uint32_t tailStart = offset + oldSegmentSize;
+    uint32_t distance = static_cast<uint32_t>(newPayload.size()) + SEGMENT_HEADER_SIZE - oldSegmentSize;
+    if (!MoveFileTail(fd, tailStart, fileLength, distance)) {
+        return false;
     }
+    uint32_t length = static_cast<uint32_t>(newPayload.size()) + SEGMENT_HEADER_SIZE - MARKER_SIZE;
+    uint8_t header[SEGMENT_HEADER_SIZE] = { MARKER_PREFIX, MARKER_APP1,
+        static_cast<uint8_t>(length >> MOVE_OFFSET_8), static_cast<uint8_t>(length & 0xff) };
+    return PwriteAll(fd, header, sizeof(header), offset) &&
+        PwriteAll(fd, newPayload.data(), newPayload.size(), offset + SEGMENT_HEADER_SIZE);
+}
 
-    // Write JPEG image data, skipping the non-EXIF header
-    if ((index + size - orginExifDataLength - sizeof(exifHeader)) > size) {
-        HiLog::Error(LABEL, "There is not enough space for writing JPEG image data!");
-        free(tempBuf);
-        tempBuf = nullptr;
-        exif_data_unref(ptrExifData);
-        return Media::ERR_MEDIA_OUT_OF_RANGE;
-    }
-    for (unsigned int i = 0; i < (size - orginExifDataLength - sizeof(exifHeader)); i++) {
-        tempBuf[index] = data[orginExifDataLength + sizeof(exifHeader) + i];
-        index += 1;
+bool EXIFInfo::MoveFileTail(int fd, uint32_t start, uint32_t fileLength, uint32_t distance)
+{
+    // copied from the end backwards in chunks, so no byte is overwritten before it is moved.
+    std::vector<uint8_t> chunk(std::min(MOVE_CHUNK_SIZE, fileLength - start));
+    uint32_t end = fileLength;
+    while (end > start) {
+        uint32_t length = std::min(static_cast<uint32_t>(chunk.size()), end - start);
+        uint32_t pos = end - length;
+        if (pread(fd, chunk.data(), length, pos) != static_cast<ssize_t>(length) ||
+            !PwriteAll(fd, chunk.data(), length, pos + distance)) {
+            HiLog::Error(LABEL, "Error moving JPEG image data in file!");
+            return false;
+        }
+        end = pos;
     }
+    return true;
+}
 
-    for (unsigned int i = 0; i < size; i++) {
-        data[i] = tempBuf[i];
+bool EXIFInfo::PwriteAll(int fd, const uint8_t *buf, size_t length, off_t offset)
+{
+    while (length > 0) {
+        ssize_t written = pwrite(fd, buf, length, offset);
+        if (written <= 0) {
+            return false;
+        }
+        buf += written;
+        length -= static_cast<size_t>(written);
+        offset += written;
     }
-
-    ParseExifData(data, static_cast<unsigned int>(index));
-    free(tempBuf);
-    tempBuf = nullptr;
-    exif_data_unref(ptrExifData);
-    return Media::SUCCESS;
+    return true;
 }
 
 ExifEntry* EXIFInfo::InitExifTag(ExifData *exif, ExifIfd ifd, ExifTag tag)
@@ -700,79 +687,6 @@ ExifEntry* EXIFInfo::CreateExifTag(ExifData *exif, ExifIfd ifd, ExifTag tag,
     return exifEntry;
 }
 
-unsigned long EXIFInfo::GetFileSize(FILE *fp)
-{
-    long int position;
-    long size;
-
-    /* Save the current position. */
-    position = ftell(fp);
-
-    /* Jump to the end of the file. */
-    (void)fseek(fp, 0L, SEEK_END);
-
-    /* Get the end position. */
-    size = ftell(fp);
-
-    /* Jump back to the original position. */
-    (void)fseek(fp, position, SEEK_SET);
-
-    return static_cast<unsigned long>(size);
-}
-
-bool EXIFInfo::CreateExifData(unsigned char *buf, unsigned long length, ExifData **ptrData, bool &isNewExifData)
-{
-    if ((buf[BUFFER_POSITION_6] == 'E' && buf[BUFFER_POSITION_7] == 'x' &&
-        buf[BUFFER_POSITION_8] == 'i' && buf[BUFFER_POSITION_9] == 'f')) {
-        *ptrData = exif_data_new_from_data(buf, static_cast<unsigned int>(length));
-        if (!(*ptrData)) {
-            HiLog::Error(LABEL, "Create exif data from file failed.");
-            return false;
-        }
-        isNewExifData = false;
-        HiLog::Debug(LABEL, "Create exif data from buffer.");
-    } else {
-        *ptrData = exif_data_new();
-        if (!(*ptrData)) {
-            HiLog::Error(LABEL, "Create exif data failed.");
-            return false;
-        }
-        /* Set the image options */
-        exif_data_set_option(*ptrData, EXIF_DATA_OPTION_FOLLOW_SPECIFICATION);
-        exif_data_set_data_type(*ptrData, EXIF_DATA_TYPE_COMPRESSED);
-        exif_data_set_byte_order(*ptrData, EXIF_BYTE_ORDER_INTEL);
-
-        /* Create the mandatory EXIF fields with default data */
-        exif_data_fix(*ptrData);
-        isNewExifData = true;
-        HiLog::Debug(LABEL, "Create new exif data.");
-    }
-    return true;
-}
-
-unsigned int EXIFInfo::GetOrginExifDataLength(const bool &isNewExifData, unsigned char *buf)
-{
-    unsigned int orginExifDataLength = 0;
-    if (!isNewExifData) {
-        orginExifDataLength = static_cast<unsigned int>(buf[BUFFER_POSITION_5]) |
-            static_cast<unsigned int>(buf[BUFFER_POSITION_4] << MOVE_OFFSET_8);
-    }
-    return orginExifDataLength;
-}
-
-ExifByteOrder EXIFInfo::GetExifByteOrder(const bool &isNewExifData, unsigned char *buf)
-{
-    if (isNewExifData) {
-        return EXIF_BYTE_ORDER_INTEL;
-    } else {
-        if (buf[BUFFER_POSITION_12] == 'M' && buf[BUFFER_POSITION_13] == 'M') {
-            return EXIF_BYTE_ORDER_MOTOROLA;
-        } else {
-            return EXIF_BYTE_ORDER_INTEL;
-        }
-    }
-}
-
 bool EXIFInfo::CreateExifEntry(const ExifTag &tag, ExifData *data, const std::string &value,
     ExifByteOrder order, ExifEntry **ptrEntry)
 {
@@ -829,91 +743,9 @@ bool EXIFInfo::CreateExifEntry(const ExifTag &tag, ExifData *data, const std::st
     return true;
 }
 
-bool EXIFInfo::WriteExifDataToFile(ExifData *data, unsigned int orginExifDataLength, unsigned long fileLength,
-    unsigned char *buf, FILE *fp)
+void EXIFInfo::UpdateCacheExifData(const std::vector<uint8_t> &payload)
 {
-    unsigned char* exifDataBuf = nullptr;
-    unsigned int exifDataBufLength = 0;
-    exif_data_save_data(data, &exifDataBuf, &exifDataBufLength);
-    if (exifDataBuf == nullptr) {
-        HiLog::Error(LABEL, "Get Exif Data Buf failed!");
-        return false;
-    }
-
-    // Write EXIF header
-    if (fwrite(exifHeader, sizeof(exifHeader), 1, fp) != 1) {
-        HiLog::Error(LABEL, "Error writing EXIF header to file!");
-        return false;
-    }
-
-    // Write EXIF block length in big-endian order
-    if (fputc((exifDataBufLength + LENGTH_OFFSET_2) >> MOVE_OFFSET_8, fp) < 0) {
-        HiLog::Error(LABEL, "Error writing EXIF block length to file!");
-        return false;
-    }
-
-    if (fputc((exifDataBufLength + LENGTH_OFFSET_2) & 0xff, fp) < 0) {
-        HiLog::Error(LABEL, "Error writing EXIF block length to file!");
-        return false;
-    }
-
-    // Write EXIF data block
-    if (fwrite(exifDataBuf, exifDataBufLength, 1, fp) != 1) {
-        HiLog::Error(LABEL, "Error writing EXIF data block to file!");
-        return false;
-    }
-    // Write JPEG image data, skipping the non-EXIF header
-    unsigned int dataOffset = orginExifDataLength + sizeof(exifHeader);
-    if (fwrite(buf + dataOffset, fileLength - dataOffset, 1, fp) != 1) {
-        HiLog::Error(LABEL, "Error writing JPEG image data to file!");
-        return false;
-    }
-
-    UpdateCacheExifData(fp);
-    return true;
-}
-
-void EXIFInfo::ReleaseSource(unsigned char **ptrBuf, FILE **ptrFile)
-{
-    if (*ptrBuf) {
-        free(*ptrBuf);
-        *ptrBuf = nullptr;
-        ptrBuf = nullptr;
-    }
-
-    if (*ptrFile != nullptr) {
-        fclose(*ptrFile);
-        *ptrFile = nullptr;
-        ptrFile = nullptr;
-    }
-}
-
-void EXIFInfo::UpdateCacheExifData(FILE *fp)
-{
-    unsigned long fileLength = GetFileSize(fp);
-    if (fileLength == 0 || fileLength > MAX_FILE_SIZE) {
-        HiLog::Error(LABEL, "Get file size failed.");
-        return;
-    }
-
-    unsigned char *fileBuf = static_cast<unsigned char *>(malloc(fileLength));
-    if (fileBuf == nullptr) {
-        HiLog::Error(LABEL, "Allocate buf failed.");
-        return;
-    }
-
-    // Set current position to begin of file.
-    (void)fseek(fp, 0L, 0);
-    if (fread(fileBuf, fileLength, 1, fp) != 1) {
-        HiLog::Error(LABEL, "Read new file failed.");
-        free(fileBuf);
-        fileBuf = nullptr;
-        return;
-    }
-
-    ParseExifData(fileBuf, static_cast<unsigned int>(fileLength));
-    free(fileBuf);
-    fileBuf = nullptr;
+    ParseExifData(payload.data(), static_cast<unsigned int>(payload.size()));
 }
 
 uint32_t EXIFInfo::GetFilterArea(const uint8_t *buf,
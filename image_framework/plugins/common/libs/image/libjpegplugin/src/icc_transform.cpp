@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "icc_transform.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include "hilog/log.h"
+#include "log_tags.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "IccTransform" };
+constexpr uint32_t CHANNELS = 3;
+constexpr uint32_t RED = 0;
+constexpr uint32_t GREEN = 1;
+constexpr uint32_t BLUE = 2;
+constexpr uint32_t CODE_NUM = 256;
+constexpr int32_t CODE_MAX = 255;
+// linear light is kept with 14 fraction bits, enough to tell the darkest 8 bit codes apart.
+constexpr uint32_t LINEAR_BITS = 14;
+constexpr int32_t LINEAR_ONE = 1 << LINEAR_BITS;
+constexpr int32_t LINEAR_ROUND = 1 << (LINEAR_BITS - 1);
+constexpr uint32_t ENCODE_SIZE = LINEAR_ONE + 1;
+constexpr uint32_t MATRIX_SIZE = CHANNELS * CHANNELS;
+// a larger row of the fixed point matrix could overflow the 32 bit sums.
+constexpr float MAX_MATRIX_ROW_SUM = 7.0f;
+// pixels converted per pass, the passes work on plain arrays the compiler can vectorise.
+constexpr uint32_t CHUNK_PIXELS = 64;
+constexpr uint32_t LUT_GRID = 33;
+constexpr uint32_t LUT_FRAC_BITS = 8;
+constexpr int32_t LUT_FRAC_ONE = 1 << LUT_FRAC_BITS;
+constexpr int32_t LUT_VALUE_MAX = CODE_MAX << LUT_FRAC_BITS;
+constexpr uint32_t MAX_CACHED_TRANSFORMS = 8;
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+// ICC data colour space signatures.
+constexpr uint32_t ICC_SIGNATURE_RGB = 0x52474220;
+constexpr uint32_t ICC_SIGNATURE_GRAY = 0x47524159;
+
+struct CacheEntry {
+    uint64_t hash = 0;
+    uint32_t size = 0;
+    PlColorSpace target = PlColorSpace::UNKNOWN;
+    std::shared_ptr<const IccTransform> transform;
+    uint64_t lastUse = 0;
+};
+
+std::mutex g_cacheMutex;
+std::vector<CacheEntry> g_cache;
+uint64_t g_cacheUse = 0;
+
+uint64_t HashProfile(const uint8_t *profile, uint32_t size)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ profile[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool GetTargetProfile(PlColorSpace target, skcms_ICCProfile &profile)
+{
+    skcms_Init(&profile);
+    switch (target) {
+        case PlColorSpace::SRGB:
+            profile = *skcms_sRGB_profile();
+            return true;
+        case PlColorSpace::LINEAR_SRGB:
+            skcms_SetTransferFunction(&profile, &SkNamedTransferFn::kLinear);
+            skcms_SetXYZD50(&profile, &SkNamedGamut::kSRGB);
+            return true;
+        case PlColorSpace::DISPLAY_P3:
+            skcms_SetTransferFunction(&profile, &SkNamedTransferFn::kSRGB);
+            skcms_SetXYZD50(&profile, &SkNamedGamut::kDisplayP3);
+            return true;
+        case PlColorSpace::ADOBE_RGB_1998:
+            skcms_SetTransferFunction(&profile, &SkNamedTransferFn::k2Dot2);
+            skcms_SetXYZD50(&profile, &SkNamedGamut::kAdobeRGB);
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::shared_ptr<const IccTransform> CreateTransform(const uint8_t *profile, uint32_t size, PlColorSpace target)
+{
+    skcms_ICCProfile dst;
+    if (!GetTargetProfile(target, dst)) {
+        HiLog::Error(LABEL, "unsupported target colour space %{public}d.", static_cast<int32_t>(target));
+        return nullptr;
+    }
+    skcms_ICCProfile src = *skcms_sRGB_profile();
+    if (profile != nullptr && !skcms_Parse(profile, size, &src)) {
+        HiLog::Error(LABEL, "parse icc profile of %{public}u bytes failed.", size);
+        return nullptr;
+    }
+    if (src.data_color_space != ICC_SIGNATURE_RGB && src.data_color_space != ICC_SIGNATURE_GRAY) {
+        HiLog::Error(LABEL, "unsupported icc data colour space 0x%{public}x.", src.data_color_space);
+        return nullptr;
+    }
+    if (skcms_ApproximatelyEqualProfiles(&src, &dst)) {
+        return nullptr;
+    }
+    auto transform = std::make_shared<IccTransform>();
+    if (!transform->Build(src, dst)) {
+        HiLog::Error(LABEL, "build icc transform failed.");
+        return nullptr;
+    }
+    return transform;
+}
+
+inline int32_t Lerp(int32_t from, int32_t to, int32_t frac)
+{
+    return from + (((to - from) * frac) >> LUT_FRAC_BITS);
+}
+} // namespace
+
+std::shared_ptr<const IccTransform> IccTransform::Get(const uint8_t *profile, uint32_t size, PlColorSpace target)
+{
+    uint64_t hash = (profile == nullptr) ? 0 : HashProfile(profile, size);
+    size = (profile == nullptr) ? 0 : size;
+    {
+        std::lock_guard<std::mutex> guard(g_cacheMutex);
+        for (auto &entry : g_cache) {
+            if (entry.hash == hash && entry.size == size && entry.target == target) {
+                entry.lastUse = ++g_cacheUse;
+                return entry.transform;
+            }
+        }
+    }
+    // built unlocked, the tables take a few milliseconds.
+    std::shared_ptr<const IccTransform> transform = CreateTransform(profile, size, target);
+    std::lock_guard<std::mutex> guard(g_cacheMutex);
+    if (g_cache.size() >= MAX_CACHED_TRANSFORMS) {
+        auto oldest = std::min_element(g_cache.begin(), g_cache.end(),
+            [](const CacheEntry &left, const CacheEntry &right) { return left.lastUse < right.lastUse; });
+        g_cache.erase(oldest);
+    }
+    CacheEntry entry;
+    entry.hash = hash;
+    entry.size = size;
+    entry.target = target;
+    entry.transform = transform;
+    entry.lastUse = ++g_cacheUse;
+    g_cache.push_back(entry);
+    return transform;
+}
+
+bool IccTransform::Build(const skcms_ICCProfile &src, const skcms_ICCProfile &dst)
+{
+    targetColorSpace_ = SkColorSpace::Make(dst);
+    // skcms prefers the A2B tables of a profile that has both, so those take the LUT too.
+    if (src.has_trc && src.has_toXYZD50 && !src.has_A2B && BuildMatrix(src, dst)) {
+        return true;
+    }
+    return BuildLut(src, dst);
+}
+
+bool IccTransform::BuildMatrix(const skcms_ICCProfile &src, const skcms_ICCProfile &dst)
+{
+    skcms_Matrix3x3 fromDst;
+    if (!dst.has_toXYZD50 || !skcms_Matrix3x3_invert(&dst.toXYZD50, &fromDst)) {
+        return false;
+    }
+    skcms_Matrix3x3 toDst = skcms_Matrix3x3_concat(&fromDst, &src.toXYZD50);
+    for (uint32_t row = 0; row < CHANNELS; row++) {
+        float sum = 0;
+        for (uint32_t column = 0; column < CHANNELS; column++) {
+            sum += std::fabs(toDst.vals[row][column]);
+        }
+        if (sum > MAX_MATRIX_ROW_SUM) {
+            return false;
+        }
+    }
+    // the curves are evaluated by skcms, as a transform to the same gamut with a linear transfer function.
+    skcms_ICCProfile srcLinear;
+    skcms_Init(&srcLinear);
+    skcms_SetTransferFunction(&srcLinear, &SkNamedTransferFn::kLinear);
+    skcms_SetXYZD50(&srcLinear, &src.toXYZD50);
+    skcms_ICCProfile dstLinear;
+    skcms_Init(&dstLinear);
+    skcms_SetTransferFunction(&dstLinear, &SkNamedTransferFn::kLinear);
+    skcms_SetXYZD50(&dstLinear, &dst.toXYZD50);
+
+    std::vector<uint8_t> codes(CODE_NUM * CHANNELS);
+    for (uint32_t i = 0; i < codes.size(); i++) {
+        codes[i] = static_cast<uint8_t>(i / CHANNELS);
+    }
+    std::vector<float> linear(CODE_NUM * CHANNELS);
+    if (!skcms_Transform(codes.data(), skcms_PixelFormat_RGB_888, skcms_AlphaFormat_Opaque, &src,
+        linear.data(), skcms_PixelFormat_RGB_fff, skcms_AlphaFormat_Opaque, &srcLinear, CODE_NUM)) {
+        return false;
+    }
+    std::vector<float> levels(ENCODE_SIZE * CHANNELS);
+    for (uint32_t i = 0; i < levels.size(); i++) {
+        levels[i] = static_cast<float>(i / CHANNELS) / LINEAR_ONE;
+    }
+    std::vector<uint8_t> encoded(ENCODE_SIZE * CHANNELS);
+    if (!skcms_Transform(levels.data(), skcms_PixelFormat_RGB_fff, skcms_AlphaFormat_Opaque, &dstLinear,
+        encoded.data(), skcms_PixelFormat_RGB_888, skcms_AlphaFormat_Opaque, &dst, ENCODE_SIZE)) {
+        return false;
+    }
+
+    linear_.resize(CODE_NUM * CHANNELS);
+    encode_.resize(ENCODE_SIZE * CHANNELS);
+    for (uint32_t c = 0; c < CHANNELS; c++) {
+        for (uint32_t i = 0; i < CODE_NUM; i++) {
+            float value = std::clamp(std::round(linear[i * CHANNELS + c] * LINEAR_ONE), 0.0f,
+                static_cast<float>(LINEAR_ONE));
+            linear_[c * CODE_NUM + i] = static_cast<int32_t>(value);
+        }
+        for (uint32_t i = 0; i < ENCODE_SIZE; i++) {
+            encode_[c * ENCODE_SIZE + i] = encoded[i * CHANNELS + c];
+        }
+    }
+    matrix_.resize(MATRIX_SIZE);
+    for (uint32_t i = 0; i < MATRIX_SIZE; i++) {
+        matrix_[i] = static_cast<int32_t>(std::round(toDst.vals[i / CHANNELS][i % CHANNELS] * LINEAR_ONE));
+    }
+    return true;
+}
+
+bool IccTransform::BuildLut(const skcms_ICCProfile &src, const skcms_ICCProfile &dst)
+{
+    constexpr uint32_t points = LUT_GRID * LUT_GRID * LUT_GRID;
+    std::vector<float> grid(points * CHANNELS);
+    for (uint32_t i = 0; i < points; i++) {
+        grid[i * CHANNELS + RED] = static_cast<float>(i / (LUT_GRID * LUT_GRID)) / (LUT_GRID - 1);
+        grid[i * CHANNELS + GREEN] = static_cast<float>((i / LUT_GRID) % LUT_GRID) / (LUT_GRID - 1);
+        grid[i * CHANNELS + BLUE] = static_cast<float>(i % LUT_GRID) / (LUT_GRID - 1);
+    }
+    std::vector<float> colors(points * CHANNELS);
+    if (!skcms_Transform(grid.data(), skcms_PixelFormat_RGB_fff, skcms_AlphaFormat_Opaque, &src,
+        colors.data(), skcms_PixelFormat_RGB_fff, skcms_AlphaFormat_Opaque, &dst, points)) {
+        return false;
+    }
+    lut_.resize(colors.size());
+    for (uint32_t i = 0; i < colors.size(); i++) {
+        float value = std::round(colors[i] * static_cast<float>(LUT_VALUE_MAX));
+        lut_[i] = static_cast<uint16_t>(std::clamp(value, 0.0f, static_cast<float>(LUT_VALUE_MAX)));
+    }
+    lutIndex_.resize(CODE_NUM);
+    lutFrac_.resize(CODE_NUM);
+    for (uint32_t code = 0; code < CODE_NUM; code++) {
+        uint32_t pos = (code * (LUT_GRID - 1) * LUT_FRAC_ONE + CODE_NUM / 2) / (CODE_NUM - 1);
+        uint32_t index = pos >> LUT_FRAC_BITS;
+        uint32_t frac = pos & (LUT_FRAC_ONE - 1);
+        // the last code sits on the last grid point, as the far end of the last cell.
+        if (index >= LUT_GRID - 1) {
+            index = LUT_GRID - 2;
+            frac = LUT_FRAC_ONE;
+        }
+        lutIndex_[code] = static_cast<uint8_t>(index);
+        lutFrac_[code] = static_cast<uint16_t>(frac);
+    }
+    return true;
+}
+
+sk_sp<SkColorSpace> IccTransform::GetTargetColorSpace() const
+{
+    return targetColorSpace_;
+}
+
+void IccTransform::TransformRow(uint8_t *row, uint32_t width, const PixelLayout &layout) const
+{
+    for (uint32_t x = 0; x < width; x += CHUNK_PIXELS) {
+        uint32_t count = std::min(CHUNK_PIXELS, width - x);
+        uint8_t *pixels = row + static_cast<size_t>(x) * layout.pixelBytes;
+        if (lut_.empty()) {
+            TransformMatrix(pixels, count, layout);
+        } else {
+            TransformLut(pixels, count, layout);
+        }
+    }
+}
+
+void IccTransform::TransformMatrix(uint8_t *pixels, uint32_t count, const PixelLayout &layout) const
+{
+    int32_t red[CHUNK_PIXELS];
+    int32_t green[CHUNK_PIXELS];
+    int32_t blue[CHUNK_PIXELS];
+    const int32_t *linearRed = linear_.data();
+    const int32_t *linearGreen = linearRed + CODE_NUM;
+    const int32_t *linearBlue = linearGreen + CODE_NUM;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *pixel = pixels + i * layout.pixelBytes;
+        red[i] = linearRed[pixel[layout.red]];
+        green[i] = linearGreen[pixel[layout.green]];
+        blue[i] = linearBlue[pixel[layout.blue]];
+    }
+    const int32_t *m = matrix_.data();
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t r = (m[0] * red[i] + m[1] * green[i] + m[2] * blue[i] + LINEAR_ROUND) >> LINEAR_BITS;
+        int32_t g = (m[3] * red[i] + m[4] * green[i] + m[5] * blue[i] + LINEAR_ROUND) >> LINEAR_BITS;
+        int32_t b = (m[6] * red[i] + m[7] * green[i] + m[8] * blue[i] + LINEAR_ROUND) >> LINEAR_BITS;
+        red[i] = std::clamp(r, 0, LINEAR_ONE);
+        green[i] = std::clamp(g, 0, LINEAR_ONE);
+        blue[i] = std::clamp(b, 0, LINEAR_ONE);
+    }
+    const uint8_t *encodeRed = encode_.data();
+    const uint8_t *encodeGreen = encodeRed + ENCODE_SIZE;
+    const uint8_t *encodeBlue = encodeGreen + ENCODE_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t *pixel = pixels + i * layout.pixelBytes;
+        pixel[layout.red] = encodeRed[red[i]];
+        pixel[layout.green] = encodeGreen[green[i]];
+        pixel[layout.blue] = encodeBlue[blue[i]];
+    }
+}
+
+void IccTransform::TransformLut(uint8_t *pixels, uint32_t count, const PixelLayout &layout) const
+{
+    constexpr uint32_t strideG = LUT_GRID * CHANNELS;
+    constexpr uint32_t strideR = LUT_GRID * strideG;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t *pixel = pixels + i * layout.pixelBytes;
+        uint8_t r = pixel[layout.red];
+        uint8_t g = pixel[layout.green];
+        uint8_t b = pixel[layout.blue];
+        const uint16_t *cell = lut_.data() + lutIndex_[r] * strideR + lutIndex_[g] * strideG +
+            lutIndex_[b] * CHANNELS;
+        int32_t fracR = lutFrac_[r];
+        int32_t fracG = lutFrac_[g];
+        int32_t fracB = lutFrac_[b];
+        uint8_t out[CHANNELS];
+        for (uint32_t c = 0; c < CHANNELS; c++) {
+            const uint16_t *p = cell + c;
+            int32_t c00 = Lerp(p[0], p[CHANNELS], fracB);
+            int32_t c01 = Lerp(p[strideG], p[strideG + CHANNELS], fracB);
+            int32_t c10 = Lerp(p[strideR], p[strideR + CHANNELS], fracB);
+            int32_t c11 = Lerp(p[strideR + strideG], p[strideR + strideG + CHANNELS], fracB);
+            int32_t value = Lerp(Lerp(c00, c01, fracG), Lerp(c10, c11, fracG), fracR);
+            out[c] = static_cast<uint8_t>(std::clamp((value + LUT_FRAC_ONE / 2) >> LUT_FRAC_BITS, 0, CODE_MAX));
+        }
+        pixel[layout.red] = out[RED];
+        pixel[layout.green] = out[GREEN];
+        pixel[layout.blue] = out[BLUE];
+    }
+}
+} // namespace ImagePlugin
+} // namespace OHOS
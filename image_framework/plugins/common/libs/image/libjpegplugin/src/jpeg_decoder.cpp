@@ -14,8 +14,12 @@
  */
 
 #include "jpeg_decoder.h"
+#include <algorithm>
+#include <cstring>
 #include <map>
+#include <thread>
 #include "jerror.h"
+#include "jpeg_parallel_decoder.h"
 #include "media_errors.h"
 #include "string_ex.h"
 #ifndef _WIN32
@@ -35,6 +39,13 @@ static constexpr uint32_t PL_MARKER_LENGTH_LIMIT = 0xFFFF;
 namespace {
 constexpr uint32_t NUM_100 = 100;
 constexpr uint32_t PIXEL_BYTES_RGB_565 = 2;
+// NV21 and NV12 take 1.5 bytes per pixel, the pixel map counts 2 as for the other YUV 420 formats.
+constexpr uint32_t PIXEL_BYTES_YUV_420SP = 2;
+constexpr uint8_t YUV_GRAY_CHROMA = 128;
+constexpr uint32_t YUV_CHROMA_SAMPLE = 2;
+constexpr int YUV_COMPONENT_NUM = 3;
+constexpr uint32_t MIN_DECODE_THREAD_NUM = 2;
+constexpr uint32_t MAX_DECODE_THREAD_NUM = 8;
 constexpr uint32_t MARKER_SIZE = 2;
 constexpr uint32_t MARKER_LENGTH = 2;
 constexpr uint8_t MARKER_LENGTH_0_OFFSET = 0;
@@ -45,12 +56,16 @@ constexpr uint8_t JPG_MARKER_CODE_OFFSET = 1;
 constexpr uint8_t JPG_MARKER_PREFIX = 0XFF;
 constexpr uint8_t JPG_MARKER_SOI = 0XD8;
 constexpr uint8_t JPG_MARKER_SOS = 0XDA;
+constexpr uint8_t JPG_MARKER_EOI = 0XD9;
 constexpr uint8_t JPG_MARKER_RST = 0XD0;
 constexpr uint8_t JPG_MARKER_RST0 = 0XD0;
 constexpr uint8_t JPG_MARKER_RSTN = 0XD7;
 constexpr uint8_t JPG_MARKER_APP = 0XE0;
 constexpr uint8_t JPG_MARKER_APP0 = 0XE0;
 constexpr uint8_t JPG_MARKER_APPN = 0XEF;
+constexpr uint8_t JPG_MARKER_APP1 = 0XE1;
+// the APP1 segment holding the EXIF data starts with "Exif" and two zero bytes, libexif parses it from there.
+constexpr uint8_t EXIF_SIGNATURE[] = { 'E', 'x', 'i', 'f', 0, 0 };
 constexpr size_t TIMES_LEN = 19;
 constexpr size_t DATE_LEN = 10;
 const std::string BITS_PER_SAMPLE = "BitsPerSample";
@@ -77,6 +92,33 @@ static const std::map<std::string, uint32_t> PROPERTY_INT = {
 constexpr uint32_t JPEG_APP1_SIZE = 2;
 constexpr uint32_t ADDRESS_4 = 4;
 constexpr int OFFSET_8 = 8;
+// libjpeg-turbo scales the IDCT by M/8, M from 1 to 16.
+constexpr uint32_t JPEG_SCALE_DENOM = 8;
+constexpr int32_t RIGHT_ANGLE = 90;
+constexpr int32_t RIGHT_ANGLE_PERIOD = 2;
+
+bool GetIccPixelLayout(J_COLOR_SPACE colorSpace, IccTransform::PixelLayout &layout)
+{
+    switch (colorSpace) {
+        case JCS_EXT_RGBA:
+            layout = { 4, 0, 1, 2 };
+            return true;
+        case JCS_EXT_BGRA:
+            layout = { 4, 2, 1, 0 };
+            return true;
+        case JCS_EXT_ARGB:
+            layout = { 4, 1, 2, 3 };
+            return true;
+        case JCS_RGB:
+            layout = { 3, 0, 1, 2 };
+            return true;
+        case JCS_EXT_BGR:
+            layout = { 3, 2, 1, 0 };
+            return true;
+        default:
+            return false;
+    }
+}
 } // namespace
 
 PluginServer &JpegDecoder::pluginServer_ = DelayedRefSingleton<PluginServer>::GetInstance();
@@ -229,19 +271,26 @@ uint32_t JpegDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions
         return ret;
     }
     info.pixelFormat = outputFormat_;
-    info.size.width = decodeInfo_.output_width;
-    info.size.height = decodeInfo_.output_height;
+    info.size.width = decodeRegion_.width;
+    info.size.height = decodeRegion_.height;
+    info.cropApplied = regionDecode_;
     info.alphaType = PlAlphaType::IMAGE_ALPHA_TYPE_OPAQUE;
     opts_ = opts;
     state_ = JpegDecodingState::IMAGE_DECODING;
     return Media::SUCCESS;
 }
 
+uint32_t JpegDecoder::GetPixelBytes()
+{
+    if (yuvDecode_) {
+        return PIXEL_BYTES_YUV_420SP;
+    }
+    return (decodeInfo_.out_color_space == JCS_RGB565) ? PIXEL_BYTES_RGB_565 : decodeInfo_.out_color_components;
+}
+
 uint32_t JpegDecoder::GetRowBytes()
 {
-    uint32_t pixelBytes =
-        (decodeInfo_.out_color_space == JCS_RGB565) ? PIXEL_BYTES_RGB_565 : decodeInfo_.out_color_components;
-    return decodeInfo_.output_width * pixelBytes;
+    return decodeInfo_.output_width * GetPixelBytes();
 }
 
 uint32_t JpegDecoder::DoSwDecode(DecodeContext &context) __attribute__((no_sanitize("cfi")))
@@ -250,9 +299,12 @@ uint32_t JpegDecoder::DoSwDecode(DecodeContext &context) __attribute__((no_sanit
         HiLog::Error(LABEL, "decode image failed.");
         return ERR_IMAGE_DECODE_ABNORMAL;
     }
-    uint32_t rowStride = GetRowBytes();
+    uint32_t rowStride = decodeRegion_.width * GetPixelBytes();
     if (context.pixelsBuffer.buffer == nullptr) {
-        uint64_t byteCount = static_cast<uint64_t>(rowStride) * decodeInfo_.output_height;
+        uint64_t byteCount = static_cast<uint64_t>(rowStride) * decodeRegion_.height;
+        if (yuvDecode_) {
+            byteCount = std::max(byteCount, GetYuvByteCount());
+        }
         if (context.allocatorType == Media::AllocatorType::SHARE_MEM_ALLOC) {
 #if !defined(_WIN32) && !defined(_APPLE) && !defined(_ANDROID) && !defined(_IOS)
             int fd = AshmemCreate("JPEG RawData", byteCount);
@@ -303,16 +355,15 @@ uint32_t JpegDecoder::DoSwDecode(DecodeContext &context) __attribute__((no_sanit
         HiLog::Error(LABEL, "decode image buffer is null.");
         return ERR_IMAGE_INVALID_PARAMETER;
     }
-    srcMgr_.inputStream->Seek(streamPosition_);
-    uint8_t *buffer = nullptr;
-    while (decodeInfo_.output_scanline < decodeInfo_.output_height) {
-        buffer = base + rowStride * decodeInfo_.output_scanline;
-        uint32_t readLineNum = jpeg_read_scanlines(&decodeInfo_, &buffer, RW_LINE_NUM);
-        if (readLineNum < RW_LINE_NUM) {
-            streamPosition_ = srcMgr_.inputStream->Tell();
-            HiLog::Error(LABEL, "read line fail, read num:%{public}u, total read num:%{public}u.", readLineNum,
-                         decodeInfo_.output_scanline);
-            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+    if (yuvDecode_) {
+        uint32_t ret = decodeInfo_.raw_data_out ? DoRawYuvDecode(base) : DoScanlineYuvDecode(base);
+        if (ret != Media::SUCCESS) {
+            return ret;
+        }
+    } else if (!DoParallelDecode(base, rowStride)) {
+        uint32_t ret = DoScanlineDecode(base, rowStride);
+        if (ret != Media::SUCCESS) {
+            return ret;
         }
     }
     streamPosition_ = srcMgr_.inputStream->Tell();
@@ -329,6 +380,198 @@ uint32_t JpegDecoder::DoSwDecode(DecodeContext &context) __attribute__((no_sanit
     return Media::SUCCESS;
 }
 
+bool JpegDecoder::DoParallelDecode(uint8_t *base, uint32_t rowStride)
+{
+    uint32_t threadCount = (opts_.threadCount == 0) ? std::thread::hardware_concurrency() : opts_.threadCount;
+    threadCount = std::min(threadCount, MAX_DECODE_THREAD_NUM);
+    // the bands are cut from the whole file, so it must be in memory already.
+    if (threadCount < MIN_DECODE_THREAD_NUM || regionDecode_ || decodeInfo_.output_scanline != 0 ||
+        !srcMgr_.inputStream->IsStreamCompleted() || srcMgr_.inputStream->GetDataPtr() == nullptr) {
+        return false;
+    }
+    JpegParallelDecoder parallelDecoder(srcMgr_.inputStream->GetDataPtr(), srcMgr_.inputStream->GetStreamSize(),
+        decodeInfo_);
+    if (!parallelDecoder.Split(threadCount)) {
+        return false;
+    }
+    if (iccTransform_ != nullptr) {
+        parallelDecoder.SetRowTransform([this](uint8_t *row) {
+            iccTransform_->TransformRow(row, decodeRegion_.width, iccLayout_);
+        });
+    }
+    // a band that fails leaves the buffer to the sequential decode, which reports the error if there is one.
+    return parallelDecoder.Decode(base, rowStride) == Media::SUCCESS;
+}
+
+uint32_t JpegDecoder::DoScanlineDecode(uint8_t *base, uint32_t rowStride) __attribute__((no_sanitize("cfi")))
+{
+    srcMgr_.inputStream->Seek(streamPosition_);
+    if (decodeInfo_.output_scanline < decodeRegion_.top) {
+        uint32_t skipLineNum = decodeRegion_.top - decodeInfo_.output_scanline;
+        if (jpeg_skip_scanlines(&decodeInfo_, skipLineNum) < skipLineNum) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "skip line fail, total read num:%{public}u.", decodeInfo_.output_scanline);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+    }
+    uint32_t regionBottom = decodeRegion_.top + decodeRegion_.height;
+    uint32_t lineNum = GetDecodeLineNum(decodeInfo_);
+    uint32_t scanlineStride = GetRowBytes();
+    JSAMPROW rows[RW_MAX_LINE_NUM];
+    // rows are counted from output_scanline, so a decode suspended on incomplete data resumes at the right row.
+    while (decodeInfo_.output_scanline < regionBottom) {
+        uint32_t firstRow = decodeInfo_.output_scanline - decodeRegion_.top;
+        uint32_t rowNum = std::min(lineNum, regionBottom - decodeInfo_.output_scanline);
+        for (uint32_t i = 0; i < rowNum; i++) {
+            rows[i] = regionRows_.empty() ? (base + rowStride * (firstRow + i)) :
+                (regionRows_.data() + scanlineStride * i);
+        }
+        uint32_t readLineNum = jpeg_read_scanlines(&decodeInfo_, rows, rowNum);
+        if (readLineNum == 0) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "read line fail, total read num:%{public}u.", decodeInfo_.output_scanline);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        for (uint32_t i = 0; i < readLineNum && !regionRows_.empty(); i++) {
+            if (memcpy_s(base + rowStride * (firstRow + i), rowStride,
+                rows[i] + regionOffset_ * GetPixelBytes(), rowStride) != EOK) {
+                HiLog::Error(LABEL, "copy region row fail.");
+                return ERR_IMAGE_DECODE_ABNORMAL;
+            }
+        }
+        TransformRows(base, rowStride, firstRow, readLineNum);
+    }
+    return Media::SUCCESS;
+}
+
+uint64_t JpegDecoder::GetYuvByteCount()
+{
+    uint64_t width = decodeRegion_.width;
+    uint64_t height = decodeRegion_.height;
+    uint64_t uvStride = (width + 1) & ~static_cast<uint64_t>(1);
+    return width * height + uvStride * ((height + 1) / YUV_CHROMA_SAMPLE);
+}
+
+void JpegDecoder::WriteUvRow(uint8_t *base, uint32_t uvRow, const uint8_t *cbRow, const uint8_t *crRow)
+{
+    uint32_t width = decodeRegion_.width;
+    uint32_t uvStride = (width + 1) & ~1u;
+    uint8_t *dst = base + static_cast<size_t>(width) * decodeRegion_.height + static_cast<size_t>(uvStride) * uvRow;
+    // the chroma plane of NV21 is vu, NV12 is uv
+    const uint8_t *first = (outputFormat_ == PlPixelFormat::NV12) ? cbRow : crRow;
+    const uint8_t *second = (outputFormat_ == PlPixelFormat::NV12) ? crRow : cbRow;
+    for (uint32_t i = 0; i < uvStride / YUV_CHROMA_SAMPLE; i++) {
+        dst[i * YUV_CHROMA_SAMPLE] = first[i];
+        dst[i * YUV_CHROMA_SAMPLE + 1] = second[i];
+    }
+}
+
+uint32_t JpegDecoder::DoRawYuvDecode(uint8_t *base) __attribute__((no_sanitize("cfi")))
+{
+    srcMgr_.inputStream->Seek(streamPosition_);
+    uint32_t width = decodeRegion_.width;
+    uint32_t height = decodeRegion_.height;
+    // an iMCU row is two luma block rows and one chroma block row, the planes are padded to whole blocks.
+    uint32_t lumaLines = decodeInfo_.max_v_samp_factor * DCTSIZE;
+    uint32_t chromaLines = lumaLines / YUV_CHROMA_SAMPLE;
+    size_t lumaStride = decodeInfo_.comp_info[0].width_in_blocks * DCTSIZE;
+    size_t chromaStride = decodeInfo_.comp_info[1].width_in_blocks * DCTSIZE;
+    yuvRows_.resize(lumaStride * lumaLines + chromaStride * chromaLines * (decodeInfo_.num_components - 1));
+    JSAMPROW lumaRows[MAX_SAMP_FACTOR * DCTSIZE];
+    JSAMPROW cbRows[DCTSIZE];
+    JSAMPROW crRows[DCTSIZE];
+    for (uint32_t i = 0; i < lumaLines; i++) {
+        lumaRows[i] = yuvRows_.data() + lumaStride * i;
+    }
+    uint8_t *chroma = yuvRows_.data() + lumaStride * lumaLines;
+    for (uint32_t i = 0; i < chromaLines; i++) {
+        cbRows[i] = chroma + chromaStride * i;
+        crRows[i] = chroma + chromaStride * (chromaLines + i);
+    }
+    JSAMPARRAY planes[] = { lumaRows, cbRows, crRows };
+    // raw data is read a whole iMCU row at a time, a decode suspended on incomplete data resumes at that row.
+    while (decodeInfo_.output_scanline < height) {
+        uint32_t firstRow = decodeInfo_.output_scanline;
+        if (jpeg_read_raw_data(&decodeInfo_, planes, lumaLines) == 0) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "read raw data fail, total read num:%{public}u.", decodeInfo_.output_scanline);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        uint32_t rowNum = std::min(lumaLines, height - firstRow);
+        for (uint32_t i = 0; i < rowNum; i++) {
+            if (memcpy_s(base + static_cast<size_t>(width) * (firstRow + i), width, lumaRows[i], width) != EOK) {
+                HiLog::Error(LABEL, "copy luma row fail.");
+                return ERR_IMAGE_DECODE_ABNORMAL;
+            }
+        }
+        uint32_t uvRowNum = (rowNum + 1) / YUV_CHROMA_SAMPLE;
+        for (uint32_t i = 0; i < uvRowNum; i++) {
+            WriteUvRow(base, firstRow / YUV_CHROMA_SAMPLE + i, cbRows[i], crRows[i]);
+        }
+    }
+    return Media::SUCCESS;
+}
+
+uint32_t JpegDecoder::DoScanlineYuvDecode(uint8_t *base) __attribute__((no_sanitize("cfi")))
+{
+    srcMgr_.inputStream->Seek(streamPosition_);
+    uint32_t width = decodeRegion_.width;
+    uint32_t height = decodeRegion_.height;
+    uint32_t components = decodeInfo_.out_color_components;
+    size_t scanlineStride = static_cast<size_t>(width) * components;
+    uint32_t uvWidth = (width + 1) / YUV_CHROMA_SAMPLE;
+    // two scanlines of a chroma row pair, then the cb and cr row averaged from them.
+    yuvRows_.resize(scanlineStride * YUV_CHROMA_SAMPLE + uvWidth * YUV_CHROMA_SAMPLE);
+    uint8_t *cbRow = yuvRows_.data() + scanlineStride * YUV_CHROMA_SAMPLE;
+    uint8_t *crRow = cbRow + uvWidth;
+    // the row pair is kept in yuvRows_, so a decode suspended between its two rows resumes at the right row.
+    while (decodeInfo_.output_scanline < height) {
+        uint32_t firstRow = decodeInfo_.output_scanline;
+        uint32_t slot = firstRow % YUV_CHROMA_SAMPLE;
+        JSAMPROW rows[YUV_CHROMA_SAMPLE] = { yuvRows_.data(), yuvRows_.data() + scanlineStride };
+        uint32_t readLineNum = jpeg_read_scanlines(&decodeInfo_, rows + slot,
+            std::min(YUV_CHROMA_SAMPLE - slot, height - firstRow));
+        if (readLineNum == 0) {
+            streamPosition_ = srcMgr_.inputStream->Tell();
+            HiLog::Error(LABEL, "read line fail, total read num:%{public}u.", decodeInfo_.output_scanline);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        for (uint32_t i = 0; i < readLineNum; i++) {
+            uint8_t *luma = base + static_cast<size_t>(width) * (firstRow + i);
+            for (uint32_t x = 0; x < width; x++) {
+                luma[x] = rows[slot + i][x * components];
+            }
+        }
+        // the chroma row is written once both its rows are read, or the last odd row is.
+        uint32_t pairRows = slot + readLineNum;
+        if (pairRows < YUV_CHROMA_SAMPLE && decodeInfo_.output_scanline < height) {
+            continue;
+        }
+        for (uint32_t i = 0; i < uvWidth; i++) {
+            if (components < YUV_CHROMA_SAMPLE) {
+                cbRow[i] = YUV_GRAY_CHROMA;
+                crRow[i] = YUV_GRAY_CHROMA;
+                continue;
+            }
+            uint32_t columns = std::min(YUV_CHROMA_SAMPLE, width - i * YUV_CHROMA_SAMPLE);
+            uint32_t cb = 0;
+            uint32_t cr = 0;
+            for (uint32_t r = 0; r < pairRows; r++) {
+                for (uint32_t c = 0; c < columns; c++) {
+                    const uint8_t *pixel = rows[r] + (i * YUV_CHROMA_SAMPLE + c) * components;
+                    cb += pixel[1];
+                    cr += pixel[YUV_CHROMA_SAMPLE];
+                }
+            }
+            uint32_t count = pairRows * columns;
+            cbRow[i] = static_cast<uint8_t>((cb + count / YUV_CHROMA_SAMPLE) / count);
+            crRow[i] = static_cast<uint8_t>((cr + count / YUV_CHROMA_SAMPLE) / count);
+        }
+        WriteUvRow(base, firstRow / YUV_CHROMA_SAMPLE, cbRow, crRow);
+    }
+    return Media::SUCCESS;
+}
+
 uint32_t JpegDecoder::Decode(uint32_t index, DecodeContext &context)
 {
     if (index >= JPEG_IMAGE_NUM) {
@@ -357,7 +600,10 @@ uint32_t JpegDecoder::Decode(uint32_t index, DecodeContext &context)
         state_ = JpegDecodingState::IMAGE_DECODING;
     }
     // only state JpegDecodingState::IMAGE_DECODING can go here.
-    if (hwJpegDecompress_ != nullptr) {
+    // the hardware decompressor writes the full size RGB, a scaled, region, YUV or colour converted decode stays
+    // in software.
+    if (hwJpegDecompress_ != nullptr && decodeInfo_.scale_num == decodeInfo_.scale_denom && !regionDecode_ &&
+        !yuvDecode_ && iccTransform_ == nullptr) {
         srcMgr_.inputStream->Seek(streamPosition_);
         uint32_t ret = hwJpegDecompress_->Decompress(&decodeInfo_, srcMgr_.inputStream, context);
         if (ret == Media::SUCCESS) {
@@ -403,8 +649,10 @@ uint32_t JpegDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext
         state_ = JpegDecodingState::IMAGE_DECODED;
     }
     // get promote decode progress, in percentage: 0~100.
+    uint32_t decodedLineNum =
+        (decodeInfo_.output_scanline > decodeRegion_.top) ? (decodeInfo_.output_scanline - decodeRegion_.top) : 0;
     progContext.totalProcessProgress =
-        decodeInfo_.output_height == 0 ? 0 : (decodeInfo_.output_scanline * NUM_100) / decodeInfo_.output_height;
+        decodeRegion_.height == 0 ? 0 : (decodedLineNum * NUM_100) / decodeRegion_.height;
     HiLog::Debug(LABEL, "incremental decode progress %{public}u.", progContext.totalProcessProgress);
     return ret;
 }
@@ -549,6 +797,7 @@ uint32_t JpegDecoder::StartDecompress(const PixelDecodeOptions &opts)
         return ERR_IMAGE_DECODE_ABNORMAL;
     }
     // set decode options
+    yuvDecode_ = false;
     if (decodeInfo_.jpeg_color_space == JCS_CMYK || decodeInfo_.jpeg_color_space == JCS_YCCK) {
         // can't support CMYK to alpha8 convert
         if (opts.desiredPixelFormat == PlPixelFormat::ALPHA_8) {
@@ -558,6 +807,8 @@ uint32_t JpegDecoder::StartDecompress(const PixelDecodeOptions &opts)
         HiLog::Debug(LABEL, "jpeg colorspace is CMYK.");
         decodeInfo_.out_color_space = JCS_CMYK;
         outputFormat_ = PlPixelFormat::CMYK;
+    } else if (IsYuvDecodable(opts)) {
+        SetYuvDecode(opts.desiredPixelFormat);
     } else {
         decodeInfo_.out_color_space = GetDecodeFormat(opts.desiredPixelFormat, outputFormat_);
         if (decodeInfo_.out_color_space == JCS_UNKNOWN) {
@@ -565,6 +816,7 @@ uint32_t JpegDecoder::StartDecompress(const PixelDecodeOptions &opts)
             return ERR_IMAGE_UNKNOWN_FORMAT;
         }
     }
+    SetDecodeScale(opts);
     srcMgr_.inputStream->Seek(streamPosition_);
     if (jpeg_start_decompress(&decodeInfo_) != TRUE) {
         streamPosition_ = srcMgr_.inputStream->Tell();
@@ -572,26 +824,229 @@ uint32_t JpegDecoder::StartDecompress(const PixelDecodeOptions &opts)
         return ERR_IMAGE_INVALID_PARAMETER;
     }
     streamPosition_ = srcMgr_.inputStream->Tell();
+    SetDecodeRegion(opts);
+    SetIccTransform(opts);
     return Media::SUCCESS;
 }
 
+void JpegDecoder::SetIccTransform(const PixelDecodeOptions &opts)
+{
+    iccTransform_ = nullptr;
+    if (!opts.convertColorSpace || yuvDecode_ || !GetIccPixelLayout(decodeInfo_.out_color_space, iccLayout_)) {
+        return;
+    }
+    JOCTET *profile = nullptr;
+    unsigned int profileSize = 0;
+    // without a profile the image is taken as sRGB, the profile was kept by jpeg_save_markers in DecodeHeader.
+    if (!jpeg_read_icc_profile(&decodeInfo_, &profile, &profileSize)) {
+        profile = nullptr;
+        profileSize = 0;
+    }
+    iccTransform_ = IccTransform::Get(profile, profileSize, opts.desiredColorSpace);
+    free(profile);
+}
+
+void JpegDecoder::TransformRows(uint8_t *base, uint32_t rowStride, uint32_t firstRow, uint32_t rowNum)
+{
+    for (uint32_t i = 0; i < rowNum && iccTransform_ != nullptr; i++) {
+        iccTransform_->TransformRow(base + static_cast<uint64_t>(rowStride) * (firstRow + i), decodeRegion_.width,
+            iccLayout_);
+    }
+}
+
+bool JpegDecoder::IsYuvDecodable(const PixelDecodeOptions &opts)
+{
+    if (opts.desiredPixelFormat != PlPixelFormat::NV21 && opts.desiredPixelFormat != PlPixelFormat::NV12) {
+        return false;
+    }
+    // the post-proc can't crop, scale or rotate a YUV pixel map, those decode to RGBA as before.
+    uint32_t targetWidth = 0;
+    uint32_t targetHeight = 0;
+    if (GetScaleTarget(opts, targetWidth, targetHeight) || opts.CropRect.width != 0 || opts.CropRect.height != 0 ||
+        opts.rotateDegrees != 0) {
+        return false;
+    }
+    // libjpeg converts only YCbCr and grayscale images to YCbCr without going through RGB.
+    return (decodeInfo_.jpeg_color_space == JCS_YCbCr && decodeInfo_.num_components == YUV_COMPONENT_NUM) ||
+        (decodeInfo_.jpeg_color_space == JCS_GRAYSCALE && decodeInfo_.num_components == 1);
+}
+
+void JpegDecoder::SetYuvDecode(PlPixelFormat format)
+{
+    yuvDecode_ = true;
+    outputFormat_ = format;
+    if (decodeInfo_.jpeg_color_space == JCS_GRAYSCALE) {
+        decodeInfo_.out_color_space = JCS_GRAYSCALE;
+        return;
+    }
+    decodeInfo_.out_color_space = JCS_YCbCr;
+    // 4:2:0 planes are already NV21 and NV12 planes, they are read without upsampling and color conversion.
+    const jpeg_component_info *comp = decodeInfo_.comp_info;
+    decodeInfo_.raw_data_out = (comp[0].h_samp_factor == YUV_CHROMA_SAMPLE &&
+        comp[0].v_samp_factor == YUV_CHROMA_SAMPLE && comp[1].h_samp_factor == 1 && comp[1].v_samp_factor == 1 &&
+        comp[YUV_CHROMA_SAMPLE].h_samp_factor == 1 && comp[YUV_CHROMA_SAMPLE].v_samp_factor == 1) ? TRUE : FALSE;
+    HiLog::Debug(LABEL, "decode to yuv format %{public}d, raw data %{public}d.", static_cast<int32_t>(format),
+        decodeInfo_.raw_data_out);
+}
+
+bool JpegDecoder::GetScaleTarget(const PixelDecodeOptions &opts, uint32_t &width, uint32_t &height)
+{
+    // the crop rect is in source pixels, so a cropped decode keeps the full scale.
+    if (opts.CropRect.width != 0 || opts.CropRect.height != 0) {
+        return false;
+    }
+    if (opts.desiredSize.width > 0 && opts.desiredSize.height > 0) {
+        // the post-proc rotates before it scales to the desired size, only right angles map the size back.
+        int32_t degrees = static_cast<int32_t>(opts.rotateDegrees);
+        if (static_cast<float>(degrees) != opts.rotateDegrees || degrees % RIGHT_ANGLE != 0) {
+            return false;
+        }
+        bool swapSize = (degrees / RIGHT_ANGLE) % RIGHT_ANGLE_PERIOD != 0;
+        width = static_cast<uint32_t>(swapSize ? opts.desiredSize.height : opts.desiredSize.width);
+        height = static_cast<uint32_t>(swapSize ? opts.desiredSize.width : opts.desiredSize.height);
+        return true;
+    }
+    if (opts.sampleSize > PixelDecodeOptions::DEFAULT_SAMPLE_SIZE) {
+        width = (decodeInfo_.image_width + opts.sampleSize - 1) / opts.sampleSize;
+        height = (decodeInfo_.image_height + opts.sampleSize - 1) / opts.sampleSize;
+        return true;
+    }
+    return false;
+}
+
+void JpegDecoder::SetDecodeScale(const PixelDecodeOptions &opts)
+{
+    decodeInfo_.scale_num = 1;
+    decodeInfo_.scale_denom = 1;
+    uint32_t targetWidth = 0;
+    uint32_t targetHeight = 0;
+    if (!GetScaleTarget(opts, targetWidth, targetHeight)) {
+        return;
+    }
+    // the smallest output still covering the target, the post-proc only does the remaining resize.
+    for (uint32_t num = 1; num < JPEG_SCALE_DENOM; num++) {
+        decodeInfo_.scale_num = num;
+        decodeInfo_.scale_denom = JPEG_SCALE_DENOM;
+        jpeg_calc_output_dimensions(&decodeInfo_);
+        if (decodeInfo_.output_width >= targetWidth && decodeInfo_.output_height >= targetHeight) {
+            HiLog::Debug(LABEL, "decode scale %{public}u/%{public}u, output size %{public}u x %{public}u.", num,
+                JPEG_SCALE_DENOM, decodeInfo_.output_width, decodeInfo_.output_height);
+            return;
+        }
+    }
+    decodeInfo_.scale_num = 1;
+    decodeInfo_.scale_denom = 1;
+}
+
+bool JpegDecoder::IsRegionDecodable(const PlRect &rect)
+{
+    // skipping scanlines needs the whole data, an incremental source decodes the full image.
+    if (!srcMgr_.inputStream->IsStreamCompleted()) {
+        return false;
+    }
+    uint32_t width = decodeInfo_.output_width;
+    uint32_t height = decodeInfo_.output_height;
+    if (rect.width == 0 || rect.height == 0 || rect.left >= width || rect.top >= height ||
+        rect.width > width - rect.left || rect.height > height - rect.top) {
+        return false;
+    }
+    return rect.width < width || rect.height < height;
+}
+
+void JpegDecoder::SetDecodeRegion(const PixelDecodeOptions &opts)
+{
+    decodeRegion_.left = 0;
+    decodeRegion_.top = 0;
+    decodeRegion_.width = decodeInfo_.output_width;
+    decodeRegion_.height = decodeInfo_.output_height;
+    regionDecode_ = false;
+    regionOffset_ = 0;
+    regionRows_.clear();
+    // the crop rect is in output pixels here, GetScaleTarget keeps the full scale for it.
+    if (!IsRegionDecodable(opts.CropRect)) {
+        return;
+    }
+    // libjpeg widens the columns to the iMCU boundaries, the extra columns are trimmed while reading.
+    JDIMENSION columnOffset = opts.CropRect.left;
+    JDIMENSION columnNum = opts.CropRect.width;
+    jpeg_crop_scanline(&decodeInfo_, &columnOffset, &columnNum);
+    decodeRegion_ = opts.CropRect;
+    regionDecode_ = true;
+    regionOffset_ = opts.CropRect.left - columnOffset;
+    if (regionOffset_ != 0 || decodeInfo_.output_width != decodeRegion_.width) {
+        regionRows_.resize(static_cast<size_t>(GetRowBytes()) * GetDecodeLineNum(decodeInfo_));
+    }
+    HiLog::Debug(LABEL, "decode region %{public}u, %{public}u, %{public}u x %{public}u, scanline width %{public}u.",
+        decodeRegion_.left, decodeRegion_.top, decodeRegion_.width, decodeRegion_.height, decodeInfo_.output_width);
+}
+
+bool JpegDecoder::FindMarkerSegment(InputDataStream &stream, uint8_t marker, const uint8_t *signature,
+    uint32_t signatureSize, uint32_t &offset, uint32_t &size)
+{
+    uint8_t buffer[MARKER_SIZE + MARKER_LENGTH] = { 0 };
+    uint32_t readSize = 0;
+    if (!stream.Seek(0) || !stream.Read(MARKER_SIZE, buffer, sizeof(buffer), readSize) || readSize != MARKER_SIZE ||
+        !IsMarker(buffer[JPG_MARKER_PREFIX_OFFSET], buffer[JPG_MARKER_CODE_OFFSET], JPG_MARKER_SOI)) {
+        return false;
+    }
+    std::vector<uint8_t> head(signatureSize);
+    uint32_t pos = MARKER_SIZE;
+    // the metadata segments all come before the first scan, the walk reads only their headers.
+    while (stream.Seek(pos) && stream.Read(sizeof(buffer), buffer, sizeof(buffer), readSize) &&
+        readSize == sizeof(buffer) && buffer[JPG_MARKER_PREFIX_OFFSET] == JPG_MARKER_PREFIX) {
+        uint8_t markerCode = buffer[JPG_MARKER_CODE_OFFSET];
+        if (markerCode == JPG_MARKER_PREFIX) {
+            // fill byte before the marker
+            pos++;
+            continue;
+        }
+        uint32_t length = (buffer[MARKER_SIZE + MARKER_LENGTH_0_OFFSET] << MARKER_LENGTH_SHIFT) +
+            buffer[MARKER_SIZE + MARKER_LENGTH_1_OFFSET];
+        if (markerCode == JPG_MARKER_SOS || markerCode == JPG_MARKER_EOI || length < MARKER_LENGTH) {
+            return false;
+        }
+        if (markerCode == marker && length - MARKER_LENGTH >= signatureSize &&
+            stream.Read(signatureSize, head.data(), signatureSize, readSize) && readSize == signatureSize &&
+            memcmp(head.data(), signature, signatureSize) == 0) {
+            offset = pos + MARKER_SIZE + MARKER_LENGTH;
+            size = length - MARKER_LENGTH;
+            return true;
+        }
+        pos += MARKER_SIZE + length;
+    }
+    return false;
+}
+
 bool JpegDecoder::ParseExifData()
 {
     HiLog::Debug(LABEL, "ParseExifData enter");
     uint32_t curPos = srcMgr_.inputStream->Tell();
-    srcMgr_.inputStream->Seek(0);
-    unsigned long fsize = static_cast<unsigned long>(srcMgr_.inputStream->GetStreamSize());
-    if (fsize <= 0) {
-        HiLog::Error(LABEL, "Get stream size failed");
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    // only the APP1 segment is read, not the whole file.
+    if (!FindMarkerSegment(*srcMgr_.inputStream, JPG_MARKER_APP1, EXIF_SIGNATURE, sizeof(EXIF_SIGNATURE), offset,
+        size)) {
+        srcMgr_.inputStream->Seek(curPos);
+        HiLog::Error(LABEL, "no EXIF segment found");
         return false;
     }
-    unsigned char *buf = new unsigned char[fsize];
-    uint32_t readSize = 0;
-    srcMgr_.inputStream->Read(fsize, buf, fsize, readSize);
-    HiLog::Debug(LABEL, "parsing EXIF: fsize %{public}lu", fsize);
-
-    int code = exifInfo_.ParseExifData(buf, fsize);
-    delete[] buf;
+    HiLog::Debug(LABEL, "parsing EXIF: offset %{public}u, size %{public}u", offset, size);
+    int code;
+    // buffer and mapped file streams expose the whole data, no need to copy it
+    const uint8_t *data = srcMgr_.inputStream->GetDataPtr();
+    if (data != nullptr && offset + size <= srcMgr_.inputStream->GetStreamSize()) {
+        code = exifInfo_.ParseExifData(data + offset, size);
+    } else {
+        std::vector<uint8_t> segment(size);
+        uint32_t readSize = 0;
+        if (!srcMgr_.inputStream->Seek(offset) || !srcMgr_.inputStream->Read(size, segment.data(), size, readSize) ||
+            readSize != size) {
+            srcMgr_.inputStream->Seek(curPos);
+            HiLog::Error(LABEL, "read EXIF segment failed");
+            return false;
+        }
+        code = exifInfo_.ParseExifData(segment.data(), size);
+    }
     srcMgr_.inputStream->Seek(curPos);
     if (code) {
         HiLog::Error(LABEL, "Error parsing EXIF: code %{public}d", code);
@@ -820,6 +1275,54 @@ uint32_t JpegDecoder::ModifyImageProperty(uint32_t index, const std::string &key
     return Media::SUCCESS;
 }
 
+bool JpegDecoder::GetExifTags(const std::map<std::string, std::string> &properties,
+    std::vector<std::pair<ExifTag, std::string>> &tags)
+{
+    for (const auto &property : properties) {
+        ExifTag tag = getExifTagFromKey(property.first);
+        if (tag == EXIF_TAG_PRINT_IMAGE_MATCHING) {
+            HiLog::Error(LABEL, "[ModifyImageProperties] unsupported key:%{public}s", property.first.c_str());
+            return false;
+        }
+        tags.emplace_back(tag, property.second);
+    }
+    return true;
+}
+
+uint32_t JpegDecoder::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    const std::string &path)
+{
+    HiLog::Debug(LABEL, "[ModifyImageProperties] with path:%{public}s, count:%{public}zu",
+        path.c_str(), properties.size());
+    std::vector<std::pair<ExifTag, std::string>> tags;
+    if (!GetExifTags(properties, tags)) {
+        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    }
+    return exifInfo_.ModifyExifData(tags, path);
+}
+
+uint32_t JpegDecoder::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    const int fd)
+{
+    HiLog::Debug(LABEL, "[ModifyImageProperties] with fd:%{public}d, count:%{public}zu", fd, properties.size());
+    std::vector<std::pair<ExifTag, std::string>> tags;
+    if (!GetExifTags(properties, tags)) {
+        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    }
+    return exifInfo_.ModifyExifData(tags, fd);
+}
+
+uint32_t JpegDecoder::ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+    uint8_t *data, uint32_t size)
+{
+    HiLog::Debug(LABEL, "[ModifyImageProperties] with count:%{public}zu", properties.size());
+    std::vector<std::pair<ExifTag, std::string>> tags;
+    if (!GetExifTags(properties, tags)) {
+        return Media::ERR_IMAGE_DECODE_EXIF_UNSUPPORT;
+    }
+    return exifInfo_.ModifyExifData(tags, data, size);
+}
+
 uint32_t JpegDecoder::GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges)
 {
     HiLog::Debug(LABEL, "[GetFilterArea] with privacyType:%{public}d ", privacyType);
@@ -863,6 +1366,9 @@ uint32_t JpegDecoder::GetFilterArea(const int &privacyType, std::vector<std::pai
 #ifdef IMAGE_COLORSPACE_FLAG
 OHOS::ColorManager::ColorSpace JpegDecoder::getGrColorSpace()
 {
+    if (iccTransform_ != nullptr && iccTransform_->GetTargetColorSpace() != nullptr) {
+        return OHOS::ColorManager::ColorSpace(iccTransform_->GetTargetColorSpace());
+    }
     OHOS::ColorManager::ColorSpace grColorSpace = iccProfileInfo_.getGrColorSpace();
     return grColorSpace;
 }
@@ -14,12 +14,16 @@
  */
 
 #include "jpeg_encoder.h"
+#include <algorithm>
+#include <map>
+#include <thread>
 #ifdef IMAGE_COLORSPACE_FLAG
 #include "color_space.h"
 #endif
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkImageInfo.h"
 #include "jerror.h"
+#include "jpeg_parallel_encoder.h"
 #include "media_errors.h"
 #include "pixel_convert.h"
 #include "src/images/SkImageEncoderFns.h"
@@ -47,6 +51,19 @@ constexpr uint8_t INDEX_ZERO = 0;
 constexpr uint8_t INDEX_ONE = 1;
 constexpr uint8_t INDEX_TWO = 2;
 constexpr uint8_t SHIFT_MASK = 1;
+constexpr uint32_t MIN_ENCODE_THREAD_NUM = 2;
+constexpr uint32_t MAX_ENCODE_THREAD_NUM = 8;
+// luma sampling factors, horizontal and vertical, the chroma components keep 1.
+static const std::map<PlChromaSubsampling, std::pair<int, int>> SUBSAMPLING_FACTORS = {
+    { PlChromaSubsampling::YUV444, { SAMPLE_FACTOR_ONE, SAMPLE_FACTOR_ONE } },
+    { PlChromaSubsampling::YUV422, { SAMPLE_FACTOR_TWO, SAMPLE_FACTOR_ONE } },
+    { PlChromaSubsampling::YUV420, { SAMPLE_FACTOR_TWO, SAMPLE_FACTOR_TWO } },
+};
+static const std::map<PlDctMethod, J_DCT_METHOD> DCT_METHODS = {
+    { PlDctMethod::ISLOW, JDCT_ISLOW },
+    { PlDctMethod::IFAST, JDCT_IFAST },
+    { PlDctMethod::FLOAT, JDCT_FLOAT },
+};
 
 JpegDstMgr::JpegDstMgr(OutputDataStream *stream) : outputStream(stream)
 {
@@ -160,7 +177,7 @@ uint32_t JpegEncoder::FinalizeEncode()
         errorCode = RGBAF16Encoder(data);
     } else if (pixelFormat == PixelFormat::RGB_565) {
         errorCode = RGB565Encoder(data);
-    } else {
+    } else if (!DoParallelEncode(data, errorCode)) {
         errorCode = SequenceEncoder(data);
     }
     if (errorCode != SUCCESS) {
@@ -193,17 +210,36 @@ uint32_t JpegEncoder::SetCommonConfig()
     jpeg_set_defaults(&encodeInfo_);
     int32_t quality = encodeOpts_.quality;
     jpeg_set_quality(&encodeInfo_, quality, TRUE);
+    SetTuningConfig();
     return SUCCESS;
 }
 
-uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
+void JpegEncoder::SetTuningConfig()
 {
-    if (setjmp(jerr_.setjmp_buffer)) {
-        HiLog::Error(LABEL, "encode image error.");
-        return ERR_IMAGE_ENCODE_FAILED;
+    // rgb input is converted to YCbCr. NV21 and NV12 input is 4:2:0 already, the yuv encoder sets it again.
+    if (encodeInfo_.jpeg_color_space == JCS_YCbCr) {
+        auto subsampling = SUBSAMPLING_FACTORS.find(encodeOpts_.subsampling);
+        if (subsampling != SUBSAMPLING_FACTORS.end()) {
+            encodeInfo_.comp_info[INDEX_ZERO].h_samp_factor = subsampling->second.first;
+            encodeInfo_.comp_info[INDEX_ZERO].v_samp_factor = subsampling->second.second;
+        }
     }
-    jpeg_start_compress(&encodeInfo_, TRUE);
+    auto dctMethod = DCT_METHODS.find(encodeOpts_.dctMethod);
+    if (dctMethod != DCT_METHODS.end()) {
+        encodeInfo_.dct_method = dctMethod->second;
+    }
+    encodeInfo_.optimize_coding = encodeOpts_.optimizeCoding ? TRUE : FALSE;
+    encodeInfo_.restart_interval = encodeOpts_.restartInterval;
+    if (encodeOpts_.progressive) {
+        jpeg_simple_progression(&encodeInfo_);
+    }
+    HiLog::Debug(LABEL, "subsampling=%{public}d, dct=%{public}d, optimize=%{public}d, progressive=%{public}d, "
+        "restart=%{public}u.", static_cast<int32_t>(encodeOpts_.subsampling), encodeInfo_.dct_method,
+        encodeOpts_.optimizeCoding, encodeOpts_.progressive, encodeOpts_.restartInterval);
+}
 
+uint32_t JpegEncoder::WriteIccProfile(jpeg_compress_struct &cinfo)
+{
 #ifdef IMAGE_COLORSPACE_FLAG
     // packing icc profile.
     SkImageInfo skImageInfo;
@@ -217,20 +253,63 @@ uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
         SkColorType ct = SkColorType::kUnknown_SkColorType;
         SkAlphaType at = SkAlphaType::kUnknown_SkAlphaType;
         skImageInfo = SkImageInfo::Make(width, height, ct, at, skColorSpace);
-        uint32_t iccPackedresult = iccProfileInfo_.PackingICCProfile(&encodeInfo_, skImageInfo);
+        uint32_t iccPackedresult = iccProfileInfo_.PackingICCProfile(&cinfo, skImageInfo);
         if (iccPackedresult == OHOS::Media::ERR_IMAGE_ENCODE_ICC_FAILED) {
             HiLog::Error(LABEL, "encode image icc error.");
             return iccPackedresult;
         }
     }
 #endif
+    return SUCCESS;
+}
+
+bool JpegEncoder::DoParallelEncode(const uint8_t *data, uint32_t &errorCode)
+{
+    uint32_t threadCount = (encodeOpts_.threadCount == 0) ? std::thread::hardware_concurrency() :
+        encodeOpts_.threadCount;
+    threadCount = std::min(threadCount, MAX_ENCODE_THREAD_NUM);
+    if (threadCount < MIN_ENCODE_THREAD_NUM) {
+        return false;
+    }
+    JpegParallelEncoder parallelEncoder(encodeInfo_);
+    if (!parallelEncoder.Split(threadCount)) {
+        return false;
+    }
+    uint32_t rowStride = encodeInfo_.image_width * encodeInfo_.input_components;
+    uint32_t ret = parallelEncoder.Encode(data, rowStride, [this](jpeg_compress_struct &cinfo) {
+        return WriteIccProfile(cinfo);
+    });
+    // nothing is written yet, a strip that fails leaves the image to the sequential encode.
+    if (ret != SUCCESS) {
+        HiLog::Error(LABEL, "parallel encode failed:%{public}u, encode on one thread.", ret);
+        return false;
+    }
+    errorCode = parallelEncoder.Write(*dstMgr_.outputStream);
+    return true;
+}
+
+uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
+{
+    if (setjmp(jerr_.setjmp_buffer)) {
+        HiLog::Error(LABEL, "encode image error.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    jpeg_start_compress(&encodeInfo_, TRUE);
+    uint32_t iccPackedresult = WriteIccProfile(encodeInfo_);
+    if (iccPackedresult != SUCCESS) {
+        return iccPackedresult;
+    }
 
     uint8_t *base = const_cast<uint8_t *>(data);
     uint32_t rowStride = encodeInfo_.image_width * encodeInfo_.input_components;
-    uint8_t *buffer = nullptr;
+    uint32_t lineNum = GetEncodeLineNum(encodeInfo_);
+    JSAMPROW rows[RW_MAX_LINE_NUM];
     while (encodeInfo_.next_scanline < encodeInfo_.image_height) {
-        buffer = base + encodeInfo_.next_scanline * rowStride;
-        jpeg_write_scanlines(&encodeInfo_, &buffer, RW_LINE_NUM);
+        uint32_t rowNum = std::min(lineNum, encodeInfo_.image_height - encodeInfo_.next_scanline);
+        for (uint32_t i = 0; i < rowNum; i++) {
+            rows[i] = base + static_cast<uint64_t>(encodeInfo_.next_scanline + i) * rowStride;
+        }
+        jpeg_write_scanlines(&encodeInfo_, rows, rowNum);
     }
     jpeg_finish_compress(&encodeInfo_);
     return SUCCESS;
@@ -239,7 +318,9 @@ uint32_t JpegEncoder::SequenceEncoder(const uint8_t *data)
 void JpegEncoder::SetYuv420spExtraConfig()
 {
     encodeInfo_.raw_data_in = TRUE;
-    encodeInfo_.dct_method = JDCT_IFAST;
+    if (encodeOpts_.dctMethod == PlDctMethod::DEFAULT) {
+        encodeInfo_.dct_method = JDCT_IFAST;
+    }
     encodeInfo_.comp_info[INDEX_ZERO].h_samp_factor = SAMPLE_FACTOR_TWO;
     encodeInfo_.comp_info[INDEX_ZERO].v_samp_factor = SAMPLE_FACTOR_TWO;
     encodeInfo_.comp_info[INDEX_ONE].h_samp_factor = SAMPLE_FACTOR_ONE;
@@ -325,15 +406,20 @@ uint32_t JpegEncoder::RGBAF16Encoder(const uint8_t *data)
     uint32_t rowStride = encodeInfo_.image_width * encodeInfo_.input_components;
     uint32_t orgRowStride = encodeInfo_.image_width * PIXEL_SIZE_RGBA_F16;
     uint8_t *buffer = nullptr;
-    auto rowBuffer = std::make_unique<uint8_t[]>(rowStride);
+    uint32_t lineNum = GetEncodeLineNum(encodeInfo_);
+    auto rowBuffer = std::make_unique<uint8_t[]>(static_cast<size_t>(rowStride) * lineNum);
+    JSAMPROW rows[RW_MAX_LINE_NUM];
     while (encodeInfo_.next_scanline < encodeInfo_.image_height) {
-        buffer = base + encodeInfo_.next_scanline * orgRowStride;
-        for (uint32_t i = 0; i < rowStride;i++) {
-            float orgPlane = HalfToFloat(U8ToU16(buffer[i*2], buffer[i*2+1]));
-            rowBuffer[i] = static_cast<uint8_t>(orgPlane/MAX_HALF*ALPHA_OPAQUE);
+        uint32_t rowNum = std::min(lineNum, encodeInfo_.image_height - encodeInfo_.next_scanline);
+        for (uint32_t row = 0; row < rowNum; row++) {
+            buffer = base + static_cast<uint64_t>(encodeInfo_.next_scanline + row) * orgRowStride;
+            rows[row] = rowBuffer.get() + static_cast<size_t>(rowStride) * row;
+            for (uint32_t i = 0; i < rowStride;i++) {
+                float orgPlane = HalfToFloat(U8ToU16(buffer[i*2], buffer[i*2+1]));
+                rows[row][i] = static_cast<uint8_t>(orgPlane/MAX_HALF*ALPHA_OPAQUE);
+            }
         }
-        uint8_t *rowBufferPtr = rowBuffer.get();
-        jpeg_write_scanlines(&encodeInfo_, &rowBufferPtr, RW_LINE_NUM);
+        jpeg_write_scanlines(&encodeInfo_, rows, rowNum);
     }
     jpeg_finish_compress(&encodeInfo_);
     return SUCCESS;
@@ -355,20 +441,25 @@ uint32_t JpegEncoder::RGB565Encoder(const uint8_t *data)
     uint8_t *orgRowBuffer = nullptr;
 
     uint32_t outRowStride = encodeInfo_.image_width * encodeInfo_.input_components;
-    auto outRowBuffer = std::make_unique<uint8_t[]>(outRowStride);
+    uint32_t lineNum = GetEncodeLineNum(encodeInfo_);
+    auto outRowBuffer = std::make_unique<uint8_t[]>(static_cast<size_t>(outRowStride) * lineNum);
+    JSAMPROW rows[RW_MAX_LINE_NUM];
 
     while (encodeInfo_.next_scanline < encodeInfo_.image_height) {
-        orgRowBuffer = base + encodeInfo_.next_scanline * orgRowStride;
+        uint32_t rowNum = std::min(lineNum, encodeInfo_.image_height - encodeInfo_.next_scanline);
+        orgRowBuffer = base + static_cast<uint64_t>(encodeInfo_.next_scanline) * orgRowStride;
+        // the rows of a batch are contiguous in both buffers, they are converted in one call.
         skcms(reinterpret_cast<char*>(&outRowBuffer[0]),
             reinterpret_cast<const char*>(orgRowBuffer),
-            encodeInfo_.image_width,
+            encodeInfo_.image_width * rowNum,
             skcms_PixelFormat_RGB_565,
             skcms_AlphaFormat_Unpremul,
             skcms_PixelFormat_RGB_888,
             skcms_AlphaFormat_Unpremul);
-
-        uint8_t *rowBufferPtr = outRowBuffer.get();
-        jpeg_write_scanlines(&encodeInfo_, &rowBufferPtr, RW_LINE_NUM);
+        for (uint32_t row = 0; row < rowNum; row++) {
+            rows[row] = outRowBuffer.get() + static_cast<size_t>(outRowStride) * row;
+        }
+        jpeg_write_scanlines(&encodeInfo_, rows, rowNum);
     }
 
     jpeg_finish_compress(&encodeInfo_);
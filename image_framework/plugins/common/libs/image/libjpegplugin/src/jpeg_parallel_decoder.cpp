@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_parallel_decoder.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include "hilog/log.h"
+#include "image_metrics.h"
+#include "log_tags.h"
+#include "media_errors.h"
+#include "securec.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace Media;
+
+namespace {
+constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "JpegParallelDecoder" };
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_STUFFING = 0x00;
+constexpr uint8_t MARKER_SOI = 0xD8;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_RST0 = 0xD0;
+constexpr uint8_t MARKER_RST7 = 0xD7;
+constexpr uint8_t MARKER_SOF0 = 0xC0;
+constexpr uint8_t MARKER_SOF1 = 0xC1;
+constexpr uint8_t MARKER_SOF15 = 0xCF;
+constexpr uint8_t MARKER_DHT = 0xC4;
+constexpr uint8_t MARKER_JPG = 0xC8;
+constexpr uint8_t MARKER_DAC = 0xCC;
+constexpr uint8_t RESTART_NUM = 8;
+constexpr uint32_t MARKER_SIZE = 2;
+constexpr uint32_t LENGTH_SIZE = 2;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint8_t BYTE_MASK = 0xFF;
+// offset of the image height in a SOFn segment: marker, length and sample precision.
+constexpr uint32_t SOF_HEIGHT_OFFSET = 5;
+// a band writes at least this many restart aligned row groups, the context rows stay a small share of it.
+constexpr uint32_t MIN_BAND_GROUPS = 4;
+constexpr uint32_t MIN_BAND_NUM = 2;
+}
+
+JpegParallelDecoder::JpegParallelDecoder(const uint8_t *data, size_t size, const jpeg_decompress_struct &info)
+    : data_(data), size_(size), colorSpace_(info.out_color_space), imageHeight_(info.image_height),
+      outputWidth_(info.output_width), mcusPerRow_(info.MCUs_per_row), mcuRows_(info.total_iMCU_rows),
+      mcuHeight_(info.max_v_samp_factor * DCTSIZE), restartInterval_(info.restart_interval)
+{
+    // one interleaved scan of all components, huffman coded, at full scale.
+    splittable_ = !info.progressive_mode && !info.arith_code && info.restart_interval > 0 &&
+        info.comps_in_scan == info.num_components && info.MCU_rows_in_scan == info.total_iMCU_rows &&
+        info.scale_num == info.scale_denom && info.output_height == info.image_height;
+}
+
+bool JpegParallelDecoder::ParseMarkers()
+{
+    if (data_ == nullptr || size_ < MARKER_SIZE || size_ > UINT32_MAX || data_[0] != MARKER_PREFIX ||
+        data_[1] != MARKER_SOI) {
+        return false;
+    }
+    size_t pos = MARKER_SIZE;
+    while (pos + MARKER_SIZE + LENGTH_SIZE <= size_) {
+        if (data_[pos] != MARKER_PREFIX) {
+            return false;
+        }
+        uint8_t marker = data_[pos + 1];
+        if (marker == MARKER_PREFIX) {
+            pos++;
+            continue;
+        }
+        uint32_t length = (static_cast<uint32_t>(data_[pos + MARKER_SIZE]) << BYTE_BITS) |
+            data_[pos + MARKER_SIZE + 1];
+        if (length < LENGTH_SIZE || pos + MARKER_SIZE + length > size_) {
+            return false;
+        }
+        if (marker == MARKER_SOF0 || marker == MARKER_SOF1) {
+            sofHeightPos_ = static_cast<uint32_t>(pos + SOF_HEIGHT_OFFSET);
+        } else if (marker > MARKER_SOF1 && marker <= MARKER_SOF15 && marker != MARKER_DHT && marker != MARKER_JPG &&
+            marker != MARKER_DAC) {
+            return false;
+        }
+        pos += MARKER_SIZE + length;
+        if (marker == MARKER_SOS) {
+            headerSize_ = static_cast<uint32_t>(pos);
+            return sofHeightPos_ != 0;
+        }
+    }
+    return false;
+}
+
+bool JpegParallelDecoder::ScanRestartMarkers()
+{
+    uint64_t mcuNum = static_cast<uint64_t>(mcusPerRow_) * mcuRows_;
+    segmentNum_ = static_cast<uint32_t>((mcuNum + restartInterval_ - 1) / restartInterval_);
+    restartPos_.reserve(segmentNum_);
+    entropyEnd_ = static_cast<uint32_t>(size_);
+    const uint8_t *end = data_ + size_;
+    const uint8_t *cur = data_ + headerSize_;
+    while (cur < end) {
+        cur = static_cast<const uint8_t *>(memchr(cur, MARKER_PREFIX, end - cur));
+        if (cur == nullptr || cur + 1 >= end) {
+            break;
+        }
+        uint8_t code = cur[1];
+        if (code == MARKER_STUFFING || code == MARKER_PREFIX) {
+            cur += (code == MARKER_STUFFING) ? MARKER_SIZE : 1;
+            continue;
+        }
+        if (code < MARKER_RST0 || code > MARKER_RST7) {
+            entropyEnd_ = static_cast<uint32_t>(cur - data_);
+            break;
+        }
+        // the intervals must follow each other, a lost marker would shift every band after it.
+        if (static_cast<uint32_t>(code - MARKER_RST0) != static_cast<uint32_t>(restartPos_.size() % RESTART_NUM)) {
+            return false;
+        }
+        restartPos_.push_back(static_cast<uint32_t>(cur - data_));
+        cur += MARKER_SIZE;
+    }
+    return restartPos_.size() + 1 == segmentNum_;
+}
+
+bool JpegParallelDecoder::Split(uint32_t threadCount)
+{
+    if (!splittable_ || threadCount < MIN_BAND_NUM || mcusPerRow_ == 0 ||
+        !ParseMarkers() || !ScanRestartMarkers()) {
+        return false;
+    }
+    // band edges are MCU rows an interval starts on.
+    uint32_t groupRows = restartInterval_ / std::gcd(restartInterval_, mcusPerRow_);
+    uint32_t bandNum = std::min(threadCount, mcuRows_ / (groupRows * MIN_BAND_GROUPS));
+    if (bandNum < MIN_BAND_NUM) {
+        return false;
+    }
+    bands_.resize(bandNum);
+    for (uint32_t i = 0; i < bandNum; i++) {
+        Band &band = bands_[i];
+        band.firstRow = static_cast<uint32_t>(static_cast<uint64_t>(mcuRows_) * i / bandNum) / groupRows * groupRows;
+        band.endRow = (i + 1 == bandNum) ? mcuRows_ :
+            static_cast<uint32_t>(static_cast<uint64_t>(mcuRows_) * (i + 1) / bandNum) / groupRows * groupRows;
+        band.decodeFirstRow = (band.firstRow == 0) ? 0 : (band.firstRow - groupRows);
+        band.decodeEndRow = std::min(band.endRow + groupRows, mcuRows_);
+    }
+    HiLog::Debug(LABEL, "split into %{public}u bands, restart interval %{public}u, %{public}u restart markers.",
+        bandNum, restartInterval_, static_cast<uint32_t>(restartPos_.size()));
+    return true;
+}
+
+uint32_t JpegParallelDecoder::GetSegment(uint32_t mcuRow)
+{
+    if (mcuRow >= mcuRows_) {
+        return segmentNum_;
+    }
+    return static_cast<uint32_t>(static_cast<uint64_t>(mcuRow) * mcusPerRow_ / restartInterval_);
+}
+
+uint32_t JpegParallelDecoder::GetSegmentStart(uint32_t segment)
+{
+    return (segment == 0) ? headerSize_ : (restartPos_[segment - 1] + MARKER_SIZE);
+}
+
+uint32_t JpegParallelDecoder::GetSegmentEnd(uint32_t segment)
+{
+    return (segment + 1 >= segmentNum_) ? entropyEnd_ : restartPos_[segment];
+}
+
+void JpegParallelDecoder::BuildBandStream(Band &band)
+{
+    uint32_t firstSegment = GetSegment(band.decodeFirstRow);
+    uint32_t endSegment = GetSegment(band.decodeEndRow);
+    uint32_t start = GetSegmentStart(firstSegment);
+    uint32_t end = GetSegmentEnd(endSegment - 1);
+    band.stream.resize(headerSize_ + (end - start) + MARKER_SIZE);
+    uint8_t *stream = band.stream.data();
+    std::copy(data_, data_ + headerSize_, stream);
+    std::copy(data_ + start, data_ + end, stream + headerSize_);
+    stream[band.stream.size() - MARKER_SIZE] = MARKER_PREFIX;
+    stream[band.stream.size() - 1] = MARKER_EOI;
+
+    uint32_t height = (band.decodeEndRow == mcuRows_) ? (imageHeight_ - band.decodeFirstRow * mcuHeight_) :
+        ((band.decodeEndRow - band.decodeFirstRow) * mcuHeight_);
+    stream[sofHeightPos_] = static_cast<uint8_t>(height >> BYTE_BITS);
+    stream[sofHeightPos_ + 1] = static_cast<uint8_t>(height & BYTE_MASK);
+    // a band starts with RST0 expected, the markers inside it are numbered again from there.
+    for (uint32_t segment = firstSegment; segment + 1 < endSegment; segment++) {
+        uint32_t markerPos = headerSize_ + (restartPos_[segment] - start);
+        stream[markerPos + 1] = MARKER_RST0 + (segment - firstSegment) % RESTART_NUM;
+    }
+}
+
+uint32_t JpegParallelDecoder::DecodeBand(Band &band, uint8_t *pixels, uint32_t rowStride)
+{
+    ImageMetricsSpan span(SPAN_DECODE_BAND);
+    BuildBandStream(band);
+    jpeg_decompress_struct dinfo;
+    dinfo.err = jpeg_std_error(&band.jerr);
+    band.jerr.error_exit = ErrorExit;
+    band.jerr.output_message = OutputErrorMessage;
+    jpeg_create_decompress(&dinfo);
+    uint32_t ret = DecodeBandStream(band, dinfo, pixels, rowStride);
+    jpeg_destroy_decompress(&dinfo);
+    return ret;
+}
+
+uint32_t JpegParallelDecoder::DecodeBandStream(Band &band, jpeg_decompress_struct &dinfo, uint8_t *pixels,
+    uint32_t rowStride) __attribute__((no_sanitize("cfi")))
+{
+    if (setjmp(band.jerr.setjmp_buffer)) {
+        HiLog::Error(LABEL, "decode band from MCU row %{public}u failed.", band.firstRow);
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    jpeg_mem_src(&dinfo, band.stream.data(), band.stream.size());
+    if (jpeg_read_header(&dinfo, TRUE) != JPEG_HEADER_OK) {
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    dinfo.out_color_space = colorSpace_;
+    if (jpeg_start_decompress(&dinfo) != TRUE || dinfo.output_width != outputWidth_) {
+        return ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    uint32_t lineNum = GetDecodeLineNum(dinfo);
+    uint32_t keepFirst = (band.firstRow - band.decodeFirstRow) * mcuHeight_;
+    uint32_t keepEnd = std::min(band.endRow * mcuHeight_, imageHeight_) - band.decodeFirstRow * mcuHeight_;
+    uint8_t *bandPixels = pixels + static_cast<uint64_t>(rowStride) * band.firstRow * mcuHeight_;
+    JSAMPROW rows[RW_MAX_LINE_NUM];
+    while (dinfo.output_scanline < keepEnd) {
+        uint32_t rowNum = std::min(lineNum, keepEnd - dinfo.output_scanline);
+        for (uint32_t i = 0; i < rowNum; i++) {
+            uint32_t row = dinfo.output_scanline + i;
+            rows[i] = (row < keepFirst) ? (band.scratchRows.data() + static_cast<size_t>(rowStride) * i) :
+                (bandPixels + static_cast<uint64_t>(rowStride) * (row - keepFirst));
+        }
+        uint32_t firstLine = dinfo.output_scanline;
+        uint32_t readLineNum = jpeg_read_scanlines(&dinfo, rows, rowNum);
+        if (readLineNum == 0) {
+            HiLog::Error(LABEL, "band data from MCU row %{public}u is incomplete.", band.firstRow);
+            return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
+        }
+        for (uint32_t i = 0; i < readLineNum && rowTransform_ != nullptr; i++) {
+            if (firstLine + i >= keepFirst) {
+                rowTransform_(rows[i]);
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+void JpegParallelDecoder::SetRowTransform(const RowTransform &transform)
+{
+    rowTransform_ = transform;
+}
+
+uint32_t JpegParallelDecoder::Decode(uint8_t *pixels, uint32_t rowStride)
+{
+    if (bands_.empty() || pixels == nullptr) {
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    for (auto &band : bands_) {
+        band.scratchRows.resize(static_cast<size_t>(rowStride) * RW_MAX_LINE_NUM);
+    }
+    std::vector<uint32_t> results(bands_.size(), SUCCESS);
+    std::vector<std::thread> workers;
+    workers.reserve(bands_.size() - 1);
+    for (size_t i = 1; i < bands_.size(); i++) {
+        workers.emplace_back([this, i, pixels, rowStride, &results]() {
+            results[i] = DecodeBand(bands_[i], pixels, rowStride);
+        });
+    }
+    results[0] = DecodeBand(bands_[0], pixels, rowStride);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (uint32_t result : results) {
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    return SUCCESS;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
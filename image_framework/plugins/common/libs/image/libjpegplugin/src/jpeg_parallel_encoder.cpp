@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_parallel_encoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include "hilog/log.h"
+#include "log_tags.h"
+#include "media_errors.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace Media;
+
+namespace {
+constexpr HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "JpegParallelEncoder" };
+constexpr uint8_t MARKER_PREFIX = 0xFF;
+constexpr uint8_t MARKER_SOI = 0xD8;
+constexpr uint8_t MARKER_EOI = 0xD9;
+constexpr uint8_t MARKER_SOS = 0xDA;
+constexpr uint8_t MARKER_RST7 = 0xD7;
+constexpr uint8_t MARKER_SOF0 = 0xC0;
+constexpr uint8_t MARKER_SOF1 = 0xC1;
+constexpr uint32_t MARKER_SIZE = 2;
+constexpr uint32_t LENGTH_SIZE = 2;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint8_t BYTE_MASK = 0xFF;
+// offset of the image height in a SOFn segment: marker, length and sample precision.
+constexpr uint32_t SOF_HEIGHT_OFFSET = 5;
+// RST0 to RST7, a strip starting on a multiple of this many MCU rows starts on RST0 in a sequential encode too.
+constexpr uint32_t RESTART_NUM = 8;
+constexpr uint32_t MIN_STRIP_NUM = 2;
+}
+
+JpegParallelEncoder::JpegParallelEncoder(const jpeg_compress_struct &config)
+    : config_(config), imageHeight_(config.image_height)
+{
+    int maxVSampFactor = 1;
+    for (int i = 0; i < config.num_components; i++) {
+        maxVSampFactor = std::max(maxVSampFactor, config.comp_info[i].v_samp_factor);
+    }
+    mcuHeight_ = static_cast<uint32_t>(maxVSampFactor) * DCTSIZE;
+    mcuRows_ = (imageHeight_ + mcuHeight_ - 1) / mcuHeight_;
+    // one sequential huffman scan with the default or given tables, the restart markers are set here.
+    splittable_ = !config.arith_code && !config.optimize_coding && config.scan_info == nullptr &&
+        !config.raw_data_in && config.smoothing_factor == 0 && config.restart_interval == 0 &&
+        config.restart_in_rows == 0;
+}
+
+JpegParallelEncoder::~JpegParallelEncoder()
+{
+    for (auto &strip : strips_) {
+        free(strip.output);
+    }
+}
+
+bool JpegParallelEncoder::Split(uint32_t threadCount)
+{
+    if (!splittable_ || threadCount < MIN_STRIP_NUM) {
+        return false;
+    }
+    uint32_t groupNum = mcuRows_ / RESTART_NUM;
+    uint32_t stripNum = std::min(threadCount, groupNum);
+    if (stripNum < MIN_STRIP_NUM) {
+        return false;
+    }
+    strips_.resize(stripNum);
+    for (uint32_t i = 0; i < stripNum; i++) {
+        Strip &strip = strips_[i];
+        strip.firstRow = (groupNum * i / stripNum) * RESTART_NUM * mcuHeight_;
+        strip.endRow = (i + 1 == stripNum) ? imageHeight_ :
+            ((groupNum * (i + 1) / stripNum) * RESTART_NUM * mcuHeight_);
+    }
+    HiLog::Debug(LABEL, "split into %{public}u strips of %{public}u MCU rows.", stripNum, mcuRows_);
+    return true;
+}
+
+void JpegParallelEncoder::ApplyConfig(jpeg_compress_struct &cinfo, uint32_t height)
+{
+    cinfo.image_width = config_.image_width;
+    cinfo.image_height = height;
+    cinfo.input_components = config_.input_components;
+    cinfo.in_color_space = config_.in_color_space;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_colorspace(&cinfo, config_.jpeg_color_space);
+    for (int i = 0; i < config_.num_components; i++) {
+        cinfo.comp_info[i].component_id = config_.comp_info[i].component_id;
+        cinfo.comp_info[i].h_samp_factor = config_.comp_info[i].h_samp_factor;
+        cinfo.comp_info[i].v_samp_factor = config_.comp_info[i].v_samp_factor;
+        cinfo.comp_info[i].quant_tbl_no = config_.comp_info[i].quant_tbl_no;
+        cinfo.comp_info[i].dc_tbl_no = config_.comp_info[i].dc_tbl_no;
+        cinfo.comp_info[i].ac_tbl_no = config_.comp_info[i].ac_tbl_no;
+    }
+    for (int i = 0; i < NUM_QUANT_TBLS; i++) {
+        if (config_.quant_tbl_ptrs[i] == nullptr) {
+            continue;
+        }
+        if (cinfo.quant_tbl_ptrs[i] == nullptr) {
+            cinfo.quant_tbl_ptrs[i] = jpeg_alloc_quant_table(reinterpret_cast<j_common_ptr>(&cinfo));
+        }
+        *cinfo.quant_tbl_ptrs[i] = *config_.quant_tbl_ptrs[i];
+    }
+    for (int i = 0; i < NUM_HUFF_TBLS; i++) {
+        if (config_.dc_huff_tbl_ptrs[i] != nullptr) {
+            if (cinfo.dc_huff_tbl_ptrs[i] == nullptr) {
+                cinfo.dc_huff_tbl_ptrs[i] = jpeg_alloc_huff_table(reinterpret_cast<j_common_ptr>(&cinfo));
+            }
+            *cinfo.dc_huff_tbl_ptrs[i] = *config_.dc_huff_tbl_ptrs[i];
+        }
+        if (config_.ac_huff_tbl_ptrs[i] != nullptr) {
+            if (cinfo.ac_huff_tbl_ptrs[i] == nullptr) {
+                cinfo.ac_huff_tbl_ptrs[i] = jpeg_alloc_huff_table(reinterpret_cast<j_common_ptr>(&cinfo));
+            }
+            *cinfo.ac_huff_tbl_ptrs[i] = *config_.ac_huff_tbl_ptrs[i];
+        }
+    }
+    cinfo.dct_method = config_.dct_method;
+    cinfo.write_JFIF_header = config_.write_JFIF_header;
+    cinfo.JFIF_major_version = config_.JFIF_major_version;
+    cinfo.JFIF_minor_version = config_.JFIF_minor_version;
+    cinfo.density_unit = config_.density_unit;
+    cinfo.X_density = config_.X_density;
+    cinfo.Y_density = config_.Y_density;
+    cinfo.write_Adobe_marker = config_.write_Adobe_marker;
+    cinfo.restart_in_rows = 1;
+}
+
+bool JpegParallelEncoder::ParseStripHeader(Strip &strip)
+{
+    const uint8_t *data = strip.output;
+    size_t size = strip.outputSize;
+    if (data == nullptr || size < MARKER_SIZE * 2 || data[0] != MARKER_PREFIX || data[1] != MARKER_SOI ||
+        data[size - MARKER_SIZE] != MARKER_PREFIX || data[size - 1] != MARKER_EOI) {
+        return false;
+    }
+    size_t pos = MARKER_SIZE;
+    while (pos + MARKER_SIZE + LENGTH_SIZE <= size) {
+        if (data[pos] != MARKER_PREFIX) {
+            return false;
+        }
+        uint8_t marker = data[pos + 1];
+        uint32_t length = (static_cast<uint32_t>(data[pos + MARKER_SIZE]) << BYTE_BITS) |
+            data[pos + MARKER_SIZE + 1];
+        if (length < LENGTH_SIZE || pos + MARKER_SIZE + length > size - MARKER_SIZE) {
+            return false;
+        }
+        if (marker == MARKER_SOF0 || marker == MARKER_SOF1) {
+            strip.sofHeightPos = static_cast<uint32_t>(pos + SOF_HEIGHT_OFFSET);
+        }
+        pos += MARKER_SIZE + length;
+        if (marker == MARKER_SOS) {
+            strip.headerSize = static_cast<uint32_t>(pos);
+            return strip.sofHeightPos != 0;
+        }
+    }
+    return false;
+}
+
+uint32_t JpegParallelEncoder::EncodeStrip(Strip &strip, const uint8_t *pixels, uint32_t rowStride,
+    const MarkerWriter *writeMarkers)
+{
+    jpeg_compress_struct cinfo;
+    cinfo.err = jpeg_std_error(&strip.jerr);
+    strip.jerr.error_exit = ErrorExit;
+    strip.jerr.output_message = OutputErrorMessage;
+    jpeg_create_compress(&cinfo);
+    uint32_t ret = EncodeStripRows(strip, cinfo, pixels, rowStride, writeMarkers);
+    jpeg_destroy_compress(&cinfo);
+    if (ret == SUCCESS && !ParseStripHeader(strip)) {
+        HiLog::Error(LABEL, "strip from row %{public}u has no valid header.", strip.firstRow);
+        ret = ERR_IMAGE_ENCODE_FAILED;
+    }
+    return ret;
+}
+
+uint32_t JpegParallelEncoder::EncodeStripRows(Strip &strip, jpeg_compress_struct &cinfo, const uint8_t *pixels,
+    uint32_t rowStride, const MarkerWriter *writeMarkers) __attribute__((no_sanitize("cfi")))
+{
+    if (setjmp(strip.jerr.setjmp_buffer)) {
+        HiLog::Error(LABEL, "encode strip from row %{public}u failed.", strip.firstRow);
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    ApplyConfig(cinfo, strip.endRow - strip.firstRow);
+    jpeg_mem_dest(&cinfo, &strip.output, &strip.outputSize);
+    jpeg_start_compress(&cinfo, TRUE);
+    if (writeMarkers != nullptr && *writeMarkers) {
+        uint32_t ret = (*writeMarkers)(cinfo);
+        if (ret != SUCCESS) {
+            return ret;
+        }
+    }
+    uint32_t lineNum = GetEncodeLineNum(cinfo);
+    const uint8_t *stripPixels = pixels + static_cast<uint64_t>(rowStride) * strip.firstRow;
+    JSAMPROW rows[RW_MAX_LINE_NUM];
+    while (cinfo.next_scanline < cinfo.image_height) {
+        uint32_t rowNum = std::min(lineNum, cinfo.image_height - cinfo.next_scanline);
+        for (uint32_t i = 0; i < rowNum; i++) {
+            rows[i] = const_cast<uint8_t *>(stripPixels + static_cast<uint64_t>(rowStride) *
+                (cinfo.next_scanline + i));
+        }
+        jpeg_write_scanlines(&cinfo, rows, rowNum);
+    }
+    jpeg_finish_compress(&cinfo);
+    return SUCCESS;
+}
+
+uint32_t JpegParallelEncoder::Encode(const uint8_t *pixels, uint32_t rowStride, const MarkerWriter &writeMarkers)
+{
+    if (strips_.empty() || pixels == nullptr) {
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    std::vector<uint32_t> results(strips_.size(), SUCCESS);
+    std::vector<std::thread> workers;
+    workers.reserve(strips_.size() - 1);
+    for (size_t i = 1; i < strips_.size(); i++) {
+        workers.emplace_back([this, i, pixels, rowStride, &results]() {
+            results[i] = EncodeStrip(strips_[i], pixels, rowStride, nullptr);
+        });
+    }
+    results[0] = EncodeStrip(strips_[0], pixels, rowStride, &writeMarkers);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (uint32_t result : results) {
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+    return SUCCESS;
+}
+
+uint32_t JpegParallelEncoder::Write(OutputDataStream &stream)
+{
+    if (strips_.empty() || strips_[0].output == nullptr) {
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    Strip &first = strips_[0];
+    std::vector<uint8_t> header(first.output, first.output + first.headerSize);
+    header[first.sofHeightPos] = static_cast<uint8_t>(imageHeight_ >> BYTE_BITS);
+    header[first.sofHeightPos + 1] = static_cast<uint8_t>(imageHeight_ & BYTE_MASK);
+    if (!stream.Write(header.data(), header.size())) {
+        HiLog::Error(LABEL, "write header size:%{public}zu failed.", header.size());
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    // every strip but the last ends after MCU row 8n - 1, the marker behind it is RST7.
+    const uint8_t restartMarker[MARKER_SIZE] = { MARKER_PREFIX, MARKER_RST7 };
+    for (size_t i = 0; i < strips_.size(); i++) {
+        Strip &strip = strips_[i];
+        if (i > 0 && !stream.Write(restartMarker, MARKER_SIZE)) {
+            HiLog::Error(LABEL, "write restart marker failed.");
+            return ERR_IMAGE_ENCODE_FAILED;
+        }
+        // the entropy coded data, the EOI marker of the last strip ends the file.
+        uint32_t end = static_cast<uint32_t>(strip.outputSize) - ((i + 1 == strips_.size()) ? 0 : MARKER_SIZE);
+        if (!stream.Write(strip.output + strip.headerSize, end - strip.headerSize)) {
+            HiLog::Error(LABEL, "write strip from row %{public}u failed.", strip.firstRow);
+            return ERR_IMAGE_ENCODE_FAILED;
+        }
+    }
+    stream.Flush();
+    return SUCCESS;
+}
+} // namespace ImagePlugin
+} // namespace OHOS
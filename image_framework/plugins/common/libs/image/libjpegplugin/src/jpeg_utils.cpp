@@ -14,6 +14,7 @@
  */
 
 #include "jpeg_utils.h"
+#include <algorithm>
 #include "securec.h"
 
 namespace OHOS {
@@ -201,5 +202,26 @@ std::string DoubleToString(double num)
     std::string result = str;
     return result;
 }
+
+uint32_t GetDecodeLineNum(const jpeg_decompress_struct &dinfo)
+{
+#if JPEG_LIB_VERSION >= 70
+    uint32_t lineNum = dinfo.max_v_samp_factor * dinfo.min_DCT_v_scaled_size;
+#else
+    uint32_t lineNum = dinfo.max_v_samp_factor * dinfo.min_DCT_scaled_size;
+#endif
+    lineNum = std::max(lineNum, static_cast<uint32_t>(dinfo.rec_outbuf_height));
+    return std::min(std::max(lineNum, 1u), RW_MAX_LINE_NUM);
+}
+
+uint32_t GetEncodeLineNum(const jpeg_compress_struct &cinfo)
+{
+#if JPEG_LIB_VERSION >= 70
+    uint32_t lineNum = cinfo.max_v_samp_factor * cinfo.min_DCT_v_scaled_size;
+#else
+    uint32_t lineNum = cinfo.max_v_samp_factor * DCTSIZE;
+#endif
+    return std::min(std::max(lineNum, 1u), RW_MAX_LINE_NUM);
+}
 } // namespace ImagePlugin
 } // namespace OHOS
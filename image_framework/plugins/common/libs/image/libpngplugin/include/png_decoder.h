@@ -16,6 +16,7 @@
 #ifndef PNG_DECODER_H
 #define PNG_DECODER_H
 
+#include <vector>
 #include "abs_image_decoder.h"
 #include "hilog/log.h"
 #include "input_data_stream.h"
@@ -73,8 +74,14 @@ private:
     static void GetAllRows(png_structp pngPtr, png_bytep row, png_uint_32 rowNum, int pass);
     static void GetInterlacedRows(png_structp pngPtr, png_bytep row, png_uint_32 rowNum, int pass);
     static int32_t ReadUserChunk(png_structp png_ptr, png_unknown_chunkp chunk);
+    static void PullData(png_structp pngPtr, png_bytep data, png_size_t length);
+    uint32_t PullRows();
     void SaveRows(png_bytep row, png_uint_32 rowNum);
     void SaveInterlacedRows(png_bytep row, png_uint_32 rowNum, int pass);
+    uint32_t GetSampleSize(const PixelDecodeOptions &opts);
+    void SetSampleSize(const PixelDecodeOptions &opts);
+    void SampleRow(png_bytep row, png_uint_32 rowNum);
+    void SampleInterlacedRow(png_bytep row, png_uint_32 rowNum, int pass);
     uint32_t ReadIncrementalHead(InputDataStream *stream, PngImageInfo &info);
     bool GetImageInfo(PngImageInfo &info);
     bool IsChunk(const png_byte *chunk, const char *flag);
@@ -110,7 +117,18 @@ private:
     uint32_t firstRow_ = 0;
     uint32_t lastRow_ = 0;
     bool interlacedComplete_ = false;
+    // a complete source is read with libpng's sequential reader, which writes the rows in place.
+    bool pullMode_ = false;
+    bool pullDataEnded_ = false;
+    std::vector<uint8_t> pullRow_;
     NinePatchListener ninePatch_;
+    // the rows are downsampled while they are read, a box of sampleSize_ x sampleSize_ pixels gives one pixel.
+    uint32_t sampleSize_ = 1;
+    uint32_t pixelBytes_ = 0;
+    PlSize outputSize_;
+    uint32_t outputRowSize_ = 0;
+    // channel sums of the boxes of the output row being read.
+    std::vector<uint32_t> sampleSums_;
 };
 } // namespace ImagePlugin
 } // namespace OHOS
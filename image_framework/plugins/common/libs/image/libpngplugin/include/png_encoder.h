@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PNG_ENCODER_H
+#define PNG_ENCODER_H
+
+#include <vector>
+#include "abs_image_encoder.h"
+#include "hilog/log.h"
+#include "log_tags.h"
+#include "plugin_class_base.h"
+#include "png.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+// zlib and filter settings of an encode, a negative filter or strategy keeps the libpng choice.
+struct PngCompressTuning {
+    int32_t level = 0;
+    int32_t filters = -1;
+    int32_t strategy = -1;
+};
+
+// how the pixel map rows are handed to libpng.
+struct PngRowLayout {
+    int32_t colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+    bool bgr = false;
+    bool swapAlpha = false;
+    // PNG_FILLER_BEFORE or PNG_FILLER_AFTER when an unused alpha byte is dropped, -1 otherwise.
+    int32_t filler = -1;
+    // set for the rows libpng cannot take as they are, they are converted into a scratch row first.
+    void (*convert)(uint8_t *dst, const uint8_t *src, uint32_t width) = nullptr;
+    uint32_t convertedPixelBytes = 0;
+};
+
+class PngEncoder : public AbsImageEncoder, public OHOS::MultimediaPlugin::PluginClassBase {
+public:
+    PngEncoder() = default;
+    ~PngEncoder() override;
+    uint32_t StartEncode(OutputDataStream &outputStream, PlEncodeOptions &option) override;
+    uint32_t AddImage(Media::PixelMap &pixelMap) override;
+    uint32_t FinalizeEncode() override;
+
+private:
+    DISALLOW_COPY_AND_MOVE(PngEncoder);
+    static void WriteData(png_structp pngPtr, png_bytep data, png_size_t size);
+    static void FlushData(png_structp pngPtr);
+    static void PngErrorExit(png_structp pngPtr, png_const_charp message);
+    static void PngWarning(png_structp pngPtr, png_const_charp message);
+    PngCompressTuning GetCompressTuning() const;
+    uint32_t SetRowLayout(Media::PixelMap &pixelMap, PngRowLayout &layout);
+    uint32_t WriteImage(Media::PixelMap &pixelMap, const PngRowLayout &layout);
+    void DestroyPngStruct();
+    static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, LOG_TAG_DOMAIN_ID_PLUGIN, "PngEncoder" };
+    OutputDataStream *outputStream_ = nullptr;
+    std::vector<Media::PixelMap *> pixelMaps_;
+    PlEncodeOptions encodeOpts_;
+    png_structp pngStructPtr_ = nullptr;
+    png_infop pngInfoPtr_ = nullptr;
+    std::vector<uint8_t> rowBuffer_;
+};
+} // namespace ImagePlugin
+} // namespace OHOS
+#endif // PNG_ENCODER_H
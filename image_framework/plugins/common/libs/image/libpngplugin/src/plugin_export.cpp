@@ -18,6 +18,7 @@
 #include "log_tags.h"
 #include "plugin_utils.h"
 #include "png_decoder.h"
+#include "png_encoder.h"
 
 // plugin package name same as metadata.
 namespace {
@@ -27,6 +28,9 @@ namespace {
 // register implement classes of this plugin.
 PLUGIN_EXPORT_REGISTER_CLASS_BEGIN
 PLUGIN_EXPORT_REGISTER_CLASS(OHOS::ImagePlugin::PngDecoder)
+#if !defined(_WIN32) && !defined(_APPLE)
+PLUGIN_EXPORT_REGISTER_CLASS(OHOS::ImagePlugin::PngEncoder)
+#endif
 PLUGIN_EXPORT_REGISTER_CLASS_END
 
 using std::string;
@@ -14,6 +14,7 @@
  */
 
 #include "png_decoder.h"
+#include <algorithm>
 #include "media_errors.h"
 #ifndef _WIN32
 #include "securec.h"
@@ -38,6 +39,13 @@ static constexpr size_t DECODE_BUFFER_SIZE = 4096;
 static constexpr size_t CHUNK_SIZE = 8;
 static constexpr size_t CHUNK_DATA_LEN = 4;
 static constexpr int PNG_HEAD_SIZE = 100;
+static constexpr int32_t RIGHT_ANGLE = 90;
+static constexpr int32_t RIGHT_ANGLE_PERIOD = 2;
+static constexpr int ADAM7_PASSES = 7;
+static constexpr uint32_t BYTES_PER_RGB = 3;
+static constexpr uint32_t BYTES_PER_RGBA = 4;
+// bounds the box sums, 256 x 256 pixels of 255 x 255 (a channel weighted by alpha) still fit in 32 bits.
+static constexpr uint32_t MAX_SAMPLE_SIZE = 256;
 
 PngDecoder::PngDecoder()
 {
@@ -129,8 +137,8 @@ uint32_t PngDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions &
         HiLog::Error(LABEL, "config decoding failed on set decode options:%{public}u.", ret);
         return ret;
     }
-    info.size.width = pngImageInfo_.width;
-    info.size.height = pngImageInfo_.height;
+    info.size.width = outputSize_.width;
+    info.size.height = outputSize_.height;
     info.pixelFormat = outputFormat_;
     info.alphaType = alphaType_;
     opts_ = opts;
@@ -199,7 +207,7 @@ uint32_t PngDecoder::Decode(uint32_t index, DecodeContext &context)
 uint8_t *PngDecoder::AllocOutputHeapBuffer(DecodeContext &context)
 {
     if (context.pixelsBuffer.buffer == nullptr) {
-        uint64_t byteCount = static_cast<uint64_t>(pngImageInfo_.rowDataSize) * pngImageInfo_.height;
+        uint64_t byteCount = static_cast<uint64_t>(outputRowSize_) * outputSize_.height;
         if (context.allocatorType == Media::AllocatorType::SHARE_MEM_ALLOC) {
 #if !defined(_WIN32) && !defined(_APPLE)
             int fd = AshmemCreate("PNG RawData", byteCount);
@@ -321,6 +329,9 @@ void PngDecoder::Reset()
     firstRow_ = 0;
     lastRow_ = 0;
     interlacedComplete_ = false;
+    pullMode_ = false;
+    pullDataEnded_ = false;
+    std::fill(sampleSums_.begin(), sampleSums_.end(), 0);
 }
 
 // private interface
@@ -611,6 +622,13 @@ uint32_t PngDecoder::ReadIncrementalHead(InputDataStream *stream, PngImageInfo &
     if (!decodeHeadFlag_) {
         png_set_keep_unknown_chunks(pngStructPtr_, PNG_HANDLE_CHUNK_ALWAYS, (png_byte *)"", 0);
         png_set_read_user_chunk_fn(pngStructPtr_, static_cast<png_voidp>(&ninePatch_), ReadUserChunk);
+        if (stream->IsStreamCompleted()) {
+            png_set_read_fn(pngStructPtr_, this, PullData);
+            png_read_info(pngStructPtr_, pngInfoPtr_);
+            pullMode_ = true;
+            decodeHeadFlag_ = true;
+            return GetImageInfo(info) ? SUCCESS : ERR_IMAGE_DECODE_HEAD_ABNORMAL;
+        }
         png_set_progressive_read_fn(pngStructPtr_, nullptr, nullptr, nullptr, nullptr);
         uint32_t ret = IncrementalRead(stream, static_cast<uint32_t>(CHUNK_SIZE), readData);
         if (ret != SUCCESS) {
@@ -640,6 +658,10 @@ void PngDecoder::SaveRows(png_bytep row, png_uint_32 rowNum)
         return;
     }
     outputRowsNum_++;
+    if (sampleSize_ > 1) {
+        SampleRow(row, rowNum);
+        return;
+    }
     uint8_t *offset = pixelsData_ + rowNum * pngImageInfo_.rowDataSize;
     uint32_t offsetSize = (pngImageInfo_.height - rowNum) * pngImageInfo_.rowDataSize;
     errno_t ret = memcpy_s(offset, offsetSize, row, pngImageInfo_.rowDataSize);
@@ -661,8 +683,12 @@ void PngDecoder::SaveInterlacedRows(png_bytep row, png_uint_32 rowNum, int pass)
                      interlacedComplete_);
         return;
     }
-    png_bytep oldRow = pixelsData_ + (rowNum - firstRow_) * pngImageInfo_.rowDataSize;
-    png_progressive_combine_row(pngStructPtr_, oldRow, row);
+    if (sampleSize_ > 1) {
+        SampleInterlacedRow(row, rowNum, pass);
+    } else {
+        png_bytep oldRow = pixelsData_ + (rowNum - firstRow_) * pngImageInfo_.rowDataSize;
+        png_progressive_combine_row(pngStructPtr_, oldRow, row);
+    }
     if (pass == 0) {
         // The first pass initializes all rows.
         if (outputRowsNum_ == rowNum - firstRow_) {
@@ -686,6 +712,104 @@ void PngDecoder::SaveInterlacedRows(png_bytep row, png_uint_32 rowNum, int pass)
     }
 }
 
+// the rows are unpremultiplied, so the colors of 4 channel rows are weighted by their alpha: a transparent pixel
+// adds nothing to the color of its box, instead of darkening the edge of an opaque area.
+template <uint32_t channels>
+static inline void AddPixelToBox(const uint8_t *pixel, uint32_t alphaIndex, uint32_t *sum)
+{
+    if (channels != BYTES_PER_RGBA) {
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            sum[channel] += pixel[channel];
+        }
+        return;
+    }
+    uint32_t alpha = pixel[alphaIndex];
+    for (uint32_t channel = 0; channel < channels; channel++) {
+        sum[channel] += (channel == alphaIndex) ? alpha : pixel[channel] * alpha;
+    }
+}
+
+template <uint32_t channels>
+static void AddRowToBoxes(const uint8_t *row, uint32_t width, uint32_t boxWidth, uint32_t alphaIndex,
+                          uint32_t *sums)
+{
+    uint32_t x = 0;
+    for (; x + boxWidth <= width; x += boxWidth, sums += channels) {
+        for (uint32_t i = 0; i < boxWidth; i++, row += channels) {
+            AddPixelToBox<channels>(row, alphaIndex, sums);
+        }
+    }
+    for (; x < width; x++, row += channels) {
+        AddPixelToBox<channels>(row, alphaIndex, sums);
+    }
+}
+
+void PngDecoder::SampleRow(png_bytep row, png_uint_32 rowNum)
+{
+    // add the row to the boxes, the output row is written when the last row of its boxes arrived.
+    uint32_t alphaIndex = (outputFormat_ == PlPixelFormat::ARGB_8888) ? 0 : BYTES_PER_RGBA - 1;
+    if (pixelBytes_ == BYTES_PER_RGBA) {
+        AddRowToBoxes<BYTES_PER_RGBA>(row, pngImageInfo_.width, sampleSize_, alphaIndex, sampleSums_.data());
+    } else {
+        AddRowToBoxes<BYTES_PER_RGB>(row, pngImageInfo_.width, sampleSize_, alphaIndex, sampleSums_.data());
+    }
+    if (rowNum % sampleSize_ != sampleSize_ - 1 && rowNum != pngImageInfo_.height - 1) {
+        return;
+    }
+    // the boxes of the last row and column may be cut by the image edge.
+    uint32_t boxRows = rowNum % sampleSize_ + 1;
+    uint8_t *output = pixelsData_ + (rowNum / sampleSize_) * outputRowSize_;
+    uint32_t *sum = sampleSums_.data();
+    for (uint32_t x = 0; x < pngImageInfo_.width; x += sampleSize_) {
+        uint32_t count = std::min(sampleSize_, pngImageInfo_.width - x) * boxRows;
+        if (pixelBytes_ == BYTES_PER_RGBA) {
+            // the weighted colors are divided by the alpha sum, a fully transparent box stays transparent black.
+            uint32_t alphaSum = sum[alphaIndex];
+            for (uint32_t channel = 0; channel < BYTES_PER_RGBA; channel++) {
+                uint32_t divisor = (channel == alphaIndex) ? count : alphaSum;
+                output[channel] = (divisor == 0) ? 0 :
+                    static_cast<uint8_t>((sum[channel] + divisor / 2) / divisor);  // 2 rounds to nearest
+                sum[channel] = 0;
+            }
+        } else {
+            for (uint32_t channel = 0; channel < pixelBytes_; channel++) {
+                output[channel] = static_cast<uint8_t>((sum[channel] + count / 2) / count);  // 2 rounds to nearest
+                sum[channel] = 0;
+            }
+        }
+        output += pixelBytes_;
+        sum += pixelBytes_;
+    }
+}
+
+void PngDecoder::SampleInterlacedRow(png_bytep row, png_uint_32 rowNum, int pass)
+{
+    // a row comes once per Adam7 pass containing it, so every box takes its top left pixel. libpng widens the
+    // row of a pass with each pixel repeated up to the next one of the pass, that value is a blocky preview of
+    // the pixels whose own pass is still to come.
+    if (rowNum % sampleSize_ != 0) {
+        return;
+    }
+    uint32_t passWidth = PNG_PASS_COLS(pngImageInfo_.width, pass) << PNG_PASS_COL_SHIFT(pass);
+    uint8_t *output = pixelsData_ + (rowNum / sampleSize_) * outputRowSize_;
+    for (uint32_t x = 0; x < pngImageInfo_.width && x < passWidth; x += sampleSize_) {
+        int ownPass = 0;
+        while (ownPass < ADAM7_PASSES - 1 && !(PNG_ROW_IN_INTERLACE_PASS(rowNum, ownPass) &&
+            PNG_COL_IN_INTERLACE_PASS(x, ownPass))) {
+            ownPass++;
+        }
+        // the pulled rows only hold the pixels of their pass.
+        if (ownPass == pass || (!pullMode_ && ownPass > pass)) {
+            errno_t ret = memcpy_s(output, pixelBytes_, row + x * pixelBytes_, pixelBytes_);
+            if (ret != 0) {
+                HiLog::Error(LABEL, "copy sampled pixel fail, ret:%{public}d.", ret);
+                return;
+            }
+        }
+        output += pixelBytes_;
+    }
+}
+
 void PngDecoder::GetAllRows(png_structp pngPtr, png_bytep row, png_uint_32 rowNum, int pass)
 {
     if (pngPtr == nullptr || row == nullptr) {
@@ -714,6 +838,63 @@ void PngDecoder::GetInterlacedRows(png_structp pngPtr, png_bytep row, png_uint_3
     decoder->SaveInterlacedRows(row, rowNum, pass);
 }
 
+void PngDecoder::PullData(png_structp pngPtr, png_bytep data, png_size_t length)
+{
+    PngDecoder *decoder = static_cast<PngDecoder *>(png_get_io_ptr(pngPtr));
+    if (decoder == nullptr || decoder->inputStreamPtr_ == nullptr) {
+        png_error(pngPtr, "pull data without source stream.");
+    }
+    InputDataStream *stream = decoder->inputStreamPtr_;
+    uint32_t position = stream->Tell();
+    const uint8_t *source = stream->GetDataPtr();
+    if (source != nullptr) {
+        // copy straight from the source data, the stream only keeps the position.
+        if (length > stream->GetStreamSize() - position) {
+            decoder->pullDataEnded_ = true;
+            png_error(pngPtr, "pull data out of source range.");
+        }
+        if (memcpy_s(data, length, source + position, length) != EOK) {
+            png_error(pngPtr, "pull data copy fail.");
+        }
+        stream->Seek(position + static_cast<uint32_t>(length));
+        return;
+    }
+    uint32_t readSize = 0;
+    if (!stream->Read(static_cast<uint32_t>(length), data, static_cast<uint32_t>(length), readSize) ||
+        readSize != length) {
+        decoder->pullDataEnded_ = true;
+        png_error(pngPtr, "pull data from source stream fail.");
+    }
+}
+
+uint32_t PngDecoder::PullRows()
+{
+    // libpng gives the rows in order, the rows of an interlaced image once per pass.
+    bool sampled = sampleSize_ > 1;
+    if (sampled) {
+        pullRow_.resize(pngImageInfo_.rowDataSize);
+    }
+    for (int32_t pass = 0; pass < pngImageInfo_.numberPasses; pass++) {
+        for (uint32_t rowNum = 0; rowNum < pngImageInfo_.height; rowNum++) {
+            png_bytep row = sampled ? pullRow_.data() : pixelsData_ + rowNum * outputRowSize_;
+            png_read_row(pngStructPtr_, row, nullptr);
+            if (pass == pngImageInfo_.numberPasses - 1) {
+                outputRowsNum_ = rowNum + 1;
+            }
+            if (!sampled) {
+                continue;
+            }
+            if (pngImageInfo_.numberPasses == 1) {
+                SampleRow(row, rowNum);
+            } else if (PNG_ROW_IN_INTERLACE_PASS(rowNum, pass)) {
+                SampleInterlacedRow(row, rowNum, pass);
+            }
+        }
+    }
+    // the chunks behind the image data carry no pixels, they are not read.
+    return SUCCESS;
+}
+
 int32_t PngDecoder::ReadUserChunk(png_structp png_ptr, png_unknown_chunkp chunk)
 {
     NinePatchListener *chunkReader = static_cast<NinePatchListener *>(png_get_user_chunk_ptr(png_ptr));
@@ -777,7 +958,11 @@ uint32_t PngDecoder::IncrementalReadRows(InputDataStream *stream)
     jmp_buf *jmpBuf = &(png_jmpbuf(pngStructPtr_));
     if ((jmpBuf == nullptr) || setjmp(*jmpBuf)) {
         HiLog::Error(LABEL, "[IncrementalReadRows]PNG decode exception.");
-        return ERR_IMAGE_DECODE_ABNORMAL;
+        // the rows read before the source ended stay in the output as a partial image.
+        return pullDataEnded_ ? ERR_IMAGE_SOURCE_DATA_INCOMPLETE : ERR_IMAGE_DECODE_ABNORMAL;
+    }
+    if (pullMode_) {
+        return PullRows();
     }
     // set process decode state to IDAT mode.
     if (!decodedIdat_) {
@@ -921,12 +1106,51 @@ uint32_t PngDecoder::ConfigInfo(const PixelDecodeOptions &opts)
         return ERR_IMAGE_DATA_ABNORMAL;
     }
     png_read_update_info(pngStructPtr_, pngInfoPtr_);
+    SetSampleSize(opts);
     return SUCCESS;
 }
 
+uint32_t PngDecoder::GetSampleSize(const PixelDecodeOptions &opts)
+{
+    // the crop rect is in source pixels, so a cropped decode keeps the full size.
+    if (opts.CropRect.width != 0 || opts.CropRect.height != 0) {
+        return PixelDecodeOptions::DEFAULT_SAMPLE_SIZE;
+    }
+    if (opts.desiredSize.width > 0 && opts.desiredSize.height > 0) {
+        // the post-proc rotates before it scales to the desired size, only right angles map the size back.
+        int32_t degrees = static_cast<int32_t>(opts.rotateDegrees);
+        if (static_cast<float>(degrees) != opts.rotateDegrees || degrees % RIGHT_ANGLE != 0) {
+            return PixelDecodeOptions::DEFAULT_SAMPLE_SIZE;
+        }
+        bool swapSize = (degrees / RIGHT_ANGLE) % RIGHT_ANGLE_PERIOD != 0;
+        uint32_t width = static_cast<uint32_t>(swapSize ? opts.desiredSize.height : opts.desiredSize.width);
+        uint32_t height = static_cast<uint32_t>(swapSize ? opts.desiredSize.width : opts.desiredSize.height);
+        // the largest box whose output still covers the target, the post-proc does the remaining resize.
+        return std::min(pngImageInfo_.width / width, pngImageInfo_.height / height);
+    }
+    return opts.sampleSize;
+}
+
+void PngDecoder::SetSampleSize(const PixelDecodeOptions &opts)
+{
+    sampleSize_ = PixelDecodeOptions::DEFAULT_SAMPLE_SIZE;
+    // 16 bit channels keep the full size, as do nine-patch images whose patch is scaled separately.
+    if (outputFormat_ != PlPixelFormat::RGBA_F16 && ninePatch_.patch_ == nullptr) {
+        sampleSize_ = std::min(std::max(GetSampleSize(opts), PixelDecodeOptions::DEFAULT_SAMPLE_SIZE),
+            MAX_SAMPLE_SIZE);
+    }
+    pixelBytes_ = pngImageInfo_.rowDataSize / pngImageInfo_.width;
+    outputSize_.width = (pngImageInfo_.width + sampleSize_ - 1) / sampleSize_;
+    outputSize_.height = (pngImageInfo_.height + sampleSize_ - 1) / sampleSize_;
+    outputRowSize_ = (sampleSize_ > 1) ? outputSize_.width * pixelBytes_ : pngImageInfo_.rowDataSize;
+    sampleSums_.assign((sampleSize_ > 1) ? outputRowSize_ : 0, 0);
+    HiLog::Debug(LABEL, "sample size:%{public}u, output size:%{public}ux%{public}u.", sampleSize_,
+        outputSize_.width, outputSize_.height);
+}
+
 uint32_t PngDecoder::DoOneTimeDecode(DecodeContext &context)
 {
-    if (idatLength_ <= 0) {
+    if (!pullMode_ && idatLength_ <= 0) {
         HiLog::Error(LABEL, "normal decode the image source incomplete.");
         return ERR_IMAGE_SOURCE_DATA_INCOMPLETE;
     }
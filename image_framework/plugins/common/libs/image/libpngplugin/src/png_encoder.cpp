@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "png_encoder.h"
+#include <algorithm>
+#include <csetjmp>
+#include <map>
+#include "media_errors.h"
+#include "pixel_convert.h"
+#include "zlib.h"
+
+namespace OHOS {
+namespace ImagePlugin {
+using namespace OHOS::HiviewDFX;
+using namespace MultimediaPlugin;
+using namespace Media;
+static constexpr uint32_t PNG_IMAGE_NUM = 1;
+static constexpr int SET_JUMP_VALUE = 1;
+static constexpr int PNG_BIT_DEPTH = 8;
+static constexpr uint32_t BYTES_PER_RGB = 3;
+static constexpr uint32_t BYTES_PER_RGBA = 4;
+static constexpr uint32_t BYTES_PER_RGB565 = 2;
+static constexpr uint32_t BYTES_PER_RGBA_F16 = 8;
+static constexpr uint32_t BITS_PER_BYTE = 8;
+static constexpr uint32_t HALF = 2;
+static constexpr float ROUND_HALF = 0.5f;
+static constexpr uint32_t RGB565_RED_SHIFT = 11;
+static constexpr uint32_t RGB565_GREEN_SHIFT = 5;
+static constexpr uint32_t RGB565_GREEN_MASK = 0x3F;
+static constexpr uint32_t RGB565_BLUE_MASK = 0x1F;
+// a 5 bit channel goes up by 3 bits and takes its top 3 bits below, a 6 bit one by 2 and takes its top 2.
+static constexpr uint32_t FIVE_BIT_SHIFT = 3;
+static constexpr uint32_t FIVE_BIT_TOP_SHIFT = 2;
+static constexpr uint32_t SIX_BIT_SHIFT = 2;
+static constexpr uint32_t SIX_BIT_TOP_SHIFT = 4;
+static constexpr uint32_t MAX_CHANNEL = 255;
+// one IDAT chunk per compressed buffer, the libpng default of 8K writes a chunk header every 8K.
+static constexpr size_t COMPRESS_BUFFER_SIZE = 65536;
+// on synthetic screen shots about three times the default speed for files up to twice as large, level 1 is no
+// faster with the up filter and compresses the flat areas worse.
+static constexpr PngCompressTuning FAST_TUNING = { 2, PNG_FILTER_UP, -1 };
+static constexpr PngCompressTuning DEFAULT_TUNING = { Z_DEFAULT_COMPRESSION, -1, -1 };
+static const std::map<PlPngFilter, int32_t> PNG_FILTERS = {
+    { PlPngFilter::NONE, PNG_FILTER_NONE },
+    { PlPngFilter::SUB, PNG_FILTER_SUB },
+    { PlPngFilter::UP, PNG_FILTER_UP },
+    { PlPngFilter::ADAPTIVE, PNG_ALL_FILTERS },
+};
+static const std::map<PlCompressionStrategy, int32_t> ZLIB_STRATEGIES = {
+    { PlCompressionStrategy::FILTERED, Z_FILTERED },
+    { PlCompressionStrategy::HUFFMAN_ONLY, Z_HUFFMAN_ONLY },
+    { PlCompressionStrategy::RLE, Z_RLE },
+    { PlCompressionStrategy::FIXED, Z_FIXED },
+};
+
+uint32_t PngEncoder::StartEncode(OutputDataStream &outputStream, PlEncodeOptions &option)
+{
+    pixelMaps_.clear();
+    outputStream_ = &outputStream;
+    encodeOpts_ = option;
+    return SUCCESS;
+}
+
+uint32_t PngEncoder::AddImage(Media::PixelMap &pixelMap)
+{
+    if (pixelMaps_.size() >= PNG_IMAGE_NUM) {
+        HiLog::Error(LABEL, "add pixel map out of range:[%{public}u].", PNG_IMAGE_NUM);
+        return ERR_IMAGE_ADD_PIXEL_MAP_FAILED;
+    }
+    pixelMaps_.push_back(&pixelMap);
+    return SUCCESS;
+}
+
+uint32_t PngEncoder::FinalizeEncode()
+{
+    if (pixelMaps_.empty() || outputStream_ == nullptr) {
+        HiLog::Error(LABEL, "encode no pixel map or output stream.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    PixelMap &pixelMap = *pixelMaps_[0];
+    if (pixelMap.GetPixels() == nullptr || pixelMap.GetWidth() <= 0 || pixelMap.GetHeight() <= 0) {
+        HiLog::Error(LABEL, "encode image buffer is null or empty.");
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    PngRowLayout layout;
+    uint32_t errorCode = SetRowLayout(pixelMap, layout);
+    if (errorCode != SUCCESS) {
+        return errorCode;
+    }
+    pngStructPtr_ = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngErrorExit, PngWarning);
+    pngInfoPtr_ = (pngStructPtr_ != nullptr) ? png_create_info_struct(pngStructPtr_) : nullptr;
+    if (pngInfoPtr_ == nullptr) {
+        HiLog::Error(LABEL, "create png write struct failed.");
+        DestroyPngStruct();
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    errorCode = WriteImage(pixelMap, layout);
+    DestroyPngStruct();
+    if (errorCode != SUCCESS) {
+        HiLog::Error(LABEL, "encode png failed:%{public}u.", errorCode);
+    }
+    return errorCode;
+}
+
+// premultiplied 8888 rows to straight alpha, ALPHA_INDEX is the byte of the alpha in a pixel.
+template<uint32_t ALPHA_INDEX>
+static void UnpremulRow(uint8_t *dst, const uint8_t *src, uint32_t width)
+{
+    for (uint32_t x = 0; x < width; x++, src += BYTES_PER_RGBA, dst += BYTES_PER_RGBA) {
+        uint32_t alpha = src[ALPHA_INDEX];
+        for (uint32_t i = 0; i < BYTES_PER_RGBA; i++) {
+            if (i == ALPHA_INDEX || alpha == MAX_CHANNEL) {
+                dst[i] = src[i];
+            } else if (alpha == 0) {
+                dst[i] = 0;
+            } else {
+                dst[i] = static_cast<uint8_t>(std::min((src[i] * MAX_CHANNEL + alpha / HALF) / alpha, MAX_CHANNEL));
+            }
+        }
+    }
+}
+
+static void Rgb565ToRgbRow(uint8_t *dst, const uint8_t *src, uint32_t width)
+{
+    for (uint32_t x = 0; x < width; x++, src += BYTES_PER_RGB565, dst += BYTES_PER_RGB) {
+        uint32_t pixel = src[0] | (static_cast<uint32_t>(src[1]) << BITS_PER_BYTE);
+        uint32_t red = pixel >> RGB565_RED_SHIFT;
+        uint32_t green = (pixel >> RGB565_GREEN_SHIFT) & RGB565_GREEN_MASK;
+        uint32_t blue = pixel & RGB565_BLUE_MASK;
+        dst[0] = static_cast<uint8_t>((red << FIVE_BIT_SHIFT) | (red >> FIVE_BIT_TOP_SHIFT));
+        dst[1] = static_cast<uint8_t>((green << SIX_BIT_SHIFT) | (green >> SIX_BIT_TOP_SHIFT));
+        dst[2] = static_cast<uint8_t>((blue << FIVE_BIT_SHIFT) | (blue >> FIVE_BIT_TOP_SHIFT));
+    }
+}
+
+template<bool PREMUL>
+static void F16ToRgbaRow(uint8_t *dst, const uint8_t *src, uint32_t width)
+{
+    for (uint32_t x = 0; x < width; x++, src += BYTES_PER_RGBA_F16, dst += BYTES_PER_RGBA) {
+        float channels[BYTES_PER_RGBA];
+        for (uint32_t i = 0; i < BYTES_PER_RGBA; i++) {
+            uint16_t half = static_cast<uint16_t>(src[i * HALF] | (src[i * HALF + 1] << BITS_PER_BYTE));
+            channels[i] = std::clamp(HalfToFloat(half), 0.0f, 1.0f);
+        }
+        float alpha = channels[BYTES_PER_RGBA - 1];
+        for (uint32_t i = 0; i < BYTES_PER_RGBA; i++) {
+            float value = channels[i];
+            if (PREMUL && i != BYTES_PER_RGBA - 1) {
+                value = (alpha > 0.0f) ? std::min(value / alpha, 1.0f) : 0.0f;
+            }
+            dst[i] = static_cast<uint8_t>(value * MAX_CHANNEL + ROUND_HALF);
+        }
+    }
+}
+
+uint32_t PngEncoder::SetRowLayout(PixelMap &pixelMap, PngRowLayout &layout)
+{
+    PixelFormat format = pixelMap.GetPixelFormat();
+    AlphaType alphaType = pixelMap.GetAlphaType();
+    bool opaque = (alphaType == AlphaType::IMAGE_ALPHA_TYPE_OPAQUE);
+    bool premul = (alphaType == AlphaType::IMAGE_ALPHA_TYPE_PREMUL);
+    layout.colorType = opaque ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA;
+    switch (format) {
+        case PixelFormat::RGBA_8888:
+        case PixelFormat::BGRA_8888:
+        case PixelFormat::ARGB_8888: {
+            bool alphaFirst = (format == PixelFormat::ARGB_8888);
+            layout.bgr = (format == PixelFormat::BGRA_8888);
+            layout.swapAlpha = alphaFirst && !opaque;
+            if (opaque) {
+                layout.filler = alphaFirst ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER;
+            }
+            // png keeps straight alpha.
+            if (premul) {
+                layout.convert = alphaFirst ? UnpremulRow<0> : UnpremulRow<BYTES_PER_RGBA - 1>;
+                layout.convertedPixelBytes = BYTES_PER_RGBA;
+            }
+            return SUCCESS;
+        }
+        case PixelFormat::RGB_888: {
+            layout.colorType = PNG_COLOR_TYPE_RGB;
+            return SUCCESS;
+        }
+        case PixelFormat::ALPHA_8: {
+            // an alpha mask has no color, writing it as gray would turn coverage into luminance.
+            HiLog::Error(LABEL, "png encode does not support ALPHA_8 pixel map.");
+            return ERR_IMAGE_INVALID_PARAMETER;
+        }
+        case PixelFormat::RGB_565: {
+            layout.colorType = PNG_COLOR_TYPE_RGB;
+            layout.convert = Rgb565ToRgbRow;
+            layout.convertedPixelBytes = BYTES_PER_RGB;
+            return SUCCESS;
+        }
+        case PixelFormat::RGBA_F16: {
+            if (opaque) {
+                layout.filler = PNG_FILLER_AFTER;
+            }
+            layout.convert = premul ? F16ToRgbaRow<true> : F16ToRgbaRow<false>;
+            layout.convertedPixelBytes = BYTES_PER_RGBA;
+            return SUCCESS;
+        }
+        default: {
+            HiLog::Error(LABEL, "png encode unsupported pixel format:%{public}d.", static_cast<int32_t>(format));
+            return ERR_IMAGE_INVALID_PARAMETER;
+        }
+    }
+}
+
+PngCompressTuning PngEncoder::GetCompressTuning() const
+{
+    PngCompressTuning tuning = (encodeOpts_.preset == PlEncodePreset::FAST) ? FAST_TUNING : DEFAULT_TUNING;
+    if (encodeOpts_.compressionLevel >= 0) {
+        tuning.level = encodeOpts_.compressionLevel;
+    }
+    auto filterSearch = PNG_FILTERS.find(encodeOpts_.pngFilter);
+    if (filterSearch != PNG_FILTERS.end()) {
+        tuning.filters = filterSearch->second;
+    }
+    auto strategySearch = ZLIB_STRATEGIES.find(encodeOpts_.compressionStrategy);
+    if (strategySearch != ZLIB_STRATEGIES.end()) {
+        tuning.strategy = strategySearch->second;
+    }
+    return tuning;
+}
+
+uint32_t PngEncoder::WriteImage(PixelMap &pixelMap, const PngRowLayout &layout)
+{
+    if (setjmp(png_jmpbuf(pngStructPtr_))) {
+        HiLog::Error(LABEL, "encode image error.");
+        return ERR_IMAGE_ENCODE_FAILED;
+    }
+    uint32_t width = static_cast<uint32_t>(pixelMap.GetWidth());
+    uint32_t height = static_cast<uint32_t>(pixelMap.GetHeight());
+    png_set_write_fn(pngStructPtr_, this, WriteData, FlushData);
+    png_set_IHDR(pngStructPtr_, pngInfoPtr_, width, height, PNG_BIT_DEPTH, layout.colorType, PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    PngCompressTuning tuning = GetCompressTuning();
+    png_set_compression_level(pngStructPtr_, tuning.level);
+    if (tuning.filters >= 0) {
+        png_set_filter(pngStructPtr_, PNG_FILTER_TYPE_BASE, tuning.filters);
+    }
+    if (tuning.strategy >= 0) {
+        png_set_compression_strategy(pngStructPtr_, tuning.strategy);
+    }
+    png_set_compression_buffer_size(pngStructPtr_, COMPRESS_BUFFER_SIZE);
+    png_write_info(pngStructPtr_, pngInfoPtr_);
+    // the transforms look at the colour type, they are set once the header is written.
+    if (layout.bgr) {
+        png_set_bgr(pngStructPtr_);
+    }
+    if (layout.swapAlpha) {
+        png_set_swap_alpha(pngStructPtr_);
+    }
+    if (layout.filler >= 0) {
+        png_set_filler(pngStructPtr_, 0, layout.filler);
+    }
+    const uint8_t *pixels = pixelMap.GetPixels();
+    size_t rowBytes = static_cast<size_t>(pixelMap.GetRowBytes());
+    rowBuffer_.resize(static_cast<size_t>(width) * layout.convertedPixelBytes);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = pixels + rowBytes * y;
+        if (layout.convert != nullptr) {
+            layout.convert(rowBuffer_.data(), row, width);
+            row = rowBuffer_.data();
+        }
+        png_write_row(pngStructPtr_, const_cast<png_bytep>(row));
+    }
+    png_write_end(pngStructPtr_, pngInfoPtr_);
+    return SUCCESS;
+}
+
+void PngEncoder::WriteData(png_structp pngPtr, png_bytep data, png_size_t size)
+{
+    auto encoder = static_cast<PngEncoder *>(png_get_io_ptr(pngPtr));
+    if (encoder == nullptr || !encoder->outputStream_->Write(data, static_cast<uint32_t>(size))) {
+        png_error(pngPtr, "write png data failed");
+    }
+}
+
+void PngEncoder::FlushData(png_structp pngPtr)
+{
+    auto encoder = static_cast<PngEncoder *>(png_get_io_ptr(pngPtr));
+    if (encoder != nullptr) {
+        encoder->outputStream_->Flush();
+    }
+}
+
+void PngEncoder::PngErrorExit(png_structp pngPtr, png_const_charp message)
+{
+    if (pngPtr == nullptr) {
+        HiLog::Error(LABEL, "ErrorExit png_structp is null.");
+        return;
+    }
+    HiLog::Error(LABEL, "png error %{public}s", (message != nullptr) ? message : "");
+    longjmp(png_jmpbuf(pngPtr), SET_JUMP_VALUE);
+}
+
+void PngEncoder::PngWarning(png_structp pngPtr, png_const_charp message)
+{
+    if (message == nullptr) {
+        HiLog::Error(LABEL, "WarningExit message is null.");
+        return;
+    }
+    HiLog::Warn(LABEL, "png warn %{public}s", message);
+}
+
+void PngEncoder::DestroyPngStruct()
+{
+    if (pngStructPtr_ != nullptr) {
+        png_destroy_write_struct(&pngStructPtr_, (pngInfoPtr_ != nullptr) ? &pngInfoPtr_ : nullptr);
+    }
+    pngStructPtr_ = nullptr;
+    pngInfoPtr_ = nullptr;
+}
+
+PngEncoder::~PngEncoder()
+{
+    DestroyPngStruct();
+    pixelMaps_.clear();
+}
+} // namespace ImagePlugin
+} // namespace OHOS
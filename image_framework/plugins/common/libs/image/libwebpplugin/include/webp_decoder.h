@@ -47,6 +47,7 @@ public:
     uint32_t Decode(uint32_t index, DecodeContext &context) override;
     uint32_t PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context) override;
     uint32_t GetImageSize(uint32_t index, PlSize &size) override;
+    uint32_t DecodeAnimationFrame(uint32_t index, AnimationFrameContext &context) override;
 
 private:
     // private function
@@ -61,6 +62,8 @@ private:
     uint32_t DoIncrementalDecode(ProgDecodeContext &context);
     void FinishOldDecompress();
     bool IsDataEnough();
+    uint32_t CreateAnimDecoder();
+    void GetAnimFrameInfo(uint32_t index, bool isNextFrame, AnimationFrameContext &context);
     // private members
     InputDataStream *stream_ = nullptr;
     DataStreamBuffer dataBuffer_;
@@ -72,6 +75,11 @@ private:
     WebpDecodingState state_ = WebpDecodingState::UNDECIDED;
     PixelDecodeOptions opts_;
     PlPixelFormat outputFormat_ = PlPixelFormat::UNKNOWN;
+    // animation frames, composed one after another on the canvas of the anim decoder.
+    WebPAnimDecoder *animDecoder_ = nullptr;
+    uint32_t animFrameCount_ = 0;
+    int32_t lastAnimIndex_ = -1;
+    uint8_t *animCanvas_ = nullptr;
 };
 } // namespace ImagePlugin
 } // namespace OHOS
@@ -14,6 +14,7 @@
  */
 
 #include "webp_decoder.h"
+#include <algorithm>
 #include "media_errors.h"
 #include "multimedia_templates.h"
 #include "securec.h"
@@ -101,8 +102,14 @@ uint32_t WebpDecoder::SetDecodeOptions(uint32_t index, const PixelDecodeOptions
     } else {
         info.alphaType = opts.desireAlphaType;
     }
-    webpMode_ = GetWebpDecodeMode(opts.desiredPixelFormat,
-                                  hasAlpha && (opts.desireAlphaType == PlAlphaType::IMAGE_ALPHA_TYPE_PREMUL));
+    WEBP_CSP_MODE webpMode = GetWebpDecodeMode(opts.desiredPixelFormat,
+        hasAlpha && (opts.desireAlphaType == PlAlphaType::IMAGE_ALPHA_TYPE_PREMUL));
+    if (animDecoder_ != nullptr && webpMode != webpMode_) {
+        // the anim decoder composes in the mode it was created with.
+        WebPAnimDecoderDelete(animDecoder_);
+        animDecoder_ = nullptr;
+    }
+    webpMode_ = webpMode;
     info.size = webpSize_;
     info.pixelFormat = outputFormat_;
     opts_ = opts;
@@ -142,6 +149,49 @@ uint32_t WebpDecoder::Decode(uint32_t index, DecodeContext &context)
     return DoCommonDecode(context);
 }
 
+uint32_t WebpDecoder::DecodeAnimationFrame(uint32_t index, AnimationFrameContext &context)
+{
+    if (state_ < WebpDecodingState::IMAGE_DECODING) {
+        HiLog::Error(LABEL, "decode animation frame failed for state %{public}d.", state_);
+        return ERR_MEDIA_INVALID_OPERATION;
+    }
+    if (animDecoder_ == nullptr) {
+        uint32_t ret = CreateAnimDecoder();
+        if (ret != SUCCESS) {
+            return ret;
+        }
+    }
+    if (index >= animFrameCount_) {
+        HiLog::Error(LABEL, "animation:invalid index, index:%{public}u, range:%{public}u.", index, animFrameCount_);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    int32_t acquiredIndex = static_cast<int32_t>(index);
+    bool isNextFrame = acquiredIndex == lastAnimIndex_ + 1;
+    bool isSameFrame = acquiredIndex == lastAnimIndex_;
+    if (acquiredIndex < lastAnimIndex_) {
+        // the anim decoder only goes forward, an earlier frame is composed again from the first one.
+        WebPAnimDecoderReset(animDecoder_);
+        lastAnimIndex_ = -1;
+    }
+    while (lastAnimIndex_ < acquiredIndex) {
+        int32_t timestamp = 0;
+        if (!WebPAnimDecoderGetNext(animDecoder_, &animCanvas_, &timestamp)) {
+            HiLog::Error(LABEL, "decode animation frame %{public}d failed.", lastAnimIndex_ + 1);
+            WebPAnimDecoderReset(animDecoder_);
+            lastAnimIndex_ = -1;
+            return ERR_IMAGE_DECODE_FAILED;
+        }
+        lastAnimIndex_++;
+    }
+    context.pixels = animCanvas_;
+    context.frameCount = animFrameCount_;
+    GetAnimFrameInfo(index, isNextFrame, context);
+    if (isSameFrame) {
+        context.dirtyRect = {};
+    }
+    return SUCCESS;
+}
+
 uint32_t WebpDecoder::PromoteIncrementalDecode(uint32_t index, ProgDecodeContext &context)
 {
     context.totalProcessProgress = 0;
@@ -228,6 +278,69 @@ bool WebpDecoder::IsDataEnough()
     return true;
 }
 
+uint32_t WebpDecoder::CreateAnimDecoder()
+{
+    if (webpMode_ != MODE_RGBA && webpMode_ != MODE_BGRA && webpMode_ != MODE_rgbA && webpMode_ != MODE_bgrA) {
+        HiLog::Error(LABEL, "animation:unsupported output mode %{public}d.", webpMode_);
+        return ERR_IMAGE_INVALID_PARAMETER;
+    }
+    WebPAnimDecoderOptions animOptions;
+    if (WebPAnimDecoderOptionsInit(&animOptions) == 0) {
+        HiLog::Error(LABEL, "animation:init options failed.");
+        return ERR_IMAGE_DECODE_FAILED;
+    }
+    animOptions.color_mode = webpMode_;
+    animOptions.use_threads = 0;
+    WebPData webpData = { dataBuffer_.inputStreamBuffer, static_cast<size_t>(dataBuffer_.dataSize) };
+    animDecoder_ = WebPAnimDecoderNew(&webpData, &animOptions);
+    WebPAnimInfo animInfo;
+    if (animDecoder_ == nullptr || WebPAnimDecoderGetInfo(animDecoder_, &animInfo) == 0 ||
+        animInfo.frame_count == 0) {
+        HiLog::Error(LABEL, "animation:create decoder failed.");
+        WebPAnimDecoderDelete(animDecoder_);
+        animDecoder_ = nullptr;
+        return ERR_IMAGE_DECODE_FAILED;
+    }
+    animFrameCount_ = animInfo.frame_count;
+    lastAnimIndex_ = -1;
+    animCanvas_ = nullptr;
+    return SUCCESS;
+}
+
+// delay and disposal of the frame, the area it changed when the frame before it is the one on the canvas.
+void WebpDecoder::GetAnimFrameInfo(uint32_t index, bool isNextFrame, AnimationFrameContext &context)
+{
+    context.dirtyRect = { 0, 0, webpSize_.width, webpSize_.height };
+    const WebPDemuxer *demuxer = WebPAnimDecoderGetDemuxer(animDecoder_);
+    WebPIterator iter;
+    // demux frames are numbered from 1.
+    if (WebPDemuxGetFrame(demuxer, static_cast<int32_t>(index) + 1, &iter) == 0) {
+        return;
+    }
+    context.delayTime = iter.duration;
+    context.disposal = (iter.dispose_method == WEBP_MUX_DISPOSE_BACKGROUND) ?
+        PlDisposalType::BACKGROUND : PlDisposalType::NONE;
+    if (!isNextFrame || index == 0 || iter.complete == 0) {
+        WebPDemuxReleaseIterator(&iter);
+        return;
+    }
+    uint32_t left = static_cast<uint32_t>(iter.x_offset);
+    uint32_t top = static_cast<uint32_t>(iter.y_offset);
+    uint32_t right = left + static_cast<uint32_t>(iter.width);
+    uint32_t bottom = top + static_cast<uint32_t>(iter.height);
+    // the area of a previous frame disposed to the background is cleared before this one is drawn.
+    if (WebPDemuxPrevFrame(&iter) != 0 && iter.dispose_method == WEBP_MUX_DISPOSE_BACKGROUND) {
+        left = std::min(left, static_cast<uint32_t>(iter.x_offset));
+        top = std::min(top, static_cast<uint32_t>(iter.y_offset));
+        right = std::max(right, static_cast<uint32_t>(iter.x_offset + iter.width));
+        bottom = std::max(bottom, static_cast<uint32_t>(iter.y_offset + iter.height));
+    }
+    WebPDemuxReleaseIterator(&iter);
+    right = std::min(right, webpSize_.width);
+    bottom = std::min(bottom, webpSize_.height);
+    context.dirtyRect = { left, top, (right > left) ? right - left : 0, (bottom > top) ? bottom - top : 0 };
+}
+
 WEBP_CSP_MODE WebpDecoder::GetWebpDecodeMode(const PlPixelFormat &pixelFormat, bool premul)
 {
     WEBP_CSP_MODE webpMode = MODE_RGBA;
@@ -369,6 +482,13 @@ bool WebpDecoder::PreDecodeProc(DecodeContext &context, WebPDecoderConfig &confi
 
 void WebpDecoder::Reset()
 {
+    if (animDecoder_ != nullptr) {
+        WebPAnimDecoderDelete(animDecoder_);
+        animDecoder_ = nullptr;
+    }
+    animFrameCount_ = 0;
+    lastAnimIndex_ = -1;
+    animCanvas_ = nullptr;
     stream_->Seek(0);
     dataBuffer_ = { nullptr, 0, 0 };
     webpSize_ = { 0, 0 };
@@ -96,6 +96,29 @@ struct PixelDecodeOptions {
     PlAlphaType desireAlphaType = PlAlphaType::IMAGE_ALPHA_TYPE_PREMUL;
     bool allowPartialImage = true;
     bool editable = false;
+    // 0 uses the hardware concurrency.
+    uint32_t threadCount = 1;
+    // convert the pixels from the embedded ICC profile to desiredColorSpace.
+    bool convertColorSpace = false;
+    // composed frames an animated image decoder keeps for seeking, 0 for either turns it off.
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 8;
+    static constexpr uint64_t DEFAULT_KEYFRAME_CACHE_SIZE = 32 * 1024 * 1024;
+    uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+    uint64_t keyframeCacheSize = DEFAULT_KEYFRAME_CACHE_SIZE;
+};
+
+struct AnimationFrameContext {
+    // Out: the frame composed on the decoder canvas, 4 bytes a pixel in the format of SetDecodeOptions,
+    // rows of the canvas width. It stays valid until the next decode call.
+    const uint8_t *pixels = nullptr;
+    // Out: frames in the animation.
+    uint32_t frameCount = 0;
+    // Out: display time of the frame in milliseconds.
+    int32_t delayTime = 0;
+    // Out: how the frame is disposed of before the next one.
+    PlDisposalType disposal = PlDisposalType::UNSPECIFIED;
+    // Out: canvas area changed since the frame decoded before, the whole canvas unless that was index - 1.
+    PlRect dirtyRect;
 };
 
 class AbsImageDecoder {
@@ -169,6 +192,32 @@ public:
         return Media::ERR_MEDIA_INVALID_OPERATION;
     }
 
+    // modify several image properties at once, properties maps the keys to the new values.
+    virtual uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const std::string &path)
+    {
+        return Media::ERR_MEDIA_INVALID_OPERATION;
+    }
+
+    virtual uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        const int fd)
+    {
+        return Media::ERR_MEDIA_INVALID_OPERATION;
+    }
+
+    virtual uint32_t ModifyImageProperties(uint32_t index, const std::map<std::string, std::string> &properties,
+        uint8_t *data, uint32_t size)
+    {
+        return Media::ERR_MEDIA_INVALID_OPERATION;
+    }
+
+    // animated images: composes frame index after the options are set by SetDecodeOptions. The frames are
+    // cheapest in order, the canvas stays with the decoder and only the changes of each frame are drawn.
+    virtual uint32_t DecodeAnimationFrame(uint32_t index, AnimationFrameContext &context)
+    {
+        return Media::ERR_MEDIA_INVALID_OPERATION;
+    }
+
     // get filter area.
     virtual uint32_t GetFilterArea(const int &privacyType, std::vector<std::pair<uint32_t, uint32_t>> &ranges)
     {
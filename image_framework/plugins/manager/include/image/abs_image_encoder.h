@@ -26,6 +26,19 @@ namespace ImagePlugin {
 struct PlEncodeOptions {
     uint8_t quality = 100;
     uint32_t numberHint = 1;
+    // 0 uses the hardware concurrency.
+    uint32_t threadCount = 1;
+    PlChromaSubsampling subsampling = PlChromaSubsampling::DEFAULT;
+    bool optimizeCoding = false;
+    bool progressive = false;
+    PlDctMethod dctMethod = PlDctMethod::DEFAULT;
+    // MCUs between two restart markers, 0 writes none.
+    uint32_t restartInterval = 0;
+    // zlib level, -1 follows the preset.
+    int32_t compressionLevel = -1;
+    PlPngFilter pngFilter = PlPngFilter::DEFAULT;
+    PlCompressionStrategy compressionStrategy = PlCompressionStrategy::DEFAULT;
+    PlEncodePreset preset = PlEncodePreset::DEFAULT;
 };
 
 class AbsImageEncoder {
@@ -102,6 +102,48 @@ enum class PlAlphaType : int32_t {
     IMAGE_ALPHA_TYPE_UNPREMUL = 3,
 };
 
+enum class PlChromaSubsampling : int32_t {
+    DEFAULT = 0,
+    YUV444 = 1,
+    YUV422 = 2,
+    YUV420 = 3,
+};
+
+enum class PlDctMethod : int32_t {
+    DEFAULT = 0,
+    ISLOW = 1,
+    IFAST = 2,
+    FLOAT = 3,
+};
+
+enum class PlPngFilter : int32_t {
+    DEFAULT = 0,
+    NONE = 1,
+    SUB = 2,
+    UP = 3,
+    ADAPTIVE = 4,
+};
+
+enum class PlCompressionStrategy : int32_t {
+    DEFAULT = 0,
+    FILTERED = 1,
+    HUFFMAN_ONLY = 2,
+    RLE = 3,
+    FIXED = 4,
+};
+
+enum class PlEncodePreset : int32_t {
+    DEFAULT = 0,
+    FAST = 1,
+};
+
+enum class PlDisposalType : int32_t {
+    UNSPECIFIED = 0,
+    NONE = 1,
+    BACKGROUND = 2,
+    PREVIOUS = 3,
+};
+
 struct PlPosition {
     uint32_t x = 0;
     uint32_t y = 0;
@@ -124,6 +166,8 @@ struct PlImageInfo {
     PlPixelFormat pixelFormat = PlPixelFormat::UNKNOWN;
     PlColorSpace colorSpace = PlColorSpace::UNKNOWN;
     PlAlphaType alphaType = PlAlphaType::IMAGE_ALPHA_TYPE_UNKNOWN;
+    // the decoder decodes only the crop rect of the decode options, the size is the size of the rect.
+    bool cropApplied = false;
 };
 
 struct PlImageBuffer {